@@ -16,6 +16,8 @@
 
 #include <AK/Assertions.h>
 
+#define OFFSET_OF(class, member) __builtin_offsetof(class, member)
+
 template<typename T, typename U>
 constexpr auto round_up_to_power_of_two(T value, U power_of_two) requires(AK::Detail::IsIntegral<T>&& AK::Detail::IsIntegral<U>)
 {
@@ -119,6 +119,12 @@ public:
     ALWAYS_INLINE size_t size() const { return m_size; }
     size_t capacity() const { return m_capacity; }
 
+    // Where the pointer returned by data() lives, for code that reads a Vector without going through C++.
+    static constexpr size_t outline_buffer_offset() requires(inline_capacity == 0)
+    {
+        return OFFSET_OF(Vector, m_outline_buffer);
+    }
+
     ALWAYS_INLINE StorageType* data()
     {
         if constexpr (inline_capacity > 0)
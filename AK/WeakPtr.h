@@ -134,6 +134,9 @@ public:
 
     [[nodiscard]] RefPtr<WeakLink> take_link() { return move(m_link); }
 
+    // The WeakLink* stored at this offset is null if the WeakPtr was never set.
+    static constexpr size_t link_offset() { return OFFSET_OF(WeakPtr, m_link); }
+
 private:
     WeakPtr(RefPtr<WeakLink> const& link)
         : m_link(link)
@@ -0,0 +1,82 @@
+/*
+ * Copyright (c) 2022, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#pragma once
+
+#include <AK/Types.h>
+
+namespace Kernel {
+
+// An IORing is created with io_ring_create() and mapped with mmap() on the returned fd.
+// The mapping starts with an IORingHeader page, followed by the submission queue at
+// `submissions_offset` and the completion queue at `completions_offset`.
+// Userspace only advances `submission_tail` and `completion_head`, the kernel only advances
+// `submission_head` and `completion_tail`. All of them only ever grow, and are taken
+// modulo the number of entries of their queue to find an entry.
+struct IORingHeader {
+    u32 submission_head;
+    u32 submission_tail;
+    u32 completion_head;
+    u32 completion_tail;
+    u32 submission_entries;
+    u32 completion_entries;
+    u32 submissions_offset;
+    u32 completions_offset;
+};
+
+enum class IORingOperation : u8 {
+    Nop,
+    // Reads or writes at `offset`, or at the current offset of the description if it's negative.
+    Read,
+    Write,
+    // The result is the new fd, `flags` takes SOCK_NONBLOCK and SOCK_CLOEXEC.
+    Accept,
+    // `flags` takes the MSG_* flags of recv() and send().
+    Recv,
+    Send,
+};
+
+struct IORingSubmission {
+    IORingOperation operation;
+    u8 reserved0;
+    u16 reserved1;
+    i32 fd;
+    u64 buffer;
+    u64 length;
+    i64 offset;
+    i32 flags;
+    u32 reserved2;
+    // Handed back untouched in the completion.
+    u64 user_data;
+};
+
+static_assert(sizeof(IORingSubmission) == 48);
+
+struct IORingCompletion {
+    u64 user_data;
+    // What the equivalent syscall would have returned, or the negated errno.
+    i64 result;
+};
+
+static_assert(sizeof(IORingCompletion) == 16);
+
+constexpr size_t io_ring_header_size = 4096;
+constexpr u32 io_ring_max_entries = 4096;
+
+// There is room for two completions per submission, so submissions that wait for their file
+// to become ready don't keep the ones behind them from being completed.
+constexpr u32 io_ring_completion_entries(u32 submission_entries)
+{
+    return submission_entries * 2;
+}
+
+constexpr size_t io_ring_size(u32 submission_entries)
+{
+    size_t size = io_ring_header_size + submission_entries * sizeof(IORingSubmission) + io_ring_completion_entries(submission_entries) * sizeof(IORingCompletion);
+    return (size + 4095) & ~static_cast<size_t>(4095);
+}
+
+}
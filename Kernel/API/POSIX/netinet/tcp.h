@@ -0,0 +1,14 @@
+/*
+ * Copyright (c) 2020, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#pragma once
+
+#define TCP_NODELAY 10
+#define TCP_MAXSEG 11
+#define TCP_CONGESTION 13
+
+// The longest name that TCP_CONGESTION accepts or returns, including the null terminator.
+#define TCP_CA_NAME_MAX 16
@@ -33,10 +33,17 @@ enum {
     PERF_EVENT_SYSCALL = 16384,
     PERF_EVENT_SIGNPOST = 32768,
     PERF_EVENT_READ = 65536,
+    PERF_EVENT_CPU_CYCLES = 131072,
+    PERF_EVENT_INSTRUCTIONS = 262144,
+    PERF_EVENT_CACHE_MISSES = 524288,
+    PERF_EVENT_BRANCH_MISSES = 1048576,
 };
 
 #define PERF_EVENT_MASK_ALL (~0ull)
 
+// These are sampled from the performance counters of the CPU, which not every CPU has.
+#define PERF_EVENT_HARDWARE_COUNTERS (PERF_EVENT_CPU_CYCLES | PERF_EVENT_INSTRUCTIONS | PERF_EVENT_CACHE_MISSES | PERF_EVENT_BRANCH_MISSES)
+
 #define THREAD_PRIORITY_MIN 1
 #define THREAD_PRIORITY_LOW 10
 #define THREAD_PRIORITY_NORMAL 30
@@ -0,0 +1,59 @@
+/*
+ * Copyright (c) 2022, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#pragma once
+
+#include <AK/Types.h>
+
+namespace Kernel {
+
+// While sampling is enabled through /dev/samples, every CPU writes the stacks it interrupts
+// into a ring of its own, which is mapped into the reader at `cpu * sample_ring_size(data_size)`.
+// The ring starts with a SampleRingHeader page and is followed by `data_size` bytes of records.
+// The kernel only advances `write_position` and the reader only advances `read_position`.
+// Both of them only ever grow, and are taken modulo `data_size` to find a record.
+struct SampleRingHeader {
+    u64 write_position;
+    u64 read_position;
+    u64 lost_samples;
+    u32 data_offset;
+    u32 data_size;
+    u32 cpu;
+    u32 samples_per_second;
+};
+
+enum class SampleRecordType : u32 {
+    Sample,
+    // Fills up the end of the ring when the next record wouldn't fit in front of it.
+    Padding,
+};
+
+struct SampleRecord {
+    // Includes the frames and is always a multiple of 8.
+    u32 size;
+    SampleRecordType type;
+    i32 pid;
+    i32 tid;
+    u64 timestamp_ns;
+    u16 kernel_frame_count;
+    u16 user_frame_count;
+    u32 reserved;
+
+    // The kernel frames (innermost first) come first, followed by the user frames.
+    FlatPtr const* frames() const { return reinterpret_cast<FlatPtr const*>(this + 1); }
+    FlatPtr* frames() { return reinterpret_cast<FlatPtr*>(this + 1); }
+};
+
+static_assert(sizeof(SampleRecord) % 8 == 0);
+
+constexpr size_t sample_ring_header_size = 4096;
+
+constexpr size_t sample_ring_size(u32 data_size)
+{
+    return sample_ring_header_size + data_size;
+}
+
+}
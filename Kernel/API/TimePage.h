@@ -18,12 +18,29 @@ namespace Kernel {
 
 inline bool time_page_supports(clockid_t clock_id)
 {
-    return clock_id == CLOCK_REALTIME_COARSE || clock_id == CLOCK_MONOTONIC_COARSE;
+    // NOTE: The kernel doesn't take the precision of CLOCK_REALTIME into account yet, so it's the same as the coarse clock.
+    return clock_id == CLOCK_REALTIME_COARSE || clock_id == CLOCK_MONOTONIC_COARSE || clock_id == CLOCK_REALTIME;
 }
 
+// The precise monotonic clocks are extrapolated from the TSC, if the kernel was able to calibrate it.
+inline bool time_page_extrapolates(clockid_t clock_id)
+{
+    return clock_id == CLOCK_MONOTONIC || clock_id == CLOCK_MONOTONIC_RAW;
+}
+
+// nanoseconds = (tsc - tsc_base) * tsc_to_ns_multiplier >> time_page_tsc_shift
+static constexpr u32 time_page_tsc_shift = 32;
+
 struct TimePage {
     volatile u32 update1;
     struct timespec clocks[CLOCK_ID_COUNT];
+    // The TSC value at the time the extrapolated clocks were updated.
+    u64 tsc_base;
+    // If the TSC has advanced further than this, the time page hasn't been updated in a while,
+    // so ask the kernel instead.
+    u64 tsc_delta_limit;
+    // Zero if the TSC can't be used.
+    u64 tsc_to_ns_multiplier;
     volatile u32 update2;
 };
 
@@ -0,0 +1,34 @@
+/*
+ * Copyright (c) 2022, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#pragma once
+
+#include <AK/Error.h>
+#include <AK/Platform.h>
+#include <AK/Types.h>
+
+namespace Kernel {
+
+struct RegisterState;
+
+// Samples the PERF_EVENT_HARDWARE_COUNTERS events of g_profiling_event_mask by letting the
+// counters of the CPU raise an interrupt every time they have counted a fixed number of events.
+class PerformanceCounters {
+public:
+    // Fails with ENOTSUP if the CPU can't count one of the hardware events in the mask.
+    // Each successful call has to be balanced by a call to disable().
+    static ErrorOr<void> enable(u64 event_mask);
+    static void disable();
+
+    // Called on every CPU from its own timer interrupt, so each CPU (re)programs its own counters.
+    static void timer_tick();
+
+#if ARCH(X86_64) || ARCH(I386)
+    static void handle_overflow(RegisterState const&);
+#endif
+};
+
+}
@@ -8,6 +8,7 @@
 #include <AK/Types.h>
 
 #include <Kernel/Arch/Delay.h>
+#include <Kernel/Arch/PerformanceCounters.h>
 #include <Kernel/Process.h>
 #include <Kernel/Sections.h>
 #include <Kernel/kstdio.h>
@@ -42,6 +43,26 @@ void microseconds_delay(u32)
 
 }
 
+// PerformanceCounters.cpp
+namespace Kernel {
+
+ErrorOr<void> PerformanceCounters::enable(u64 event_mask)
+{
+    if (event_mask & PERF_EVENT_HARDWARE_COUNTERS)
+        return ENOTSUP;
+    return {};
+}
+
+void PerformanceCounters::disable()
+{
+}
+
+void PerformanceCounters::timer_tick()
+{
+}
+
+}
+
 // Initializer.cpp
 namespace Kernel::PCI {
 
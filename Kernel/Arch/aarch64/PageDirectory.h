@@ -47,6 +47,9 @@ public:
         m_raw |= TABLE_DESCRIPTOR;
     }
 
+    PhysicalPtr large_page_base() const { TODO_AARCH64(); }
+    void set_large_page_base(PhysicalPtr) { }
+
     bool is_null() const { return m_raw == 0; }
     void clear() { m_raw = 0; }
 
@@ -81,6 +84,12 @@ public:
     bool is_execute_disabled() const { TODO_AARCH64(); }
     void set_execute_disabled(bool) { }
 
+    bool is_large_page_pat() const { TODO_AARCH64(); }
+    void set_large_page_pat(bool) { }
+
+    bool is_write_protect_deferred() const { TODO_AARCH64(); }
+    void set_write_protect_deferred(bool) { }
+
 private:
     void set_bit(u64 bit, bool value)
     {
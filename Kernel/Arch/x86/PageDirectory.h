@@ -22,6 +22,14 @@ public:
         m_raw |= PhysicalAddress::physical_page_base(value);
     }
 
+    // NOTE: When the Huge bit is set, this entry maps a 2 MiB page instead of pointing to a page table.
+    PhysicalPtr large_page_base() const { return m_raw & 0x000fffffffe00000ULL; }
+    void set_large_page_base(PhysicalPtr value)
+    {
+        m_raw &= 0x8000000000000fffULL;
+        m_raw |= value & 0x000fffffffe00000ULL;
+    }
+
     bool is_null() const { return m_raw == 0; }
     void clear() { m_raw = 0; }
 
@@ -36,6 +44,9 @@ public:
         CacheDisabled = 1 << 4,
         Huge = 1 << 7,
         Global = 1 << 8,
+        // NOTE: This bit is ignored by the CPU, see MemoryManager::defer_write_protection().
+        WriteProtectDeferred = 1 << 9,
+        LargePagePAT = 1 << 12,
         NoExecute = 0x8000000000000000ULL,
     };
 
@@ -63,6 +74,12 @@ public:
     bool is_execute_disabled() const { return (raw() & NoExecute) == NoExecute; }
     void set_execute_disabled(bool b) { set_bit(NoExecute, b); }
 
+    bool is_large_page_pat() const { return (raw() & LargePagePAT) == LargePagePAT; }
+    void set_large_page_pat(bool b) { set_bit(LargePagePAT, b); }
+
+    bool is_write_protect_deferred() const { return (raw() & WriteProtectDeferred) == WriteProtectDeferred; }
+    void set_write_protect_deferred(bool b) { set_bit(WriteProtectDeferred, b); }
+
 private:
     void set_bit(u64 bit, bool value)
     {
@@ -26,6 +26,7 @@ public:
 
     bool init_bsp();
     void eoi();
+    void unmask_performance_counter_interrupt();
     void setup_ap_boot_environment();
     void boot_aps();
     void enable(u32 cpu);
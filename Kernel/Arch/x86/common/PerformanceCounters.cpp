@@ -0,0 +1,161 @@
+/*
+ * Copyright (c) 2022, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <AK/Array.h>
+#include <AK/Atomic.h>
+#include <Kernel/API/POSIX/serenity.h>
+#include <Kernel/Arch/PerformanceCounters.h>
+#include <Kernel/Arch/Processor.h>
+#include <Kernel/Arch/RegisterState.h>
+#include <Kernel/Arch/x86/CPUID.h>
+#include <Kernel/Arch/x86/MSR.h>
+#include <Kernel/PerformanceManager.h>
+
+#define IA32_PMC0 0xc1
+#define IA32_PERFEVTSEL0 0x186
+#define IA32_PERF_GLOBAL_STATUS 0x38e
+#define IA32_PERF_GLOBAL_CTRL 0x38f
+#define IA32_PERF_GLOBAL_OVF_CTRL 0x390
+
+#define PERFEVTSEL_USR (1 << 16)
+#define PERFEVTSEL_OS (1 << 17)
+#define PERFEVTSEL_INT (1 << 20)
+#define PERFEVTSEL_EN (1 << 22)
+
+namespace Kernel {
+
+// FIXME: These are the architectural events of Intel CPUs, AMD CPUs have their own counters.
+struct HardwareEvent {
+    u64 type;
+    u8 event_select;
+    u8 unit_mask;
+    // The bit in CPUID.0AH:EBX that says the event is *not* available.
+    u8 unavailable_bit;
+    // Take a sample every this many events.
+    u32 period;
+};
+
+// Each event always uses the general-purpose counter with the same index.
+static constexpr HardwareEvent s_hardware_events[] = {
+    { PERF_EVENT_CPU_CYCLES, 0x3c, 0x00, 0, 1'000'000 },
+    { PERF_EVENT_INSTRUCTIONS, 0xc0, 0x00, 1, 1'000'000 },
+    { PERF_EVENT_CACHE_MISSES, 0x2e, 0x41, 4, 10'000 },
+    { PERF_EVENT_BRANCH_MISSES, 0xc5, 0x00, 6, 10'000 },
+};
+
+static constexpr size_t hardware_event_count = sizeof(s_hardware_events) / sizeof(s_hardware_events[0]);
+
+static Atomic<u32> s_enable_count;
+static Atomic<u64> s_supported_events;
+static size_t s_counter_count;
+// Only ever touched by the CPU itself.
+static Array<u64, MAX_CPU_COUNT> s_programmed_events;
+
+static u64 detect_supported_events()
+{
+    if (CPUID(0).eax() < 0xa)
+        return 0;
+    CPUID perfmon(0xa);
+    u8 version = perfmon.eax() & 0xff;
+    u8 counter_count = (perfmon.eax() >> 8) & 0xff;
+    u8 availability_bit_count = (perfmon.eax() >> 24) & 0xff;
+    // We need IA32_PERF_GLOBAL_CTRL and friends, which came with version 2.
+    if (version < 2)
+        return 0;
+
+    s_counter_count = min(static_cast<size_t>(counter_count), hardware_event_count);
+    u64 supported_events = 0;
+    for (size_t i = 0; i < s_counter_count; ++i) {
+        auto const& event = s_hardware_events[i];
+        if (event.unavailable_bit >= availability_bit_count || (perfmon.ebx() & (1 << event.unavailable_bit)))
+            continue;
+        supported_events |= event.type;
+    }
+    return supported_events;
+}
+
+static void reload_counter(size_t index)
+{
+    // Writes to IA32_PMCx are sign-extended from 32 bits, so this overflows after `period` more events.
+    MSR counter(IA32_PMC0 + index);
+    counter.set(static_cast<u32>(-static_cast<i32>(s_hardware_events[index].period)));
+}
+
+static void program_counters(u64 events)
+{
+    MSR global_control(IA32_PERF_GLOBAL_CTRL);
+    global_control.set(0);
+
+    u64 enabled_counters = 0;
+    for (size_t i = 0; i < s_counter_count; ++i) {
+        auto const& event = s_hardware_events[i];
+        MSR event_select(IA32_PERFEVTSEL0 + i);
+        if (!(events & event.type)) {
+            event_select.set(0);
+            continue;
+        }
+        reload_counter(i);
+        event_select.set(event.event_select | (event.unit_mask << 8) | PERFEVTSEL_USR | PERFEVTSEL_OS | PERFEVTSEL_INT | PERFEVTSEL_EN);
+        enabled_counters |= 1 << i;
+    }
+
+    MSR overflow_control(IA32_PERF_GLOBAL_OVF_CTRL);
+    overflow_control.set((1 << s_counter_count) - 1);
+    global_control.set(enabled_counters);
+}
+
+ErrorOr<void> PerformanceCounters::enable(u64 event_mask)
+{
+    auto requested_events = event_mask & PERF_EVENT_HARDWARE_COUNTERS;
+    if (requested_events) {
+        if (!s_supported_events.load())
+            s_supported_events.store(detect_supported_events());
+        if ((requested_events & s_supported_events.load()) != requested_events)
+            return ENOTSUP;
+    }
+    s_enable_count.fetch_add(1);
+    return {};
+}
+
+void PerformanceCounters::disable()
+{
+    auto previous_count = s_enable_count.fetch_sub(1);
+    VERIFY(previous_count > 0);
+}
+
+void PerformanceCounters::timer_tick()
+{
+    u64 wanted_events = 0;
+    if (s_enable_count.load(AK::MemoryOrder::memory_order_relaxed))
+        wanted_events = g_profiling_event_mask & s_supported_events.load(AK::MemoryOrder::memory_order_relaxed);
+
+    auto& programmed_events = s_programmed_events[Processor::current_id()];
+    if (wanted_events == programmed_events)
+        return;
+    program_counters(wanted_events);
+    programmed_events = wanted_events;
+}
+
+void PerformanceCounters::handle_overflow(RegisterState const& regs)
+{
+    MSR global_status(IA32_PERF_GLOBAL_STATUS);
+    auto overflowed_counters = global_status.get();
+
+    auto* current_thread = Thread::current();
+    bool should_sample = current_thread && !current_thread->is_idle_thread();
+    for (size_t i = 0; i < s_counter_count; ++i) {
+        if (!(overflowed_counters & (1 << i)))
+            continue;
+        reload_counter(i);
+        if (should_sample)
+            PerformanceManager::add_hardware_counter_event(*current_thread, regs, s_hardware_events[i].type, s_hardware_events[i].period);
+    }
+
+    MSR overflow_control(IA32_PERF_GLOBAL_OVF_CTRL);
+    overflow_control.set(overflowed_counters);
+}
+
+}
@@ -26,6 +26,7 @@
 #include <Kernel/Devices/NullDevice.h>
 #include <Kernel/Devices/PCISerialDevice.h>
 #include <Kernel/Devices/RandomDevice.h>
+#include <Kernel/Devices/SamplingDevice.h>
 #include <Kernel/Devices/SelfTTYDevice.h>
 #include <Kernel/Devices/SerialDevice.h>
 #include <Kernel/Devices/ZeroDevice.h>
@@ -354,6 +355,7 @@ void init_stage2(void*)
     (void)ZeroDevice::must_create().leak_ref();
     (void)FullDevice::must_create().leak_ref();
     (void)RandomDevice::must_create().leak_ref();
+    (void)SamplingDevice::must_create().leak_ref();
     (void)SelfTTYDevice::must_create().leak_ref();
     PTYMultiplexer::initialize();
 
@@ -391,7 +393,8 @@ void init_stage2(void*)
     if (boot_profiling) {
         dbgln("Starting full system boot profiling");
         MutexLocker mutex_locker(Process::current().big_lock());
-        auto const enable_all = ~(u64)0;
+        // The hardware counters are opt-in, not every CPU has them.
+        auto const enable_all = ~(u64)0 & ~(u64)PERF_EVENT_HARDWARE_COUNTERS;
         auto result = Process::current().profiling_enable(-1, enable_all);
         VERIFY(!result.is_error());
     }
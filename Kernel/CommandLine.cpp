@@ -307,6 +307,18 @@ NonnullOwnPtrVector<KString> CommandLine::userspace_init_args() const
     return args;
 }
 
+Optional<size_t> CommandLine::network_receive_workers() const
+{
+    auto const value = lookup("network_receive_workers"sv).value_or("0"sv);
+    // An empty result means one worker for each processor.
+    if (value == "auto"sv)
+        return {};
+    auto worker_count = value.to_uint();
+    if (worker_count.has_value())
+        return worker_count.value();
+    PANIC("Unknown network_receive_workers value: {}", value);
+}
+
 UNMAP_AFTER_INIT size_t CommandLine::switch_to_tty() const
 {
     auto const default_tty = lookup("switch_to_tty"sv).value_or("1"sv);
@@ -93,6 +93,7 @@ public:
     [[nodiscard]] NonnullOwnPtrVector<KString> userspace_init_args() const;
     [[nodiscard]] StringView root_device() const;
     [[nodiscard]] bool is_nvme_polling_enabled() const;
+    [[nodiscard]] Optional<size_t> network_receive_workers() const;
     [[nodiscard]] size_t switch_to_tty() const;
 
 private:
@@ -0,0 +1,207 @@
+/*
+ * Copyright (c) 2022, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <AK/BuiltinWrappers.h>
+#include <Kernel/API/SampleRing.h>
+#include <Kernel/Devices/DeviceManagement.h>
+#include <Kernel/Devices/SamplingDevice.h>
+#include <Kernel/FileSystem/OpenFileDescription.h>
+#include <Kernel/Memory/MemoryManager.h>
+#include <Kernel/PerformanceEventBuffer.h>
+#include <Kernel/Sections.h>
+#include <Kernel/Time/TimeManagement.h>
+#include <LibC/sys/ioctl_numbers.h>
+
+namespace Kernel {
+
+static SamplingDevice* s_the;
+
+UNMAP_AFTER_INIT NonnullLockRefPtr<SamplingDevice> SamplingDevice::must_create()
+{
+    auto sampling_device_or_error = DeviceManagement::try_create_device<SamplingDevice>();
+    // FIXME: Find a way to propagate errors
+    VERIFY(!sampling_device_or_error.is_error());
+    return sampling_device_or_error.release_value();
+}
+
+UNMAP_AFTER_INIT SamplingDevice::SamplingDevice()
+    : CharacterDevice(1, 10)
+{
+    VERIFY(!s_the);
+    s_the = this;
+}
+
+SamplingDevice::~SamplingDevice() = default;
+
+void SamplingDevice::timer_tick(RegisterState const& regs)
+{
+    if (!s_the || !s_the->m_enabled.load(AK::MemoryOrder::memory_order_relaxed))
+        return;
+    auto* current_thread = Thread::current();
+    if (!current_thread || current_thread->is_idle_thread() || current_thread->is_profiling_suppressed())
+        return;
+    s_the->m_rings[Processor::current_id()].add_sample(*current_thread, regs);
+}
+
+void SamplingDevice::Ring::add_sample(Thread& thread, RegisterState const& regs)
+{
+    // Walking the user stack may fault, so don't do it with the lock held.
+    auto backtrace = PerformanceEventBuffer::raw_backtrace(regs.bp(), regs.ip());
+    size_t kernel_frame_count = 0;
+    while (kernel_frame_count < backtrace.size() && !Memory::is_user_address(VirtualAddress { backtrace[kernel_frame_count] }))
+        ++kernel_frame_count;
+    size_t record_size = align_up_to(sizeof(SampleRecord) + backtrace.size() * sizeof(FlatPtr), 8);
+
+    SpinlockLocker locker(lock);
+    if (!region)
+        return;
+    auto* header = reinterpret_cast<SampleRingHeader*>(region->vaddr().as_ptr());
+    auto* data = region->vaddr().offset(sample_ring_header_size).as_ptr();
+    size_t data_size = region->size() - sample_ring_header_size;
+
+    size_t offset = write_position & (data_size - 1);
+    size_t padding = data_size - offset < record_size ? data_size - offset : 0;
+    // A reader that lies about its position only gets garbage back, nothing we write depends on it.
+    auto read_position = AK::atomic_load(&header->read_position, AK::MemoryOrder::memory_order_acquire);
+    if (write_position + padding + record_size - read_position > data_size) {
+        AK::atomic_store(&header->lost_samples, ++lost_samples, AK::MemoryOrder::memory_order_relaxed);
+        return;
+    }
+
+    if (padding) {
+        auto& padding_record = *reinterpret_cast<SampleRecord*>(data + offset);
+        padding_record.size = padding;
+        padding_record.type = SampleRecordType::Padding;
+        write_position += padding;
+        offset = 0;
+    }
+
+    auto& record = *reinterpret_cast<SampleRecord*>(data + offset);
+    record.size = record_size;
+    record.type = SampleRecordType::Sample;
+    record.pid = thread.pid().value();
+    record.tid = thread.tid().value();
+    record.timestamp_ns = TimeManagement::the().monotonic_time().to_nanoseconds();
+    record.kernel_frame_count = kernel_frame_count;
+    record.user_frame_count = backtrace.size() - kernel_frame_count;
+    record.reserved = 0;
+    memcpy(record.frames(), backtrace.data(), backtrace.size() * sizeof(FlatPtr));
+
+    write_position += record_size;
+    AK::atomic_store(&header->write_position, write_position, AK::MemoryOrder::memory_order_release);
+}
+
+ErrorOr<void> SamplingDevice::enable(OpenFileDescription& description, size_t data_size)
+{
+    if (!data_size)
+        data_size = default_data_size;
+    data_size = clamp(data_size, minimum_data_size, maximum_data_size);
+    if (!is_power_of_two(data_size))
+        data_size = static_cast<size_t>(1) << (sizeof(size_t) * 8 - count_leading_zeroes(data_size));
+
+    MutexLocker locker(m_lock);
+    if (m_owner)
+        return EBUSY;
+
+    // Allocate everything up front, so we don't have to undo anything if we run out of memory.
+    Vector<NonnullLockRefPtr<Memory::AnonymousVMObject>> vmobjects;
+    Vector<NonnullOwnPtr<Memory::Region>> regions;
+    for (u32 cpu = 0; cpu < Processor::count(); ++cpu) {
+        auto vmobject = TRY(Memory::AnonymousVMObject::try_create_with_size(sample_ring_size(data_size), AllocationStrategy::AllocateNow));
+        auto region_name = TRY(KString::formatted("Sample ring #{}", cpu));
+        auto region = TRY(MM.allocate_kernel_region_with_vmobject(*vmobject, vmobject->size(), region_name->view(), Memory::Region::Access::ReadWrite));
+
+        auto& header = *reinterpret_cast<SampleRingHeader*>(region->vaddr().as_ptr());
+        header.data_offset = sample_ring_header_size;
+        header.data_size = data_size;
+        header.cpu = cpu;
+        header.samples_per_second = OPTIMAL_TICKS_PER_SECOND_RATE;
+
+        TRY(vmobjects.try_append(move(vmobject)));
+        TRY(regions.try_append(move(region)));
+    }
+
+    for (u32 cpu = 0; cpu < Processor::count(); ++cpu) {
+        auto& ring = m_rings[cpu];
+        SpinlockLocker ring_locker(ring.lock);
+        VERIFY(!ring.region);
+        ring.vmobject = vmobjects[cpu];
+        ring.region = move(regions[cpu]);
+        ring.write_position = 0;
+        ring.lost_samples = 0;
+    }
+
+    m_owner = &description;
+    m_data_size = data_size;
+    m_enabled.store(true);
+    return {};
+}
+
+ErrorOr<void> SamplingDevice::disable(OpenFileDescription& description)
+{
+    MutexLocker locker(m_lock);
+    if (m_owner != &description)
+        return EPERM;
+
+    m_enabled.store(false);
+    for (u32 cpu = 0; cpu < Processor::count(); ++cpu) {
+        auto& ring = m_rings[cpu];
+        LockRefPtr<Memory::AnonymousVMObject> vmobject;
+        OwnPtr<Memory::Region> region;
+        {
+            SpinlockLocker ring_locker(ring.lock);
+            vmobject = move(ring.vmobject);
+            region = move(ring.region);
+        }
+        // Any mappings of the reader keep the samples around until they go away.
+    }
+    m_owner = nullptr;
+    m_data_size = 0;
+    return {};
+}
+
+void SamplingDevice::detach(OpenFileDescription& description)
+{
+    (void)disable(description);
+    CharacterDevice::detach(description);
+}
+
+ErrorOr<void> SamplingDevice::ioctl(OpenFileDescription& description, unsigned request, Userspace<void*> arg)
+{
+    switch (request) {
+    case SAMPLING_IOCTL_ENABLE:
+        return enable(description, static_cast<size_t>(bit_cast<FlatPtr>(arg.unsafe_userspace_ptr())));
+    case SAMPLING_IOCTL_DISABLE:
+        return disable(description);
+    default:
+        return EINVAL;
+    }
+}
+
+ErrorOr<NonnullLockRefPtr<Memory::VMObject>> SamplingDevice::vmobject_for_mmap(Process&, Memory::VirtualRange const& range, u64& offset, bool shared)
+{
+    if (!shared)
+        return EINVAL;
+
+    MutexLocker locker(m_lock);
+    if (!m_owner)
+        return ENOBUFS;
+
+    auto ring_size = sample_ring_size(m_data_size);
+    if (offset % ring_size != 0 || range.size() > ring_size)
+        return EINVAL;
+    auto cpu = offset / ring_size;
+    if (cpu >= Processor::count())
+        return EINVAL;
+
+    auto& ring = m_rings[cpu];
+    SpinlockLocker ring_locker(ring.lock);
+    VERIFY(ring.vmobject);
+    offset = 0;
+    return *ring.vmobject;
+}
+
+}
@@ -0,0 +1,71 @@
+/*
+ * Copyright (c) 2022, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#pragma once
+
+#include <AK/Array.h>
+#include <AK/Atomic.h>
+#include <Kernel/Devices/CharacterDevice.h>
+#include <Kernel/Locking/Mutex.h>
+#include <Kernel/Locking/Spinlock.h>
+#include <Kernel/Memory/AnonymousVMObject.h>
+#include <Kernel/Memory/Region.h>
+
+namespace Kernel {
+
+// Streams a stack sample of whatever each CPU is running on every timer tick into a ring of
+// that CPU, which the process that enabled sampling maps and drains while it keeps running.
+// Unlike profile(2) this never stops and nothing has to be serialized, see Kernel/API/SampleRing.h.
+class SamplingDevice final : public CharacterDevice {
+    friend class DeviceManagement;
+
+public:
+    static constexpr size_t default_data_size = 256 * KiB;
+    static constexpr size_t minimum_data_size = 16 * KiB;
+    static constexpr size_t maximum_data_size = 16 * MiB;
+
+    static NonnullLockRefPtr<SamplingDevice> must_create();
+    virtual ~SamplingDevice() override;
+
+    // Called on every CPU from its own timer interrupt.
+    static void timer_tick(RegisterState const&);
+
+    // ^File
+    virtual ErrorOr<NonnullLockRefPtr<Memory::VMObject>> vmobject_for_mmap(Process&, Memory::VirtualRange const&, u64& offset, bool shared) override;
+    virtual void detach(OpenFileDescription&) override;
+
+private:
+    SamplingDevice();
+
+    struct Ring {
+        Spinlock lock { LockRank::None };
+        LockRefPtr<Memory::AnonymousVMObject> vmobject;
+        OwnPtr<Memory::Region> region;
+        // The copies in the header are shared with the reader, so they can't be trusted.
+        u64 write_position { 0 };
+        u64 lost_samples { 0 };
+
+        void add_sample(Thread&, RegisterState const&);
+    };
+
+    ErrorOr<void> enable(OpenFileDescription&, size_t data_size);
+    ErrorOr<void> disable(OpenFileDescription&);
+
+    virtual StringView class_name() const override { return "SamplingDevice"sv; }
+    virtual bool can_read(OpenFileDescription const&, u64) const override { return true; }
+    virtual bool can_write(OpenFileDescription const&, u64) const override { return false; }
+    virtual ErrorOr<size_t> read(OpenFileDescription&, u64, UserOrKernelBuffer&, size_t) override { return EINVAL; }
+    virtual ErrorOr<size_t> write(OpenFileDescription&, u64, UserOrKernelBuffer const&, size_t) override { return EINVAL; }
+    virtual ErrorOr<void> ioctl(OpenFileDescription&, unsigned request, Userspace<void*> arg) override;
+
+    Mutex m_lock { "SamplingDevice"sv };
+    OpenFileDescription const* m_owner { nullptr };
+    size_t m_data_size { 0 };
+    Atomic<bool> m_enabled { false };
+    Array<Ring, MAX_CPU_COUNT> m_rings;
+};
+
+}
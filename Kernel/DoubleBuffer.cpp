@@ -36,6 +36,35 @@ DoubleBuffer::DoubleBuffer(size_t capacity, NonnullOwnPtr<KBuffer> storage)
     m_space_for_writing = capacity;
 }
 
+ErrorOr<void> DoubleBuffer::try_grow(StringView name, size_t new_capacity)
+{
+    VERIFY(new_capacity >= m_capacity * 2);
+    auto storage = TRY(KBuffer::try_create_with_size(name, new_capacity * 2, Memory::Region::Access::ReadWrite));
+
+    MutexLocker locker(m_lock);
+    // Everything that hasn't been read yet fits into the new read buffer, since both
+    // of the old buffers together hold at most twice the old capacity.
+    size_t unread_in_read_buffer = m_read_buffer->size - m_read_buffer_index;
+    u8* new_data = storage->data();
+    memcpy(new_data, m_read_buffer->data + m_read_buffer_index, unread_in_read_buffer);
+    memcpy(new_data + unread_in_read_buffer, m_write_buffer->data, m_write_buffer->size);
+    size_t unread = unread_in_read_buffer + m_write_buffer->size;
+
+    m_storage = move(storage);
+    m_capacity = new_capacity;
+    m_read_buffer = &m_buffer1;
+    m_write_buffer = &m_buffer2;
+    m_buffer1.data = new_data;
+    m_buffer1.size = unread;
+    m_buffer2.data = new_data + new_capacity;
+    m_buffer2.size = 0;
+    m_read_buffer_index = 0;
+    compute_lockfree_metadata();
+    if (m_unblock_callback && m_space_for_writing > 0)
+        m_unblock_callback();
+    return {};
+}
+
 void DoubleBuffer::flip()
 {
     VERIFY(m_read_buffer_index == m_read_buffer->size);
@@ -18,6 +18,8 @@ class DoubleBuffer {
 public:
     static ErrorOr<NonnullOwnPtr<DoubleBuffer>> try_create(StringView name, size_t capacity = 65536);
     ErrorOr<size_t> write(UserOrKernelBuffer const&, size_t);
+    // Moves the contents into new storage that holds at least twice as much.
+    ErrorOr<void> try_grow(StringView name, size_t new_capacity);
     ErrorOr<size_t> write(u8 const* data, size_t size)
     {
         return write(UserOrKernelBuffer::for_kernel_buffer(const_cast<u8*>(data)), size);
@@ -37,6 +39,7 @@ public:
 
     bool is_empty() const { return m_empty; }
 
+    size_t capacity() const { return m_capacity; }
     size_t space_for_writing() const { return m_space_for_writing; }
     size_t immediately_readable() const
     {
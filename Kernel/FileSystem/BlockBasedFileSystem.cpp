@@ -4,106 +4,225 @@
  * SPDX-License-Identifier: BSD-2-Clause
  */
 
+#include <AK/Array.h>
 #include <AK/IntrusiveList.h>
 #include <Kernel/Debug.h>
 #include <Kernel/FileSystem/BlockBasedFileSystem.h>
+#include <Kernel/Memory/MemoryManager.h>
 #include <Kernel/Process.h>
 
 namespace Kernel {
 
 struct CacheEntry {
-    IntrusiveListNode<CacheEntry> list_node;
+    IntrusiveListNode<CacheEntry> dirty_list_node;
     BlockBasedFileSystem::BlockIndex block_index { 0 };
     u8* data { nullptr };
     bool has_data { false };
+    bool is_in_use { false };
+    // Bumped by cache hits and decayed by the clock hand, see DiskCache::Shard::find_victim().
+    Atomic<u8, AK::MemoryOrder::memory_order_relaxed> usage_count { 0 };
 };
 
+// The block cache is split into shards by block index, each with its own lock.
+// Cache hits only take their shard's lock in shared mode, so parallel readers
+// don't serialize on each other.
+//
+// Eviction uses a generalized CLOCK: every hit bumps a small saturating usage
+// count, and the clock hand decays it while looking for a victim. Blocks are
+// inserted with a count of zero, so a large sequential scan only ever evicts
+// other blocks that were touched once, instead of the hot working set.
 class DiskCache {
 public:
-    static constexpr size_t EntryCount = 10000;
-    explicit DiskCache(BlockBasedFileSystem& fs, NonnullOwnPtr<KBuffer> cached_block_data, NonnullOwnPtr<KBuffer> entries_buffer)
-        : m_fs(fs)
-        , m_cached_block_data(move(cached_block_data))
-        , m_entries(move(entries_buffer))
-    {
-        for (size_t i = 0; i < EntryCount; ++i) {
-            entries()[i].data = m_cached_block_data->data() + i * m_fs->block_size();
-            m_clean_list.append(entries()[i]);
+    static constexpr size_t ShardCount = 16;
+    static constexpr size_t MinimumEntriesPerShard = 64;
+    static constexpr u8 MaximumUsageCount = 3;
+
+    // Each cache gets a slice of the physical memory that is still available when the file system is mounted.
+    static constexpr size_t AvailableMemoryFraction = 64;
+    static constexpr size_t MaximumCacheSize = 64 * MiB;
+
+    class Shard {
+    public:
+        CacheEntry* get(BlockBasedFileSystem::BlockIndex block_index) const
+        {
+            auto it = m_hash.find(block_index);
+            if (it == m_hash.end())
+                return nullptr;
+            auto& entry = *it->value;
+            VERIFY(entry.block_index == block_index);
+            return &entry;
         }
-    }
 
-    ~DiskCache() = default;
+        bool is_dirty() const { return !m_dirty_list.is_empty(); }
+        bool entry_is_dirty(CacheEntry const& entry) const { return entry.dirty_list_node.is_in_list(); }
+
+        void mark_dirty(CacheEntry& entry)
+        {
+            if (!entry_is_dirty(entry))
+                m_dirty_list.append(entry);
+        }
+
+        void mark_clean(CacheEntry& entry)
+        {
+            if (entry_is_dirty(entry))
+                m_dirty_list.remove(entry);
+        }
 
-    bool is_dirty() const { return !m_dirty_list.is_empty(); }
-    bool entry_is_dirty(CacheEntry const& entry) const { return m_dirty_list.contains(entry); }
+        void mark_all_clean()
+        {
+            m_dirty_list.clear();
+        }
 
-    void mark_all_clean()
+        template<typename Callback>
+        void for_each_dirty_entry(Callback callback)
+        {
+            for (auto& entry : m_dirty_list)
+                callback(entry);
+        }
+
+        Mutex& lock() const { return m_lock; }
+
+    private:
+        friend class DiskCache;
+
+        CacheEntry* find_victim()
+        {
+            // Every full sweep decays the usage counts by one, so after MaximumUsageCount + 1
+            // sweeps the only reason for not having found a victim is that everything is dirty.
+            for (size_t step = 0; step < (MaximumUsageCount + 1) * m_entries.size(); ++step) {
+                auto& entry = m_entries[m_clock_hand];
+                m_clock_hand = (m_clock_hand + 1) % m_entries.size();
+                if (entry_is_dirty(entry))
+                    continue;
+                if (auto usage_count = entry.usage_count.load(); usage_count > 0) {
+                    entry.usage_count = usage_count - 1;
+                    continue;
+                }
+                return &entry;
+            }
+            return nullptr;
+        }
+
+        mutable Mutex m_lock { "DiskCacheShard"sv };
+        HashMap<BlockBasedFileSystem::BlockIndex, CacheEntry*> m_hash;
+        IntrusiveList<&CacheEntry::dirty_list_node> m_dirty_list;
+        Span<CacheEntry> m_entries;
+        size_t m_clock_hand { 0 };
+    };
+
+    static size_t entry_count_for_block_size(size_t block_size)
     {
-        while (auto* entry = m_dirty_list.first())
-            m_clean_list.prepend(*entry);
+        auto available_memory = MM.get_system_memory_info().physical_pages_uncommitted * PAGE_SIZE;
+        auto cache_size = min(available_memory / AvailableMemoryFraction, static_cast<u64>(MaximumCacheSize));
+        auto entries_per_shard = max(cache_size / block_size / ShardCount, MinimumEntriesPerShard);
+        return entries_per_shard * ShardCount;
     }
 
-    void mark_dirty(CacheEntry& entry)
+    explicit DiskCache(BlockBasedFileSystem& fs, size_t entry_count, NonnullOwnPtr<KBuffer> cached_block_data, NonnullOwnPtr<KBuffer> entries_buffer)
+        : m_fs(fs)
+        , m_cached_block_data(move(cached_block_data))
+        , m_entries(move(entries_buffer))
     {
-        m_dirty_list.prepend(entry);
+        VERIFY(entry_count % ShardCount == 0);
+        for (size_t i = 0; i < entry_count; ++i) {
+            auto* entry = new (&entries()[i]) CacheEntry;
+            entry->data = m_cached_block_data->data() + i * m_fs->block_size();
+        }
+        auto entries_per_shard = entry_count / ShardCount;
+        for (size_t i = 0; i < ShardCount; ++i)
+            m_shards[i].m_entries = { &entries()[i * entries_per_shard], entries_per_shard };
     }
 
-    void mark_clean(CacheEntry& entry)
+    ~DiskCache() = default;
+
+    Shard& shard_for(BlockBasedFileSystem::BlockIndex block_index) const
     {
-        m_clean_list.prepend(entry);
+        return m_shards[u64_hash(block_index.value()) % ShardCount];
     }
 
-    CacheEntry* get(BlockBasedFileSystem::BlockIndex block_index) const
+    template<typename Callback>
+    void for_each_shard(Callback callback) const
     {
-        auto it = m_hash.find(block_index);
-        if (it == m_hash.end())
-            return nullptr;
-        auto& entry = const_cast<CacheEntry&>(*it->value);
-        VERIFY(entry.block_index == block_index);
-        return &entry;
+        for (auto& shard : m_shards)
+            callback(shard);
     }
 
-    ErrorOr<CacheEntry*> ensure(BlockBasedFileSystem::BlockIndex block_index) const
+    // NOTE: The shard must be locked exclusively.
+    ErrorOr<CacheEntry*> ensure(Shard& shard, BlockBasedFileSystem::BlockIndex block_index) const
     {
-        if (auto* entry = get(block_index))
+        VERIFY(shard.m_lock.is_exclusively_locked_by_current_thread());
+        if (auto* entry = shard.get(block_index))
             return entry;
 
-        if (m_clean_list.is_empty()) {
-            // Not a single clean entry! Flush writes and try again.
-            // NOTE: We want to make sure we only call FileBackedFileSystem flush here,
-            //       not some FileBackedFileSystem subclass flush!
-            m_fs->flush_writes_impl();
-            return ensure(block_index);
+        auto* new_entry = shard.find_victim();
+        if (!new_entry) {
+            // Not a single clean entry! Flush this shard's writes and try again.
+            flush_while_locked(shard);
+            new_entry = shard.find_victim();
+            VERIFY(new_entry);
         }
 
-        VERIFY(m_clean_list.last());
-        auto& new_entry = *m_clean_list.last();
-        m_clean_list.prepend(new_entry);
+        if (new_entry->is_in_use)
+            shard.m_hash.remove(new_entry->block_index);
+        new_entry->is_in_use = false;
+        TRY(shard.m_hash.try_set(block_index, new_entry));
 
-        m_hash.remove(new_entry.block_index);
-        TRY(m_hash.try_set(block_index, &new_entry));
+        new_entry->block_index = block_index;
+        new_entry->has_data = false;
+        new_entry->is_in_use = true;
+        new_entry->usage_count = 0;
 
-        new_entry.block_index = block_index;
-        new_entry.has_data = false;
+        return new_entry;
+    }
 
-        return &new_entry;
+    // NOTE: The shard must be locked exclusively.
+    ErrorOr<void> fill_while_locked(Shard& shard, CacheEntry& entry) const
+    {
+        VERIFY(shard.m_lock.is_exclusively_locked_by_current_thread());
+        VERIFY(entry.is_in_use);
+        if (entry.has_data)
+            return {};
+        auto base_offset = entry.block_index.value() * m_fs->block_size();
+        auto entry_data_buffer = UserOrKernelBuffer::for_kernel_buffer(entry.data);
+        auto nread = TRY(m_fs->file_description().read(entry_data_buffer, base_offset, m_fs->block_size()));
+        VERIFY(nread == m_fs->block_size());
+        entry.has_data = true;
+        return {};
     }
 
-    CacheEntry const* entries() const { return (CacheEntry const*)m_entries->data(); }
-    CacheEntry* entries() { return (CacheEntry*)m_entries->data(); }
+    // NOTE: The shard must be locked exclusively.
+    void flush_entry_while_locked(Shard& shard, CacheEntry& entry) const
+    {
+        VERIFY(shard.m_lock.is_exclusively_locked_by_current_thread());
+        if (!shard.entry_is_dirty(entry))
+            return;
+        auto base_offset = entry.block_index.value() * m_fs->block_size();
+        auto entry_data_buffer = UserOrKernelBuffer::for_kernel_buffer(entry.data);
+        (void)m_fs->file_description().write(base_offset, entry_data_buffer, m_fs->block_size());
+        shard.mark_clean(entry);
+    }
 
-    template<typename Callback>
-    void for_each_dirty_entry(Callback callback)
+    // NOTE: The shard must be locked exclusively.
+    size_t flush_while_locked(Shard& shard) const
     {
-        for (auto& entry : m_dirty_list)
-            callback(entry);
+        VERIFY(shard.m_lock.is_exclusively_locked_by_current_thread());
+        size_t count = 0;
+        shard.for_each_dirty_entry([&](CacheEntry& entry) {
+            auto base_offset = entry.block_index.value() * m_fs->block_size();
+            auto entry_data_buffer = UserOrKernelBuffer::for_kernel_buffer(entry.data);
+            [[maybe_unused]] auto rc = m_fs->file_description().write(base_offset, entry_data_buffer, m_fs->block_size());
+            ++count;
+        });
+        shard.mark_all_clean();
+        return count;
     }
 
+    CacheEntry const* entries() const { return (CacheEntry const*)m_entries->data(); }
+    CacheEntry* entries() { return (CacheEntry*)m_entries->data(); }
+
 private:
     mutable NonnullRefPtr<BlockBasedFileSystem> m_fs;
-    mutable IntrusiveList<&CacheEntry::list_node> m_dirty_list;
-    mutable IntrusiveList<&CacheEntry::list_node> m_clean_list;
-    mutable HashMap<BlockBasedFileSystem::BlockIndex, CacheEntry*> m_hash;
+    mutable Array<Shard, ShardCount> m_shards;
     NonnullOwnPtr<KBuffer> m_cached_block_data;
     NonnullOwnPtr<KBuffer> m_entries;
 };
@@ -129,9 +248,11 @@ ErrorOr<void> BlockBasedFileSystem::initialize_while_locked()
     VERIFY(m_lock.is_locked());
     VERIFY(!is_initialized_while_locked());
     VERIFY(block_size() != 0);
-    auto cached_block_data = TRY(KBuffer::try_create_with_size("BlockBasedFS: Cache blocks"sv, DiskCache::EntryCount * block_size()));
-    auto entries_data = TRY(KBuffer::try_create_with_size("BlockBasedFS: Cache entries"sv, DiskCache::EntryCount * sizeof(CacheEntry)));
-    auto disk_cache = TRY(adopt_nonnull_own_or_enomem(new (nothrow) DiskCache(*this, move(cached_block_data), move(entries_data))));
+    auto entry_count = DiskCache::entry_count_for_block_size(block_size());
+    auto cached_block_data = TRY(KBuffer::try_create_with_size("BlockBasedFS: Cache blocks"sv, entry_count * block_size()));
+    auto entries_data = TRY(KBuffer::try_create_with_size("BlockBasedFS: Cache entries"sv, entry_count * sizeof(CacheEntry)));
+    auto disk_cache = TRY(adopt_nonnull_own_or_enomem(new (nothrow) DiskCache(*this, entry_count, move(cached_block_data), move(entries_data))));
+    dbgln_if(BBFS_DEBUG, "BlockBasedFileSystem: Caching up to {} blocks of {} bytes", entry_count, block_size());
 
     m_cache.with_exclusive([&](auto& cache) {
         cache = move(disk_cache);
@@ -152,23 +273,31 @@ ErrorOr<void> BlockBasedFileSystem::write_block(BlockIndex index, UserOrKernelBu
 
     TRY(data.read(buffered_data.bytes()));
 
-    return m_cache.with_exclusive([&](auto& cache) -> ErrorOr<void> {
+    return m_cache.with_shared([&](auto& cache) -> ErrorOr<void> {
+        auto& shard = cache->shard_for(index);
+        MutexLocker locker(shard.lock());
+
         if (!allow_cache) {
-            flush_specific_block_if_needed(index);
+            if (auto* entry = shard.get(index)) {
+                // Write back what we have first, so the cached block can't later clobber this write.
+                // It is stale afterwards, so have the next access read it from disk again.
+                cache->flush_entry_while_locked(shard, *entry);
+                entry->has_data = false;
+            }
             u64 base_offset = index.value() * block_size() + offset;
             auto nwritten = TRY(file_description().write(base_offset, data, count));
             VERIFY(nwritten == count);
             return {};
         }
 
-        auto entry = TRY(cache->ensure(index));
+        auto entry = TRY(cache->ensure(shard, index));
         if (count < block_size()) {
             // Fill the cache first.
-            TRY(read_block(index, nullptr, block_size()));
+            TRY(cache->fill_while_locked(shard, *entry));
         }
         memcpy(entry->data + offset, buffered_data.data(), count);
 
-        cache->mark_dirty(*entry);
+        shard.mark_dirty(*entry);
         entry->has_data = true;
         return {};
     });
@@ -214,6 +343,33 @@ ErrorOr<void> BlockBasedFileSystem::write_blocks(BlockIndex index, unsigned coun
 {
     VERIFY(m_logical_block_size);
     dbgln_if(BBFS_DEBUG, "BlockBasedFileSystem::write_blocks {}, count={}", index, count);
+    if (!allow_cache && count > 1) {
+        // Write back and invalidate any cached copies first, so they can't clobber this
+        // write later on, then hand the whole range to the device in as few requests as possible.
+        m_cache.with_shared([&](auto& cache) {
+            for (unsigned i = 0; i < count; ++i) {
+                BlockIndex block_index { index.value() + i };
+                auto& shard = cache->shard_for(block_index);
+                MutexLocker locker(shard.lock());
+                if (auto* entry = shard.get(block_index)) {
+                    cache->flush_entry_while_locked(shard, *entry);
+                    entry->has_data = false;
+                }
+            }
+        });
+
+        u64 base_offset = index.value() * block_size();
+        size_t total_size = count * block_size();
+        size_t nwritten = 0;
+        while (nwritten < total_size) {
+            auto chunk_nwritten = TRY(file_description().write(base_offset + nwritten, data.offset(nwritten), total_size - nwritten));
+            if (chunk_nwritten == 0)
+                return EIO;
+            nwritten += chunk_nwritten;
+        }
+        return {};
+    }
+
     for (unsigned i = 0; i < count; ++i) {
         TRY(write_block(BlockIndex { index.value() + i }, data.offset(i * block_size()), block_size(), 0, allow_cache));
     }
@@ -226,23 +382,34 @@ ErrorOr<void> BlockBasedFileSystem::read_block(BlockIndex index, UserOrKernelBuf
     VERIFY(offset + count <= block_size());
     dbgln_if(BBFS_DEBUG, "BlockBasedFileSystem::read_block {}", index);
 
-    return m_cache.with_exclusive([&](auto& cache) -> ErrorOr<void> {
+    return m_cache.with_shared([&](auto& cache) -> ErrorOr<void> {
+        auto& shard = cache->shard_for(index);
+
         if (!allow_cache) {
-            const_cast<BlockBasedFileSystem*>(this)->flush_specific_block_if_needed(index);
+            MutexLocker locker(shard.lock());
+            if (auto* entry = shard.get(index))
+                cache->flush_entry_while_locked(shard, *entry);
             u64 base_offset = index.value() * block_size() + offset;
             auto nread = TRY(file_description().read(*buffer, base_offset, count));
             VERIFY(nread == count);
             return {};
         }
 
-        auto* entry = TRY(cache->ensure(index));
-        if (!entry->has_data) {
-            auto base_offset = index.value() * block_size();
-            auto entry_data_buffer = UserOrKernelBuffer::for_kernel_buffer(entry->data);
-            auto nread = TRY(file_description().read(entry_data_buffer, base_offset, block_size()));
-            VERIFY(nread == block_size());
-            entry->has_data = true;
+        {
+            // Fast path: Cache hits only need the shard for reading.
+            MutexLocker locker(shard.lock(), Mutex::Mode::Shared);
+            if (auto* entry = shard.get(index); entry && entry->has_data) {
+                if (auto usage_count = entry->usage_count.load(); usage_count < DiskCache::MaximumUsageCount)
+                    entry->usage_count = usage_count + 1;
+                if (buffer)
+                    TRY(buffer->write(entry->data + offset, count));
+                return {};
+            }
         }
+
+        MutexLocker locker(shard.lock());
+        auto* entry = TRY(cache->ensure(shard, index));
+        TRY(cache->fill_while_locked(shard, *entry));
         if (buffer)
             TRY(buffer->write(entry->data + offset, count));
         return {};
@@ -256,6 +423,33 @@ ErrorOr<void> BlockBasedFileSystem::read_blocks(BlockIndex index, unsigned count
         return EINVAL;
     if (count == 1)
         return read_block(index, &buffer, block_size(), 0, allow_cache);
+
+    if (!allow_cache) {
+        // Make sure the device has the latest version of each block, then read them
+        // with as few device requests as possible instead of one block at a time.
+        m_cache.with_shared([&](auto& cache) {
+            for (unsigned i = 0; i < count; ++i) {
+                BlockIndex block_index { index.value() + i };
+                auto& shard = cache->shard_for(block_index);
+                MutexLocker locker(shard.lock());
+                if (auto* entry = shard.get(block_index))
+                    cache->flush_entry_while_locked(shard, *entry);
+            }
+        });
+
+        u64 base_offset = index.value() * block_size();
+        size_t total_size = count * block_size();
+        size_t nread = 0;
+        while (nread < total_size) {
+            auto out = buffer.offset(nread);
+            auto chunk_nread = TRY(file_description().read(out, base_offset + nread, total_size - nread));
+            if (chunk_nread == 0)
+                return EIO;
+            nread += chunk_nread;
+        }
+        return {};
+    }
+
     auto out = buffer;
     for (unsigned i = 0; i < count; ++i) {
         TRY(read_block(BlockIndex { index.value() + i }, &out, block_size(), 0, allow_cache));
@@ -265,37 +459,18 @@ ErrorOr<void> BlockBasedFileSystem::read_blocks(BlockIndex index, unsigned count
     return {};
 }
 
-void BlockBasedFileSystem::flush_specific_block_if_needed(BlockIndex index)
-{
-    m_cache.with_exclusive([&](auto& cache) {
-        if (!cache->is_dirty())
-            return;
-        auto* entry = cache->get(index);
-        if (!entry)
-            return;
-        if (!cache->entry_is_dirty(*entry))
-            return;
-        size_t base_offset = entry->block_index.value() * block_size();
-        auto entry_data_buffer = UserOrKernelBuffer::for_kernel_buffer(entry->data);
-        (void)file_description().write(base_offset, entry_data_buffer, block_size());
-    });
-}
-
 void BlockBasedFileSystem::flush_writes_impl()
 {
     size_t count = 0;
-    m_cache.with_exclusive([&](auto& cache) {
-        if (!cache->is_dirty())
-            return;
-        cache->for_each_dirty_entry([&](CacheEntry& entry) {
-            auto base_offset = entry.block_index.value() * block_size();
-            auto entry_data_buffer = UserOrKernelBuffer::for_kernel_buffer(entry.data);
-            [[maybe_unused]] auto rc = file_description().write(base_offset, entry_data_buffer, block_size());
-            ++count;
+    m_cache.with_shared([&](auto& cache) {
+        cache->for_each_shard([&](auto& shard) {
+            MutexLocker locker(shard.lock());
+            if (shard.is_dirty())
+                count += cache->flush_while_locked(shard);
         });
-        cache->mark_all_clean();
-        dbgln("{}: Flushed {} blocks to disk", class_name(), count);
     });
+    if (count > 0)
+        dbgln("{}: Flushed {} blocks to disk", class_name(), count);
 }
 
 void BlockBasedFileSystem::flush_writes()
@@ -45,7 +45,6 @@ protected:
 
 private:
     DiskCache& cache() const;
-    void flush_specific_block_if_needed(BlockIndex index);
 
     mutable MutexProtected<OwnPtr<DiskCache>> m_cache;
 };
@@ -0,0 +1,309 @@
+/*
+ * Copyright (c) 2022, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <Kernel/API/POSIX/errno.h>
+#include <Kernel/FileSystem/EventPoll.h>
+#include <Kernel/FileSystem/OpenFileDescription.h>
+#include <Kernel/Process.h>
+
+namespace Kernel {
+
+using BlockFlags = Thread::FileBlocker::BlockFlags;
+
+static constexpr u32 supported_epoll_events = EPOLLIN | EPOLLPRI | EPOLLOUT | EPOLLWRBAND | EPOLLRDHUP | EPOLLONESHOT | EPOLLET;
+
+static BlockFlags block_flags_for_epoll_events(u32 events)
+{
+    BlockFlags block_flags = BlockFlags::WriteError | BlockFlags::WriteHangUp; // always want EPOLLERR and EPOLLHUP
+    if (events & EPOLLIN)
+        block_flags |= BlockFlags::Read;
+    if (events & EPOLLOUT)
+        block_flags |= BlockFlags::Write;
+    if (events & EPOLLPRI)
+        block_flags |= BlockFlags::ReadPriority;
+    if (events & EPOLLWRBAND)
+        block_flags |= BlockFlags::WritePriority;
+    if (events & EPOLLRDHUP)
+        block_flags |= BlockFlags::ReadHangUp;
+    return block_flags;
+}
+
+static u32 epoll_events_for_unblock_flags(BlockFlags unblock_flags)
+{
+    u32 events = 0;
+    if (has_flag(unblock_flags, BlockFlags::WriteHangUp))
+        events |= EPOLLHUP;
+    if (has_flag(unblock_flags, BlockFlags::WriteError))
+        events |= EPOLLERR;
+    if (has_flag(unblock_flags, BlockFlags::Read))
+        events |= EPOLLIN;
+    if (has_flag(unblock_flags, BlockFlags::ReadPriority))
+        events |= EPOLLPRI;
+    if (!has_flag(unblock_flags, BlockFlags::WriteHangUp) && has_flag(unblock_flags, BlockFlags::Write))
+        events |= EPOLLOUT;
+    if (has_flag(unblock_flags, BlockFlags::WritePriority))
+        events |= EPOLLWRBAND;
+    if (has_flag(unblock_flags, BlockFlags::ReadHangUp))
+        events |= EPOLLRDHUP;
+    return events;
+}
+
+EventPoll::Watch::Watch(EventPoll& event_poll, OpenFileDescription& description, int fd, epoll_event const& event)
+    : FileReadinessWatch(description)
+    , m_event_poll(event_poll)
+    , m_file(description.file())
+    , m_description(&description)
+    , m_pid(Process::current().pid())
+    , m_fd(fd)
+    , m_events(event.events)
+    , m_data(event.data.u64)
+{
+}
+
+void EventPoll::Watch::readiness_may_have_changed()
+{
+    m_event_poll->watch_may_be_ready(*this);
+}
+
+void EventPoll::Watch::watched_description_will_be_destroyed()
+{
+    m_event_poll->forget_watch(*this);
+}
+
+void EventPoll::Watch::watched_fd_was_closed()
+{
+    m_event_poll->forget_watch(*this);
+}
+
+ErrorOr<NonnullLockRefPtr<EventPoll>> EventPoll::try_create()
+{
+    return adopt_nonnull_lock_ref_or_enomem(new (nothrow) EventPoll);
+}
+
+EventPoll::~EventPoll()
+{
+    // Every watch keeps us alive, so they must all be gone by now.
+    VERIFY(m_watches.is_empty());
+    VERIFY(m_ready_watches.is_empty());
+}
+
+bool EventPoll::can_read(OpenFileDescription const&, u64) const
+{
+    // FIXME: Watched files don't re-evaluate our own block conditions when they
+    //        become ready, so poll() or select() on an EventPoll only notices
+    //        watches that are already on the ready list.
+    SpinlockLocker lock(m_lock);
+    return !m_ready_watches.is_empty();
+}
+
+ErrorOr<void> EventPoll::close()
+{
+    HashMap<int, NonnullLockRefPtr<Watch>> watches;
+    {
+        SpinlockLocker lock(m_lock);
+        m_ready_watches.clear();
+        swap(watches, m_watches);
+        for (auto& it : watches)
+            it.value->m_description = nullptr;
+    }
+
+    for (auto& it : watches)
+        it.value->m_file->blocker_set().remove_readiness_watch(*it.value);
+    return {};
+}
+
+ErrorOr<NonnullOwnPtr<KString>> EventPoll::pseudo_path(OpenFileDescription const&) const
+{
+    SpinlockLocker lock(m_lock);
+    return KString::formatted("EventPoll:({})", m_watches.size());
+}
+
+ErrorOr<void> EventPoll::add_watch(OpenFileDescription& description, int fd, epoll_event const& event)
+{
+    if (event.events & ~supported_epoll_events)
+        return EINVAL;
+    // FIXME: Support watching other EventPolls.
+    if (description.is_event_poll())
+        return EINVAL;
+
+    auto watch = TRY(adopt_nonnull_lock_ref_or_enomem(new (nothrow) Watch(*this, description, fd, event)));
+
+    // Attach the watch before publishing it, so a concurrent removal always finds it attached.
+    description.file().blocker_set().add_readiness_watch(*watch);
+
+    LockRefPtr<Watch> replaced_watch;
+    auto result = [&]() -> ErrorOr<void> {
+        SpinlockLocker lock(m_lock);
+        if (auto it = m_watches.find(fd); it != m_watches.end()) {
+            if (it->value->m_description == &description)
+                return EEXIST;
+            // The fd was closed and reused while the previously watched description
+            // stayed open elsewhere. That watch can't be addressed anymore, so replace it.
+            replaced_watch = it->value;
+        }
+        TRY(m_watches.try_set(fd, watch));
+        if (replaced_watch) {
+            replaced_watch->m_description = nullptr;
+            m_ready_watches.remove(*replaced_watch);
+        }
+        // Let the next wait find out whether the description is ready already.
+        if (!watch->m_ready_list_node.is_in_list())
+            m_ready_watches.append(*watch);
+        return {};
+    }();
+
+    if (result.is_error()) {
+        {
+            SpinlockLocker lock(m_lock);
+            watch->m_description = nullptr;
+            m_ready_watches.remove(*watch);
+        }
+        description.file().blocker_set().remove_readiness_watch(*watch);
+        return result.release_error();
+    }
+
+    if (replaced_watch)
+        replaced_watch->m_file->blocker_set().remove_readiness_watch(*replaced_watch);
+    m_wait_queue.wake_all();
+    return {};
+}
+
+ErrorOr<void> EventPoll::modify_watch(OpenFileDescription& description, int fd, epoll_event const& event)
+{
+    if (event.events & ~supported_epoll_events)
+        return EINVAL;
+
+    {
+        SpinlockLocker lock(m_lock);
+        auto it = m_watches.find(fd);
+        if (it == m_watches.end() || it->value->m_description != &description)
+            return ENOENT;
+        auto& watch = *it->value;
+        watch.m_events = event.events;
+        watch.m_data = event.data.u64;
+        watch.m_is_disarmed = false;
+        if (!watch.m_ready_list_node.is_in_list())
+            m_ready_watches.append(watch);
+    }
+
+    m_wait_queue.wake_all();
+    return {};
+}
+
+ErrorOr<void> EventPoll::remove_watch(OpenFileDescription const* description, int fd)
+{
+    LockRefPtr<Watch> watch;
+    {
+        SpinlockLocker lock(m_lock);
+        auto it = m_watches.find(fd);
+        if (it == m_watches.end() || (description && it->value->m_description != description))
+            return ENOENT;
+        watch = it->value;
+        watch->m_description = nullptr;
+        m_ready_watches.remove(*watch);
+        m_watches.remove(it);
+    }
+
+    watch->m_file->blocker_set().remove_readiness_watch(*watch);
+    return {};
+}
+
+size_t EventPoll::collect_ready_events(Span<epoll_event> events)
+{
+    // Take the whole ready list up front. Level-triggered watches that are still
+    // ready get appended to m_ready_watches again, and we don't want to report
+    // them twice in a single call.
+    IntrusiveList<&Watch::m_ready_list_node> pending_watches;
+    {
+        SpinlockLocker lock(m_lock);
+        while (auto watch = m_ready_watches.take_first())
+            pending_watches.append(*watch);
+    }
+
+    size_t event_count = 0;
+    while (event_count < events.size()) {
+        LockRefPtr<Watch> watch;
+        LockRefPtr<OpenFileDescription> description;
+        u32 interest = 0;
+        {
+            SpinlockLocker lock(m_lock);
+            watch = pending_watches.take_first();
+            if (!watch)
+                break;
+            // NOTE: If the description's ref count already dropped to zero, it is
+            //       about to tell us to forget this watch.
+            if (watch->m_is_disarmed || !watch->m_description || !watch->m_description->try_ref())
+                continue;
+            description = adopt_lock_ref(*watch->m_description);
+            interest = watch->m_events;
+        }
+
+        // This may take the File's FileBlockerSet lock, so it must not be called with m_lock held.
+        auto unblock_flags = description->should_unblock(block_flags_for_epoll_events(interest));
+        auto ready_events = epoll_events_for_unblock_flags(unblock_flags);
+
+        SpinlockLocker lock(m_lock);
+        if (watch->m_is_disarmed || watch->m_description != description.ptr() || ready_events == 0)
+            continue;
+        // The interest set may have been modified while we were looking.
+        ready_events &= watch->m_events | EPOLLERR | EPOLLHUP;
+        if (ready_events == 0)
+            continue;
+
+        events[event_count++] = { .events = ready_events, .data = { .u64 = watch->m_data } };
+        if (watch->m_events & EPOLLONESHOT)
+            watch->m_is_disarmed = true;
+        else if (!(watch->m_events & EPOLLET) && !watch->m_ready_list_node.is_in_list())
+            m_ready_watches.append(*watch);
+    }
+
+    // Put back whatever didn't fit, in order, so the next call starts with it.
+    SpinlockLocker lock(m_lock);
+    while (auto watch = pending_watches.take_last()) {
+        if (watch->m_description)
+            m_ready_watches.prepend(*watch);
+    }
+    return event_count;
+}
+
+Thread::BlockResult EventPoll::wait_for_events(Thread::BlockTimeout const& timeout)
+{
+    {
+        SpinlockLocker lock(m_lock);
+        if (!m_ready_watches.is_empty())
+            return Thread::BlockResult::NotBlocked;
+    }
+    return m_wait_queue.wait_on(timeout, "EventPoll"sv);
+}
+
+void EventPoll::watch_may_be_ready(Watch& watch)
+{
+    {
+        SpinlockLocker lock(m_lock);
+        if (!watch.m_description || watch.m_is_disarmed)
+            return;
+        // NOTE: If the watch is in a list already (ours, or a batch that is being
+        //       collected right now), it is going to be looked at anyway.
+        if (watch.m_ready_list_node.is_in_list())
+            return;
+        m_ready_watches.append(watch);
+    }
+    m_wait_queue.wake_all();
+}
+
+void EventPoll::forget_watch(Watch& watch)
+{
+    LockRefPtr<Watch> protector = watch;
+    SpinlockLocker lock(m_lock);
+    if (!watch.m_description)
+        return;
+    watch.m_description = nullptr;
+    m_ready_watches.remove(watch);
+    if (auto it = m_watches.find(watch.m_fd); it != m_watches.end() && it->value.ptr() == &watch)
+        m_watches.remove(it);
+}
+
+}
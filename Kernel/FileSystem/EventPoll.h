@@ -0,0 +1,85 @@
+/*
+ * Copyright (c) 2022, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#pragma once
+
+#include <AK/HashMap.h>
+#include <AK/IntrusiveList.h>
+#include <AK/Span.h>
+#include <Kernel/API/POSIX/sys/epoll.h>
+#include <Kernel/FileSystem/File.h>
+#include <Kernel/Locking/Spinlock.h>
+#include <Kernel/WaitQueue.h>
+
+namespace Kernel {
+
+// EventPoll is a persistent interest set of file descriptions. Instead of
+// handing the kernel the full list of descriptions on every wait like poll()
+// does, userspace registers each description once. Whenever a watched File
+// re-evaluates its block conditions, its watch is put on the ready list, so a
+// wait only has to look at descriptions that may actually have changed.
+class EventPoll final : public File {
+public:
+    static ErrorOr<NonnullLockRefPtr<EventPoll>> try_create();
+    virtual ~EventPoll() override;
+
+    virtual bool can_read(OpenFileDescription const&, u64) const override;
+    virtual ErrorOr<size_t> read(OpenFileDescription&, u64, UserOrKernelBuffer&, size_t) override { return EINVAL; }
+    virtual bool can_write(OpenFileDescription const&, u64) const override { return true; }
+    virtual ErrorOr<size_t> write(OpenFileDescription&, u64, UserOrKernelBuffer const&, size_t) override { return EINVAL; }
+    virtual ErrorOr<void> close() override;
+
+    virtual ErrorOr<NonnullOwnPtr<KString>> pseudo_path(OpenFileDescription const&) const override;
+    virtual StringView class_name() const override { return "EventPoll"sv; }
+    virtual bool is_event_poll() const override { return true; }
+
+    ErrorOr<void> add_watch(OpenFileDescription&, int fd, epoll_event const&);
+    ErrorOr<void> modify_watch(OpenFileDescription&, int fd, epoll_event const&);
+    // Without a description, removes whatever watch was added through the fd.
+    ErrorOr<void> remove_watch(OpenFileDescription const*, int fd);
+
+    // Fills in up to events.size() ready events and returns how many were filled in.
+    size_t collect_ready_events(Span<epoll_event> events);
+    Thread::BlockResult wait_for_events(Thread::BlockTimeout const&);
+
+private:
+    class Watch final : public FileReadinessWatch {
+    public:
+        Watch(EventPoll&, OpenFileDescription&, int fd, epoll_event const&);
+
+        virtual void readiness_may_have_changed() override;
+        virtual void watched_description_will_be_destroyed() override;
+        virtual bool was_added_through_fd(ProcessID pid, int fd) const override { return pid == m_pid && fd == m_fd; }
+        virtual void watched_fd_was_closed() override;
+
+        // Everything below is protected by the owning EventPoll's m_lock.
+        NonnullLockRefPtr<EventPoll> m_event_poll;
+        // Keeps the File (and its FileBlockerSet) around so the watch can always be removed from it.
+        NonnullLockRefPtr<File> m_file;
+        // Cleared once the watch is removed or the description is being destroyed.
+        OpenFileDescription* m_description { nullptr };
+        // The process whose fd table m_fd belongs to.
+        ProcessID m_pid { 0 };
+        int m_fd { -1 };
+        u32 m_events { 0 };
+        u64 m_data { 0 };
+        bool m_is_disarmed { false };
+
+        IntrusiveListNode<Watch, LockRefPtr<Watch>> m_ready_list_node;
+    };
+
+    EventPoll() = default;
+
+    void watch_may_be_ready(Watch&);
+    void forget_watch(Watch&);
+
+    mutable Spinlock m_lock { LockRank::None };
+    HashMap<int, NonnullLockRefPtr<Watch>> m_watches;
+    IntrusiveList<&Watch::m_ready_list_node> m_ready_watches;
+    WaitQueue m_wait_queue;
+};
+
+}
@@ -0,0 +1,89 @@
+/*
+ * Copyright (c) 2022, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <AK/BinarySearch.h>
+#include <Kernel/FileSystem/Ext2FS/BlockMap.h>
+
+namespace Kernel {
+
+ErrorOr<Ext2FSBlockMap> Ext2FSBlockMap::try_create(Span<BlockIndex const> block_list)
+{
+    Ext2FSBlockMap map;
+    for (auto block_index : block_list)
+        TRY(map.append(block_index, 1));
+    return map;
+}
+
+size_t Ext2FSBlockMap::extent_index_containing(u64 logical_index) const
+{
+    VERIFY(logical_index < block_count());
+    size_t nearby_index = 0;
+    binary_search(m_extents, logical_index, &nearby_index, [](u64 needle, Extent const& extent) -> int {
+        if (needle < extent.logical_start)
+            return -1;
+        if (needle >= extent.logical_end())
+            return 1;
+        return 0;
+    });
+    VERIFY(m_extents[nearby_index].logical_start <= logical_index && logical_index < m_extents[nearby_index].logical_end());
+    return nearby_index;
+}
+
+Ext2FSBlockMap::Run Ext2FSBlockMap::run_at(u64 logical_index, u64 max_length) const
+{
+    VERIFY(max_length > 0);
+    if (logical_index >= block_count())
+        return { 0, max_length };
+
+    auto& extent = m_extents[extent_index_containing(logical_index)];
+    auto offset = logical_index - extent.logical_start;
+    auto length = min(extent.length - offset, max_length);
+    if (extent.is_hole())
+        return { 0, length };
+    return { extent.physical_start.value() + offset, length };
+}
+
+ErrorOr<void> Ext2FSBlockMap::append(BlockIndex physical_start, u64 length)
+{
+    if (length == 0)
+        return {};
+
+    if (!m_extents.is_empty()) {
+        auto& last = m_extents.last();
+        bool both_holes = last.is_hole() && physical_start.value() == 0;
+        bool contiguous_on_disk = !last.is_hole() && physical_start.value() == last.physical_start.value() + last.length;
+        if (both_holes || contiguous_on_disk) {
+            last.length += length;
+            if (!last.is_hole())
+                m_allocated_block_count += length;
+            return {};
+        }
+    }
+
+    TRY(m_extents.try_append({ block_count(), physical_start, length }));
+    if (physical_start.value() != 0)
+        m_allocated_block_count += length;
+    return {};
+}
+
+ErrorOr<Vector<Ext2FSBlockMap::BlockIndex>> Ext2FSBlockMap::to_block_list() const
+{
+    Vector<BlockIndex> block_list;
+    TRY(block_list.try_ensure_capacity(block_count()));
+    for (auto& extent : m_extents) {
+        for (u64 i = 0; i < extent.length; ++i)
+            block_list.unchecked_append(extent.is_hole() ? 0 : extent.physical_start.value() + i);
+    }
+    return block_list;
+}
+
+void Ext2FSBlockMap::clear()
+{
+    m_extents.clear();
+    m_allocated_block_count = 0;
+}
+
+}
@@ -0,0 +1,89 @@
+/*
+ * Copyright (c) 2022, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#pragma once
+
+#include <AK/Error.h>
+#include <AK/Span.h>
+#include <AK/Types.h>
+#include <AK/Vector.h>
+#include <Kernel/FileSystem/BlockBasedFileSystem.h>
+
+namespace Kernel {
+
+// Maps the logical blocks of an inode to blocks on disk. Instead of one entry per
+// block, it keeps a sorted list of extents (runs of logical blocks that are also
+// contiguous on disk), so well laid out files take up very little memory and
+// readers and writers can find contiguous runs without looking at every block.
+//
+// Blocks that don't have a place on disk (yet) are holes, and read back as zeroes.
+class Ext2FSBlockMap {
+public:
+    using BlockIndex = BlockBasedFileSystem::BlockIndex;
+
+    struct Extent {
+        u64 logical_start { 0 };
+        BlockIndex physical_start { 0 };
+        u64 length { 0 };
+
+        u64 logical_end() const { return logical_start + length; }
+        bool is_hole() const { return physical_start.value() == 0; }
+    };
+
+    struct Run {
+        BlockIndex physical_start { 0 };
+        u64 length { 0 };
+
+        bool is_hole() const { return physical_start.value() == 0; }
+    };
+
+    static ErrorOr<Ext2FSBlockMap> try_create(Span<BlockIndex const>);
+
+    bool is_empty() const { return m_extents.is_empty(); }
+    u64 block_count() const { return m_extents.is_empty() ? 0 : m_extents.last().logical_end(); }
+    u64 allocated_block_count() const { return m_allocated_block_count; }
+    Vector<Extent> const& extents() const { return m_extents; }
+
+    // Returns the run of up to `max_length` blocks starting at `logical_index` that is
+    // contiguous on disk (or one big hole). Everything past the end of the map is a hole.
+    Run run_at(u64 logical_index, u64 max_length) const;
+    BlockIndex block_at(u64 logical_index) const { return run_at(logical_index, 1).physical_start; }
+
+    // Adds `length` blocks to the end of the map. A zero `physical_start` adds a hole.
+    ErrorOr<void> append(BlockIndex physical_start, u64 length);
+
+    // Drops everything from `new_block_count` on, calling `callback` with every run
+    // of blocks on disk that is no longer used by the map.
+    template<typename Callback>
+    ErrorOr<void> truncate(u64 new_block_count, Callback callback)
+    {
+        while (!m_extents.is_empty() && m_extents.last().logical_end() > new_block_count) {
+            auto& extent = m_extents.last();
+            auto first_dropped = max(extent.logical_start, new_block_count);
+            auto dropped_length = extent.logical_end() - first_dropped;
+            if (!extent.is_hole()) {
+                TRY(callback(BlockIndex { extent.physical_start.value() + (first_dropped - extent.logical_start) }, dropped_length));
+                m_allocated_block_count -= dropped_length;
+            }
+            if (first_dropped == extent.logical_start)
+                m_extents.take_last();
+            else
+                extent.length -= dropped_length;
+        }
+        return {};
+    }
+
+    ErrorOr<Vector<BlockIndex>> to_block_list() const;
+    void clear();
+
+private:
+    size_t extent_index_containing(u64 logical_index) const;
+
+    Vector<Extent> m_extents;
+    u64 m_allocated_block_count { 0 };
+};
+
+}
@@ -223,9 +223,9 @@ ErrorOr<void> Ext2FS::write_ext2_inode(InodeIndex inode, ext2_inode const& e2ino
     return write_block(block_index, buffer, inode_size(), offset);
 }
 
-auto Ext2FS::allocate_blocks(GroupIndex preferred_group_index, size_t count) -> ErrorOr<Vector<BlockIndex>>
+auto Ext2FS::allocate_blocks(GroupIndex preferred_group_index, size_t count, size_t reserved_count) -> ErrorOr<Vector<BlockIndex>>
 {
-    dbgln_if(EXT2_DEBUG, "Ext2FS: allocate_blocks(preferred group: {}, count {})", preferred_group_index, count);
+    dbgln_if(EXT2_DEBUG, "Ext2FS: allocate_blocks(preferred group: {}, count {}, reserved {})", preferred_group_index, count, reserved_count);
     if (count == 0)
         return Vector<BlockIndex> {};
 
@@ -233,13 +233,36 @@ auto Ext2FS::allocate_blocks(GroupIndex preferred_group_index, size_t count) ->
     TRY(blocks.try_ensure_capacity(count));
 
     MutexLocker locker(m_lock);
+    TRY(ensure_unreserved_blocks_while_locked(count, reserved_count));
+    TRY(allocate_blocks_while_locked(preferred_group_index, count, blocks));
+    VERIFY(blocks.size() == count);
+    m_reserved_block_count -= reserved_count;
+    return blocks;
+}
+
+ErrorOr<void> Ext2FS::ensure_unreserved_blocks_while_locked(size_t count, size_t reserved_count) const
+{
+    VERIFY(m_lock.is_locked());
+    VERIFY(reserved_count <= count);
+    VERIFY(reserved_count <= m_reserved_block_count);
+    // Blocks reserved by others must still be there when they come to allocate them.
+    auto unreserved_free_blocks = m_super_block.s_free_blocks_count - min<u32>(m_reserved_block_count, m_super_block.s_free_blocks_count);
+    if (count - reserved_count > unreserved_free_blocks)
+        return ENOSPC;
+    return {};
+}
+
+ErrorOr<void> Ext2FS::allocate_blocks_while_locked(GroupIndex preferred_group_index, size_t count, Vector<BlockIndex>& blocks)
+{
+    VERIFY(m_lock.is_locked());
+    auto target_size = blocks.size() + count;
     auto group_index = preferred_group_index;
 
     if (!group_descriptor(preferred_group_index).bg_free_blocks_count) {
         group_index = 1;
     }
 
-    while (blocks.size() < count) {
+    while (blocks.size() < target_size) {
         bool found_a_group = false;
         if (group_descriptor(group_index).bg_free_blocks_count) {
             found_a_group = true;
@@ -258,27 +281,175 @@ auto Ext2FS::allocate_blocks(GroupIndex preferred_group_index, size_t count) ->
         auto const& bgd = group_descriptor(group_index);
 
         auto* cached_bitmap = TRY(get_bitmap_block(bgd.bg_block_bitmap));
+        auto block_bitmap = cached_bitmap->bitmap(blocks_in_group());
 
-        int blocks_in_group = min(blocks_per_group(), super_block().s_blocks_count);
-        auto block_bitmap = cached_bitmap->bitmap(blocks_in_group);
-
-        BlockIndex first_block_in_group = (group_index.value() - 1) * blocks_per_group() + first_block_index().value();
         size_t free_region_size = 0;
-        auto first_unset_bit_index = block_bitmap.find_longest_range_of_unset_bits(count - blocks.size(), free_region_size);
+        auto first_unset_bit_index = block_bitmap.find_longest_range_of_unset_bits(target_size - blocks.size(), free_region_size);
         VERIFY(first_unset_bit_index.has_value());
         dbgln_if(EXT2_DEBUG, "Ext2FS: allocating free region of size: {} [{}]", free_region_size, group_index);
-        for (size_t i = 0; i < free_region_size; ++i) {
-            BlockIndex block_index = (first_unset_bit_index.value() + i) + first_block_in_group.value();
-            TRY(set_block_allocation_state(block_index, true));
-            blocks.unchecked_append(block_index);
-            dbgln_if(EXT2_DEBUG, "  allocated > {}", block_index);
+        BlockIndex first_block = first_block_in_group(group_index).value() + first_unset_bit_index.value();
+        auto allocated = TRY(allocate_run_while_locked(first_block, free_region_size, blocks));
+        VERIFY(allocated == free_region_size);
+    }
+
+    return {};
+}
+
+ErrorOr<size_t> Ext2FS::allocate_run_while_locked(BlockIndex first_block, size_t max_count, Vector<BlockIndex>& blocks)
+{
+    VERIFY(m_lock.is_locked());
+    VERIFY(first_block >= first_block_index());
+    GroupIndex group_index = (first_block.value() - first_block_index().value()) / blocks_per_group() + 1;
+    size_t first_bit = (first_block.value() - first_block_index().value()) % blocks_per_group();
+    auto& bgd = const_cast<ext2_group_desc&>(group_descriptor(group_index));
+
+    auto* cached_bitmap = TRY(get_bitmap_block(bgd.bg_block_bitmap));
+    auto block_bitmap = cached_bitmap->bitmap(blocks_in_group());
+
+    size_t count = 0;
+    while (count < max_count && first_bit + count < blocks_in_group() && !block_bitmap.get(first_bit + count))
+        ++count;
+    if (count == 0)
+        return 0;
+
+    // The bitmap and the free block counters are only updated once for the whole run,
+    // and like every other metadata change they reach the disk with the next flush.
+    TRY(blocks.try_ensure_capacity(blocks.size() + count));
+    block_bitmap.set_range(first_bit, count, true);
+    cached_bitmap->dirty = true;
+    m_super_block.s_free_blocks_count -= count;
+    bgd.bg_free_blocks_count -= count;
+    m_super_block_dirty = true;
+    m_block_group_descriptors_dirty = true;
+
+    for (size_t i = 0; i < count; ++i) {
+        blocks.unchecked_append(first_block.value() + i);
+        dbgln_if(EXT2_DEBUG, "  allocated > {}", first_block.value() + i);
+    }
+    return count;
+}
+
+auto Ext2FS::allocate_blocks_for_inode(InodeIndex inode, BlockIndex goal, size_t count, size_t reserved_count) -> ErrorOr<Vector<BlockIndex>>
+{
+    dbgln_if(EXT2_DEBUG, "Ext2FS: allocate_blocks_for_inode(inode: {}, goal: {}, count {}, reserved {})", inode, goal, count, reserved_count);
+    if (count == 0)
+        return Vector<BlockIndex> {};
+
+    Vector<BlockIndex> blocks;
+    TRY(blocks.try_ensure_capacity(count));
+
+    MutexLocker locker(m_lock);
+    TRY(ensure_unreserved_blocks_while_locked(count, reserved_count));
+    TRY(allocate_from_reservation_window_while_locked(inode, count, blocks));
+
+    if (blocks.size() < count) {
+        // Open a new window close to the file's other blocks, large enough for this
+        // allocation and for the file to keep growing contiguously for a while.
+        auto window_length = min(max(count - blocks.size(), ReservationWindowBlocks), blocks_in_group());
+        if (!goal.value() || goal >= super_block().s_blocks_count)
+            goal = first_block_in_group(group_index_from_inode(inode));
+        if (auto window = TRY(find_free_window_while_locked(inode, goal, window_length)); window.has_value()) {
+            dbgln_if(EXT2_DEBUG, "Ext2FS: New reservation window for inode {}: {} blocks at {}", inode, window->length, window->start);
+            TRY(m_reservation_windows.try_set(inode, *window));
+            TRY(allocate_from_reservation_window_while_locked(inode, count - blocks.size(), blocks));
         }
     }
 
+    // If there's no room for a window anymore, take whatever is left.
+    if (blocks.size() < count)
+        TRY(allocate_blocks_while_locked(group_index_from_inode(inode), count - blocks.size(), blocks));
+
     VERIFY(blocks.size() == count);
+    m_reserved_block_count -= reserved_count;
     return blocks;
 }
 
+ErrorOr<void> Ext2FS::allocate_from_reservation_window_while_locked(InodeIndex inode, size_t count, Vector<BlockIndex>& blocks)
+{
+    VERIFY(m_lock.is_locked());
+    auto it = m_reservation_windows.find(inode);
+    if (it == m_reservation_windows.end())
+        return {};
+
+    auto& window = it->value;
+    auto target_size = blocks.size() + count;
+    while (blocks.size() < target_size && window.length > 0) {
+        auto allocated = TRY(allocate_run_while_locked(window.start, min(target_size - blocks.size(), window.length), blocks));
+        // Windows are only advisory, so other allocations may have taken blocks from it.
+        if (allocated == 0)
+            break;
+        window.start = window.start.value() + allocated;
+        window.length -= allocated;
+    }
+    if (blocks.size() < target_size || window.length == 0)
+        m_reservation_windows.remove(it);
+    return {};
+}
+
+auto Ext2FS::find_free_window_while_locked(InodeIndex inode, BlockIndex goal, size_t length) -> ErrorOr<Optional<ReservationWindow>>
+{
+    VERIFY(m_lock.is_locked());
+    GroupIndex goal_group = (goal.value() - first_block_index().value()) / blocks_per_group() + 1;
+
+    auto find_in_group = [&](GroupIndex group_index, size_t from) -> ErrorOr<Optional<ReservationWindow>> {
+        auto const& bgd = group_descriptor(group_index);
+        if (bgd.bg_free_blocks_count < length)
+            return Optional<ReservationWindow> {};
+        auto* cached_bitmap = TRY(get_bitmap_block(bgd.bg_block_bitmap));
+        auto block_bitmap = cached_bitmap->bitmap(blocks_in_group());
+        auto first_block = first_block_in_group(group_index);
+        while (from < blocks_in_group()) {
+            auto found_length = block_bitmap.find_next_range_of_unset_bits(from, length, length);
+            if (!found_length.has_value())
+                break;
+            ReservationWindow candidate { first_block.value() + from, found_length.value() };
+            bool overlaps_other_window = false;
+            for (auto& it : m_reservation_windows) {
+                if (it.key == inode || !it.value.overlaps(candidate.start, candidate.length))
+                    continue;
+                overlaps_other_window = true;
+                // Keep looking right behind the window that is in the way.
+                from = it.value.start.value() + it.value.length - first_block.value();
+                break;
+            }
+            if (!overlaps_other_window)
+                return Optional<ReservationWindow> { candidate };
+        }
+        return Optional<ReservationWindow> {};
+    };
+
+    size_t goal_bit = (goal.value() - first_block_index().value()) % blocks_per_group();
+    if (auto window = TRY(find_in_group(goal_group, goal_bit)); window.has_value())
+        return window;
+    for (GroupIndex group_index = 1; group_index <= m_block_group_count; group_index = GroupIndex { group_index.value() + 1 }) {
+        if (auto window = TRY(find_in_group(group_index, 0)); window.has_value())
+            return window;
+    }
+    return Optional<ReservationWindow> {};
+}
+
+void Ext2FS::release_reservation_window(InodeIndex inode)
+{
+    MutexLocker locker(m_lock);
+    m_reservation_windows.remove(inode);
+}
+
+ErrorOr<void> Ext2FS::reserve_blocks(size_t count)
+{
+    MutexLocker locker(m_lock);
+    if (m_reserved_block_count + count > m_super_block.s_free_blocks_count)
+        return ENOSPC;
+    m_reserved_block_count += count;
+    return {};
+}
+
+void Ext2FS::unreserve_blocks(size_t count)
+{
+    MutexLocker locker(m_lock);
+    VERIFY(m_reserved_block_count >= count);
+    m_reserved_block_count -= count;
+}
+
 ErrorOr<InodeIndex> Ext2FS::allocate_inode(GroupIndex preferred_group)
 {
     dbgln_if(EXT2_DEBUG, "Ext2FS: allocate_inode(preferred_group: {})", preferred_group);
@@ -517,7 +688,7 @@ unsigned Ext2FS::total_block_count() const
 unsigned Ext2FS::free_block_count() const
 {
     MutexLocker locker(m_lock);
-    return super_block().s_free_blocks_count;
+    return super_block().s_free_blocks_count - min<u32>(m_reserved_block_count, super_block().s_free_blocks_count);
 }
 
 unsigned Ext2FS::total_inode_count() const
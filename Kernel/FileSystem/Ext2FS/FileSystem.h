@@ -78,7 +78,16 @@ private:
 
     BlockIndex first_block_index() const;
     ErrorOr<InodeIndex> allocate_inode(GroupIndex preferred_group = 0);
-    ErrorOr<Vector<BlockIndex>> allocate_blocks(GroupIndex preferred_group_index, size_t count);
+    // `reserved_count` of the blocks come out of blocks the caller reserved earlier, the others
+    // have to be taken from the blocks nobody has reserved.
+    ErrorOr<Vector<BlockIndex>> allocate_blocks(GroupIndex preferred_group_index, size_t count, size_t reserved_count = 0);
+    ErrorOr<Vector<BlockIndex>> allocate_blocks_for_inode(InodeIndex, BlockIndex goal, size_t count, size_t reserved_count = 0);
+    void release_reservation_window(InodeIndex);
+
+    // Files growing in the page cache reserve their blocks up front, but only get
+    // them assigned when their data is written back (see Ext2FSInode).
+    ErrorOr<void> reserve_blocks(size_t count);
+    void unreserve_blocks(size_t count);
     GroupIndex group_index_from_inode(InodeIndex) const;
     GroupIndex group_index_from_block_index(BlockIndex) const;
 
@@ -124,7 +133,32 @@ private:
     ErrorOr<CachedBitmap*> get_bitmap_block(BlockIndex);
     ErrorOr<void> update_bitmap_block(BlockIndex bitmap_block, size_t bit_index, bool new_state, u32& super_block_counter, u16& group_descriptor_counter);
 
+    // Each file that is being written to gets a window of free blocks that it can grow
+    // into, which other files steer clear of when they open windows of their own. This
+    // keeps files that grow at the same time from being interleaved on disk. Windows
+    // are never written to disk, and only exist while the inode is in memory.
+    struct ReservationWindow {
+        BlockIndex start { 0 };
+        size_t length { 0 };
+
+        bool overlaps(BlockIndex other_start, size_t other_length) const
+        {
+            return start.value() < other_start.value() + other_length && other_start.value() < start.value() + length;
+        }
+    };
+    static constexpr size_t ReservationWindowBlocks = 128;
+
+    size_t blocks_in_group() const { return min(blocks_per_group(), super_block().s_blocks_count); }
+    BlockIndex first_block_in_group(GroupIndex group_index) const { return (group_index.value() - 1) * blocks_per_group() + first_block_index().value(); }
+    ErrorOr<void> ensure_unreserved_blocks_while_locked(size_t count, size_t reserved_count) const;
+    ErrorOr<void> allocate_blocks_while_locked(GroupIndex preferred_group_index, size_t count, Vector<BlockIndex>& blocks);
+    ErrorOr<size_t> allocate_run_while_locked(BlockIndex first_block, size_t max_count, Vector<BlockIndex>& blocks);
+    ErrorOr<void> allocate_from_reservation_window_while_locked(InodeIndex, size_t count, Vector<BlockIndex>& blocks);
+    ErrorOr<Optional<ReservationWindow>> find_free_window_while_locked(InodeIndex, BlockIndex goal, size_t length);
+
     Vector<OwnPtr<CachedBitmap>> m_cached_bitmaps;
+    HashMap<InodeIndex, ReservationWindow> m_reservation_windows;
+    size_t m_reserved_block_count { 0 };
     LockRefPtr<Ext2FSInode> m_root_inode;
 };
 
@@ -202,11 +202,14 @@ ErrorOr<void> Ext2FSInode::shrink_triply_indirect_block(BlockBasedFileSystem::Bl
     return {};
 }
 
-ErrorOr<void> Ext2FSInode::flush_block_list()
+ErrorOr<void> Ext2FSInode::flush_block_list(u64 old_block_count)
 {
     MutexLocker locker(m_inode_lock);
 
-    if (m_block_list.is_empty()) {
+    // Writing out the indirect blocks needs the flat list of every block in the file.
+    auto block_list = TRY(m_block_map.to_block_list());
+
+    if (block_list.is_empty()) {
         m_raw_inode.i_blocks = 0;
         memset(m_raw_inode.i_block, 0, sizeof(m_raw_inode.i_block));
         set_metadata_dirty(true);
@@ -214,29 +217,31 @@ ErrorOr<void> Ext2FSInode::flush_block_list()
     }
 
     // NOTE: There is a mismatch between i_blocks and blocks.size() since i_blocks includes meta blocks and blocks.size() does not.
-    auto const old_block_count = ceil_div(size(), static_cast<u64>(fs().block_size()));
-
     auto old_shape = fs().compute_block_list_shape(old_block_count);
-    auto const new_shape = fs().compute_block_list_shape(m_block_list.size());
+    auto const new_shape = fs().compute_block_list_shape(block_list.size());
 
     Vector<Ext2FS::BlockIndex> new_meta_blocks;
     if (new_shape.meta_blocks > old_shape.meta_blocks) {
-        new_meta_blocks = TRY(fs().allocate_blocks(fs().group_index_from_inode(index()), new_shape.meta_blocks - old_shape.meta_blocks));
+        // Indirect blocks for delayed allocations were reserved along with the data blocks.
+        auto meta_block_count = new_shape.meta_blocks - old_shape.meta_blocks;
+        auto reserved_count = min<size_t>(meta_block_count, m_delayed_block_count);
+        new_meta_blocks = TRY(fs().allocate_blocks(fs().group_index_from_inode(index()), meta_block_count, reserved_count));
+        m_delayed_block_count -= reserved_count;
     }
 
-    m_raw_inode.i_blocks = (m_block_list.size() + new_shape.meta_blocks) * (fs().block_size() / 512);
+    m_raw_inode.i_blocks = (block_list.size() + new_shape.meta_blocks) * (fs().block_size() / 512);
     dbgln_if(EXT2_BLOCKLIST_DEBUG, "Ext2FSInode[{}]::flush_block_list(): Old shape=({};{};{};{}:{}), new shape=({};{};{};{}:{})", identifier(), old_shape.direct_blocks, old_shape.indirect_blocks, old_shape.doubly_indirect_blocks, old_shape.triply_indirect_blocks, old_shape.meta_blocks, new_shape.direct_blocks, new_shape.indirect_blocks, new_shape.doubly_indirect_blocks, new_shape.triply_indirect_blocks, new_shape.meta_blocks);
 
     unsigned output_block_index = 0;
-    unsigned remaining_blocks = m_block_list.size();
+    unsigned remaining_blocks = block_list.size();
 
     // Deal with direct blocks.
     bool inode_dirty = false;
     VERIFY(new_shape.direct_blocks <= EXT2_NDIR_BLOCKS);
     for (unsigned i = 0; i < new_shape.direct_blocks; ++i) {
-        if (BlockBasedFileSystem::BlockIndex(m_raw_inode.i_block[i]) != m_block_list[output_block_index])
+        if (BlockBasedFileSystem::BlockIndex(m_raw_inode.i_block[i]) != block_list[output_block_index])
             inode_dirty = true;
-        m_raw_inode.i_block[i] = m_block_list[output_block_index].value();
+        m_raw_inode.i_block[i] = block_list[output_block_index].value();
         ++output_block_index;
         --remaining_blocks;
     }
@@ -251,9 +256,9 @@ ErrorOr<void> Ext2FSInode::flush_block_list()
     }
     if (inode_dirty) {
         if constexpr (EXT2_DEBUG) {
-            dbgln("Ext2FSInode[{}]::flush_block_list(): Writing {} direct block(s) to i_block array of inode {}", identifier(), min((size_t)EXT2_NDIR_BLOCKS, m_block_list.size()), index());
-            for (size_t i = 0; i < min((size_t)EXT2_NDIR_BLOCKS, m_block_list.size()); ++i)
-                dbgln("   + {}", m_block_list[i]);
+            dbgln("Ext2FSInode[{}]::flush_block_list(): Writing {} direct block(s) to i_block array of inode {}", identifier(), min((size_t)EXT2_NDIR_BLOCKS, block_list.size()), index());
+            for (size_t i = 0; i < min((size_t)EXT2_NDIR_BLOCKS, block_list.size()); ++i)
+                dbgln("   + {}", block_list[i]);
         }
         set_metadata_dirty(true);
     }
@@ -270,7 +275,7 @@ ErrorOr<void> Ext2FSInode::flush_block_list()
                 old_shape.meta_blocks++;
             }
 
-            TRY(write_indirect_block(m_raw_inode.i_block[EXT2_IND_BLOCK], m_block_list.span().slice(output_block_index, new_shape.indirect_blocks)));
+            TRY(write_indirect_block(m_raw_inode.i_block[EXT2_IND_BLOCK], block_list.span().slice(output_block_index, new_shape.indirect_blocks)));
         } else if ((new_shape.indirect_blocks == 0) && (old_shape.indirect_blocks != 0)) {
             dbgln_if(EXT2_BLOCKLIST_DEBUG, "Ext2FSInode[{}]::flush_block_list(): Freeing indirect block: {}", identifier(), m_raw_inode.i_block[EXT2_IND_BLOCK]);
             TRY(fs().set_block_allocation_state(m_raw_inode.i_block[EXT2_IND_BLOCK], false));
@@ -292,7 +297,7 @@ ErrorOr<void> Ext2FSInode::flush_block_list()
                 set_metadata_dirty(true);
                 old_shape.meta_blocks++;
             }
-            TRY(grow_doubly_indirect_block(m_raw_inode.i_block[EXT2_DIND_BLOCK], old_shape.doubly_indirect_blocks, m_block_list.span().slice(output_block_index, new_shape.doubly_indirect_blocks), new_meta_blocks, old_shape.meta_blocks));
+            TRY(grow_doubly_indirect_block(m_raw_inode.i_block[EXT2_DIND_BLOCK], old_shape.doubly_indirect_blocks, block_list.span().slice(output_block_index, new_shape.doubly_indirect_blocks), new_meta_blocks, old_shape.meta_blocks));
         } else {
             TRY(shrink_doubly_indirect_block(m_raw_inode.i_block[EXT2_DIND_BLOCK], old_shape.doubly_indirect_blocks, new_shape.doubly_indirect_blocks, old_shape.meta_blocks));
             if (new_shape.doubly_indirect_blocks == 0)
@@ -313,7 +318,7 @@ ErrorOr<void> Ext2FSInode::flush_block_list()
                 set_metadata_dirty(true);
                 old_shape.meta_blocks++;
             }
-            TRY(grow_triply_indirect_block(m_raw_inode.i_block[EXT2_TIND_BLOCK], old_shape.triply_indirect_blocks, m_block_list.span().slice(output_block_index, new_shape.triply_indirect_blocks), new_meta_blocks, old_shape.meta_blocks));
+            TRY(grow_triply_indirect_block(m_raw_inode.i_block[EXT2_TIND_BLOCK], old_shape.triply_indirect_blocks, block_list.span().slice(output_block_index, new_shape.triply_indirect_blocks), new_meta_blocks, old_shape.meta_blocks));
         } else {
             TRY(shrink_triply_indirect_block(m_raw_inode.i_block[EXT2_TIND_BLOCK], old_shape.triply_indirect_blocks, new_shape.triply_indirect_blocks, old_shape.meta_blocks));
             if (new_shape.triply_indirect_blocks == 0)
@@ -410,6 +415,12 @@ ErrorOr<Vector<Ext2FS::BlockIndex>> Ext2FSInode::compute_block_list_impl_interna
         auto count = min(blocks_remaining, entries_per_block);
         if (!count)
             return {};
+        if (array_block_index == 0) {
+            // Nothing below this point has been given a block on disk yet, so it's all one big hole.
+            for (unsigned i = 0; i < count; ++i)
+                TRY(callback(Ext2FS::BlockIndex(0)));
+            return {};
+        }
         size_t read_size = count * sizeof(u32);
         auto array_storage = TRY(ByteBuffer::create_uninitialized(read_size));
         auto* array = (u32*)array_storage.data();
@@ -454,6 +465,9 @@ Ext2FSInode::Ext2FSInode(Ext2FS& fs, InodeIndex index)
 
 Ext2FSInode::~Ext2FSInode()
 {
+    if (m_delayed_block_count)
+        fs().unreserve_blocks(m_delayed_block_count);
+    fs().release_reservation_window(index());
     if (m_raw_inode.i_links_count == 0) {
         // Alas, we have nowhere to propagate any errors that occur here.
         (void)fs().free_inode(*this);
@@ -510,20 +524,39 @@ ErrorOr<void> Ext2FSInode::flush_metadata()
     return {};
 }
 
-ErrorOr<void> Ext2FSInode::compute_block_list_with_exclusive_locking()
+ErrorOr<void> Ext2FSInode::ensure_block_map()
+{
+    if (m_block_map.is_empty()) {
+        auto block_list = TRY(compute_block_list());
+        m_block_map = TRY(Ext2FSBlockMap::try_create(block_list.span()));
+    }
+    return {};
+}
+
+ErrorOr<void> Ext2FSInode::ensure_block_map_with_exclusive_locking()
 {
     // Note: We verify that the inode mutex is being held locked. Because only the read_bytes_locked()
     // method uses this method and the mutex can be locked in shared mode when reading the Inode if
     // it is an ext2 regular file, but also in exclusive mode, when the Inode is an ext2 directory and being
     // traversed, we use another exclusive lock to ensure we always mutate the block list safely.
     VERIFY(m_inode_lock.is_locked());
-    MutexLocker block_list_locker(m_block_list_lock);
-    if (m_block_list.is_empty())
-        m_block_list = TRY(compute_block_list());
-    return {};
+    MutexLocker block_map_locker(m_block_map_lock);
+    return ensure_block_map();
 }
 
 ErrorOr<size_t> Ext2FSInode::read_bytes_locked(off_t offset, size_t count, UserOrKernelBuffer& buffer, OpenFileDescription* description) const
+{
+    bool allow_cache = !description || !description->is_direct();
+    return read_bytes_impl(offset, count, buffer, allow_cache);
+}
+
+ErrorOr<size_t> Ext2FSInode::read_bytes_for_page_cache_locked(off_t offset, size_t count, UserOrKernelBuffer& buffer) const
+{
+    // The page cache holds on to file data itself, so keep it out of the block cache.
+    return read_bytes_impl(offset, count, buffer, false);
+}
+
+ErrorOr<size_t> Ext2FSInode::read_bytes_impl(off_t offset, size_t count, UserOrKernelBuffer& buffer, bool allow_cache) const
 {
     VERIFY(m_inode_lock.is_locked());
     VERIFY(offset >= 0);
@@ -545,23 +578,16 @@ ErrorOr<size_t> Ext2FSInode::read_bytes_locked(off_t offset, size_t count, UserO
     // Note: We bypass the const declaration of this method, but this is a strong
     // requirement to be able to accomplish the read operation successfully.
     // We call this special method because it locks a separate mutex to ensure we
-    // update the block list of the inode safely, as the m_inode_lock is locked in
+    // update the block map of the inode safely, as the m_inode_lock is locked in
     // shared mode.
-    TRY(const_cast<Ext2FSInode&>(*this).compute_block_list_with_exclusive_locking());
-
-    if (m_block_list.is_empty()) {
-        dmesgln("Ext2FSInode[{}]::read_bytes(): Empty block list", identifier());
-        return EIO;
-    }
-
-    bool allow_cache = !description || !description->is_direct();
+    TRY(const_cast<Ext2FSInode&>(*this).ensure_block_map_with_exclusive_locking());
 
     int const block_size = fs().block_size();
 
+    // NOTE: Blocks past the end of the block map belong to delayed allocations (or are
+    //       holes), and read back as zeroes.
     BlockBasedFileSystem::BlockIndex first_block_logical_index = offset / block_size;
     BlockBasedFileSystem::BlockIndex last_block_logical_index = (offset + count) / block_size;
-    if (last_block_logical_index >= m_block_list.size())
-        last_block_logical_index = m_block_list.size() - 1;
 
     int offset_into_first_block = offset % block_size;
 
@@ -571,13 +597,23 @@ ErrorOr<size_t> Ext2FSInode::read_bytes_locked(off_t offset, size_t count, UserO
     dbgln_if(EXT2_VERY_DEBUG, "Ext2FSInode[{}]::read_bytes(): Reading up to {} bytes, {} bytes into inode to {}", identifier(), count, offset, buffer.user_or_kernel_ptr());
 
     for (auto bi = first_block_logical_index; remaining_count && bi <= last_block_logical_index; bi = bi.value() + 1) {
-        auto block_index = m_block_list[bi.value()];
+        auto block_index = m_block_map.block_at(bi.value());
         size_t offset_into_block = (bi == first_block_logical_index) ? offset_into_first_block : 0;
         size_t num_bytes_to_copy = min((size_t)block_size - offset_into_block, (size_t)remaining_count);
         auto buffer_offset = buffer.offset(nread);
         if (block_index.value() == 0) {
             // This is a hole, act as if it's filled with zeroes.
             TRY(buffer_offset.memset(0, num_bytes_to_copy));
+        } else if (!allow_cache && offset_into_block == 0 && num_bytes_to_copy == (size_t)block_size) {
+            // Uncached reads of whole blocks that are contiguous on disk are done with a single request.
+            auto run = m_block_map.run_at(bi.value(), last_block_logical_index.value() - bi.value() + 1);
+            size_t run_length = min(static_cast<size_t>(run.length), static_cast<size_t>(remaining_count) / block_size);
+            if (auto result = fs().read_blocks(block_index, run_length, buffer_offset, false); result.is_error()) {
+                dmesgln("Ext2FSInode[{}]::read_bytes(): Failed to read {} blocks at {} (index {})", identifier(), run_length, block_index.value(), bi);
+                return result.release_error();
+            }
+            num_bytes_to_copy = run_length * block_size;
+            bi = bi.value() + run_length - 1;
         } else {
             if (auto result = fs().read_block(block_index, &buffer_offset, num_bytes_to_copy, offset_into_block, allow_cache); result.is_error()) {
                 dmesgln("Ext2FSInode[{}]::read_bytes(): Failed to read block {} (index {})", identifier(), block_index.value(), bi);
@@ -591,6 +627,110 @@ ErrorOr<size_t> Ext2FSInode::read_bytes_locked(off_t offset, size_t count, UserO
     return nread;
 }
 
+BlockBasedFileSystem::BlockIndex Ext2FSInode::allocation_goal() const
+{
+    // New blocks should continue right where the file currently ends on disk.
+    auto const& extents = m_block_map.extents();
+    for (size_t i = extents.size(); i > 0; --i) {
+        auto const& extent = extents[i - 1];
+        if (!extent.is_hole())
+            return extent.physical_start.value() + extent.length;
+    }
+    return 0;
+}
+
+ErrorOr<bool> Ext2FSInode::try_grow_for_page_cache_locked(u64 new_size)
+{
+    VERIFY(m_inode_lock.is_locked());
+    if (!is_page_cacheable())
+        return false;
+
+    auto old_size = size();
+    VERIFY(new_size > old_size);
+    if (!((u32)fs().get_features_readonly() & (u32)Ext2FS::FeaturesReadOnly::FileSize64bits) && (new_size >= static_cast<u32>(-1)))
+        return false;
+
+    TRY(ensure_block_map());
+
+    u64 block_size = fs().block_size();
+    auto blocks_needed_before = ceil_div(old_size, block_size);
+    auto blocks_needed_after = ceil_div(new_size, block_size);
+
+    // The rest of the last block on disk may still contain old data, which must not become
+    // part of the file. Once zeroed, it stays that way until the file is resized again.
+    auto offset_into_last_block = old_size % block_size;
+    if (offset_into_last_block != 0 && m_known_zero_end < blocks_needed_before * block_size) {
+        auto last_block = m_block_map.block_at(blocks_needed_before - 1);
+        if (last_block.value() != 0) {
+            auto zeroes = TRY(ByteBuffer::create_zeroed(block_size - offset_into_last_block));
+            auto buffer = UserOrKernelBuffer::for_kernel_buffer(zeroes.data());
+            TRY(fs().write_block(last_block, buffer, zeroes.size(), offset_into_last_block, false));
+        }
+        m_known_zero_end = blocks_needed_before * block_size;
+    }
+
+    // Reserve the new blocks, and the indirect blocks needed to reach them, so
+    // writing them back later on can't run out of space.
+    size_t blocks_to_reserve = blocks_needed_after - blocks_needed_before;
+    blocks_to_reserve += fs().compute_block_list_shape(blocks_needed_after).meta_blocks - fs().compute_block_list_shape(blocks_needed_before).meta_blocks;
+    if (blocks_to_reserve)
+        TRY(fs().reserve_blocks(blocks_to_reserve));
+    m_delayed_block_count += blocks_to_reserve;
+
+    dbgln_if(EXT2_DEBUG, "Ext2FSInode[{}]::try_grow_for_page_cache_locked(): Growing from {} to {} bytes, {} blocks delayed", identifier(), old_size, new_size, m_delayed_block_count);
+    m_raw_inode.i_size = new_size;
+    m_raw_inode.i_dir_acl = new_size >> 32;
+    set_metadata_dirty(true);
+    return true;
+}
+
+ErrorOr<void> Ext2FSInode::allocate_delayed_blocks()
+{
+    VERIFY(m_inode_lock.is_locked());
+    if (!Kernel::is_regular_file(m_raw_inode.i_mode))
+        return {};
+
+    TRY(ensure_block_map());
+
+    u64 block_size = fs().block_size();
+    auto block_count = ceil_div(size(), block_size);
+    auto old_block_count = m_block_map.block_count();
+    if (block_count > old_block_count) {
+        // Everything past the end of the block map gets its blocks in one go, now that
+        // we know how much there is, so the file ends up as contiguous as possible.
+        auto new_block_count = block_count - old_block_count;
+        auto reserved_count = min<size_t>(new_block_count, m_delayed_block_count);
+        auto blocks = TRY(fs().allocate_blocks_for_inode(index(), allocation_goal(), new_block_count, reserved_count));
+        m_delayed_block_count -= reserved_count;
+        dbgln_if(EXT2_DEBUG, "Ext2FSInode[{}]::allocate_delayed_blocks(): Allocated {} blocks starting at {}", identifier(), new_block_count, blocks.first());
+        for (auto block_index : blocks)
+            TRY(m_block_map.append(block_index, 1));
+        TRY(flush_block_list(old_block_count));
+        set_metadata_dirty(true);
+
+        // Blocks that the page cache isn't going to write back (parts of the file that were
+        // skipped over, or writes that failed) have to read back as zeroes.
+        auto* page_cache = existing_page_cache();
+        Optional<ByteBuffer> zeroes;
+        for (size_t i = 0; i < blocks.size(); ++i) {
+            auto page_index = (old_block_count + i) * block_size / PAGE_SIZE;
+            if (page_cache && page_cache->is_page_dirty(page_index))
+                continue;
+            if (!zeroes.has_value())
+                zeroes = TRY(ByteBuffer::create_zeroed(block_size));
+            auto buffer = UserOrKernelBuffer::for_kernel_buffer(zeroes->data());
+            TRY(fs().write_block(blocks[i], buffer, block_size, 0, false));
+        }
+        m_known_zero_end = 0;
+    }
+
+    if (m_delayed_block_count) {
+        fs().unreserve_blocks(m_delayed_block_count);
+        m_delayed_block_count = 0;
+    }
+    return {};
+}
+
 ErrorOr<void> Ext2FSInode::resize(u64 new_size)
 {
     auto old_size = size();
@@ -600,6 +740,9 @@ ErrorOr<void> Ext2FSInode::resize(u64 new_size)
     if (!((u32)fs().get_features_readonly() & (u32)Ext2FS::FeaturesReadOnly::FileSize64bits) && (new_size >= static_cast<u32>(-1)))
         return ENOSPC;
 
+    // Give everything that is still waiting for blocks a place on disk first, so the block map covers the whole file.
+    TRY(allocate_delayed_blocks());
+
     u64 block_size = fs().block_size();
     auto blocks_needed_before = ceil_div(old_size, block_size);
     auto blocks_needed_after = ceil_div(new_size, block_size);
@@ -611,35 +754,39 @@ ErrorOr<void> Ext2FSInode::resize(u64 new_size)
 
     if (blocks_needed_after > blocks_needed_before) {
         auto additional_blocks_needed = blocks_needed_after - blocks_needed_before;
-        if (additional_blocks_needed > fs().super_block().s_free_blocks_count)
+        if (additional_blocks_needed > fs().free_block_count())
             return ENOSPC;
     }
 
-    if (m_block_list.is_empty())
-        m_block_list = TRY(compute_block_list());
+    TRY(ensure_block_map());
 
     if (blocks_needed_after > blocks_needed_before) {
-        auto blocks = TRY(fs().allocate_blocks(fs().group_index_from_inode(index()), blocks_needed_after - blocks_needed_before));
-        TRY(m_block_list.try_extend(move(blocks)));
+        auto blocks = TRY(fs().allocate_blocks_for_inode(index(), allocation_goal(), blocks_needed_after - blocks_needed_before));
+        for (auto block_index : blocks)
+            TRY(m_block_map.append(block_index, 1));
     } else if (blocks_needed_after < blocks_needed_before) {
         if constexpr (EXT2_VERY_DEBUG) {
-            dbgln("Ext2FSInode[{}]::resize(): Shrinking inode, old block list is {} entries:", identifier(), m_block_list.size());
-            for (auto block_index : m_block_list) {
-                dbgln("    # {}", block_index);
+            dbgln("Ext2FSInode[{}]::resize(): Shrinking inode, old block map is {} extents:", identifier(), m_block_map.extents().size());
+            for (auto& extent : m_block_map.extents()) {
+                dbgln("    # {} blocks at {}", extent.length, extent.physical_start);
             }
         }
-        while (m_block_list.size() != blocks_needed_after) {
-            auto block_index = m_block_list.take_last();
-            if (block_index.value()) {
+        TRY(m_block_map.truncate(blocks_needed_after, [&](auto first_block, u64 length) -> ErrorOr<void> {
+            for (u64 i = 0; i < length; ++i) {
+                BlockBasedFileSystem::BlockIndex block_index = first_block.value() + i;
                 if (auto result = fs().set_block_allocation_state(block_index, false); result.is_error()) {
                     dbgln("Ext2FSInode[{}]::resize(): Failed to free block {}: {}", identifier(), block_index, result.error());
                     return result;
                 }
             }
-        }
+            return {};
+        }));
+        // The file isn't growing into its window anymore.
+        fs().release_reservation_window(index());
     }
 
-    TRY(flush_block_list());
+    TRY(flush_block_list(blocks_needed_before));
+    m_known_zero_end = 0;
 
     m_raw_inode.i_size = new_size;
     if (Kernel::is_regular_file(m_raw_inode.i_mode))
@@ -665,6 +812,21 @@ ErrorOr<void> Ext2FSInode::resize(u64 new_size)
 }
 
 ErrorOr<size_t> Ext2FSInode::write_bytes_locked(off_t offset, size_t count, UserOrKernelBuffer const& data, OpenFileDescription* description)
+{
+    bool allow_cache = !description || !description->is_direct();
+    auto nwritten = TRY(write_bytes_impl(offset, count, data, allow_cache));
+    if (nwritten > 0)
+        did_modify_contents();
+    return nwritten;
+}
+
+ErrorOr<size_t> Ext2FSInode::write_bytes_for_page_cache_locked(off_t offset, size_t count, UserOrKernelBuffer const& data)
+{
+    // NOTE: The contents were already modified when the data went into the page cache.
+    return write_bytes_impl(offset, count, data, false);
+}
+
+ErrorOr<size_t> Ext2FSInode::write_bytes_impl(off_t offset, size_t count, UserOrKernelBuffer const& data, bool allow_cache)
 {
     VERIFY(m_inode_lock.is_locked());
     VERIFY(offset >= 0);
@@ -684,25 +846,22 @@ ErrorOr<size_t> Ext2FSInode::write_bytes_locked(off_t offset, size_t count, User
         }
     }
 
-    bool allow_cache = !description || !description->is_direct();
-
     auto const block_size = fs().block_size();
     auto new_size = max(static_cast<u64>(offset) + count, size());
 
     TRY(resize(new_size));
+    // This is where delayed allocations are given their place on disk, when the page cache writes them back.
+    TRY(allocate_delayed_blocks());
 
-    if (m_block_list.is_empty())
-        m_block_list = TRY(compute_block_list());
-
-    if (m_block_list.is_empty()) {
-        dbgln("Ext2FSInode[{}]::write_bytes(): Empty block list", identifier());
+    if (m_block_map.is_empty()) {
+        dbgln("Ext2FSInode[{}]::write_bytes(): Empty block map", identifier());
         return EIO;
     }
 
     BlockBasedFileSystem::BlockIndex first_block_logical_index = offset / block_size;
     BlockBasedFileSystem::BlockIndex last_block_logical_index = (offset + count) / block_size;
-    if (last_block_logical_index >= m_block_list.size())
-        last_block_logical_index = m_block_list.size() - 1;
+    if (last_block_logical_index >= m_block_map.block_count())
+        last_block_logical_index = m_block_map.block_count() - 1;
 
     size_t offset_into_first_block = offset % block_size;
 
@@ -714,18 +873,34 @@ ErrorOr<size_t> Ext2FSInode::write_bytes_locked(off_t offset, size_t count, User
     for (auto bi = first_block_logical_index; remaining_count && bi <= last_block_logical_index; bi = bi.value() + 1) {
         size_t offset_into_block = (bi == first_block_logical_index) ? offset_into_first_block : 0;
         size_t num_bytes_to_copy = min((size_t)block_size - offset_into_block, (size_t)remaining_count);
-        dbgln_if(EXT2_DEBUG, "Ext2FSInode[{}]::write_bytes_locked(): Writing block {} (offset_into_block: {})", identifier(), m_block_list[bi.value()], offset_into_block);
-        if (auto result = fs().write_block(m_block_list[bi.value()], data.offset(nwritten), num_bytes_to_copy, offset_into_block, allow_cache); result.is_error()) {
-            dbgln("Ext2FSInode[{}]::write_bytes_locked(): Failed to write block {} (index {})", identifier(), m_block_list[bi.value()], bi);
-            return result.release_error();
+        auto block_index = m_block_map.block_at(bi.value());
+        if (block_index.value() == 0) {
+            dbgln("Ext2FSInode[{}]::write_bytes_locked(): Can't write into a hole at index {}", identifier(), bi);
+            return EIO;
+        }
+        if (!allow_cache && offset_into_block == 0 && num_bytes_to_copy == (size_t)block_size) {
+            // Uncached writes of whole blocks that are contiguous on disk are done with a single request.
+            auto run = m_block_map.run_at(bi.value(), last_block_logical_index.value() - bi.value() + 1);
+            size_t run_length = min(static_cast<size_t>(run.length), static_cast<size_t>(remaining_count) / block_size);
+            dbgln_if(EXT2_DEBUG, "Ext2FSInode[{}]::write_bytes_locked(): Writing {} blocks at {}", identifier(), run_length, block_index);
+            if (auto result = fs().write_blocks(block_index, run_length, data.offset(nwritten), false); result.is_error()) {
+                dbgln("Ext2FSInode[{}]::write_bytes_locked(): Failed to write {} blocks at {} (index {})", identifier(), run_length, block_index, bi);
+                return result.release_error();
+            }
+            num_bytes_to_copy = run_length * block_size;
+            bi = bi.value() + run_length - 1;
+        } else {
+            dbgln_if(EXT2_DEBUG, "Ext2FSInode[{}]::write_bytes_locked(): Writing block {} (offset_into_block: {})", identifier(), block_index, offset_into_block);
+            if (auto result = fs().write_block(block_index, data.offset(nwritten), num_bytes_to_copy, offset_into_block, allow_cache); result.is_error()) {
+                dbgln("Ext2FSInode[{}]::write_bytes_locked(): Failed to write block {} (index {})", identifier(), block_index, bi);
+                return result.release_error();
+            }
         }
         remaining_count -= num_bytes_to_copy;
         nwritten += num_bytes_to_copy;
     }
 
-    did_modify_contents();
-
-    dbgln_if(EXT2_VERY_DEBUG, "Ext2FSInode[{}]::write_bytes_locked(): After write, i_size={}, i_blocks={} ({} blocks in list)", identifier(), size(), m_raw_inode.i_blocks, m_block_list.size());
+    dbgln_if(EXT2_VERY_DEBUG, "Ext2FSInode[{}]::write_bytes_locked(): After write, i_size={}, i_blocks={} ({} blocks in map)", identifier(), size(), m_raw_inode.i_blocks, m_block_map.block_count());
     return nwritten;
 }
 
@@ -1065,6 +1240,8 @@ ErrorOr<void> Ext2FSInode::truncate(u64 size)
     MutexLocker locker(m_inode_lock);
     if (static_cast<u64>(m_raw_inode.i_size) == size)
         return {};
+    if (auto* page_cache = this->page_cache())
+        page_cache->truncate(size);
     TRY(resize(size));
     set_metadata_dirty(true);
     return {};
@@ -1074,13 +1251,12 @@ ErrorOr<int> Ext2FSInode::get_block_address(int index)
 {
     MutexLocker locker(m_inode_lock);
 
-    if (m_block_list.is_empty())
-        m_block_list = TRY(compute_block_list());
+    TRY(ensure_block_map());
 
-    if (index < 0 || (size_t)index >= m_block_list.size())
+    if (index < 0)
         return 0;
 
-    return m_block_list[index].value();
+    return m_block_map.block_at(index).value();
 }
 
 }
@@ -7,6 +7,7 @@
 #pragma once
 
 #include <AK/HashMap.h>
+#include <Kernel/FileSystem/Ext2FS/BlockMap.h>
 #include <Kernel/FileSystem/Ext2FS/Definitions.h>
 #include <Kernel/FileSystem/Ext2FS/DirectoryEntry.h>
 #include <Kernel/FileSystem/Ext2FS/FileSystem.h>
@@ -44,6 +45,13 @@ private:
     virtual ErrorOr<void> chown(UserID, GroupID) override;
     virtual ErrorOr<void> truncate(u64) override;
     virtual ErrorOr<int> get_block_address(int) override;
+    virtual bool is_page_cacheable() const override { return Kernel::is_regular_file(m_raw_inode.i_mode); }
+    virtual ErrorOr<size_t> read_bytes_for_page_cache_locked(off_t, size_t, UserOrKernelBuffer& buffer) const override;
+    virtual ErrorOr<size_t> write_bytes_for_page_cache_locked(off_t, size_t, UserOrKernelBuffer const& data) override;
+    virtual ErrorOr<bool> try_grow_for_page_cache_locked(u64 new_size) override;
+
+    ErrorOr<size_t> read_bytes_impl(off_t, size_t, UserOrKernelBuffer& buffer, bool allow_cache) const;
+    ErrorOr<size_t> write_bytes_impl(off_t, size_t, UserOrKernelBuffer const& data, bool allow_cache);
 
     ErrorOr<void> write_directory(Vector<Ext2FSDirectoryEntry>&);
     ErrorOr<void> populate_lookup_cache();
@@ -53,9 +61,12 @@ private:
     ErrorOr<void> shrink_doubly_indirect_block(BlockBasedFileSystem::BlockIndex, size_t, size_t, unsigned&);
     ErrorOr<void> grow_triply_indirect_block(BlockBasedFileSystem::BlockIndex, size_t, Span<BlockBasedFileSystem::BlockIndex>, Vector<BlockBasedFileSystem::BlockIndex>&, unsigned&);
     ErrorOr<void> shrink_triply_indirect_block(BlockBasedFileSystem::BlockIndex, size_t, size_t, unsigned&);
-    ErrorOr<void> flush_block_list();
+    ErrorOr<void> flush_block_list(u64 old_block_count);
 
-    ErrorOr<void> compute_block_list_with_exclusive_locking();
+    ErrorOr<void> ensure_block_map();
+    ErrorOr<void> ensure_block_map_with_exclusive_locking();
+    ErrorOr<void> allocate_delayed_blocks();
+    BlockBasedFileSystem::BlockIndex allocation_goal() const;
     ErrorOr<Vector<BlockBasedFileSystem::BlockIndex>> compute_block_list() const;
     ErrorOr<Vector<BlockBasedFileSystem::BlockIndex>> compute_block_list_with_meta_blocks() const;
     ErrorOr<Vector<BlockBasedFileSystem::BlockIndex>> compute_block_list_impl(bool include_block_list_blocks) const;
@@ -65,11 +76,18 @@ private:
     Ext2FS const& fs() const;
     Ext2FSInode(Ext2FS&, InodeIndex);
 
-    Vector<BlockBasedFileSystem::BlockIndex> m_block_list;
+    Ext2FSBlockMap m_block_map;
     HashMap<NonnullOwnPtr<KString>, InodeIndex> m_lookup_cache;
     ext2_inode m_raw_inode {};
 
-    Mutex m_block_list_lock { "BlockList"sv };
+    // Delayed allocation: the file can grow in the page cache without getting any blocks
+    // on disk. Blocks for it are reserved right away, but only picked once the data is
+    // written back, when the final size is known and they can be placed in one go.
+    size_t m_delayed_block_count { 0 };
+    // Everything on disk from the end of the file up to here is known to be zeroed.
+    u64 m_known_zero_end { 0 };
+
+    Mutex m_block_map_lock { "BlockMap"sv };
 };
 
 inline Ext2FS& Ext2FSInode::fs()
@@ -8,6 +8,7 @@
 
 #include <AK/AtomicRefCounted.h>
 #include <AK/Error.h>
+#include <AK/IntrusiveList.h>
 #include <AK/StringView.h>
 #include <AK/Types.h>
 #include <Kernel/Forward.h>
@@ -21,10 +22,77 @@ namespace Kernel {
 
 class File;
 
+// A persistent interest in the readiness of an OpenFileDescription. Unlike a
+// Thread::FileBlocker it is not tied to a blocked thread: it stays attached to
+// the File's FileBlockerSet and gets told every time the File re-evaluates its
+// block conditions, until it is removed or the description goes away.
+class FileReadinessWatch : public AtomicRefCounted<FileReadinessWatch> {
+    friend class FileBlockerSet;
+
+public:
+    virtual ~FileReadinessWatch() = default;
+
+    // Called with the FileBlockerSet lock held, so this must not block.
+    virtual void readiness_may_have_changed() = 0;
+    virtual void watched_description_will_be_destroyed() = 0;
+
+    // A watch that was added through an fd goes away with that fd, even if the description lives on.
+    virtual bool was_added_through_fd(ProcessID, int) const { return false; }
+    virtual void watched_fd_was_closed() { }
+
+protected:
+    explicit FileReadinessWatch(OpenFileDescription const& description)
+        : m_watched_description(&description)
+    {
+    }
+
+private:
+    OpenFileDescription const* m_watched_description { nullptr };
+    IntrusiveListNode<FileReadinessWatch, LockRefPtr<FileReadinessWatch>> m_blocker_set_list_node;
+};
+
 class FileBlockerSet final : public Thread::BlockerSet {
 public:
     FileBlockerSet() { }
 
+    virtual ~FileBlockerSet() override
+    {
+        VERIFY(m_readiness_watches.is_empty());
+    }
+
+    void add_readiness_watch(FileReadinessWatch& watch)
+    {
+        SpinlockLocker lock(m_lock);
+        VERIFY(!watch.m_blocker_set_list_node.is_in_list());
+        m_readiness_watches.append(watch);
+    }
+
+    void remove_readiness_watch(FileReadinessWatch& watch)
+    {
+        SpinlockLocker lock(m_lock);
+        // NOTE: The watch may already have been detached by its description going away.
+        if (watch.m_blocker_set_list_node.is_in_list())
+            m_readiness_watches.remove(watch);
+    }
+
+    void detach_readiness_watches_for(OpenFileDescription const& description)
+    {
+        IntrusiveList<&FileReadinessWatch::m_blocker_set_list_node> detached_watches;
+        detach_readiness_watches_if(detached_watches, [&](auto& watch) { return watch.m_watched_description == &description; });
+        while (auto watch = detached_watches.take_first())
+            watch->watched_description_will_be_destroyed();
+    }
+
+    void detach_readiness_watches_for_fd(OpenFileDescription const& description, ProcessID pid, int fd)
+    {
+        IntrusiveList<&FileReadinessWatch::m_blocker_set_list_node> detached_watches;
+        detach_readiness_watches_if(detached_watches, [&](auto& watch) {
+            return watch.m_watched_description == &description && watch.was_added_through_fd(pid, fd);
+        });
+        while (auto watch = detached_watches.take_first())
+            watch->watched_fd_was_closed();
+    }
+
     virtual bool should_add_blocker(Thread::Blocker& b, void* data) override
     {
         VERIFY(b.blocker_type() == Thread::Blocker::Type::File);
@@ -40,7 +108,28 @@ public:
             auto& blocker = static_cast<Thread::FileBlocker&>(b);
             return blocker.unblock_if_conditions_are_met(false, data);
         });
+        for (auto& watch : m_readiness_watches)
+            watch.readiness_may_have_changed();
     }
+
+private:
+    template<typename Predicate>
+    void detach_readiness_watches_if(IntrusiveList<&FileReadinessWatch::m_blocker_set_list_node>& detached_watches, Predicate predicate)
+    {
+        SpinlockLocker lock(m_lock);
+        for (auto it = m_readiness_watches.begin(); it != m_readiness_watches.end();) {
+            auto& watch = *it;
+            ++it;
+            if (!predicate(watch))
+                continue;
+            // Moving the watch between lists drops the reference held by the
+            // old list before the new list takes one, so keep it alive here.
+            NonnullLockRefPtr<FileReadinessWatch> protector = watch;
+            detached_watches.append(watch);
+        }
+    }
+
+    IntrusiveList<&FileReadinessWatch::m_blocker_set_list_node> m_readiness_watches;
 };
 
 // File is the base class for anything that can be referenced by a OpenFileDescription.
@@ -114,6 +203,8 @@ public:
     virtual bool is_character_device() const { return false; }
     virtual bool is_socket() const { return false; }
     virtual bool is_inode_watcher() const { return false; }
+    virtual bool is_event_poll() const { return false; }
+    virtual bool is_io_ring() const { return false; }
 
     virtual bool is_regular_file() const { return false; }
 
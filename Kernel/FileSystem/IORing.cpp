@@ -0,0 +1,99 @@
+/*
+ * Copyright (c) 2022, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <AK/BuiltinWrappers.h>
+#include <Kernel/FileSystem/IORing.h>
+#include <Kernel/FileSystem/OpenFileDescription.h>
+#include <Kernel/Memory/MemoryManager.h>
+
+namespace Kernel {
+
+ErrorOr<NonnullLockRefPtr<IORing>> IORing::try_create(u32 submission_entries)
+{
+    if (submission_entries == 0 || submission_entries > io_ring_max_entries || !is_power_of_two(submission_entries))
+        return EINVAL;
+
+    auto vmobject = TRY(Memory::AnonymousVMObject::try_create_with_size(io_ring_size(submission_entries), AllocationStrategy::AllocateNow));
+    auto region = TRY(MM.allocate_kernel_region_with_vmobject(*vmobject, vmobject->size(), "IORing"sv, Memory::Region::Access::ReadWrite));
+    return adopt_nonnull_lock_ref_or_enomem(new (nothrow) IORing(submission_entries, move(vmobject), move(region)));
+}
+
+IORing::IORing(u32 submission_entries, NonnullLockRefPtr<Memory::AnonymousVMObject> vmobject, NonnullOwnPtr<Memory::Region> region)
+    : m_submission_entries(submission_entries)
+    , m_completion_entries(io_ring_completion_entries(submission_entries))
+    , m_vmobject(move(vmobject))
+    , m_region(move(region))
+{
+    auto& header = this->header();
+    header.submission_entries = m_submission_entries;
+    header.completion_entries = m_completion_entries;
+    header.submissions_offset = io_ring_header_size;
+    header.completions_offset = completions_offset();
+}
+
+IORing::~IORing() = default;
+
+bool IORing::can_read(OpenFileDescription const&, u64) const
+{
+    auto completion_head = AK::atomic_load(&header().completion_head, AK::MemoryOrder::memory_order_relaxed);
+    return completion_head != m_completion_tail.load(AK::MemoryOrder::memory_order_relaxed);
+}
+
+ErrorOr<NonnullLockRefPtr<Memory::VMObject>> IORing::vmobject_for_mmap(Process&, Memory::VirtualRange const& range, u64& offset, bool shared)
+{
+    if (!shared || offset != 0 || range.size() > m_vmobject->size())
+        return EINVAL;
+    return m_vmobject;
+}
+
+ErrorOr<NonnullOwnPtr<KString>> IORing::pseudo_path(OpenFileDescription const&) const
+{
+    return KString::formatted("IORing:({})", m_submission_entries);
+}
+
+size_t IORing::free_completion_slots() const
+{
+    VERIFY(m_lock.is_locked());
+    auto completion_head = AK::atomic_load(&header().completion_head, AK::MemoryOrder::memory_order_acquire);
+    // A completion head from the future just means userspace lied to us, treat the queue as full.
+    u32 unconsumed_completions = min(m_completion_tail.load() - completion_head, m_completion_entries);
+    return m_completion_entries - unconsumed_completions;
+}
+
+Optional<IORingSubmission> IORing::take_submission()
+{
+    VERIFY(m_lock.is_locked());
+    auto submission_tail = AK::atomic_load(&header().submission_tail, AK::MemoryOrder::memory_order_acquire);
+    if (m_submission_head == submission_tail)
+        return {};
+    // Every pending submission needs its completion slot to still be free when it's done.
+    if (free_completion_slots() <= m_pending_submissions.size())
+        return {};
+
+    auto const* submissions = reinterpret_cast<IORingSubmission const*>(m_region->vaddr().offset(io_ring_header_size).as_ptr());
+    // Take a copy, userspace may change the entry at any time.
+    IORingSubmission submission;
+    memcpy(&submission, &submissions[m_submission_head & (m_submission_entries - 1)], sizeof(submission));
+    ++m_submission_head;
+    AK::atomic_store(&header().submission_head, m_submission_head, AK::MemoryOrder::memory_order_release);
+    return submission;
+}
+
+void IORing::post_completion(u64 user_data, ErrorOr<FlatPtr> const& result)
+{
+    VERIFY(m_lock.is_locked());
+    auto completion_tail = m_completion_tail.load();
+    auto* completions = reinterpret_cast<IORingCompletion*>(m_region->vaddr().offset(completions_offset()).as_ptr());
+    auto& completion = completions[completion_tail & (m_completion_entries - 1)];
+    completion.user_data = user_data;
+    completion.result = result.is_error() ? -static_cast<i64>(result.error().code()) : static_cast<i64>(result.value());
+
+    m_completion_tail.store(completion_tail + 1);
+    AK::atomic_store(&header().completion_tail, completion_tail + 1, AK::MemoryOrder::memory_order_release);
+    evaluate_block_conditions();
+}
+
+}
@@ -0,0 +1,67 @@
+/*
+ * Copyright (c) 2022, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#pragma once
+
+#include <AK/Vector.h>
+#include <Kernel/API/IORing.h>
+#include <Kernel/FileSystem/File.h>
+#include <Kernel/Locking/Mutex.h>
+#include <Kernel/Memory/AnonymousVMObject.h>
+#include <Kernel/Memory/Region.h>
+
+namespace Kernel {
+
+// IORing is a submission and a completion queue shared with userspace, see Kernel/API/IORing.h.
+// Userspace fills in any number of submissions and then hands all of them to the kernel with
+// a single io_ring_enter(). Submissions whose file isn't ready yet are kept around, and are
+// tried again by the next io_ring_enter() of the process, which can also wait for them.
+class IORing final : public File {
+public:
+    static ErrorOr<NonnullLockRefPtr<IORing>> try_create(u32 submission_entries);
+    virtual ~IORing() override;
+
+    // Readable while there are completions that userspace hasn't consumed yet.
+    virtual bool can_read(OpenFileDescription const&, u64) const override;
+    virtual ErrorOr<size_t> read(OpenFileDescription&, u64, UserOrKernelBuffer&, size_t) override { return EINVAL; }
+    virtual bool can_write(OpenFileDescription const&, u64) const override { return true; }
+    virtual ErrorOr<size_t> write(OpenFileDescription&, u64, UserOrKernelBuffer const&, size_t) override { return EINVAL; }
+    virtual ErrorOr<NonnullLockRefPtr<Memory::VMObject>> vmobject_for_mmap(Process&, Memory::VirtualRange const&, u64& offset, bool shared) override;
+
+    virtual ErrorOr<NonnullOwnPtr<KString>> pseudo_path(OpenFileDescription const&) const override;
+    virtual StringView class_name() const override { return "IORing"sv; }
+    virtual bool is_io_ring() const override { return true; }
+
+    Mutex& lock() { return m_lock; }
+
+    // Everything below requires lock() to be held.
+
+    // Takes the next submission out of the submission queue, as long as there is room left for its completion.
+    Optional<IORingSubmission> take_submission();
+    void post_completion(u64 user_data, ErrorOr<FlatPtr> const& result);
+
+    // Submissions that have been taken but are still waiting for their file to become ready.
+    Vector<IORingSubmission>& pending_submissions() { return m_pending_submissions; }
+    size_t free_completion_slots() const;
+
+private:
+    IORing(u32 submission_entries, NonnullLockRefPtr<Memory::AnonymousVMObject>, NonnullOwnPtr<Memory::Region>);
+
+    IORingHeader& header() const { return *reinterpret_cast<IORingHeader*>(m_region->vaddr().as_ptr()); }
+    size_t completions_offset() const { return io_ring_header_size + m_submission_entries * sizeof(IORingSubmission); }
+
+    Mutex m_lock { "IORing"sv };
+    u32 m_submission_entries { 0 };
+    u32 m_completion_entries { 0 };
+    NonnullLockRefPtr<Memory::AnonymousVMObject> m_vmobject;
+    NonnullOwnPtr<Memory::Region> m_region;
+    // The copies in the header are shared with userspace, so they can't be trusted.
+    u32 m_submission_head { 0 };
+    Atomic<u32> m_completion_tail { 0 };
+    Vector<IORingSubmission> m_pending_submissions;
+};
+
+}
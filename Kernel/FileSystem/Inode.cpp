@@ -6,6 +6,7 @@
  * SPDX-License-Identifier: BSD-2-Clause
  */
 
+#include <AK/NumericLimits.h>
 #include <AK/Singleton.h>
 #include <AK/StringView.h>
 #include <Kernel/API/InodeWatcherEvent.h>
@@ -34,22 +35,63 @@ void Inode::sync_all()
     NonnullLockRefPtrVector<Inode, 32> inodes;
     Inode::all_instances().with([&](auto& all_inodes) {
         for (auto& inode : all_inodes) {
-            if (inode.is_metadata_dirty())
+            auto* page_cache = inode.existing_page_cache();
+            if (inode.is_metadata_dirty() || (page_cache && page_cache->has_dirty_pages()))
                 inodes.append(inode);
         }
     });
 
     for (auto& inode : inodes) {
-        VERIFY(inode.is_metadata_dirty());
-        (void)inode.flush_metadata();
+        // The dirty pages stay in the cache, so the next sync will try them again.
+        if (auto result = inode.write_back_cached_pages(); result.is_error())
+            dmesgln("Inode::sync_all(): Failed to write back cached pages of {}: {}", inode.identifier(), result.error());
+        if (inode.is_metadata_dirty())
+            (void)inode.flush_metadata();
+    }
+
+    if (InodePageCache::page_count_over_budget() == 0)
+        return;
+
+    // Only clean pages can be released, so do this after writing back.
+    NonnullLockRefPtrVector<Inode, 32> cached_inodes;
+    Inode::all_instances().with([&](auto& all_inodes) {
+        for (auto& inode : all_inodes) {
+            if (auto* page_cache = inode.existing_page_cache(); page_cache && page_cache->cached_page_count() > 0)
+                cached_inodes.append(inode);
+        }
+    });
+
+    for (auto& inode : cached_inodes) {
+        auto page_count_over_budget = InodePageCache::page_count_over_budget();
+        if (page_count_over_budget == 0)
+            break;
+        inode.existing_page_cache()->release_clean_pages(page_count_over_budget);
     }
 }
 
-void Inode::sync()
+size_t Inode::release_all_clean_cached_pages()
 {
+    NonnullLockRefPtrVector<Inode, 32> cached_inodes;
+    Inode::all_instances().with([&](auto& all_inodes) {
+        for (auto& inode : all_inodes) {
+            if (auto* page_cache = inode.existing_page_cache(); page_cache && page_cache->cached_page_count() > 0)
+                cached_inodes.append(inode);
+        }
+    });
+
+    size_t released_page_count = 0;
+    for (auto& inode : cached_inodes)
+        released_page_count += inode.existing_page_cache()->release_clean_pages(NumericLimits<size_t>::max());
+    return released_page_count;
+}
+
+ErrorOr<void> Inode::sync()
+{
+    TRY(write_back_cached_pages());
     if (is_metadata_dirty())
         (void)flush_metadata();
     fs().flush_writes();
+    return {};
 }
 
 ErrorOr<NonnullOwnPtr<KBuffer>> Inode::read_entire(OpenFileDescription* description) const
@@ -102,6 +144,9 @@ Inode::~Inode()
 void Inode::will_be_destroyed()
 {
     MutexLocker locker(m_inode_lock);
+    // NOTE: There's no point in writing back the contents of an inode that is about to be freed.
+    if (auto* page_cache = existing_page_cache(); page_cache && metadata().link_count != 0)
+        (void)page_cache->write_back();
     if (m_metadata_dirty)
         (void)flush_metadata();
 }
@@ -110,15 +155,126 @@ ErrorOr<size_t> Inode::write_bytes(off_t offset, size_t length, UserOrKernelBuff
 {
     MutexLocker locker(m_inode_lock);
     TRY(prepare_to_write_data());
-    return write_bytes_locked(offset, length, target_buffer, open_description);
+    auto* page_cache = this->page_cache();
+    if (!page_cache)
+        return write_bytes_locked(offset, length, target_buffer, open_description);
+
+    VERIFY(offset >= 0);
+    if (!open_description || !open_description->is_direct()) {
+        bool is_append = static_cast<u64>(offset) + length > size();
+        bool fits_in_file = !is_append;
+        if (is_append) {
+            auto grown_or_error = try_grow_for_page_cache_locked(offset + length);
+            fits_in_file = !grown_or_error.is_error() && grown_or_error.value();
+        }
+        if (fits_in_file) {
+            auto nwritten_or_error = page_cache->try_write(offset, length, target_buffer, is_append);
+            if (nwritten_or_error.is_error() && nwritten_or_error.error().code() != ENOMEM)
+                return nwritten_or_error.release_error();
+            if (!nwritten_or_error.is_error() && nwritten_or_error.value().has_value()) {
+                did_modify_contents();
+                return nwritten_or_error.value().value();
+            }
+        }
+    }
+
+    // The write has to go to the file system, so bring whatever we have cached up to date with it.
+    auto nwritten_or_error = write_bytes_locked(offset, length, target_buffer, open_description);
+    if (nwritten_or_error.is_error()) {
+        page_cache->invalidate(offset, length);
+        return nwritten_or_error.release_error();
+    }
+    TRY(page_cache->did_write_through(offset, nwritten_or_error.value(), target_buffer));
+    return nwritten_or_error.release_value();
 }
 
 ErrorOr<size_t> Inode::read_bytes(off_t offset, size_t length, UserOrKernelBuffer& buffer, OpenFileDescription* open_description) const
 {
+    auto* page_cache = this->page_cache();
+    if (page_cache && open_description && open_description->is_direct()) {
+        // Direct reads go around the page cache, so they must not miss anything that is only in there.
+        if (page_cache->has_dirty_pages()) {
+            MutexLocker locker(m_inode_lock);
+            TRY(page_cache->write_back());
+        }
+        page_cache = nullptr;
+    }
+
     MutexLocker locker(m_inode_lock, Mutex::Mode::Shared);
+    if (page_cache) {
+        VERIFY(offset >= 0);
+        auto nread_or_error = page_cache->read(offset, length, buffer);
+        if (!nread_or_error.is_error() && open_description)
+            page_cache->did_read(*open_description, offset, nread_or_error.value());
+        // If we're out of memory for the cache, simply read around it.
+        if (!nread_or_error.is_error() || nread_or_error.error().code() != ENOMEM)
+            return nread_or_error;
+    }
     return read_bytes_locked(offset, length, buffer, open_description);
 }
 
+ErrorOr<Optional<InodePageCache::PinnedBytes>> Inode::pin_cached_bytes(off_t offset, size_t length, OpenFileDescription* open_description) const
+{
+    auto* page_cache = this->page_cache();
+    if (!page_cache || (open_description && open_description->is_direct()))
+        return Optional<InodePageCache::PinnedBytes> {};
+
+    MutexLocker locker(m_inode_lock, Mutex::Mode::Shared);
+    VERIFY(offset >= 0);
+    auto pinned_or_error = page_cache->pin(offset, length);
+    if (pinned_or_error.is_error()) {
+        // If we're out of memory for the cache, the data has to be read around it.
+        if (pinned_or_error.error().code() == ENOMEM)
+            return Optional<InodePageCache::PinnedBytes> {};
+        return pinned_or_error.release_error();
+    }
+    auto pinned = pinned_or_error.release_value();
+    if (pinned.has_value() && open_description)
+        page_cache->did_read(*open_description, offset, pinned->bytes().size());
+    return pinned;
+}
+
+ErrorOr<RefPtr<Memory::PhysicalPage>> Inode::page_cache_physical_page(size_t page_index)
+{
+    VERIFY(is_page_cacheable());
+    MutexLocker locker(m_inode_lock, Mutex::Mode::Shared);
+    if (page_index * PAGE_SIZE >= size())
+        return RefPtr<Memory::PhysicalPage> {};
+    auto* page_cache = this->page_cache();
+    if (!page_cache)
+        return ENOMEM;
+    return TRY(page_cache->physical_page(page_index));
+}
+
+InodePageCache* Inode::page_cache() const
+{
+    if (!is_page_cacheable())
+        return nullptr;
+    return m_page_cache.with([&](auto& page_cache) -> InodePageCache* {
+        if (!page_cache) {
+            // NOTE: If this fails, we simply keep doing uncached I/O and try again next time.
+            auto page_cache_or_error = InodePageCache::try_create(const_cast<Inode&>(*this));
+            if (page_cache_or_error.is_error())
+                return nullptr;
+            page_cache = page_cache_or_error.release_value();
+        }
+        return page_cache.ptr();
+    });
+}
+
+InodePageCache* Inode::existing_page_cache() const
+{
+    return m_page_cache.with([](auto& page_cache) { return page_cache.ptr(); });
+}
+
+ErrorOr<void> Inode::write_back_cached_pages()
+{
+    MutexLocker locker(m_inode_lock);
+    if (auto* page_cache = existing_page_cache(); page_cache && page_cache->has_dirty_pages())
+        return page_cache->write_back();
+    return {};
+}
+
 ErrorOr<void> Inode::update_timestamps([[maybe_unused]] Optional<Time> atime, [[maybe_unused]] Optional<Time> ctime, [[maybe_unused]] Optional<Time> mtime)
 {
     return ENOTIMPL;
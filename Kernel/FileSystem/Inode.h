@@ -15,6 +15,7 @@
 #include <Kernel/FileSystem/FileSystem.h>
 #include <Kernel/FileSystem/InodeIdentifier.h>
 #include <Kernel/FileSystem/InodeMetadata.h>
+#include <Kernel/FileSystem/InodePageCache.h>
 #include <Kernel/Forward.h>
 #include <Kernel/Library/ListedRefCounted.h>
 #include <Kernel/Library/LockWeakPtr.h>
@@ -33,6 +34,7 @@ class Inode : public ListedRefCounted<Inode, LockType::Spinlock>
     friend class VirtualFileSystem;
     friend class FileSystem;
     friend class InodeFile;
+    friend class InodePageCache;
 
 public:
     virtual ~Inode();
@@ -57,6 +59,9 @@ public:
 
     ErrorOr<size_t> write_bytes(off_t, size_t, UserOrKernelBuffer const& data, OpenFileDescription*);
     ErrorOr<size_t> read_bytes(off_t, size_t, UserOrKernelBuffer& buffer, OpenFileDescription*) const;
+    // Hands out file contents straight from the page cache, so sendfile() and splice() don't
+    // have to copy them first. Returns an empty Optional if they have to be read instead.
+    ErrorOr<Optional<InodePageCache::PinnedBytes>> pin_cached_bytes(off_t, size_t, OpenFileDescription*) const;
 
     virtual ErrorOr<void> attach(OpenFileDescription&) { return {}; }
     virtual void detach(OpenFileDescription&) { }
@@ -77,6 +82,12 @@ public:
 
     virtual ErrorOr<int> get_block_address(int) { return ENOTSUP; }
 
+    // Regular files whose contents should go through an InodePageCache.
+    virtual bool is_page_cacheable() const { return false; }
+    // Returns a null page for pages past the end of the file.
+    ErrorOr<RefPtr<Memory::PhysicalPage>> page_cache_physical_page(size_t page_index);
+    static size_t release_all_clean_cached_pages();
+
     LockRefPtr<LocalSocket> bound_socket() const;
     bool bind_socket(LocalSocket&);
     bool unbind_socket();
@@ -95,7 +106,7 @@ public:
     LockRefPtr<Memory::SharedInodeVMObject> shared_vmobject() const;
 
     static void sync_all();
-    void sync();
+    ErrorOr<void> sync();
 
     bool has_watchers() const;
 
@@ -125,6 +136,18 @@ protected:
     virtual ErrorOr<size_t> write_bytes_locked(off_t, size_t, UserOrKernelBuffer const& data, OpenFileDescription*) = 0;
     virtual ErrorOr<size_t> read_bytes_locked(off_t, size_t, UserOrKernelBuffer& buffer, OpenFileDescription*) const = 0;
 
+    // Used by the page cache to move file data between itself and the file system.
+    virtual ErrorOr<size_t> read_bytes_for_page_cache_locked(off_t offset, size_t count, UserOrKernelBuffer& buffer) const { return read_bytes_locked(offset, count, buffer, nullptr); }
+    virtual ErrorOr<size_t> write_bytes_for_page_cache_locked(off_t offset, size_t count, UserOrKernelBuffer const& data) { return write_bytes_locked(offset, count, data, nullptr); }
+    // Lets a write past the end of the file be taken by the page cache. File systems that can
+    // defer choosing blocks for the new data until it is written back grow the file to `new_size`
+    // and return true, the others return false and the write goes straight to the file system.
+    virtual ErrorOr<bool> try_grow_for_page_cache_locked(u64 new_size [[maybe_unused]]) { return false; }
+
+    InodePageCache* page_cache() const;
+    InodePageCache* existing_page_cache() const;
+    ErrorOr<void> write_back_cached_pages();
+
 private:
     ErrorOr<bool> try_apply_flock(Process const&, OpenFileDescription const&, flock const&);
 
@@ -135,6 +158,7 @@ private:
     SpinlockProtected<HashTable<InodeWatcher*>> m_watchers { LockRank::None };
     bool m_metadata_dirty { false };
     LockRefPtr<FIFO> m_fifo;
+    mutable SpinlockProtected<OwnPtr<InodePageCache>> m_page_cache { LockRank::None };
     IntrusiveListNode<Inode> m_inode_list_node;
 
     struct Flock {
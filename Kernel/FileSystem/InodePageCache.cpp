@@ -0,0 +1,480 @@
+/*
+ * Copyright (c) 2022, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <AK/NumericLimits.h>
+#include <Kernel/FileSystem/Inode.h>
+#include <Kernel/FileSystem/InodePageCache.h>
+#include <Kernel/FileSystem/OpenFileDescription.h>
+#include <Kernel/Memory/MemoryManager.h>
+#include <Kernel/WorkQueue.h>
+
+namespace Kernel {
+
+// All page caches together get a slice of physical memory, which is enforced by the sync task.
+static constexpr size_t physical_memory_fraction = 8;
+static constexpr size_t maximum_total_cache_size = 128 * MiB;
+
+static Atomic<size_t> s_total_chunk_count;
+static Atomic<size_t> s_chunk_budget;
+static Atomic<u64> s_access_clock;
+
+static size_t chunk_budget()
+{
+    if (auto budget = s_chunk_budget.load(); budget != 0)
+        return budget;
+    auto physical_memory_size = MM.get_system_memory_info().physical_pages * PAGE_SIZE;
+    auto cache_size = min(physical_memory_size / physical_memory_fraction, maximum_total_cache_size);
+    auto budget = max(cache_size / InodePageCache::ChunkSize, static_cast<size_t>(1));
+    s_chunk_budget = budget;
+    return budget;
+}
+
+static u16 page_mask(size_t first_page, size_t last_page)
+{
+    VERIFY(first_page <= last_page && last_page < InodePageCache::ChunkPageCount);
+    return static_cast<u16>(((1u << (last_page + 1)) - 1) & ~((1u << first_page) - 1));
+}
+
+template<typename Callback>
+static ErrorOr<void> for_each_page_run(u16 mask, Callback callback)
+{
+    size_t page = 0;
+    while (page < InodePageCache::ChunkPageCount) {
+        if (!(mask & (1u << page))) {
+            ++page;
+            continue;
+        }
+        auto first_page = page;
+        while (page < InodePageCache::ChunkPageCount && (mask & (1u << page)))
+            ++page;
+        TRY(callback(first_page, page - 1));
+    }
+    return {};
+}
+
+size_t InodePageCache::page_count_over_budget()
+{
+    auto chunk_count = s_total_chunk_count.load();
+    auto budget = chunk_budget();
+    return chunk_count > budget ? (chunk_count - budget) * ChunkPageCount : 0;
+}
+
+size_t InodePageCache::total_cached_page_count()
+{
+    return s_total_chunk_count.load() * ChunkPageCount;
+}
+
+bool InodePageCache::Chunk::is_mapped_elsewhere() const
+{
+    for (size_t i = 0; i < ChunkPageCount; ++i) {
+        // NOTE: One reference is held by the region's VMObject, and one by `page` itself.
+        auto page = region->physical_page(i);
+        if (page && page->ref_count() > 2)
+            return true;
+    }
+    return false;
+}
+
+ErrorOr<NonnullOwnPtr<InodePageCache>> InodePageCache::try_create(Inode& inode)
+{
+    return adopt_nonnull_own_or_enomem(new (nothrow) InodePageCache(inode));
+}
+
+InodePageCache::InodePageCache(Inode& inode)
+    : m_inode(inode)
+{
+}
+
+InodePageCache::~InodePageCache()
+{
+    s_total_chunk_count.fetch_sub(m_chunk_count.load());
+}
+
+ErrorOr<NonnullRefPtr<InodePageCache::Chunk>> InodePageCache::ensure_chunk_while_locked(size_t chunk_index)
+{
+    VERIFY(m_lock.is_exclusively_locked_by_current_thread());
+    if (auto it = m_chunks.find(chunk_index); it != m_chunks.end())
+        return it->value;
+
+    // Make room in our own cache first. If other inodes are using the memory,
+    // the sync task is going to take it back from them.
+    if (page_count_over_budget() > 0)
+        release_clean_pages_while_locked(ChunkPageCount);
+
+    auto region = TRY(MM.allocate_kernel_region(ChunkSize, "Inode Page Cache"sv, Memory::Region::Access::ReadWrite, AllocationStrategy::AllocateNow));
+    auto chunk = TRY(adopt_nonnull_ref_or_enomem(new (nothrow) Chunk(move(region))));
+    TRY(m_chunks.try_set(chunk_index, chunk));
+    m_chunk_count++;
+    s_total_chunk_count++;
+    return chunk;
+}
+
+ErrorOr<void> InodePageCache::fill_while_locked(Chunk& chunk, size_t chunk_index, u16 pages)
+{
+    VERIFY(m_lock.is_exclusively_locked_by_current_thread());
+    return for_each_page_run(pages & ~chunk.valid_pages, [&](size_t first_page, size_t last_page) -> ErrorOr<void> {
+        auto* data = chunk.page_data(first_page);
+        auto length = (last_page - first_page + 1) * PAGE_SIZE;
+        auto buffer = UserOrKernelBuffer::for_kernel_buffer(data);
+        auto nread = TRY(m_inode.read_bytes_for_page_cache_locked(chunk_index * ChunkSize + first_page * PAGE_SIZE, length, buffer));
+        // Whatever is past the end of the file must read back as zeroes, both here and in mappings.
+        if (nread < length)
+            memset(data + nread, 0, length - nread);
+        chunk.valid_pages |= page_mask(first_page, last_page);
+        return {};
+    });
+}
+
+ErrorOr<NonnullRefPtr<InodePageCache::Chunk>> InodePageCache::ensure_pages(size_t chunk_index, size_t first_page, size_t last_page, u16 pages_to_skip_fill)
+{
+    auto mask = page_mask(first_page, last_page);
+    {
+        // Fast path: Cache hits only need our lock for reading.
+        MutexLocker locker(m_lock, Mutex::Mode::Shared);
+        if (auto it = m_chunks.find(chunk_index); it != m_chunks.end() && (it->value->valid_pages & mask) == mask) {
+            it->value->last_access = s_access_clock.fetch_add(1);
+            return it->value;
+        }
+    }
+
+    MutexLocker locker(m_lock);
+    auto chunk = TRY(ensure_chunk_while_locked(chunk_index));
+    chunk->last_access = s_access_clock.fetch_add(1);
+
+    // The caller overwrites these pages entirely, so don't bother reading them.
+    // They only become valid once the caller marks them dirty.
+    auto missing_pages = static_cast<u16>(mask & ~chunk->valid_pages);
+    for (size_t page = 0; page < ChunkPageCount; ++page) {
+        if (missing_pages & pages_to_skip_fill & (1u << page))
+            memset(chunk->page_data(page), 0, PAGE_SIZE);
+    }
+    TRY(fill_while_locked(*chunk, chunk_index, missing_pages & ~pages_to_skip_fill));
+    return chunk;
+}
+
+void InodePageCache::mark_dirty_while_locked(Chunk& chunk, u16 pages)
+{
+    VERIFY(m_lock.is_exclusively_locked_by_current_thread());
+    if (pages == 0)
+        return;
+    if (!chunk.is_dirty())
+        m_dirty_chunk_count++;
+    chunk.valid_pages |= pages;
+    chunk.dirty_pages |= pages;
+}
+
+ErrorOr<size_t> InodePageCache::read(u64 offset, size_t count, UserOrKernelBuffer& buffer)
+{
+    auto size = m_inode.size();
+    if (offset >= size)
+        return 0;
+    count = min(count, size - offset);
+
+    size_t nread = 0;
+    while (nread < count) {
+        auto position = offset + nread;
+        auto chunk_index = position / ChunkSize;
+        auto offset_in_chunk = position % ChunkSize;
+        auto length = min(ChunkSize - offset_in_chunk, count - nread);
+
+        auto chunk = TRY(ensure_pages(chunk_index, offset_in_chunk / PAGE_SIZE, (offset_in_chunk + length - 1) / PAGE_SIZE));
+        TRY(buffer.write(chunk->page_data(0) + offset_in_chunk, nread, length));
+        nread += length;
+    }
+    return nread;
+}
+
+ErrorOr<Optional<InodePageCache::PinnedBytes>> InodePageCache::pin(u64 offset, size_t count)
+{
+    auto size = m_inode.size();
+    if (offset >= size || count == 0)
+        return Optional<PinnedBytes> {};
+
+    auto chunk_index = offset / ChunkSize;
+    auto offset_in_chunk = offset % ChunkSize;
+    auto length = static_cast<size_t>(min<u64>(min(ChunkSize - offset_in_chunk, count), size - offset));
+    auto chunk = TRY(ensure_pages(chunk_index, offset_in_chunk / PAGE_SIZE, (offset_in_chunk + length - 1) / PAGE_SIZE));
+    ReadonlyBytes bytes { chunk->page_data(0) + offset_in_chunk, length };
+    return PinnedBytes { move(chunk), bytes };
+}
+
+void InodePageCache::did_read(OpenFileDescription& description, u64 offset, size_t nread)
+{
+    if (nread == 0)
+        return;
+    auto state = description.readahead_state();
+    u64 end = offset + nread;
+    if (offset != state.next_offset) {
+        // This doesn't look sequential (anymore), so stop reading ahead until it does again.
+        description.set_readahead_state({ .next_offset = end });
+        return;
+    }
+
+    state.next_offset = end;
+    if (state.window_size == 0)
+        state.window_size = InitialReadaheadSize;
+
+    // Start the next batch once the reader is halfway through the previous one,
+    // so the disk stays busy while the reader copies out of the cache.
+    if (state.readahead_end < end + state.window_size / 2) {
+        auto start = max(state.readahead_end, end);
+        auto target_end = end + state.window_size;
+        if (schedule_readahead(start, target_end - start)) {
+            state.readahead_end = target_end;
+            state.window_size = min(state.window_size * 2, MaximumReadaheadSize);
+        }
+    }
+    description.set_readahead_state(state);
+}
+
+bool InodePageCache::schedule_readahead(u64 offset, size_t count)
+{
+    if (offset >= m_inode.size() || page_count_over_budget() > 0)
+        return false;
+    // One readahead per inode at a time is plenty, the reader comes back for more soon enough.
+    if (m_readahead_in_progress.exchange(true))
+        return false;
+
+    NonnullLockRefPtr<Inode> inode = m_inode;
+    auto result = g_readahead_work->try_queue([this, inode, offset, count]() {
+        {
+            MutexLocker locker(inode->m_inode_lock, Mutex::Mode::Shared);
+            if (auto result = prefetch(offset, count); result.is_error())
+                dbgln("InodePageCache: Readahead of {} bytes at offset {} for {} failed: {}", count, offset, inode->identifier(), result.error());
+        }
+        m_readahead_in_progress = false;
+    });
+    if (result.is_error()) {
+        m_readahead_in_progress = false;
+        return false;
+    }
+    return true;
+}
+
+ErrorOr<void> InodePageCache::prefetch(u64 offset, size_t count)
+{
+    auto size = m_inode.size();
+    if (offset >= size)
+        return {};
+    count = min(count, size - offset);
+
+    size_t nprefetched = 0;
+    while (nprefetched < count) {
+        // Don't push other files' pages out just to read ahead in this one.
+        if (page_count_over_budget() > 0)
+            break;
+        auto position = offset + nprefetched;
+        auto chunk_index = position / ChunkSize;
+        auto offset_in_chunk = position % ChunkSize;
+        auto length = min(ChunkSize - offset_in_chunk, count - nprefetched);
+        TRY(ensure_pages(chunk_index, offset_in_chunk / PAGE_SIZE, (offset_in_chunk + length - 1) / PAGE_SIZE));
+        nprefetched += length;
+    }
+    return {};
+}
+
+ErrorOr<Optional<size_t>> InodePageCache::try_write(u64 offset, size_t count, UserOrKernelBuffer const& data, bool may_fill_partial_pages)
+{
+    auto size = m_inode.size();
+    if (count == 0 || offset + count > size)
+        return Optional<size_t> {};
+
+    // Only take writes that don't need to read anything from the disk: every page
+    // they touch has to be cached already, or be overwritten up to the end of the file.
+    // Small appends are the exception, since they would otherwise never be cached.
+    bool may_add_pages = page_count_over_budget() == 0;
+    {
+        MutexLocker locker(m_lock, Mutex::Mode::Shared);
+        for (auto page_index = offset / PAGE_SIZE; page_index <= (offset + count - 1) / PAGE_SIZE; ++page_index) {
+            auto it = m_chunks.find(page_index / ChunkPageCount);
+            if (it != m_chunks.end() && (it->value->valid_pages & (1u << (page_index % ChunkPageCount))))
+                continue;
+            u64 page_start = page_index * PAGE_SIZE;
+            u64 page_end = min(page_start + PAGE_SIZE, static_cast<u64>(size));
+            if (!may_add_pages)
+                return Optional<size_t> {};
+            if ((page_start < offset || page_end > offset + count) && !may_fill_partial_pages)
+                return Optional<size_t> {};
+        }
+    }
+
+    size_t nwritten = 0;
+    while (nwritten < count) {
+        auto position = offset + nwritten;
+        auto chunk_index = position / ChunkSize;
+        auto offset_in_chunk = position % ChunkSize;
+        auto length = min(ChunkSize - offset_in_chunk, count - nwritten);
+        auto first_page = offset_in_chunk / PAGE_SIZE;
+        auto last_page = (offset_in_chunk + length - 1) / PAGE_SIZE;
+
+        u16 overwritten_pages = 0;
+        for (auto page = first_page; page <= last_page; ++page) {
+            u64 page_start = chunk_index * ChunkSize + page * PAGE_SIZE;
+            u64 page_end = min(page_start + PAGE_SIZE, static_cast<u64>(size));
+            if (page_start >= offset && page_end <= offset + count)
+                overwritten_pages |= 1u << page;
+        }
+
+        auto chunk = TRY(ensure_pages(chunk_index, first_page, last_page, overwritten_pages));
+        auto result = data.read(chunk->page_data(0) + offset_in_chunk, nwritten, length);
+
+        MutexLocker locker(m_lock);
+        auto pages = page_mask(first_page, last_page);
+        if (result.is_error()) {
+            // Pages that were cached before may have been partially overwritten, so they
+            // have to be written back. The others never became valid in the first place.
+            mark_dirty_while_locked(*chunk, pages & chunk->valid_pages);
+            return result.release_error();
+        }
+        mark_dirty_while_locked(*chunk, pages);
+        nwritten += length;
+    }
+    return Optional<size_t> { nwritten };
+}
+
+ErrorOr<void> InodePageCache::did_write_through(u64 offset, size_t count, UserOrKernelBuffer const& data)
+{
+    // Bring cached pages up to date with what was just written to the file system.
+    for (auto page_index = offset / PAGE_SIZE; count > 0 && page_index <= (offset + count - 1) / PAGE_SIZE; ++page_index) {
+        RefPtr<Chunk> chunk;
+        {
+            MutexLocker locker(m_lock, Mutex::Mode::Shared);
+            auto it = m_chunks.find(page_index / ChunkPageCount);
+            if (it == m_chunks.end() || !(it->value->valid_pages & (1u << (page_index % ChunkPageCount))))
+                continue;
+            chunk = it->value;
+        }
+        u64 page_start = page_index * PAGE_SIZE;
+        u64 start = max(page_start, offset);
+        u64 end = min(page_start + PAGE_SIZE, offset + count);
+        auto* page_data = chunk->page_data(page_index % ChunkPageCount);
+        TRY(data.read(page_data + (start - page_start), start - offset, end - start));
+    }
+    return {};
+}
+
+void InodePageCache::invalidate(u64 offset, size_t count)
+{
+    if (count == 0)
+        return;
+    MutexLocker locker(m_lock);
+    for (auto page_index = offset / PAGE_SIZE; page_index <= (offset + count - 1) / PAGE_SIZE; ++page_index) {
+        auto it = m_chunks.find(page_index / ChunkPageCount);
+        if (it == m_chunks.end())
+            continue;
+        auto& chunk = *it->value;
+        u16 page_bit = 1u << (page_index % ChunkPageCount);
+        if (!(chunk.dirty_pages & page_bit))
+            chunk.valid_pages &= ~page_bit;
+    }
+}
+
+ErrorOr<NonnullRefPtr<Memory::PhysicalPage>> InodePageCache::physical_page(size_t page_index)
+{
+    auto chunk_index = page_index / ChunkPageCount;
+    auto page_in_chunk = page_index % ChunkPageCount;
+    auto chunk = TRY(ensure_pages(chunk_index, page_in_chunk, page_in_chunk));
+    return chunk->region->physical_page(page_in_chunk).release_nonnull();
+}
+
+bool InodePageCache::is_page_dirty(size_t page_index) const
+{
+    MutexLocker locker(m_lock, Mutex::Mode::Shared);
+    auto it = m_chunks.find(page_index / ChunkPageCount);
+    return it != m_chunks.end() && (it->value->dirty_pages & (1u << (page_index % ChunkPageCount)));
+}
+
+ErrorOr<void> InodePageCache::write_back()
+{
+    MutexLocker locker(m_lock);
+    if (!has_dirty_pages())
+        return {};
+
+    auto size = m_inode.size();
+    for (auto& it : m_chunks) {
+        auto chunk_index = it.key;
+        auto& chunk = *it.value;
+        if (!chunk.is_dirty())
+            continue;
+        TRY(for_each_page_run(chunk.dirty_pages, [&](size_t first_page, size_t last_page) -> ErrorOr<void> {
+            u64 start = chunk_index * ChunkSize + first_page * PAGE_SIZE;
+            if (start < size) {
+                auto length = min((last_page - first_page + 1) * PAGE_SIZE, size - start);
+                auto buffer = UserOrKernelBuffer::for_kernel_buffer(chunk.page_data(first_page));
+                TRY(m_inode.write_bytes_for_page_cache_locked(start, length, buffer));
+            }
+            chunk.dirty_pages &= ~page_mask(first_page, last_page);
+            return {};
+        }));
+        m_dirty_chunk_count--;
+    }
+    return {};
+}
+
+void InodePageCache::truncate(u64 new_size)
+{
+    MutexLocker locker(m_lock);
+    m_chunks.remove_all_matching([&](size_t chunk_index, NonnullRefPtr<Chunk> const& chunk) {
+        u64 chunk_start = chunk_index * ChunkSize;
+        if (chunk_start >= new_size) {
+            if (chunk->is_dirty())
+                m_dirty_chunk_count--;
+            m_chunk_count--;
+            s_total_chunk_count--;
+            return true;
+        }
+        if (chunk_start + ChunkSize <= new_size)
+            return false;
+
+        // Zero the tail of the page that now ends the file, so that growing the
+        // file again reads back zeroes. Pages past it are simply forgotten.
+        auto offset_in_chunk = new_size - chunk_start;
+        auto first_dropped_page = (offset_in_chunk + PAGE_SIZE - 1) / PAGE_SIZE;
+        memset(chunk->page_data(0) + offset_in_chunk, 0, first_dropped_page * PAGE_SIZE - offset_in_chunk);
+        if (first_dropped_page < ChunkPageCount) {
+            auto dropped_pages = page_mask(first_dropped_page, ChunkPageCount - 1);
+            bool was_dirty = chunk->is_dirty();
+            chunk->valid_pages &= ~dropped_pages;
+            chunk->dirty_pages &= ~dropped_pages;
+            if (was_dirty && !chunk->is_dirty())
+                m_dirty_chunk_count--;
+        }
+        return false;
+    });
+}
+
+size_t InodePageCache::release_clean_pages(size_t page_count)
+{
+    MutexLocker locker(m_lock);
+    return release_clean_pages_while_locked(page_count);
+}
+
+size_t InodePageCache::release_clean_pages_while_locked(size_t page_count)
+{
+    VERIFY(m_lock.is_exclusively_locked_by_current_thread());
+    size_t released_page_count = 0;
+    while (released_page_count < page_count) {
+        Optional<size_t> oldest_chunk_index;
+        u64 oldest_access = NumericLimits<u64>::max();
+        for (auto& it : m_chunks) {
+            auto& chunk = *it.value;
+            // NOTE: A reference count above one means someone is copying to or from the chunk right now.
+            if (chunk.is_dirty() || chunk.ref_count() > 1 || chunk.last_access.load() >= oldest_access || chunk.is_mapped_elsewhere())
+                continue;
+            oldest_chunk_index = it.key;
+            oldest_access = chunk.last_access.load();
+        }
+        if (!oldest_chunk_index.has_value())
+            break;
+        m_chunks.remove(*oldest_chunk_index);
+        m_chunk_count--;
+        s_total_chunk_count--;
+        released_page_count += ChunkPageCount;
+    }
+    return released_page_count;
+}
+
+}
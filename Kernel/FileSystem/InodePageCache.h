@@ -0,0 +1,142 @@
+/*
+ * Copyright (c) 2022, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#pragma once
+
+#include <AK/AtomicRefCounted.h>
+#include <AK/Error.h>
+#include <AK/HashMap.h>
+#include <AK/NonnullOwnPtr.h>
+#include <AK/NonnullRefPtr.h>
+#include <AK/Optional.h>
+#include <Kernel/Forward.h>
+#include <Kernel/Locking/Mutex.h>
+#include <Kernel/Memory/PhysicalPage.h>
+#include <Kernel/Memory/Region.h>
+#include <Kernel/UserOrKernelBuffer.h>
+
+namespace Kernel {
+
+// Tracks how a file is being read through one OpenFileDescription, so sequential
+// readers can have the page cache fill up ahead of them.
+struct ReadaheadState {
+    u64 next_offset { 0 };
+    u64 readahead_end { 0 };
+    size_t window_size { 0 };
+};
+
+// Caches the contents of a regular file in page-sized units, on behalf of both
+// read()/write() and page faults in file mappings.
+//
+// Pages are kept in chunks of ChunkPageCount pages, each of which is one kernel
+// region. read() copies straight out of that region, and shared file mappings
+// map the very same physical pages instead of reading into pages of their own.
+// Writes that land on cached pages (or overwrite whole pages) only touch the
+// cache; dirty pages are written back by the sync task, fsync() and when the
+// inode is destroyed.
+//
+// The owning inode's lock must be held for every operation: at least in shared
+// mode for reads and page lookups, in exclusive mode for everything else. The
+// cache's own lock is never held while copying to or from the caller's buffer,
+// so page faults in that buffer can safely come back in here.
+class InodePageCache {
+public:
+    static constexpr size_t ChunkPageCount = 16;
+    static constexpr size_t ChunkSize = ChunkPageCount * PAGE_SIZE;
+    static constexpr size_t InitialReadaheadSize = ChunkSize;
+    static constexpr size_t MaximumReadaheadSize = 1 * MiB;
+
+    static ErrorOr<NonnullOwnPtr<InodePageCache>> try_create(Inode&);
+    ~InodePageCache();
+
+    ErrorOr<size_t> read(u64 offset, size_t count, UserOrKernelBuffer&);
+    void did_read(OpenFileDescription&, u64 offset, size_t nread);
+
+    // Returns an empty Optional if the write can't be absorbed by the cache, in
+    // which case it has to go to the file system, followed by did_write_through().
+    // Appends may read the partially overwritten pages at either end from disk.
+    ErrorOr<Optional<size_t>> try_write(u64 offset, size_t count, UserOrKernelBuffer const&, bool may_fill_partial_pages = false);
+    ErrorOr<void> did_write_through(u64 offset, size_t count, UserOrKernelBuffer const&);
+    void invalidate(u64 offset, size_t count);
+
+    ErrorOr<NonnullRefPtr<Memory::PhysicalPage>> physical_page(size_t page_index);
+
+    ErrorOr<void> write_back();
+    void truncate(u64 new_size);
+
+    bool has_dirty_pages() const { return m_dirty_chunk_count.load() > 0; }
+    bool is_page_dirty(size_t page_index) const;
+    size_t cached_page_count() const { return m_chunk_count.load() * ChunkPageCount; }
+
+    // Drops chunks that are neither dirty, nor in use, nor mapped anywhere, oldest first,
+    // until `page_count` pages have been released. Returns the number of released pages.
+    size_t release_clean_pages(size_t page_count);
+
+    static size_t page_count_over_budget();
+    static size_t total_cached_page_count();
+
+private:
+    struct Chunk : public AtomicRefCounted<Chunk> {
+        explicit Chunk(NonnullOwnPtr<Memory::Region> region)
+            : region(move(region))
+        {
+        }
+
+        u8* page_data(size_t index) { return region->vaddr().offset(index * PAGE_SIZE).as_ptr(); }
+        bool is_dirty() const { return dirty_pages != 0; }
+        bool is_mapped_elsewhere() const;
+
+        NonnullOwnPtr<Memory::Region> region;
+        u16 valid_pages { 0 };
+        u16 dirty_pages { 0 };
+        Atomic<u64, AK::MemoryOrder::memory_order_relaxed> last_access { 0 };
+    };
+    static_assert(ChunkPageCount <= sizeof(Chunk::valid_pages) * 8);
+
+public:
+    // Cached file data that stays readable for as long as this is kept around, without
+    // any locks held. (It may still change underneath if the file is written to.)
+    class PinnedBytes {
+    public:
+        ReadonlyBytes bytes() const { return m_bytes; }
+
+    private:
+        friend class InodePageCache;
+        PinnedBytes(NonnullRefPtr<Chunk> chunk, ReadonlyBytes bytes)
+            : m_chunk(move(chunk))
+            , m_bytes(bytes)
+        {
+        }
+
+        NonnullRefPtr<Chunk> m_chunk;
+        ReadonlyBytes m_bytes;
+    };
+
+    // Returns the data at `offset`, up to `count` bytes or the end of its chunk, reading it
+    // in first if needed. Returns an empty Optional at the end of the file.
+    ErrorOr<Optional<PinnedBytes>> pin(u64 offset, size_t count);
+
+private:
+
+    explicit InodePageCache(Inode&);
+
+    ErrorOr<NonnullRefPtr<Chunk>> ensure_chunk_while_locked(size_t chunk_index);
+    ErrorOr<void> fill_while_locked(Chunk&, size_t chunk_index, u16 pages);
+    bool schedule_readahead(u64 offset, size_t count);
+    ErrorOr<void> prefetch(u64 offset, size_t count);
+    ErrorOr<NonnullRefPtr<Chunk>> ensure_pages(size_t chunk_index, size_t first_page, size_t last_page, u16 pages_to_skip_fill = 0);
+    void mark_dirty_while_locked(Chunk&, u16 pages);
+    size_t release_clean_pages_while_locked(size_t page_count);
+
+    Inode& m_inode;
+    mutable Mutex m_lock { "InodePageCache"sv };
+    HashMap<size_t, NonnullRefPtr<Chunk>> m_chunks;
+    Atomic<size_t> m_chunk_count { 0 };
+    Atomic<size_t> m_dirty_chunk_count { 0 };
+    Atomic<bool> m_readahead_in_progress { false };
+};
+
+}
@@ -41,6 +41,8 @@ public:
     void set_rw_mode(int options);
 
     ErrorOr<void> close();
+    // Drops the epoll watches that were added through this fd, the description itself may still be open elsewhere.
+    void did_close_fd(ProcessID, int fd);
 
     ErrorOr<off_t> seek(off_t, int whence);
     ErrorOr<size_t> read(UserOrKernelBuffer&, size_t);
@@ -65,6 +67,9 @@ public:
 
     bool is_direct() const;
 
+    ReadaheadState readahead_state() const;
+    void set_readahead_state(ReadaheadState const&);
+
     bool is_directory() const;
 
     File& file() { return *m_file; }
@@ -82,6 +87,12 @@ public:
     InodeWatcher const* inode_watcher() const;
     InodeWatcher* inode_watcher();
 
+    bool is_event_poll() const;
+    EventPoll* event_poll();
+
+    bool is_io_ring() const;
+    IORing* io_ring();
+
     bool is_master_pty() const;
     MasterPTY const* master_pty() const;
     MasterPTY* master_pty();
@@ -155,6 +166,7 @@ private:
         bool should_append : 1 { false };
         bool direct : 1 { false };
         FIFO::Direction fifo_direction : 2 { FIFO::Direction::Neither };
+        ReadaheadState readahead;
     };
 
     SpinlockProtected<State> m_state { LockRank::None };
@@ -27,6 +27,7 @@ ErrorOr<void> SysFSMemoryStatus::try_generate(KBufferBuilder& builder)
     get_kmalloc_stats(stats);
 
     auto system_memory = MM.get_system_memory_info();
+    auto large_pages = MM.get_large_page_statistics();
 
     auto json = TRY(JsonObjectSerializer<>::try_create(builder));
     TRY(json.add("kmalloc_allocated"sv, stats.bytes_allocated));
@@ -35,8 +36,24 @@ ErrorOr<void> SysFSMemoryStatus::try_generate(KBufferBuilder& builder)
     TRY(json.add("physical_available"sv, system_memory.physical_pages - system_memory.physical_pages_used));
     TRY(json.add("physical_committed"sv, system_memory.physical_pages_committed));
     TRY(json.add("physical_uncommitted"sv, system_memory.physical_pages_uncommitted));
+    TRY(json.add("large_page_size"sv, Memory::large_page_size));
+    TRY(json.add("large_pages_mapped"sv, large_pages.mapped));
+    TRY(json.add("large_page_allocations"sv, large_pages.allocations));
+    TRY(json.add("large_page_allocation_failures"sv, large_pages.allocation_failures));
+    TRY(json.add("large_page_splits"sv, large_pages.splits));
+    TRY(json.add("large_page_collapses"sv, large_pages.collapses));
     TRY(json.add("kmalloc_call_count"sv, stats.kmalloc_call_count));
     TRY(json.add("kfree_call_count"sv, stats.kfree_call_count));
+    auto slabheaps = TRY(json.add_array("kmalloc_slabheaps"sv));
+    for (auto const& slabheap : stats.slabheaps) {
+        auto slabheap_object = TRY(slabheaps.add_object());
+        TRY(slabheap_object.add("slab_size"sv, slabheap.slab_size));
+        TRY(slabheap_object.add("magazine_hits"sv, slabheap.magazine_hits));
+        TRY(slabheap_object.add("magazine_misses"sv, slabheap.magazine_misses));
+        TRY(slabheap_object.add("magazine_cached_count"sv, slabheap.magazine_cached_count));
+        TRY(slabheap_object.finish());
+    }
+    TRY(slabheaps.finish());
     TRY(json.finish());
     return {};
 }
@@ -0,0 +1,32 @@
+/*
+ * Copyright (c) 2022, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <Kernel/FileSystem/SysFS/Subsystems/Kernel/Variables/LoopbackFaultInjection.h>
+#include <Kernel/Net/LoopbackAdapter.h>
+#include <Kernel/Sections.h>
+
+namespace Kernel {
+
+UNMAP_AFTER_INIT SysFSLoopbackFaultInjection::SysFSLoopbackFaultInjection(SysFSDirectory const& parent_directory)
+    : SysFSSystemBoolean(parent_directory)
+{
+}
+
+UNMAP_AFTER_INIT NonnullLockRefPtr<SysFSLoopbackFaultInjection> SysFSLoopbackFaultInjection::must_create(SysFSDirectory const& parent_directory)
+{
+    return adopt_lock_ref_if_nonnull(new (nothrow) SysFSLoopbackFaultInjection(parent_directory)).release_nonnull();
+}
+
+bool SysFSLoopbackFaultInjection::value() const
+{
+    return g_loopback_fault_injection.load();
+}
+void SysFSLoopbackFaultInjection::set_value(bool new_value)
+{
+    g_loopback_fault_injection.store(new_value);
+}
+
+}
@@ -19,14 +19,17 @@ class Custody;
 class Device;
 class DiskCache;
 class DoubleBuffer;
+class EventPoll;
 class File;
 class FATInode;
+class IORing;
 class OpenFileDescription;
 class DisplayConnector;
 class FileSystem;
 class FutexQueue;
 class IPv4Socket;
 class Inode;
+class InodePageCache;
 class InodeIdentifier;
 class InodeWatcher;
 class Jail;
@@ -80,6 +83,7 @@ class PhysicalPage;
 class PhysicalRegion;
 class PrivateInodeVMObject;
 class Region;
+class RegionTree;
 class SharedInodeVMObject;
 class VMObject;
 class VirtualRange;
@@ -30,60 +30,60 @@ bool FutexQueue::should_add_blocker(Thread::Blocker& b, void*)
     return true;
 }
 
-ErrorOr<u32> FutexQueue::wake_n_requeue(u32 wake_count, Function<ErrorOr<FutexQueue*>()> const& get_target_queue, u32 requeue_count, bool& is_empty, bool& is_empty_target)
+u32 FutexQueue::wake_n_requeue(u32 wake_count, FutexQueue* target_futex_queue, u32 requeue_count, bool& is_empty, bool& is_empty_target)
 {
+    VERIFY(target_futex_queue != this);
     is_empty_target = false;
     SpinlockLocker lock(m_lock);
 
     dbgln_if(FUTEXQUEUE_DEBUG, "FutexQueue @ {}: wake_n_requeue({}, {})", this, wake_count, requeue_count);
 
     u32 did_wake = 0, did_requeue = 0;
-    unblock_all_blockers_whose_conditions_are_met_locked([&](Thread::Blocker& b, void*, bool& stop_iterating) {
-        VERIFY(b.blocker_type() == Thread::Blocker::Type::Futex);
-        auto& blocker = static_cast<Thread::FutexBlocker&>(b);
-
-        dbgln_if(FUTEXQUEUE_DEBUG, "FutexQueue @ {}: wake_n_requeue unblocking {}", this, blocker.thread());
-        VERIFY(did_wake < wake_count);
-        if (blocker.unblock()) {
-            if (++did_wake >= wake_count)
-                stop_iterating = true;
-            return true;
-        }
-        return false;
-    });
-    is_empty = is_empty_and_no_imminent_waits_locked();
-    if (requeue_count > 0) {
+    if (wake_count > 0) {
+        unblock_all_blockers_whose_conditions_are_met_locked([&](Thread::Blocker& b, void*, bool& stop_iterating) {
+            VERIFY(b.blocker_type() == Thread::Blocker::Type::Futex);
+            auto& blocker = static_cast<Thread::FutexBlocker&>(b);
+
+            dbgln_if(FUTEXQUEUE_DEBUG, "FutexQueue @ {}: wake_n_requeue unblocking {}", this, blocker.thread());
+            VERIFY(did_wake < wake_count);
+            if (blocker.unblock()) {
+                if (++did_wake >= wake_count)
+                    stop_iterating = true;
+                return true;
+            }
+            return false;
+        });
+    }
+    if (requeue_count > 0 && target_futex_queue) {
         auto blockers_to_requeue = do_take_blockers(requeue_count);
         if (!blockers_to_requeue.is_empty()) {
-            if (auto* target_futex_queue = TRY(get_target_queue())) {
-                dbgln_if(FUTEXQUEUE_DEBUG, "FutexQueue @ {}: wake_n_requeue requeueing {} blockers to {}", this, blockers_to_requeue.size(), target_futex_queue);
-
-                // While still holding m_lock, notify each blocker
-                for (auto& info : blockers_to_requeue) {
-                    VERIFY(info.blocker->blocker_type() == Thread::Blocker::Type::Futex);
-                    auto& blocker = *static_cast<Thread::FutexBlocker*>(info.blocker);
-                    blocker.begin_requeue();
-                }
-
-                lock.unlock();
-                did_requeue = blockers_to_requeue.size();
-
-                SpinlockLocker target_lock(target_futex_queue->m_lock);
-                // Now that we have the lock of the target, append the blockers
-                // and notify them that they completed the move
-                for (auto& info : blockers_to_requeue) {
-                    VERIFY(info.blocker->blocker_type() == Thread::Blocker::Type::Futex);
-                    auto& blocker = *static_cast<Thread::FutexBlocker*>(info.blocker);
-                    blocker.finish_requeue(*target_futex_queue);
-                }
-                target_futex_queue->do_append_blockers(move(blockers_to_requeue));
-                is_empty_target = target_futex_queue->is_empty_and_no_imminent_waits_locked();
-            } else {
-                dbgln_if(FUTEXQUEUE_DEBUG, "FutexQueue @ {}: wake_n_requeue could not get target queue to requeue {} blockers", this, blockers_to_requeue.size());
-                do_append_blockers(move(blockers_to_requeue));
+            dbgln_if(FUTEXQUEUE_DEBUG, "FutexQueue @ {}: wake_n_requeue requeueing {} blockers to {}", this, blockers_to_requeue.size(), target_futex_queue);
+
+            // While still holding m_lock, notify each blocker
+            for (auto& info : blockers_to_requeue) {
+                VERIFY(info.blocker->blocker_type() == Thread::Blocker::Type::Futex);
+                auto& blocker = *static_cast<Thread::FutexBlocker*>(info.blocker);
+                blocker.begin_requeue();
+            }
+
+            is_empty = is_empty_and_no_imminent_waits_locked();
+            lock.unlock();
+            did_requeue = blockers_to_requeue.size();
+
+            SpinlockLocker target_lock(target_futex_queue->m_lock);
+            // Now that we have the lock of the target, append the blockers
+            // and notify them that they completed the move
+            for (auto& info : blockers_to_requeue) {
+                VERIFY(info.blocker->blocker_type() == Thread::Blocker::Type::Futex);
+                auto& blocker = *static_cast<Thread::FutexBlocker*>(info.blocker);
+                blocker.finish_requeue(*target_futex_queue);
             }
+            target_futex_queue->do_append_blockers(move(blockers_to_requeue));
+            is_empty_target = target_futex_queue->is_empty_and_no_imminent_waits_locked();
+            return did_wake + did_requeue;
         }
     }
+    is_empty = is_empty_and_no_imminent_waits_locked();
     return did_wake + did_requeue;
 }
 
@@ -132,6 +132,47 @@ u32 FutexQueue::wake_all(bool& is_empty)
     return did_wake;
 }
 
+LockRefPtr<Thread> FutexQueue::highest_priority_waiter(bool& has_other_waiters, u32& other_waiters_priority)
+{
+    SpinlockLocker lock(m_lock);
+    Thread* best_thread = nullptr;
+    size_t waiter_count = 0;
+    other_waiters_priority = 0;
+    // This never unblocks anything, it's just the only way to look at all the blockers.
+    unblock_all_blockers_whose_conditions_are_met_locked([&](Thread::Blocker& b, void*, bool&) {
+        VERIFY(b.blocker_type() == Thread::Blocker::Type::Futex);
+        auto& thread = b.thread();
+        ++waiter_count;
+        if (!best_thread || thread.effective_priority() > best_thread->effective_priority()) {
+            if (best_thread)
+                other_waiters_priority = max(other_waiters_priority, best_thread->effective_priority());
+            best_thread = &thread;
+        } else {
+            other_waiters_priority = max(other_waiters_priority, thread.effective_priority());
+        }
+        return false;
+    });
+    // Someone who is just about to block has to be woken up by the next owner as well.
+    has_other_waiters = waiter_count > 1 || m_imminent_waits > 0;
+    return best_thread;
+}
+
+bool FutexQueue::wake_thread(Thread& thread, bool& is_empty)
+{
+    SpinlockLocker lock(m_lock);
+    bool did_wake = false;
+    unblock_all_blockers_whose_conditions_are_met_locked([&](Thread::Blocker& b, void*, bool& stop_iterating) {
+        VERIFY(b.blocker_type() == Thread::Blocker::Type::Futex);
+        if (&b.thread() != &thread)
+            return false;
+        stop_iterating = true;
+        did_wake = static_cast<Thread::FutexBlocker&>(b).unblock();
+        return did_wake;
+    });
+    is_empty = is_empty_and_no_imminent_waits_locked();
+    return did_wake;
+}
+
 bool FutexQueue::is_empty_and_no_imminent_waits_locked()
 {
     return m_imminent_waits == 0 && is_empty_locked();
@@ -146,6 +187,13 @@ bool FutexQueue::queue_imminent_wait()
     return true;
 }
 
+void FutexQueue::cancel_imminent_wait()
+{
+    SpinlockLocker lock(m_lock);
+    VERIFY(m_imminent_waits > 0);
+    m_imminent_waits--;
+}
+
 bool FutexQueue::try_remove()
 {
     SpinlockLocker lock(m_lock);
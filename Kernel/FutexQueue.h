@@ -19,10 +19,14 @@ public:
     FutexQueue();
     virtual ~FutexQueue();
 
-    ErrorOr<u32> wake_n_requeue(u32, Function<ErrorOr<FutexQueue*>()> const&, u32, bool&, bool&);
+    u32 wake_n_requeue(u32, FutexQueue*, u32, bool&, bool&);
     u32 wake_n(u32, Optional<u32> const&, bool&);
     u32 wake_all(bool&);
 
+    // For priority-inheriting futexes, which hand the lock over to their most important waiter.
+    LockRefPtr<Thread> highest_priority_waiter(bool& has_other_waiters, u32& other_waiters_priority);
+    bool wake_thread(Thread&, bool& is_empty);
+
     template<class... Args>
     Thread::BlockResult wait_on(Thread::BlockTimeout const& timeout, Args&&... args)
     {
@@ -30,6 +34,7 @@ public:
     }
 
     bool queue_imminent_wait();
+    void cancel_imminent_wait();
     bool try_remove();
 
     bool is_empty_and_no_imminent_waits()
@@ -10,6 +10,7 @@
 #include <Kernel/Debug.h>
 #include <Kernel/Heap/Heap.h>
 #include <Kernel/Heap/kmalloc.h>
+#include <Kernel/InterruptDisabler.h>
 #include <Kernel/KSyms.h>
 #include <Kernel/Locking/Spinlock.h>
 #include <Kernel/Memory/MemoryManager.h>
@@ -204,6 +205,29 @@ private:
     KmallocSlabBlock::List m_full_blocks;
 };
 
+// Every processor keeps a magazine of free slabs for each slabheap, so most small
+// allocations and deallocations are served without taking s_lock. Magazines are
+// refilled from (and flushed to) the slabheaps in batches, and are only ever touched
+// by their own processor, with interrupts disabled.
+struct KmallocMagazine {
+    static constexpr size_t capacity = 32;
+    static constexpr size_t batch_size = capacity / 2;
+
+    void* slabs[capacity];
+    size_t count { 0 };
+    size_t hits { 0 };
+    size_t misses { 0 };
+};
+
+struct KmallocPerProcessorData {
+    KmallocMagazine magazines[KMALLOC_SLABHEAP_COUNT];
+    size_t kmalloc_call_count { 0 };
+    size_t kfree_call_count { 0 };
+    size_t nested_kfree_calls { 0 };
+};
+
+static KmallocPerProcessorData s_per_processor_data[MAX_CPU_COUNT];
+
 struct KmallocGlobalData {
     static constexpr size_t minimum_subheap_size = 1 * MiB;
 
@@ -223,11 +247,8 @@ struct KmallocGlobalData {
     void* allocate(size_t size)
     {
         VERIFY(!expansion_in_progress);
-
-        for (auto& slabheap : slabheaps) {
-            if (size <= slabheap.slab_size())
-                return slabheap.allocate();
-        }
+        // NOTE: Sizes that fit into a slabheap are handled by the magazines.
+        VERIFY(!slabheap_index_for_size(size).has_value());
 
         for (auto& subheap : subheaps) {
             if (auto* ptr = subheap.allocator.allocate(size))
@@ -236,6 +257,12 @@ struct KmallocGlobalData {
 
         // NOTE: This size calculation is a mirror of kmalloc_aligned(KmallocSlabBlock)
         if (size <= KmallocSlabBlock::block_size * 2 + sizeof(ptrdiff_t) + sizeof(size_t)) {
+            // Slabs sitting in our magazines keep their blocks alive, so give them back first.
+            // NOTE: The magazines of other processors are out of reach, as they don't take s_lock.
+            auto& per_processor = s_per_processor_data[Processor::current_id()];
+            for (size_t i = 0; i < KMALLOC_SLABHEAP_COUNT; ++i)
+                flush_magazine(per_processor.magazines[i], i, per_processor.magazines[i].count);
+
             // FIXME: We should propagate a freed pointer, to find the specific subheap it belonged to
             //        This would save us iterating over them in the next step and remove a recursion
             bool did_purge = false;
@@ -261,11 +288,7 @@ struct KmallocGlobalData {
     {
         VERIFY(!expansion_in_progress);
         VERIFY(is_valid_kmalloc_address(VirtualAddress { ptr }));
-
-        for (auto& slabheap : slabheaps) {
-            if (size <= slabheap.slab_size())
-                return slabheap.deallocate(ptr);
-        }
+        VERIFY(!slabheap_index_for_size(size).has_value());
 
         for (auto& subheap : subheaps) {
             if (subheap.allocator.contains(ptr)) {
@@ -277,6 +300,29 @@ struct KmallocGlobalData {
         PANIC("Bogus pointer passed to kfree_sized({:p}, {})", ptr, size);
     }
 
+    Optional<size_t> slabheap_index_for_size(size_t size) const
+    {
+        for (size_t i = 0; i < KMALLOC_SLABHEAP_COUNT; ++i) {
+            if (size <= slabheaps[i].slab_size())
+                return i;
+        }
+        return {};
+    }
+
+    void refill_magazine(KmallocMagazine& magazine, size_t slabheap_index)
+    {
+        VERIFY(!expansion_in_progress);
+        while (magazine.count < KmallocMagazine::batch_size)
+            magazine.slabs[magazine.count++] = slabheaps[slabheap_index].allocate();
+    }
+
+    void flush_magazine(KmallocMagazine& magazine, size_t slabheap_index, size_t count)
+    {
+        VERIFY(count <= magazine.count);
+        for (size_t i = 0; i < count; ++i)
+            slabheaps[slabheap_index].deallocate(magazine.slabs[--magazine.count]);
+    }
+
     size_t allocated_bytes() const
     {
         size_t total = 0;
@@ -392,7 +438,7 @@ struct KmallocGlobalData {
 
     KmallocSubheap::List subheaps;
 
-    KmallocSlabheap slabheaps[6] = { 16, 32, 64, 128, 256, 512 };
+    KmallocSlabheap slabheaps[KMALLOC_SLABHEAP_COUNT] = { 16, 32, 64, 128, 256, 512 };
 
     bool expansion_in_progress { false };
 };
@@ -400,9 +446,6 @@ struct KmallocGlobalData {
 READONLY_AFTER_INIT static KmallocGlobalData* g_kmalloc_global;
 alignas(KmallocGlobalData) static u8 g_kmalloc_global_heap[sizeof(KmallocGlobalData)];
 
-static size_t g_kmalloc_call_count;
-static size_t g_kfree_call_count;
-static size_t g_nested_kfree_calls;
 bool g_dump_kmalloc_stacks;
 
 void kmalloc_enable_expand()
@@ -426,15 +469,32 @@ void* kmalloc(size_t size)
         Processor::verify_no_spinlocks_held();
     }
 
-    SpinlockLocker lock(s_lock);
-    ++g_kmalloc_call_count;
+    InterruptDisabler disabler;
+    auto& per_processor = s_per_processor_data[Processor::current_id()];
+    ++per_processor.kmalloc_call_count;
 
     if (g_dump_kmalloc_stacks && Kernel::g_kernel_symbols_available) {
+        SpinlockLocker lock(s_lock);
         dbgln("kmalloc({})", size);
         Kernel::dump_backtrace();
     }
 
-    void* ptr = g_kmalloc_global->allocate(size);
+    void* ptr = nullptr;
+    if (auto slabheap_index = g_kmalloc_global->slabheap_index_for_size(size); slabheap_index.has_value()) {
+        auto& magazine = per_processor.magazines[*slabheap_index];
+        if (magazine.count == 0) {
+            ++magazine.misses;
+            SpinlockLocker lock(s_lock);
+            g_kmalloc_global->refill_magazine(magazine, *slabheap_index);
+        } else {
+            ++magazine.hits;
+        }
+        ptr = magazine.slabs[--magazine.count];
+        memset(ptr, KMALLOC_SCRUB_BYTE, g_kmalloc_global->slabheaps[*slabheap_index].slab_size());
+    } else {
+        SpinlockLocker lock(s_lock);
+        ptr = g_kmalloc_global->allocate(size);
+    }
 
     Thread* current_thread = Thread::current();
     if (!current_thread)
@@ -473,11 +533,12 @@ void kfree_sized(void* ptr, size_t size)
         Processor::verify_no_spinlocks_held();
     }
 
-    SpinlockLocker lock(s_lock);
-    ++g_kfree_call_count;
-    ++g_nested_kfree_calls;
+    InterruptDisabler disabler;
+    auto& per_processor = s_per_processor_data[Processor::current_id()];
+    ++per_processor.kfree_call_count;
+    ++per_processor.nested_kfree_calls;
 
-    if (g_nested_kfree_calls == 1) {
+    if (per_processor.nested_kfree_calls == 1) {
         Thread* current_thread = Thread::current();
         if (!current_thread)
             current_thread = Processor::idle_thread();
@@ -487,8 +548,20 @@ void kfree_sized(void* ptr, size_t size)
         }
     }
 
-    g_kmalloc_global->deallocate(ptr, size);
-    --g_nested_kfree_calls;
+    if (auto slabheap_index = g_kmalloc_global->slabheap_index_for_size(size); slabheap_index.has_value()) {
+        VERIFY(g_kmalloc_global->is_valid_kmalloc_address(VirtualAddress { ptr }));
+        auto& magazine = per_processor.magazines[*slabheap_index];
+        if (magazine.count == KmallocMagazine::capacity) {
+            SpinlockLocker lock(s_lock);
+            g_kmalloc_global->flush_magazine(magazine, *slabheap_index, KmallocMagazine::batch_size);
+        }
+        memset(ptr, KFREE_SCRUB_BYTE, g_kmalloc_global->slabheaps[*slabheap_index].slab_size());
+        magazine.slabs[magazine.count++] = ptr;
+    } else {
+        SpinlockLocker lock(s_lock);
+        g_kmalloc_global->deallocate(ptr, size);
+    }
+    --per_processor.nested_kfree_calls;
 }
 
 size_t kmalloc_good_size(size_t size)
@@ -585,6 +658,26 @@ void get_kmalloc_stats(kmalloc_stats& stats)
     SpinlockLocker lock(s_lock);
     stats.bytes_allocated = g_kmalloc_global->allocated_bytes();
     stats.bytes_free = g_kmalloc_global->free_bytes();
-    stats.kmalloc_call_count = g_kmalloc_call_count;
-    stats.kfree_call_count = g_kfree_call_count;
+    stats.kmalloc_call_count = 0;
+    stats.kfree_call_count = 0;
+    for (size_t i = 0; i < KMALLOC_SLABHEAP_COUNT; ++i)
+        stats.slabheaps[i] = { g_kmalloc_global->slabheaps[i].slab_size(), 0, 0, 0 };
+
+    // NOTE: The other processors keep updating their counters while we read them, so these are only a snapshot.
+    for (auto const& per_processor : s_per_processor_data) {
+        stats.kmalloc_call_count += per_processor.kmalloc_call_count;
+        stats.kfree_call_count += per_processor.kfree_call_count;
+        for (size_t i = 0; i < KMALLOC_SLABHEAP_COUNT; ++i) {
+            auto const& magazine = per_processor.magazines[i];
+            stats.slabheaps[i].magazine_hits += magazine.hits;
+            stats.slabheaps[i].magazine_misses += magazine.misses;
+            stats.slabheaps[i].magazine_cached_count += magazine.count;
+        }
+    }
+
+    // Slabs in magazines are allocated as far as the slabheaps are concerned, but they are free for everyone else.
+    for (auto const& slabheap_stats : stats.slabheaps) {
+        stats.bytes_allocated -= slabheap_stats.magazine_cached_count * slabheap_stats.slab_size;
+        stats.bytes_free += slabheap_stats.magazine_cached_count * slabheap_stats.slab_size;
+    }
 }
@@ -42,11 +42,21 @@ void kmalloc_init();
 
 void kfree_sized(void*, size_t);
 
+constexpr size_t KMALLOC_SLABHEAP_COUNT = 6;
+
+struct kmalloc_slabheap_stats {
+    size_t slab_size;
+    size_t magazine_hits;
+    size_t magazine_misses;
+    size_t magazine_cached_count;
+};
+
 struct kmalloc_stats {
     size_t bytes_allocated;
     size_t bytes_free;
     size_t kmalloc_call_count;
     size_t kfree_call_count;
+    kmalloc_slabheap_stats slabheaps[KMALLOC_SLABHEAP_COUNT];
 };
 void get_kmalloc_stats(kmalloc_stats&);
 
@@ -309,6 +309,66 @@ ErrorOr<void> AnonymousVMObject::set_should_cow(size_t page_index, bool cow)
     return {};
 }
 
+// Returns whether the pages starting at `page_index` are a single naturally aligned,
+// physically contiguous run that can be mapped as one large page.
+bool AnonymousVMObject::is_backed_by_large_page(size_t page_index) const
+{
+    VERIFY(m_lock.is_locked_by_current_processor());
+    if (page_index + pages_per_large_page > page_count())
+        return false;
+
+    auto const& first_page = physical_pages()[page_index];
+    if (!first_page || first_page->is_shared_zero_page() || first_page->is_lazy_committed_page())
+        return false;
+    auto base = first_page->paddr();
+    if (base.get() % large_page_size != 0)
+        return false;
+
+    for (size_t i = 1; i < pages_per_large_page; ++i) {
+        auto const& page = physical_pages()[page_index + i];
+        if (!page || page->paddr() != base.offset(i * PAGE_SIZE))
+            return false;
+    }
+    return true;
+}
+
+// Backs the pages starting at `page_index` with a freshly allocated large page, as long as none of
+// them has been touched yet. Nothing is changed if that isn't possible.
+bool AnonymousVMObject::try_populate_large_page(size_t page_index)
+{
+    SpinlockLocker lock(m_lock);
+
+    if (is_volatile() || page_index + pages_per_large_page > page_count())
+        return false;
+
+    // Either all of the pages are still committed but unallocated, or none of them are.
+    bool is_committed = physical_pages()[page_index]->is_lazy_committed_page();
+    for (size_t i = 0; i < pages_per_large_page; ++i) {
+        auto const& page = physical_pages()[page_index + i];
+        if (is_committed ? !page->is_lazy_committed_page() : !page->is_shared_zero_page())
+            return false;
+    }
+
+    Optional<NonnullRefPtrVector<PhysicalPage>> large_page;
+    if (is_committed) {
+        large_page = m_unused_committed_pages->try_take_large_page();
+    } else {
+        auto large_page_or_error = MM.allocate_large_physical_page();
+        if (!large_page_or_error.is_error())
+            large_page = large_page_or_error.release_value();
+    }
+    if (!large_page.has_value())
+        return false;
+
+    for (size_t i = 0; i < pages_per_large_page; ++i) {
+        physical_pages()[page_index + i] = large_page->ptr_at(i);
+        // The new pages aren't shared with anyone, so there's nothing to copy on write.
+        if (!m_cow_map.is_null())
+            m_cow_map.set(page_index + i, false);
+    }
+    return true;
+}
+
 size_t AnonymousVMObject::cow_pages() const
 {
     if (m_cow_map.is_null())
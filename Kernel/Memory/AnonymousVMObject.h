@@ -31,6 +31,9 @@ public:
     bool should_cow(size_t page_index, bool) const;
     ErrorOr<void> set_should_cow(size_t page_index, bool);
 
+    bool is_backed_by_large_page(size_t page_index) const;
+    bool try_populate_large_page(size_t page_index);
+
     bool is_purgeable() const { return m_purgeable; }
     bool is_volatile() const { return m_volatile; }
 
@@ -577,7 +577,7 @@ PageTableEntry* MemoryManager::ensure_pte(PageDirectory& page_directory, Virtual
 
     auto* pd = quickmap_pd(page_directory, page_directory_table_index);
     auto& pde = pd[page_directory_index];
-    if (pde.is_present())
+    if (pde.is_present() && !pde.is_huge())
         return &quickmap_pt(PhysicalAddress(pde.page_table_base()))[page_table_index];
 
     bool did_purge = false;
@@ -594,13 +594,39 @@ PageTableEntry* MemoryManager::ensure_pte(PageDirectory& page_directory, Virtual
         pd = quickmap_pd(page_directory, page_directory_table_index);
         VERIFY(&pde == &pd[page_directory_index]); // Sanity check
 
-        VERIFY(!pde.is_present()); // Should have not changed
+        VERIFY(!pde.is_present() || pde.is_huge()); // Should have not changed
     }
-    pde.set_page_table_base(page_table->paddr().get());
-    pde.set_user_allowed(true);
-    pde.set_present(true);
-    pde.set_writable(true);
-    pde.set_global(&page_directory == m_kernel_page_directory.ptr());
+
+    PageDirectoryEntry new_pde;
+    new_pde.clear();
+    new_pde.set_page_table_base(page_table->paddr().get());
+    new_pde.set_user_allowed(true);
+    new_pde.set_present(true);
+    new_pde.set_writable(true);
+    new_pde.set_global(&page_directory == m_kernel_page_directory.ptr());
+
+    if (pde.is_present()) {
+        // Split the large page into a page table that maps the same memory the same way,
+        // so that individual pages can be changed from here on.
+        auto* entries = quickmap_pt(page_table->paddr());
+        for (size_t i = 0; i < pages_per_large_page; ++i) {
+            auto& pte = entries[i];
+            pte.set_physical_page_base(pde.large_page_base() + i * PAGE_SIZE);
+            pte.set_present(true);
+            pte.set_writable(pde.is_writable());
+            pte.set_user_allowed(pde.is_user_allowed());
+            pte.set_write_through(pde.is_write_through());
+            pte.set_cache_disabled(pde.is_cache_disabled());
+            pte.set_global(pde.is_global());
+            pte.set_execute_disabled(pde.is_execute_disabled());
+            pte.set_pat(pde.is_large_page_pat());
+        }
+        --m_large_pages_mapped;
+        ++m_large_page_splits;
+    }
+
+    // NOTE: The new entry is written in one go, since other processors may be walking this page directory.
+    pde = new_pde;
 
     // NOTE: This leaked ref is matched by the unref in MemoryManager::release_pte()
     (void)page_table.leak_ref();
@@ -619,6 +645,8 @@ void MemoryManager::release_pte(PageDirectory& page_directory, VirtualAddress va
     auto* pd = quickmap_pd(page_directory, page_directory_table_index);
     PageDirectoryEntry& pde = pd[page_directory_index];
     if (pde.is_present()) {
+        // NOTE: Large pages are only used for 2 MiB that belong to a single region, which releases them as a whole.
+        VERIFY(!pde.is_huge());
         auto* page_table = quickmap_pt(PhysicalAddress((FlatPtr)pde.page_table_base()));
         auto& pte = page_table[page_table_index];
         pte.clear();
@@ -641,6 +669,109 @@ void MemoryManager::release_pte(PageDirectory& page_directory, VirtualAddress va
     }
 }
 
+void MemoryManager::map_large_page(PageDirectory& page_directory, VirtualAddress vaddr, PageDirectoryEntry const& entry)
+{
+    VERIFY_INTERRUPTS_DISABLED();
+    VERIFY(page_directory.get_lock().is_locked_by_current_processor());
+    VERIFY(vaddr.get() % large_page_size == 0);
+    VERIFY(entry.is_huge());
+    u32 page_directory_table_index = (vaddr.get() >> 30) & 0x1ff;
+    u32 page_directory_index = (vaddr.get() >> 21) & 0x1ff;
+
+    auto* pd = quickmap_pd(page_directory, page_directory_table_index);
+    auto& pde = pd[page_directory_index];
+    Optional<PhysicalAddress> old_page_table;
+    if (pde.is_present() && !pde.is_huge())
+        old_page_table = PhysicalAddress { pde.page_table_base() };
+    if (!pde.is_present() || !pde.is_huge())
+        ++m_large_pages_mapped;
+    pde = entry;
+
+    if (old_page_table.has_value()) {
+        // The old page table may only be reused once no processor can walk it anymore.
+        flush_tlb(&page_directory, vaddr, pages_per_large_page);
+        get_physical_page_entry(*old_page_table).allocated.physical_page.unref();
+        ++m_large_page_collapses;
+    }
+}
+
+bool MemoryManager::release_large_page(PageDirectory& page_directory, VirtualAddress vaddr)
+{
+    VERIFY_INTERRUPTS_DISABLED();
+    VERIFY(page_directory.get_lock().is_locked_by_current_processor());
+    VERIFY(vaddr.get() % large_page_size == 0);
+    u32 page_directory_table_index = (vaddr.get() >> 30) & 0x1ff;
+    u32 page_directory_index = (vaddr.get() >> 21) & 0x1ff;
+
+    auto* pd = quickmap_pd(page_directory, page_directory_table_index);
+    auto& pde = pd[page_directory_index];
+    if (!pde.is_present() || !pde.is_huge())
+        return false;
+    pde.clear();
+    --m_large_pages_mapped;
+    return true;
+}
+
+void MemoryManager::defer_write_protection(PageDirectory& page_directory, VirtualRange const& range)
+{
+    VERIFY_INTERRUPTS_DISABLED();
+    VERIFY(page_directory.get_lock().is_locked_by_current_processor());
+    for (FlatPtr vaddr = range.base().get() & ~(large_page_size - 1); vaddr < range.end().get(); vaddr += large_page_size) {
+        u32 page_directory_table_index = (vaddr >> 30) & 0x1ff;
+        u32 page_directory_index = (vaddr >> 21) & 0x1ff;
+
+        auto* pd = quickmap_pd(page_directory, page_directory_table_index);
+        auto& pde = pd[page_directory_index];
+        if (!pde.is_present() || !pde.is_writable())
+            continue;
+        pde.set_writable(false);
+        // NOTE: A large page belongs to a single region as a whole, so all of it is copy-on-write now.
+        if (!pde.is_huge())
+            pde.set_write_protect_deferred(true);
+    }
+}
+
+bool MemoryManager::resolve_deferred_write_protection(PageDirectory& page_directory, VirtualAddress vaddr)
+{
+    SpinlockLocker page_lock(page_directory.get_lock());
+    u32 page_directory_table_index = (vaddr.get() >> 30) & 0x1ff;
+    u32 page_directory_index = (vaddr.get() >> 21) & 0x1ff;
+    u32 page_table_index = (vaddr.get() >> 12) & 0x1ff;
+
+    auto* pd = quickmap_pd(page_directory, page_directory_table_index);
+    auto& pde = pd[page_directory_index];
+    if (!pde.is_present() || pde.is_huge())
+        return false;
+
+    auto* page_table = quickmap_pt(PhysicalAddress(pde.page_table_base()));
+    if (!pde.is_write_protect_deferred()) {
+        // Another processor may have resolved this page table while we were waiting for the lock.
+        auto const& pte = page_table[page_table_index];
+        return pde.is_writable() && pte.is_present() && pte.is_writable();
+    }
+
+    VERIFY(page_directory.address_space());
+    auto& space = *page_directory.address_space();
+    FlatPtr page_table_base = vaddr.get() & ~(large_page_size - 1);
+    Region* region = nullptr;
+    for (u32 i = 0; i <= 0x1ff; i++) {
+        auto& pte = page_table[i];
+        if (!pte.is_present() || !pte.is_writable())
+            continue;
+        VirtualAddress page_vaddr { page_table_base + i * PAGE_SIZE };
+        if (!region || !region->contains(page_vaddr))
+            region = find_user_region_from_vaddr(space, page_vaddr);
+        if (region && region->should_cow(region->page_index_from_address(page_vaddr)))
+            pte.set_writable(false);
+    }
+
+    // NOTE: Nothing below this entry could have been cached as writable while it was write-protected,
+    //       so there are no TLB entries to flush.
+    pde.set_write_protect_deferred(false);
+    pde.set_writable(true);
+    return true;
+}
+
 UNMAP_AFTER_INIT void MemoryManager::initialize(u32 cpu)
 {
     ProcessorSpecific<MemoryManagerData>::initialize();
@@ -666,6 +797,29 @@ Region* MemoryManager::find_user_region_from_vaddr(AddressSpace& space, VirtualA
     return space.find_region_containing({ vaddr, 1 });
 }
 
+Region* MemoryManager::find_user_region_for_page_fault(AddressSpace& space, VirtualAddress vaddr)
+{
+    // NOTE: This doesn't take the address space lock, so that threads faulting on different regions
+    //       of the same process don't have to wait on each other.
+    auto& region_tree = space.region_tree();
+    auto* current_thread = Thread::current();
+
+    // Faults tend to come in bunches, e.g. when a freshly allocated buffer is touched page by page,
+    // so check the region of the last fault first. It is still in the tree if no region has been
+    // placed or removed since then.
+    if (current_thread) {
+        auto& cache = current_thread->page_fault_region_cache();
+        if (cache.region && cache.region_tree == &region_tree && cache.region_tree_sequence == region_tree.sequence() && cache.region->contains(vaddr))
+            return cache.region;
+    }
+
+    u32 sequence = 0;
+    auto* region = region_tree.find_region_containing_without_lock(vaddr, sequence);
+    if (current_thread && region)
+        current_thread->page_fault_region_cache() = { &region_tree, region, sequence };
+    return region;
+}
+
 void MemoryManager::validate_syscall_preconditions(Process& process, RegisterState const& regs)
 {
     bool should_crash = false;
@@ -716,7 +870,7 @@ Region* MemoryManager::find_region_from_vaddr(VirtualAddress vaddr)
     if (!page_directory)
         return nullptr;
     VERIFY(page_directory->address_space());
-    return find_user_region_from_vaddr(*page_directory->address_space(), vaddr);
+    return find_user_region_for_page_fault(*page_directory->address_space(), vaddr);
 }
 
 PageFaultResponse MemoryManager::handle_page_fault(PageFault const& fault)
@@ -743,6 +897,10 @@ PageFaultResponse MemoryManager::handle_page_fault(PageFault const& fault)
         return PageFaultResponse::ShouldCrash;
     }
     dbgln_if(PAGE_FAULT_DEBUG, "MM: CPU[{}] handle_page_fault({:#04x}) at {}", Processor::current_id(), fault.code(), fault.vaddr());
+    if (fault.type() == PageFault::Type::ProtectionViolation && fault.is_write() && is_user_address(fault.vaddr())) {
+        if (auto page_directory = PageDirectory::find_current(); page_directory && resolve_deferred_write_protection(*page_directory, fault.vaddr()))
+            return PageFaultResponse::Continue;
+    }
     auto* region = find_region_from_vaddr(fault.vaddr());
     if (!region) {
         return PageFaultResponse::ShouldCrash;
@@ -927,6 +1085,64 @@ RefPtr<PhysicalPage> MemoryManager::find_free_physical_page(bool committed)
     return page;
 }
 
+bool MemoryManager::supports_large_pages()
+{
+#if ARCH(X86_64) || ARCH(I386)
+    // NOTE: We always use PAE paging, which has 2 MiB pages regardless of the PSE feature bit.
+    return true;
+#else
+    return false;
+#endif
+}
+
+Optional<NonnullRefPtrVector<PhysicalPage>> MemoryManager::find_free_large_physical_page(bool committed, ShouldZeroFill should_zero_fill)
+{
+    Optional<NonnullRefPtrVector<PhysicalPage>> large_page;
+    m_global_data.with([&](auto& global_data) {
+        auto& pool = committed ? global_data.system_memory_info.physical_pages_committed : global_data.system_memory_info.physical_pages_uncommitted;
+        if (pool < pages_per_large_page)
+            return;
+        for (auto& region : global_data.physical_regions) {
+            auto physical_pages = region.take_contiguous_free_pages(pages_per_large_page, large_page_size);
+            if (physical_pages.is_empty())
+                continue;
+            pool -= pages_per_large_page;
+            global_data.system_memory_info.physical_pages_used += pages_per_large_page;
+            large_page = move(physical_pages);
+            return;
+        }
+    });
+
+    if (!large_page.has_value()) {
+        ++m_large_page_allocation_failures;
+        return {};
+    }
+    ++m_large_page_allocations;
+
+    if (should_zero_fill == ShouldZeroFill::Yes) {
+        InterruptDisabler disabler;
+        for (auto& page : *large_page) {
+            auto* ptr = quickmap_page(page);
+            memset(ptr, 0, PAGE_SIZE);
+            unquickmap_page();
+        }
+    }
+    return large_page;
+}
+
+Optional<NonnullRefPtrVector<PhysicalPage>> MemoryManager::allocate_committed_large_physical_page(Badge<CommittedPhysicalPageSet>, ShouldZeroFill should_zero_fill)
+{
+    return find_free_large_physical_page(true, should_zero_fill);
+}
+
+ErrorOr<NonnullRefPtrVector<PhysicalPage>> MemoryManager::allocate_large_physical_page(ShouldZeroFill should_zero_fill)
+{
+    auto large_page = find_free_large_physical_page(false, should_zero_fill);
+    if (!large_page.has_value())
+        return ENOMEM;
+    return large_page.release_value();
+}
+
 NonnullRefPtr<PhysicalPage> MemoryManager::allocate_committed_physical_page(Badge<CommittedPhysicalPageSet>, ShouldZeroFill should_zero_fill)
 {
     auto page = find_free_physical_page(true);
@@ -1036,6 +1252,7 @@ void MemoryManager::enter_address_space(AddressSpace& space)
 {
     auto* current_thread = Thread::current();
     VERIFY(current_thread != nullptr);
+    current_thread->page_fault_region_cache() = {};
     activate_page_directory(space.page_directory(), current_thread);
 }
 
@@ -1192,6 +1409,17 @@ void CommittedPhysicalPageSet::uncommit_one()
     MM.uncommit_physical_pages({}, 1);
 }
 
+Optional<NonnullRefPtrVector<PhysicalPage>> CommittedPhysicalPageSet::try_take_large_page()
+{
+    if (m_page_count < pages_per_large_page)
+        return {};
+    auto large_page = MM.allocate_committed_large_physical_page({});
+    if (!large_page.has_value())
+        return {};
+    m_page_count -= pages_per_large_page;
+    return large_page;
+}
+
 void MemoryManager::copy_physical_page(PhysicalPage& physical_page, u8 page_buffer[PAGE_SIZE])
 {
     auto* quickmapped_page = quickmap_page(physical_page);
@@ -1216,6 +1444,17 @@ ErrorOr<NonnullOwnPtr<Region>> MemoryManager::allocate_unbacked_region_anywhere(
     return region;
 }
 
+MemoryManager::LargePageStatistics MemoryManager::get_large_page_statistics() const
+{
+    return {
+        .mapped = m_large_pages_mapped,
+        .allocations = m_large_page_allocations,
+        .allocation_failures = m_large_page_allocation_failures,
+        .splits = m_large_page_splits,
+        .collapses = m_large_page_collapses,
+    };
+}
+
 MemoryManager::SystemMemoryInfo MemoryManager::get_system_memory_info()
 {
     return m_global_data.with([&](auto& global_data) {
@@ -6,11 +6,13 @@
 
 #pragma once
 
+#include <AK/Atomic.h>
 #include <AK/Badge.h>
 #include <AK/Concepts.h>
 #include <AK/HashTable.h>
 #include <AK/IntrusiveRedBlackTree.h>
 #include <AK/NonnullOwnPtrVector.h>
+#include <AK/NonnullRefPtrVector.h>
 #include <Kernel/Forward.h>
 #include <Kernel/Library/NonnullLockRefPtrVector.h>
 #include <Kernel/Locking/Spinlock.h>
@@ -37,6 +39,10 @@ constexpr FlatPtr page_round_down(FlatPtr x)
     return ((FlatPtr)(x)) & ~(PAGE_SIZE - 1);
 }
 
+// One page directory entry can map this much memory on its own, without a page table.
+constexpr size_t large_page_size = 2 * MiB;
+constexpr size_t pages_per_large_page = large_page_size / PAGE_SIZE;
+
 inline FlatPtr virtual_to_low_physical(FlatPtr virtual_)
 {
     return virtual_ - physical_to_virtual_offset;
@@ -119,6 +125,9 @@ public:
     [[nodiscard]] NonnullRefPtr<PhysicalPage> take_one();
     void uncommit_one();
 
+    // Takes pages_per_large_page pages that form a single large page, if one is available.
+    Optional<NonnullRefPtrVector<PhysicalPage>> try_take_large_page();
+
     void operator=(CommittedPhysicalPageSet&&) = delete;
 
 private:
@@ -171,6 +180,12 @@ public:
     ErrorOr<NonnullRefPtrVector<PhysicalPage>> allocate_contiguous_physical_pages(size_t size);
     void deallocate_physical_page(PhysicalAddress);
 
+    // A large page is a naturally aligned, physically contiguous run of pages_per_large_page pages.
+    // Each of its pages is still a separate PhysicalPage, and is freed on its own.
+    static bool supports_large_pages();
+    Optional<NonnullRefPtrVector<PhysicalPage>> allocate_committed_large_physical_page(Badge<CommittedPhysicalPageSet>, ShouldZeroFill = ShouldZeroFill::Yes);
+    ErrorOr<NonnullRefPtrVector<PhysicalPage>> allocate_large_physical_page(ShouldZeroFill = ShouldZeroFill::Yes);
+
     ErrorOr<NonnullOwnPtr<Region>> allocate_contiguous_kernel_region(size_t, StringView name, Region::Access access, Region::Cacheable = Region::Cacheable::Yes);
     ErrorOr<NonnullOwnPtr<Memory::Region>> allocate_dma_buffer_page(StringView name, Memory::Region::Access access, RefPtr<Memory::PhysicalPage>& dma_buffer_page);
     ErrorOr<NonnullOwnPtr<Memory::Region>> allocate_dma_buffer_page(StringView name, Memory::Region::Access access);
@@ -191,6 +206,16 @@ public:
 
     SystemMemoryInfo get_system_memory_info();
 
+    struct LargePageStatistics {
+        size_t mapped { 0 };
+        size_t allocations { 0 };
+        size_t allocation_failures { 0 };
+        size_t splits { 0 };
+        size_t collapses { 0 };
+    };
+
+    LargePageStatistics get_large_page_statistics() const;
+
     template<IteratorFunction<VMObject&> Callback>
     static void for_each_vmobject(Callback callback)
     {
@@ -213,6 +238,7 @@ public:
     }
 
     static Region* find_user_region_from_vaddr(AddressSpace&, VirtualAddress);
+    static Region* find_user_region_for_page_fault(AddressSpace&, VirtualAddress);
     static void validate_syscall_preconditions(Process&, RegisterState const&);
 
     void dump_kernel_regions();
@@ -258,6 +284,7 @@ private:
     static Region* find_region_from_vaddr(VirtualAddress);
 
     RefPtr<PhysicalPage> find_free_physical_page(bool);
+    Optional<NonnullRefPtrVector<PhysicalPage>> find_free_large_physical_page(bool committed, ShouldZeroFill);
 
     ALWAYS_INLINE u8* quickmap_page(PhysicalPage& page)
     {
@@ -277,6 +304,16 @@ private:
     };
     void release_pte(PageDirectory&, VirtualAddress, IsLastPTERelease);
 
+    // These replace whatever the page directory entry for `vaddr` pointed to. A page table that
+    // was there is freed, while ensure_pte() splits a large page back into a page table.
+    void map_large_page(PageDirectory&, VirtualAddress, PageDirectoryEntry const&);
+    bool release_large_page(PageDirectory&, VirtualAddress);
+
+    // fork() write-protects the parent's memory one page directory entry at a time instead of
+    // one page at a time. The page table entries below are only fixed up on the first write fault.
+    void defer_write_protection(PageDirectory&, VirtualRange const&);
+    bool resolve_deferred_write_protection(PageDirectory&, VirtualAddress);
+
     // NOTE: These are outside of GlobalData as they are only assigned on startup,
     //       and then never change. Atomic ref-counting covers that case without
     //       the need for additional synchronization.
@@ -289,6 +326,12 @@ private:
     PhysicalPageEntry* m_physical_page_entries { nullptr };
     size_t m_physical_page_entries_count { 0 };
 
+    Atomic<size_t, AK::MemoryOrder::memory_order_relaxed> m_large_pages_mapped { 0 };
+    Atomic<size_t, AK::MemoryOrder::memory_order_relaxed> m_large_page_allocations { 0 };
+    Atomic<size_t, AK::MemoryOrder::memory_order_relaxed> m_large_page_allocation_failures { 0 };
+    Atomic<size_t, AK::MemoryOrder::memory_order_relaxed> m_large_page_splits { 0 };
+    Atomic<size_t, AK::MemoryOrder::memory_order_relaxed> m_large_page_collapses { 0 };
+
     struct GlobalData {
         GlobalData();
 
@@ -40,15 +40,19 @@ void PhysicalRegion::initialize_zones()
     size_t remaining_pages = m_pages;
     auto base_address = m_lower;
 
+    auto make_zone = [&](size_t page_count) {
+        m_zones.append(adopt_nonnull_own_or_enomem(new (nothrow) PhysicalZone(base_address, page_count)).release_value_but_fixme_should_propagate_errors());
+        base_address = base_address.offset(page_count * PAGE_SIZE);
+        m_usable_zones.append(m_zones.last());
+        remaining_pages -= page_count;
+    };
+
     auto make_zones = [&](size_t zone_size) -> size_t {
         size_t pages_per_zone = zone_size / PAGE_SIZE;
         size_t zone_count = 0;
         auto first_address = base_address;
         while (remaining_pages >= pages_per_zone) {
-            m_zones.append(adopt_nonnull_own_or_enomem(new (nothrow) PhysicalZone(base_address, pages_per_zone)).release_value_but_fixme_should_propagate_errors());
-            base_address = base_address.offset(pages_per_zone * PAGE_SIZE);
-            m_usable_zones.append(m_zones.last());
-            remaining_pages -= pages_per_zone;
+            make_zone(pages_per_zone);
             ++zone_count;
         }
         if (zone_count)
@@ -56,6 +60,22 @@ void PhysicalRegion::initialize_zones()
         return zone_count;
     };
 
+    // Buddy blocks are only aligned relative to the base of their zone. Bring the large zones up
+    // to a large page boundary with a few small zones first, so their 2 MiB blocks can be mapped as large pages.
+    auto first_address = base_address;
+    while (remaining_pages > 0 && base_address.get() % large_page_size != 0) {
+        size_t pages_to_boundary = (large_page_size - base_address.get() % large_page_size) / PAGE_SIZE;
+        // Zones must have a power of two size. Taking the lowest bit first keeps each one naturally aligned.
+        size_t zone_pages = pages_to_boundary & -pages_to_boundary;
+        while (zone_pages > remaining_pages)
+            zone_pages /= 2;
+        make_zone(zone_pages);
+        ++m_alignment_zones;
+    }
+    if (m_alignment_zones)
+        dmesgln(" * {}x PhysicalZone (alignment) @ {:016x}-{:016x}", m_alignment_zones, first_address.get(), base_address.get() - 1);
+    m_large_zones_base = base_address;
+
     // First make 16 MiB zones (with 4096 pages each)
     m_large_zones = make_zones(large_zone_size);
 
@@ -75,13 +95,17 @@ OwnPtr<PhysicalRegion> PhysicalRegion::try_take_pages_from_beginning(unsigned pa
     return try_create(taken_lower, taken_upper);
 }
 
-NonnullRefPtrVector<PhysicalPage> PhysicalRegion::take_contiguous_free_pages(size_t count)
+NonnullRefPtrVector<PhysicalPage> PhysicalRegion::take_contiguous_free_pages(size_t count, size_t alignment)
 {
     auto rounded_page_count = next_power_of_two(count);
     auto order = count_trailing_zeroes(rounded_page_count);
+    VERIFY(alignment <= rounded_page_count * PAGE_SIZE);
 
     Optional<PhysicalAddress> page_base;
     for (auto& zone : m_usable_zones) {
+        // Blocks are naturally aligned within their zone, so an aligned zone base gives us aligned blocks.
+        if (zone.base().get() % alignment != 0)
+            continue;
         page_base = zone.allocate_block(order);
         if (page_base.has_value()) {
             if (zone.is_empty()) {
@@ -122,14 +146,20 @@ RefPtr<PhysicalPage> PhysicalRegion::take_free_page()
 
 void PhysicalRegion::return_page(PhysicalAddress paddr)
 {
-    auto large_zone_base = lower().get();
-    auto small_zone_base = lower().get() + (m_large_zones * large_zone_size);
+    auto large_zone_base = m_large_zones_base.get();
+    auto small_zone_base = large_zone_base + (m_large_zones * large_zone_size);
 
     size_t zone_index;
-    if (paddr.get() < small_zone_base)
-        zone_index = (paddr.get() - large_zone_base) / large_zone_size;
-    else
-        zone_index = m_large_zones + (paddr.get() - small_zone_base) / small_zone_size;
+    if (paddr.get() < large_zone_base) {
+        // There are only a handful of alignment zones in front of the large ones.
+        zone_index = 0;
+        while (!m_zones[zone_index].contains(paddr))
+            ++zone_index;
+    } else if (paddr.get() < small_zone_base) {
+        zone_index = m_alignment_zones + (paddr.get() - large_zone_base) / large_zone_size;
+    } else {
+        zone_index = m_alignment_zones + m_large_zones + (paddr.get() - small_zone_base) / small_zone_size;
+    }
 
     auto& zone = m_zones[zone_index];
     VERIFY(zone.contains(paddr));
@@ -34,7 +34,8 @@ public:
     OwnPtr<PhysicalRegion> try_take_pages_from_beginning(unsigned);
 
     RefPtr<PhysicalPage> take_free_page();
-    NonnullRefPtrVector<PhysicalPage> take_contiguous_free_pages(size_t count);
+    // NOTE: The returned pages start at a multiple of `alignment`, which must not be larger than a large zone.
+    NonnullRefPtrVector<PhysicalPage> take_contiguous_free_pages(size_t count, size_t alignment = PAGE_SIZE);
     void return_page(PhysicalAddress);
 
 private:
@@ -45,7 +46,9 @@ private:
 
     NonnullOwnPtrVector<PhysicalZone> m_zones;
 
+    size_t m_alignment_zones { 0 };
     size_t m_large_zones { 0 };
+    PhysicalAddress m_large_zones_base;
 
     PhysicalZone::List m_usable_zones;
     PhysicalZone::List m_full_zones;
@@ -119,7 +119,7 @@ ErrorOr<NonnullOwnPtr<Region>> Region::try_clone()
 
     // Set up a COW region. The parent (this) region becomes COW as well!
     if (is_writable())
-        remap();
+        defer_write_protection();
 
     OwnPtr<KString> clone_region_name;
     if (m_name)
@@ -238,6 +238,52 @@ bool Region::map_individual_page_impl(size_t page_index, RefPtr<PhysicalPage> pa
     return true;
 }
 
+bool Region::try_map_large_page_impl(size_t page_index)
+{
+    VERIFY(m_page_directory->get_lock().is_locked_by_current_processor());
+
+    if (!MM.supports_large_pages() || !is_user() || !vmobject().is_anonymous())
+        return false;
+    if (!is_readable() && !is_writable())
+        return false;
+
+    auto page_vaddr = vaddr_from_page_index(page_index);
+    if (page_vaddr.get() % large_page_size != 0 || page_index + pages_per_large_page > page_count())
+        return false;
+
+    PhysicalAddress large_page_base;
+    {
+        auto const& anonymous_vmobject = static_cast<AnonymousVMObject const&>(vmobject());
+        SpinlockLocker vmobject_locker(vmobject().m_lock);
+        auto first_page_index_in_vmobject = translate_to_vmobject_page(page_index);
+        if (!anonymous_vmobject.is_backed_by_large_page(first_page_index_in_vmobject))
+            return false;
+        // All of the pages have to be mapped writable, or none of them.
+        if (is_writable()) {
+            for (size_t i = 0; i < pages_per_large_page; ++i) {
+                if (anonymous_vmobject.should_cow(first_page_index_in_vmobject + i, m_shared))
+                    return false;
+            }
+        }
+        large_page_base = anonymous_vmobject.physical_pages()[first_page_index_in_vmobject]->paddr();
+    }
+
+    PageDirectoryEntry entry;
+    entry.clear();
+    entry.set_large_page_base(large_page_base.get());
+    entry.set_huge(true);
+    entry.set_present(true);
+    entry.set_writable(is_writable());
+    entry.set_cache_disabled(!m_cacheable);
+    if (Processor::current().has_nx())
+        entry.set_execute_disabled(!is_executable());
+    if (Processor::current().has_pat())
+        entry.set_large_page_pat(is_write_combine());
+    entry.set_user_allowed(page_vaddr.get() >= USER_RANGE_BASE && is_user_address(page_vaddr));
+    MM.map_large_page(*m_page_directory, page_vaddr, entry);
+    return true;
+}
+
 bool Region::map_individual_page_impl(size_t page_index)
 {
     RefPtr<PhysicalPage> page;
@@ -275,9 +321,14 @@ void Region::unmap_with_locks_held(ShouldFlushTLB should_flush_tlb, SpinlockLock
     if (!m_page_directory)
         return;
     size_t count = page_count();
-    for (size_t i = 0; i < count; ++i) {
+    for (size_t i = 0; i < count;) {
         auto vaddr = vaddr_from_page_index(i);
+        if (vaddr.get() % large_page_size == 0 && count - i >= pages_per_large_page && MM.release_large_page(*m_page_directory, vaddr)) {
+            i += pages_per_large_page;
+            continue;
+        }
         MM.release_pte(*m_page_directory, vaddr, i == count - 1 ? MemoryManager::IsLastPTERelease::Yes : MemoryManager::IsLastPTERelease::No);
+        ++i;
     }
     if (should_flush_tlb == ShouldFlushTLB::Yes)
         MemoryManager::flush_tlb(m_page_directory, vaddr(), page_count());
@@ -302,6 +353,12 @@ ErrorOr<void> Region::map(PageDirectory& page_directory, ShouldFlushTLB should_f
     set_page_directory(page_directory);
     size_t page_index = 0;
     while (page_index < page_count()) {
+        // NOTE: This collapses 2 MiB that were mapped with a page table into a large page where possible,
+        //       and ensure_pte() splits a large page again if part of it has to be mapped differently.
+        if (try_map_large_page_impl(page_index)) {
+            page_index += pages_per_large_page;
+            continue;
+        }
         if (!map_individual_page_impl(page_index))
             break;
         ++page_index;
@@ -323,6 +380,14 @@ void Region::remap()
         TODO();
 }
 
+void Region::defer_write_protection()
+{
+    VERIFY(m_page_directory);
+    SpinlockLocker page_lock(m_page_directory->get_lock());
+    MM.defer_write_protection(*m_page_directory, range());
+    MemoryManager::flush_tlb(m_page_directory, vaddr(), page_count());
+}
+
 ErrorOr<void> Region::set_write_combine(bool enable)
 {
     if (enable && !Processor::current().has_pat()) {
@@ -375,6 +440,13 @@ PageFaultResponse Region::handle_fault(PageFault const& fault)
                 return PageFaultResponse::OutOfMemory;
             return PageFaultResponse::Continue;
         }
+        if (page_slot) {
+            // fork() leaves the pages of the child unmapped until it touches them.
+            dbgln_if(PAGE_FAULT_DEBUG, "NP(resident) fault in Region({})[{}] at {}", this, page_index_in_region, fault.vaddr());
+            if (!remap_vmobject_page(translate_to_vmobject_page(page_index_in_region), *page_slot))
+                return PageFaultResponse::OutOfMemory;
+            return PageFaultResponse::Continue;
+        }
         dbgln("BUG! Unexpected NP fault at {}", fault.vaddr());
         dbgln("     - Physical page slot pointer: {:p}", page_slot.ptr());
         if (page_slot) {
@@ -408,6 +480,9 @@ PageFaultResponse Region::handle_zero_fault(size_t page_index_in_region, Physica
     if (current_thread != nullptr)
         current_thread->did_zero_fault();
 
+    if (auto response = handle_zero_fault_with_large_page(page_index_in_region); response.has_value())
+        return response.release_value();
+
     RefPtr<PhysicalPage> new_physical_page;
 
     if (page_in_slot_at_time_of_fault.is_lazy_committed_page()) {
@@ -446,6 +521,33 @@ PageFaultResponse Region::handle_zero_fault(size_t page_index_in_region, Physica
     return PageFaultResponse::Continue;
 }
 
+Optional<PageFaultResponse> Region::handle_zero_fault_with_large_page(size_t page_index_in_region)
+{
+    // NOTE: Shared regions are left alone, since other regions may be mapping the same pages.
+    if (!MM.supports_large_pages() || !is_user() || is_shared())
+        return {};
+
+    // Back the whole 2 MiB around the fault with a large page if it lies within this region
+    // and none of it has been touched yet.
+    auto large_page_vaddr = VirtualAddress { vaddr_from_page_index(page_index_in_region).get() & ~(large_page_size - 1) };
+    if (large_page_vaddr < vaddr() || large_page_vaddr.offset(large_page_size) > range().end())
+        return {};
+    auto first_page_index_in_region = page_index_from_address(large_page_vaddr);
+    if (!static_cast<AnonymousVMObject&>(vmobject()).try_populate_large_page(translate_to_vmobject_page(first_page_index_in_region)))
+        return {};
+
+    // All of these pages changed, so all of them have to be remapped.
+    SpinlockLocker page_lock(m_page_directory->get_lock());
+    if (!try_map_large_page_impl(first_page_index_in_region)) {
+        for (size_t i = 0; i < pages_per_large_page; ++i) {
+            if (!map_individual_page_impl(first_page_index_in_region + i))
+                return PageFaultResponse::OutOfMemory;
+        }
+    }
+    MemoryManager::flush_tlb(m_page_directory, large_page_vaddr, pages_per_large_page);
+    return PageFaultResponse::Continue;
+}
+
 PageFaultResponse Region::handle_cow_fault(size_t page_index_in_region)
 {
     auto current_thread = Thread::current();
@@ -489,9 +591,23 @@ PageFaultResponse Region::handle_inode_fault(size_t page_index_in_region)
     if (current_thread)
         current_thread->did_inode_fault();
 
-    u8 page_buffer[PAGE_SIZE];
     auto& inode = inode_vmobject.inode();
 
+    if (inode_vmobject.is_shared_inode() && inode.is_page_cacheable()) {
+        // Shared mappings map the page cache's own pages, so they see the same data as read() and write().
+        auto page_or_error = inode.page_cache_physical_page(page_index_in_vmobject);
+        if (page_or_error.is_error()) {
+            dmesgln("handle_inode_fault: Error ({}) while looking up page in the page cache", page_or_error.error());
+            return page_or_error.error().code() == ENOMEM ? PageFaultResponse::OutOfMemory : PageFaultResponse::ShouldCrash;
+        }
+        auto page = page_or_error.release_value();
+        if (!page)
+            return PageFaultResponse::BusError;
+        return install_inode_fault_page(page_index_in_vmobject, page.release_nonnull());
+    }
+
+    u8 page_buffer[PAGE_SIZE];
+
     auto buffer = UserOrKernelBuffer::for_kernel_buffer(page_buffer);
     auto result = inode.read_bytes(page_index_in_vmobject * PAGE_SIZE, PAGE_SIZE, buffer, nullptr);
 
@@ -525,6 +641,14 @@ PageFaultResponse Region::handle_inode_fault(size_t page_index_in_region)
         MM.unquickmap_page();
     }
 
+    return install_inode_fault_page(page_index_in_vmobject, move(new_physical_page));
+}
+
+PageFaultResponse Region::install_inode_fault_page(size_t page_index_in_vmobject, NonnullRefPtr<PhysicalPage> physical_page)
+{
+    auto& inode_vmobject = static_cast<InodeVMObject&>(vmobject());
+    auto& vmobject_physical_page_slot = inode_vmobject.physical_pages()[page_index_in_vmobject];
+
     {
         // NOTE: The VMObject lock is required when manipulating the VMObject's physical page slot.
         SpinlockLocker locker(inode_vmobject.m_lock);
@@ -538,7 +662,7 @@ PageFaultResponse Region::handle_inode_fault(size_t page_index_in_region)
             return PageFaultResponse::Continue;
         }
 
-        vmobject_physical_page_slot = new_physical_page;
+        vmobject_physical_page_slot = move(physical_page);
     }
 
     if (!remap_vmobject_page(page_index_in_vmobject, *vmobject_physical_page_slot))
@@ -192,6 +192,8 @@ public:
     void unmap_with_locks_held(ShouldFlushTLB, SpinlockLocker<RecursiveSpinlock>& pd_locker);
 
     void remap();
+    // Write-protects the region for copy-on-write, see MemoryManager::defer_write_protection().
+    void defer_write_protection();
 
     [[nodiscard]] bool is_mapped() const { return m_page_directory != nullptr; }
 
@@ -220,10 +222,14 @@ private:
 
     [[nodiscard]] PageFaultResponse handle_cow_fault(size_t page_index);
     [[nodiscard]] PageFaultResponse handle_inode_fault(size_t page_index);
+    [[nodiscard]] PageFaultResponse install_inode_fault_page(size_t page_index_in_vmobject, NonnullRefPtr<PhysicalPage>);
     [[nodiscard]] PageFaultResponse handle_zero_fault(size_t page_index, PhysicalPage& page_in_slot_at_time_of_fault);
+    [[nodiscard]] Optional<PageFaultResponse> handle_zero_fault_with_large_page(size_t page_index);
 
     [[nodiscard]] bool map_individual_page_impl(size_t page_index);
     [[nodiscard]] bool map_individual_page_impl(size_t page_index, RefPtr<PhysicalPage>);
+    // Returns false if the pages starting at `page_index` can't be mapped as one large page.
+    [[nodiscard]] bool try_map_large_page_impl(size_t page_index);
 
     LockRefPtr<PageDirectory> m_page_directory;
     VirtualRange m_range;
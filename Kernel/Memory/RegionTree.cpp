@@ -20,11 +20,13 @@ RegionTree::~RegionTree()
 void RegionTree::delete_all_regions_assuming_they_are_unmapped()
 {
     // FIXME: This could definitely be done in a more efficient manner.
+    begin_modification();
     while (!m_regions.is_empty()) {
         auto& region = *m_regions.begin();
         m_regions.remove(region.vaddr().get());
         delete &region;
     }
+    end_modification();
 }
 
 ErrorOr<VirtualRange> RegionTree::allocate_range_anywhere(size_t size, size_t alignment)
@@ -153,7 +155,9 @@ ErrorOr<void> RegionTree::place_anywhere(Region& region, RandomizeVirtualAddress
 {
     auto range = TRY(randomize_virtual_address == RandomizeVirtualAddress::Yes ? allocate_range_randomized(size, alignment) : allocate_range_anywhere(size, alignment));
     region.m_range = range;
+    begin_modification();
     m_regions.insert(region.vaddr().get(), region);
+    end_modification();
     return {};
 }
 
@@ -161,13 +165,18 @@ ErrorOr<void> RegionTree::place_specifically(Region& region, VirtualRange const&
 {
     auto allocated_range = TRY(allocate_range_specific(range.base(), range.size()));
     region.m_range = allocated_range;
+    begin_modification();
     m_regions.insert(region.vaddr().get(), region);
+    end_modification();
     return {};
 }
 
 bool RegionTree::remove(Region& region)
 {
-    return m_regions.remove(region.range().base().get());
+    begin_modification();
+    bool removed = m_regions.remove(region.range().base().get());
+    end_modification();
+    return removed;
 }
 
 Region* RegionTree::find_region_containing(VirtualAddress address)
@@ -178,6 +187,20 @@ Region* RegionTree::find_region_containing(VirtualAddress address)
     return region;
 }
 
+Region* RegionTree::find_region_containing_without_lock(VirtualAddress address, u32& sequence)
+{
+    for (;;) {
+        sequence = this->sequence();
+        if (sequence & 1) {
+            Processor::pause();
+            continue;
+        }
+        auto* region = find_region_containing(address);
+        if (sequence == this->sequence())
+            return region;
+    }
+}
+
 Region* RegionTree::find_region_containing(VirtualRange range)
 {
     auto* region = m_regions.find_largest_not_above(range.base().get());
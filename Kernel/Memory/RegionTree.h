@@ -6,6 +6,7 @@
 
 #pragma once
 
+#include <AK/Atomic.h>
 #include <AK/Error.h>
 #include <AK/IntrusiveRedBlackTree.h>
 #include <Kernel/Locking/Spinlock.h>
@@ -50,13 +51,25 @@ public:
     Region* find_region_containing(VirtualAddress);
     Region* find_region_containing(VirtualRange);
 
+    // Unlike everything else, this may be called without holding the lock that protects the tree.
+    // The tree is walked again until no region was placed or removed while walking it, and the
+    // sequence the result is valid for is returned in `sequence`.
+    Region* find_region_containing_without_lock(VirtualAddress, u32& sequence);
+
+    // Changes whenever a region is placed or removed, and is odd while that is in progress.
+    u32 sequence() const { return m_sequence.load(AK::MemoryOrder::memory_order_acquire); }
+
 private:
+    void begin_modification() { m_sequence.fetch_add(1, AK::MemoryOrder::memory_order_acq_rel); }
+    void end_modification() { m_sequence.fetch_add(1, AK::MemoryOrder::memory_order_release); }
+
     ErrorOr<VirtualRange> allocate_range_anywhere(size_t size, size_t alignment = PAGE_SIZE);
     ErrorOr<VirtualRange> allocate_range_specific(VirtualAddress base, size_t size);
     ErrorOr<VirtualRange> allocate_range_randomized(size_t size, size_t alignment = PAGE_SIZE);
 
     IntrusiveRedBlackTree<&Region::m_tree_node> m_regions;
     VirtualRange const m_total_range;
+    Atomic<u32> m_sequence { 0 };
 };
 
 }
@@ -24,6 +24,8 @@ ScopedAddressSpaceSwitcher::ScopedAddressSpaceSwitcher(Process& process)
 ScopedAddressSpaceSwitcher::~ScopedAddressSpaceSwitcher()
 {
     InterruptDisabler disabler;
+    // The region of the last page fault belongs to the address space we are leaving.
+    Thread::current()->page_fault_region_cache() = {};
 #if ARCH(I386) || ARCH(X86_64)
     Thread::current()->regs().cr3 = m_previous_cr3;
     write_cr3(m_previous_cr3);
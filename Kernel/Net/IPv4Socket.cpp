@@ -35,9 +35,17 @@ MutexProtected<IPv4Socket::List>& IPv4Socket::all_sockets()
     return *s_all_sockets;
 }
 
+static constexpr StringView receive_buffer_name = "IPv4Socket: Receive buffer"sv;
+
 ErrorOr<NonnullOwnPtr<DoubleBuffer>> IPv4Socket::try_create_receive_buffer()
 {
-    return DoubleBuffer::try_create("IPv4Socket: Receive buffer"sv, 256 * KiB);
+    return DoubleBuffer::try_create(receive_buffer_name, 256 * KiB);
+}
+
+ErrorOr<void> IPv4Socket::try_grow_receive_buffer(size_t new_capacity)
+{
+    VERIFY(m_receive_buffer);
+    return m_receive_buffer->try_grow(receive_buffer_name, new_capacity);
 }
 
 ErrorOr<NonnullLockRefPtr<Socket>> IPv4Socket::create(int type, int protocol)
@@ -278,10 +286,13 @@ ErrorOr<size_t> IPv4Socket::receive_byte_buffered(OpenFileDescription& descripti
     else
         nreceived_or_error = m_receive_buffer->read(buffer, buffer_length);
 
-    if (!nreceived_or_error.is_error() && nreceived_or_error.value() > 0 && !(flags & MSG_PEEK))
+    set_can_read(!m_receive_buffer->is_empty());
+
+    if (!nreceived_or_error.is_error() && nreceived_or_error.value() > 0 && !(flags & MSG_PEEK)) {
         Thread::current()->did_ipv4_socket_read(nreceived_or_error.value());
+        protocol_did_read(nreceived_or_error.value());
+    }
 
-    set_can_read(!m_receive_buffer->is_empty());
     return nreceived_or_error;
 }
 
@@ -425,8 +436,13 @@ bool IPv4Socket::did_receive(IPv4Address const& source_address, u16 source_port,
     if (buffer_mode() == BufferMode::Bytes) {
         VERIFY(m_receive_buffer);
 
+        // NOTE: Only the payload ends up in the buffer, and a stream protocol may have
+        //       announced a window that is exactly as large as the remaining space.
+        auto payload_size_or_error = protocol_size(packet);
+        if (payload_size_or_error.is_error())
+            return false;
         size_t space_in_receive_buffer = m_receive_buffer->space_for_writing();
-        if (packet_size > space_in_receive_buffer) {
+        if (payload_size_or_error.value() > space_in_receive_buffer) {
             dbgln("IPv4Socket({}): did_receive refusing packet since buffer is full.", this);
             VERIFY(m_can_read);
             return false;
@@ -472,6 +488,25 @@ bool IPv4Socket::did_receive(IPv4Address const& source_address, u16 source_port,
     return true;
 }
 
+bool IPv4Socket::did_receive_payload(ReadonlyBytes payload)
+{
+    MutexLocker locker(mutex());
+
+    if (is_shut_down_for_reading())
+        return false;
+
+    VERIFY(buffer_mode() == BufferMode::Bytes);
+    VERIFY(m_receive_buffer);
+    if (payload.size() > m_receive_buffer->space_for_writing())
+        return false;
+    auto nwritten_or_error = m_receive_buffer->write(payload.data(), payload.size());
+    if (nwritten_or_error.is_error())
+        return false;
+    set_can_read(!m_receive_buffer->is_empty());
+    m_bytes_received += payload.size();
+    return true;
+}
+
 ErrorOr<NonnullOwnPtr<KString>> IPv4Socket::pseudo_path(OpenFileDescription const&) const
 {
     if (m_role == Role::None)
@@ -504,10 +539,10 @@ ErrorOr<NonnullOwnPtr<KString>> IPv4Socket::pseudo_path(OpenFileDescription cons
     return KString::try_create(builder.string_view());
 }
 
-ErrorOr<void> IPv4Socket::setsockopt(int level, int option, Userspace<void const*> user_value, socklen_t user_value_size)
+ErrorOr<void> IPv4Socket::setsockopt(OpenFileDescription& description, int level, int option, Userspace<void const*> user_value, socklen_t user_value_size)
 {
     if (level != IPPROTO_IP)
-        return Socket::setsockopt(level, option, user_value, user_value_size);
+        return Socket::setsockopt(description, level, option, user_value, user_value_size);
 
     MutexLocker locker(mutex());
 
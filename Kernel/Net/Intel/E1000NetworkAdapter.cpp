@@ -121,6 +121,8 @@ namespace Kernel {
 #define INTERRUPT_TXD_LOW (1 << 15)
 #define INTERRUPT_SRPD (1 << 16)
 
+#define INTERRUPTS_RX (INTERRUPT_RXDMT0 | INTERRUPT_RXO | INTERRUPT_RXT0)
+
 // https://www.intel.com/content/dam/doc/manual/pci-pci-x-family-gbe-controllers-software-dev-manual.pdf Section 5.2
 UNMAP_AFTER_INIT static bool is_valid_device_id(u16 device_id)
 {
@@ -187,8 +189,12 @@ UNMAP_AFTER_INIT void E1000NetworkAdapter::setup_link()
 
 UNMAP_AFTER_INIT void E1000NetworkAdapter::setup_interrupts()
 {
-    out32(REG_INTERRUPT_RATE, 6000); // Interrupt rate of 1.536 milliseconds
-    out32(REG_INTERRUPT_MASK_SET, INTERRUPT_LSC | INTERRUPT_RXT0 | INTERRUPT_RXO);
+    // At most one interrupt every 125 microseconds. Everything that arrives in the
+    // meantime is picked up by polling the receive ring, see poll_receive().
+    out32(REG_INTERRUPT_RATE, 488);
+    // NOTE: send_raw() sleeps until the descriptor is written back, so transmit completion
+    //       has to interrupt us even while the receive interrupts are masked for polling.
+    out32(REG_INTERRUPT_MASK_SET, INTERRUPT_LSC | INTERRUPT_TXDW | INTERRUPT_RXT0 | INTERRUPT_RXO);
     in32(REG_INTERRUPT_CAUSE_READ);
     enable_irq();
 }
@@ -244,14 +250,14 @@ bool E1000NetworkAdapter::handle_irq(RegisterState const&)
 
         m_link_up = ((in32(REG_STATUS) & STATUS_LU) != 0);
     }
-    if (status & INTERRUPT_RXDMT0) {
-        // Threshold OK?
-    }
     if (status & INTERRUPT_RXO) {
         dbgln_if(E1000_DEBUG, "E1000: RX buffer overrun");
     }
-    if (status & INTERRUPT_RXT0) {
-        receive();
+    if (status & INTERRUPTS_RX) {
+        // Leave the receive ring to the network task, and don't interrupt again for
+        // every frame until it has caught up.
+        out32(REG_INTERRUPT_MASK_CLEAR, INTERRUPTS_RX);
+        schedule_poll();
     }
 
     m_wait_queue.wake_all();
@@ -421,23 +427,35 @@ void E1000NetworkAdapter::send_raw(ReadonlyBytes payload)
     dbgln_if(E1000_DEBUG, "E1000: Sent packet, status is now {:#02x}!", (u8)descriptor.status);
 }
 
-void E1000NetworkAdapter::receive()
+size_t E1000NetworkAdapter::poll_receive(size_t budget)
 {
     auto* rx_descriptors = (e1000_tx_desc*)m_rx_descriptors_region->vaddr().as_ptr();
-    u32 rx_current;
-    for (;;) {
-        rx_current = in32(REG_RXDESCTAIL) % number_of_rx_descriptors;
-        rx_current = (rx_current + 1) % number_of_rx_descriptors;
-        if (!(rx_descriptors[rx_current].status & 1))
+    size_t received = 0;
+    u32 rx_current = in32(REG_RXDESCTAIL) % number_of_rx_descriptors;
+    while (received < budget) {
+        auto rx_next = (rx_current + 1) % number_of_rx_descriptors;
+        if (!(rx_descriptors[rx_next].status & 1))
             break;
+        rx_current = rx_next;
         auto* buffer = m_rx_buffers[rx_current];
         u16 length = rx_descriptors[rx_current].length;
         VERIFY(length <= 8192);
         dbgln_if(E1000_DEBUG, "E1000: Received 1 packet @ {:p} ({} bytes)", buffer, length);
         did_receive({ buffer, length });
         rx_descriptors[rx_current].status = 0;
+        received++;
+    }
+
+    // Hand all the descriptors we consumed back to the hardware at once.
+    if (received > 0)
         out32(REG_RXDESCTAIL, rx_current);
+
+    if (received < budget) {
+        // The ring is drained, so go back to being interrupt driven. Frames that arrived
+        // since we last looked have already latched their cause, and interrupt right away.
+        out32(REG_INTERRUPT_MASK_SET, INTERRUPT_RXT0 | INTERRUPT_RXO);
     }
+    return received;
 }
 
 i32 E1000NetworkAdapter::link_speed()
@@ -45,8 +45,8 @@ ErrorOr<void> LocalSocket::try_for_each(Function<ErrorOr<void>(LocalSocket const
 
 ErrorOr<NonnullLockRefPtr<LocalSocket>> LocalSocket::try_create(int type)
 {
-    auto client_buffer = TRY(DoubleBuffer::try_create("LocalSocket: Client buffer"sv));
-    auto server_buffer = TRY(DoubleBuffer::try_create("LocalSocket: Server buffer"sv));
+    auto client_buffer = TRY(SPSCRingBuffer::try_create("LocalSocket: Client buffer"sv));
+    auto server_buffer = TRY(SPSCRingBuffer::try_create("LocalSocket: Server buffer"sv));
     return adopt_nonnull_lock_ref_or_enomem(new (nothrow) LocalSocket(type, move(client_buffer), move(server_buffer)));
 }
 
@@ -67,7 +67,7 @@ ErrorOr<SocketPair> LocalSocket::try_create_connected_pair(int type)
     return SocketPair { move(description1), move(description2) };
 }
 
-LocalSocket::LocalSocket(int type, NonnullOwnPtr<DoubleBuffer> client_buffer, NonnullOwnPtr<DoubleBuffer> server_buffer)
+LocalSocket::LocalSocket(int type, NonnullOwnPtr<SPSCRingBuffer> client_buffer, NonnullOwnPtr<SPSCRingBuffer> server_buffer)
     : Socket(AF_LOCAL, type, 0)
     , m_for_client(move(client_buffer))
     , m_for_server(move(server_buffer))
@@ -314,7 +314,7 @@ ErrorOr<size_t> LocalSocket::sendto(OpenFileDescription& description, UserOrKern
     return nwritten_or_error;
 }
 
-DoubleBuffer* LocalSocket::receive_buffer_for(OpenFileDescription& description)
+SPSCRingBuffer* LocalSocket::receive_buffer_for(OpenFileDescription& description)
 {
     auto role = this->role(description);
     if (role == Role::Accepted)
@@ -324,7 +324,7 @@ DoubleBuffer* LocalSocket::receive_buffer_for(OpenFileDescription& description)
     return nullptr;
 }
 
-DoubleBuffer* LocalSocket::send_buffer_for(OpenFileDescription& description)
+SPSCRingBuffer* LocalSocket::send_buffer_for(OpenFileDescription& description)
 {
     auto role = this->role(description);
     if (role == Role::Connected)
@@ -392,6 +392,42 @@ ErrorOr<NonnullOwnPtr<KString>> LocalSocket::pseudo_path(OpenFileDescription con
     return KString::try_create(builder.string_view());
 }
 
+SPSCRingBuffer* LocalSocket::buffer_for_option(OpenFileDescription const& description, int option)
+{
+    VERIFY(option == SO_SNDBUF || option == SO_RCVBUF);
+    bool is_receive_buffer = option == SO_RCVBUF;
+    switch (role(description)) {
+    case Role::Accepted:
+        return is_receive_buffer ? m_for_server.ptr() : m_for_client.ptr();
+    // A socket that isn't connected yet becomes the connect side, so it can be sized up front.
+    case Role::None:
+    case Role::Connecting:
+    case Role::Connected:
+        return is_receive_buffer ? m_for_client.ptr() : m_for_server.ptr();
+    default:
+        return nullptr;
+    }
+}
+
+ErrorOr<void> LocalSocket::setsockopt(OpenFileDescription& description, int level, int option, Userspace<void const*> user_value, socklen_t user_value_size)
+{
+    if (level != SOL_SOCKET || (option != SO_SNDBUF && option != SO_RCVBUF))
+        return Socket::setsockopt(description, level, option, user_value, user_value_size);
+
+    if (user_value_size != sizeof(int))
+        return EINVAL;
+    auto capacity = TRY(copy_typed_from_user(static_ptr_cast<int const*>(user_value)));
+    if (capacity <= 0)
+        return EINVAL;
+
+    MutexLocker locker(mutex());
+    auto* buffer = buffer_for_option(description, option);
+    if (!buffer)
+        return ENOTCONN;
+    auto name = buffer == m_for_client.ptr() ? "LocalSocket: Client buffer"sv : "LocalSocket: Server buffer"sv;
+    return buffer->try_resize(name, capacity);
+}
+
 ErrorOr<void> LocalSocket::getsockopt(OpenFileDescription& description, int level, int option, Userspace<void*> value, Userspace<socklen_t*> value_size)
 {
     if (level != SOL_SOCKET)
@@ -404,9 +440,17 @@ ErrorOr<void> LocalSocket::getsockopt(OpenFileDescription& description, int leve
 
     switch (option) {
     case SO_SNDBUF:
-        return ENOTSUP;
-    case SO_RCVBUF:
-        return ENOTSUP;
+    case SO_RCVBUF: {
+        if (size < sizeof(int))
+            return EINVAL;
+        auto* buffer = buffer_for_option(description, option);
+        if (!buffer)
+            return ENOTCONN;
+        int capacity = buffer->capacity();
+        TRY(copy_to_user(static_ptr_cast<int*>(value), &capacity));
+        size = sizeof(int);
+        return copy_to_user(value_size, &size);
+    }
     case SO_PEERCRED: {
         if (size < sizeof(ucred))
             return EINVAL;
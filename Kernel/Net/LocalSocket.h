@@ -7,8 +7,8 @@
 #pragma once
 
 #include <AK/IntrusiveList.h>
-#include <Kernel/DoubleBuffer.h>
 #include <Kernel/Net/Socket.h>
+#include <Kernel/SPSCRingBuffer.h>
 
 namespace Kernel {
 
@@ -47,18 +47,20 @@ public:
     virtual bool can_write(OpenFileDescription const&, u64) const override;
     virtual ErrorOr<size_t> sendto(OpenFileDescription&, UserOrKernelBuffer const&, size_t, int, Userspace<sockaddr const*>, socklen_t) override;
     virtual ErrorOr<size_t> recvfrom(OpenFileDescription&, UserOrKernelBuffer&, size_t, int flags, Userspace<sockaddr*>, Userspace<socklen_t*>, Time&, bool blocking) override;
+    virtual ErrorOr<void> setsockopt(OpenFileDescription&, int level, int option, Userspace<void const*>, socklen_t) override;
     virtual ErrorOr<void> getsockopt(OpenFileDescription&, int level, int option, Userspace<void*>, Userspace<socklen_t*>) override;
     virtual ErrorOr<void> ioctl(OpenFileDescription&, unsigned request, Userspace<void*> arg) override;
     virtual ErrorOr<void> chown(Credentials const&, OpenFileDescription&, UserID, GroupID) override;
     virtual ErrorOr<void> chmod(Credentials const&, OpenFileDescription&, mode_t) override;
 
 private:
-    explicit LocalSocket(int type, NonnullOwnPtr<DoubleBuffer> client_buffer, NonnullOwnPtr<DoubleBuffer> server_buffer);
+    explicit LocalSocket(int type, NonnullOwnPtr<SPSCRingBuffer> client_buffer, NonnullOwnPtr<SPSCRingBuffer> server_buffer);
     virtual StringView class_name() const override { return "LocalSocket"sv; }
     virtual bool is_local() const override { return true; }
     bool has_attached_peer(OpenFileDescription const&) const;
-    DoubleBuffer* receive_buffer_for(OpenFileDescription&);
-    DoubleBuffer* send_buffer_for(OpenFileDescription&);
+    SPSCRingBuffer* receive_buffer_for(OpenFileDescription&);
+    SPSCRingBuffer* send_buffer_for(OpenFileDescription&);
+    SPSCRingBuffer* buffer_for_option(OpenFileDescription const&, int option);
     NonnullLockRefPtrVector<OpenFileDescription>& sendfd_queue_for(OpenFileDescription const&);
     NonnullLockRefPtrVector<OpenFileDescription>& recvfd_queue_for(OpenFileDescription const&);
 
@@ -97,8 +99,8 @@ private:
     bool m_accept_side_fd_open { false };
     OwnPtr<KString> m_path;
 
-    NonnullOwnPtr<DoubleBuffer> m_for_client;
-    NonnullOwnPtr<DoubleBuffer> m_for_server;
+    NonnullOwnPtr<SPSCRingBuffer> m_for_client;
+    NonnullOwnPtr<SPSCRingBuffer> m_for_server;
 
     NonnullLockRefPtrVector<OpenFileDescription> m_fds_for_client;
     NonnullLockRefPtrVector<OpenFileDescription> m_fds_for_server;
@@ -11,6 +11,12 @@ namespace Kernel {
 
 static bool s_loopback_initialized = false;
 
+Atomic<bool> g_loopback_fault_injection;
+
+// Prime, so the losses and the reorderings hit different packets of a flow over time.
+static constexpr u32 dropped_packet_interval = 53;
+static constexpr u32 held_back_packet_interval = 31;
+
 LockRefPtr<LoopbackAdapter> LoopbackAdapter::try_create()
 {
     auto interface_name = KString::try_create("loop"sv);
@@ -33,7 +39,40 @@ LoopbackAdapter::~LoopbackAdapter() = default;
 void LoopbackAdapter::send_raw(ReadonlyBytes payload)
 {
     dbgln("LoopbackAdapter: Sending {} byte(s) to myself.", payload.size());
+    if (g_loopback_fault_injection.load(AK::MemoryOrder::memory_order_relaxed)) {
+        send_raw_with_faults(payload);
+        return;
+    }
+    did_receive(payload);
+}
+
+void LoopbackAdapter::send_raw_with_faults(ReadonlyBytes payload)
+{
+    auto packet_number = m_faulty_packet_count.fetch_add(1, AK::MemoryOrder::memory_order_relaxed) + 1;
+    if (packet_number % dropped_packet_interval == 0)
+        return;
+
+    // A held back packet arrives right after the next one that is sent.
+    Optional<ByteBuffer> previously_held_back_packet;
+    if (packet_number % held_back_packet_interval == 0) {
+        if (auto copy = ByteBuffer::copy(payload); !copy.is_error()) {
+            m_held_back_packet.with([&](auto& held_back_packet) {
+                previously_held_back_packet = move(held_back_packet);
+                held_back_packet = copy.release_value();
+            });
+            if (previously_held_back_packet.has_value())
+                did_receive(previously_held_back_packet->bytes());
+            return;
+        }
+    }
+
     did_receive(payload);
+    m_held_back_packet.with([&](auto& held_back_packet) {
+        previously_held_back_packet = move(held_back_packet);
+        held_back_packet.clear();
+    });
+    if (previously_held_back_packet.has_value())
+        did_receive(previously_held_back_packet->bytes());
 }
 
 }
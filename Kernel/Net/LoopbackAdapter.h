@@ -6,10 +6,16 @@
 
 #pragma once
 
+#include <AK/ByteBuffer.h>
+#include <Kernel/Locking/SpinlockProtected.h>
 #include <Kernel/Net/NetworkAdapter.h>
 
 namespace Kernel {
 
+// When set, the loopback adapter loses and reorders some of the packets sent through it,
+// so the tests can exercise the loss recovery of the protocols on top of it.
+extern Atomic<bool> g_loopback_fault_injection;
+
 class LoopbackAdapter final : public NetworkAdapter {
 private:
     LoopbackAdapter(NonnullOwnPtr<KString>);
@@ -23,6 +29,12 @@ public:
     virtual bool link_up() override { return true; }
     virtual bool link_full_duplex() override { return true; }
     virtual int link_speed() override { return 1000; }
+
+private:
+    void send_raw_with_faults(ReadonlyBytes);
+
+    Atomic<u32> m_faulty_packet_count { 0 };
+    SpinlockProtected<Optional<ByteBuffer>> m_held_back_packet { LockRank::None };
 };
 
 }
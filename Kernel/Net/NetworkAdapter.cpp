@@ -95,20 +95,33 @@ void NetworkAdapter::did_receive(ReadonlyBytes payload)
         on_receive();
 }
 
-size_t NetworkAdapter::dequeue_packet(u8* buffer, size_t buffer_size, Time& packet_timestamp)
+size_t NetworkAdapter::dequeue_packets(PacketList& packets, size_t max_packets)
 {
     InterruptDisabler disabler;
-    if (m_packet_queue.is_empty())
-        return 0;
-    auto packet_with_timestamp = m_packet_queue.take_first();
-    m_packet_queue_size--;
-    packet_timestamp = packet_with_timestamp->timestamp;
-    auto& packet_buffer = packet_with_timestamp->buffer;
-    size_t packet_size = packet_buffer->size();
-    VERIFY(packet_size <= buffer_size);
-    memcpy(buffer, packet_buffer->data(), packet_size);
-    release_packet_buffer(*packet_with_timestamp);
-    return packet_size;
+    size_t count = 0;
+    while (count < max_packets && !m_packet_queue.is_empty()) {
+        packets.append(*m_packet_queue.take_first());
+        m_packet_queue_size--;
+        count++;
+    }
+    return count;
+}
+
+void NetworkAdapter::schedule_poll()
+{
+    m_poll_scheduled.store(true, AK::MemoryOrder::memory_order_release);
+    if (on_receive)
+        on_receive();
+}
+
+size_t NetworkAdapter::poll(size_t budget)
+{
+    m_poll_scheduled.store(false, AK::MemoryOrder::memory_order_release);
+    auto received = poll_receive(budget);
+    // A full budget means there is probably more waiting, so keep the interrupt masked.
+    if (received >= budget)
+        m_poll_scheduled.store(true, AK::MemoryOrder::memory_order_release);
+    return received;
 }
 
 LockRefPtr<PacketWithTimestamp> NetworkAdapter::acquire_packet_buffer(size_t size)
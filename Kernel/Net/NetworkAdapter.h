@@ -6,6 +6,7 @@
 
 #pragma once
 
+#include <AK/Atomic.h>
 #include <AK/AtomicRefCounted.h>
 #include <AK/ByteBuffer.h>
 #include <AK/Function.h>
@@ -48,6 +49,8 @@ class NetworkAdapter
 public:
     static constexpr i32 LINKSPEED_INVALID = -1;
 
+    using PacketList = IntrusiveList<&PacketWithTimestamp::packet_node>;
+
     virtual ~NetworkAdapter();
 
     virtual StringView class_name() const = 0;
@@ -71,10 +74,17 @@ public:
     void send(MACAddress const&, ARPPacket const&);
     void fill_in_ipv4_header(PacketWithTimestamp&, IPv4Address const&, MACAddress const&, IPv4Address const&, IPv4Protocol, size_t, u8 type_of_service, u8 ttl);
 
-    size_t dequeue_packet(u8* buffer, size_t buffer_size, Time& packet_timestamp);
+    // Moves up to `max_packets` received packets to the end of `packets`, oldest first.
+    // They have to be handed back with release_packet_buffer() once they are processed.
+    size_t dequeue_packets(PacketList& packets, size_t max_packets);
 
     bool has_queued_packets() const { return !m_packet_queue.is_empty(); }
 
+    // Adapters that mitigate interrupts mask their receive interrupt once it fires and
+    // ask to be polled instead, until their receive ring is drained.
+    bool is_poll_scheduled() const { return m_poll_scheduled.load(AK::MemoryOrder::memory_order_acquire); }
+    size_t poll(size_t budget);
+
     u32 mtu() const { return m_mtu; }
     void set_mtu(u32 mtu) { m_mtu = mtu; }
 
@@ -99,6 +109,11 @@ protected:
     void did_receive(ReadonlyBytes);
     virtual void send_raw(ReadonlyBytes) = 0;
 
+    void schedule_poll();
+    // Receives at most `budget` frames and returns how many there were. Once fewer than
+    // `budget` frames were found, the receive interrupt has to be unmasked again.
+    virtual size_t poll_receive(size_t) { return 0; }
+
 private:
     MACAddress m_mac_address;
     IPv4Address m_ipv4_address;
@@ -107,10 +122,9 @@ private:
     // FIXME: Make this configurable
     static constexpr size_t max_packet_buffers = 1024;
 
-    using PacketList = IntrusiveList<&PacketWithTimestamp::packet_node>;
-
     PacketList m_packet_queue;
     size_t m_packet_queue_size { 0 };
+    Atomic<bool> m_poll_scheduled { false };
     SpinlockProtected<PacketList> m_unused_packets { LockRank::None };
     NonnullOwnPtr<KString> m_name;
     u32 m_packets_in { 0 };
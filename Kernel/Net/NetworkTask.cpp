@@ -4,6 +4,10 @@
  * SPDX-License-Identifier: BSD-2-Clause
  */
 
+#include <AK/CircularQueue.h>
+#include <AK/HashFunctions.h>
+#include <AK/ScopeGuard.h>
+#include <Kernel/CommandLine.h>
 #include <Kernel/Debug.h>
 #include <Kernel/Locking/Mutex.h>
 #include <Kernel/Locking/MutexProtected.h>
@@ -32,35 +36,91 @@ static void handle_udp(IPv4Packet const&, Time const& packet_timestamp);
 static void handle_tcp(IPv4Packet const&, Time const& packet_timestamp);
 static void send_delayed_tcp_ack(LockRefPtr<TCPSocket> socket);
 static void send_tcp_rst(IPv4Packet const& ipv4_packet, TCPPacket const& tcp_packet, LockRefPtr<NetworkAdapter> adapter);
-static void flush_delayed_tcp_acks();
 static void retransmit_tcp_packets();
 
-static Thread* network_task = nullptr;
-static HashTable<LockRefPtr<TCPSocket>>* delayed_ack_sockets;
+// Frames are taken from each adapter in batches of this size, so that a busy adapter can't
+// starve the others, and so a polled adapter re-arms its interrupt only once it's idle.
+static constexpr size_t receive_batch_size = 64;
+static constexpr size_t max_receive_workers = 16;
+static constexpr size_t max_queued_frames_per_worker = 1024;
+
+struct ReceivedFrame {
+    LockRefPtr<NetworkAdapter> adapter;
+    LockRefPtr<PacketWithTimestamp> packet;
+};
+
+// The network task is receive worker 0. It takes frames from all adapters and steers each one
+// to a worker by its flow hash, so all packets of a TCP connection are handled on one thread.
+struct ReceiveWorker {
+    Thread* thread { nullptr };
+    WaitQueue wait_queue;
+    SpinlockProtected<CircularQueue<ReceivedFrame, max_queued_frames_per_worker>> queued_frames { LockRank::None };
+    HashTable<LockRefPtr<TCPSocket>> delayed_ack_sockets;
+};
+
+static Array<ReceiveWorker*, max_receive_workers> s_receive_workers;
+static size_t s_receive_worker_count = 0;
+static NonnullLockRefPtrVector<NetworkAdapter>* s_adapters;
+
+static void process_frame(NetworkAdapter&, PacketWithTimestamp&);
+static void steer_frames(NetworkAdapter&, NetworkAdapter::PacketList&);
+static void flush_delayed_tcp_acks(ReceiveWorker&);
+static ReceiveWorker& current_receive_worker();
 
 [[noreturn]] static void NetworkTask_main(void*);
+[[noreturn]] static void ReceiveWorker_main(void*);
 
 void NetworkTask::spawn()
 {
+    s_receive_workers[0] = new ReceiveWorker;
+    s_receive_worker_count = 1;
+
     LockRefPtr<Thread> thread;
     auto name = KString::try_create("Network Task"sv);
     if (name.is_error())
         TODO();
-    (void)Process::create_kernel_process(thread, name.release_value(), NetworkTask_main, nullptr);
-    network_task = thread;
+    (void)Process::create_kernel_process(thread, name.release_value(), NetworkTask_main, s_receive_workers[0]);
 }
 
 bool NetworkTask::is_current()
 {
-    return Thread::current() == network_task;
+    auto* current_thread = Thread::current();
+    for (size_t i = 0; i < s_receive_worker_count; ++i) {
+        if (s_receive_workers[i]->thread == current_thread)
+            return true;
+    }
+    return false;
+}
+
+static void spawn_receive_workers()
+{
+    auto processor_count = Processor::count();
+    auto worker_count = kernel_command_line().network_receive_workers().value_or(processor_count - 1) + 1;
+    worker_count = min(worker_count, max_receive_workers);
+
+    for (size_t index = 1; index < worker_count; ++index) {
+        auto* worker = new ReceiveWorker;
+        auto name = KString::formatted("Network Receive Worker #{}", index);
+        if (name.is_error())
+            break;
+        // Spread the workers over the processors, leaving the first one to the network task.
+        auto thread = Process::current().create_kernel_thread(ReceiveWorker_main, worker, THREAD_PRIORITY_NORMAL, name.release_value(), 1u << (index % processor_count), false);
+        if (!thread) {
+            delete worker;
+            break;
+        }
+        s_receive_workers[index] = worker;
+        s_receive_worker_count = index + 1;
+    }
+    dmesgln("NetworkTask: Processing received packets on {} thread(s)", s_receive_worker_count);
 }
 
-void NetworkTask_main(void*)
+void NetworkTask_main(void* data)
 {
-    delayed_ack_sockets = new HashTable<LockRefPtr<TCPSocket>>;
+    auto& worker = *static_cast<ReceiveWorker*>(data);
+    worker.thread = Thread::current();
 
-    WaitQueue packet_wait_queue;
-    int pending_packets = 0;
+    s_adapters = new NonnullLockRefPtrVector<NetworkAdapter>;
     NetworkingManagement::the().for_each([&](auto& adapter) {
         dmesgln("NetworkTask: {} network adapter found: hw={}", adapter.class_name(), adapter.mac_address().to_string());
 
@@ -69,64 +129,160 @@ void NetworkTask_main(void*)
             adapter.set_ipv4_netmask({ 255, 0, 0, 0 });
         }
 
-        adapter.on_receive = [&]() {
-            pending_packets++;
-            packet_wait_queue.wake_all();
+        adapter.on_receive = [&worker]() {
+            worker.wait_queue.wake_all();
         };
+        MUST(s_adapters->try_append(adapter));
     });
 
-    auto dequeue_packet = [&pending_packets](u8* buffer, size_t buffer_size, Time& packet_timestamp) -> size_t {
-        if (pending_packets == 0)
-            return 0;
-        size_t packet_size = 0;
-        NetworkingManagement::the().for_each([&](auto& adapter) {
-            if (packet_size || !adapter.has_queued_packets())
-                return;
-            packet_size = adapter.dequeue_packet(buffer, buffer_size, packet_timestamp);
-            pending_packets--;
-            dbgln_if(NETWORK_TASK_DEBUG, "NetworkTask: Dequeued packet from {} ({} bytes)", adapter.name(), packet_size);
-        });
-        return packet_size;
-    };
-
-    size_t buffer_size = 64 * KiB;
-    auto region_or_error = MM.allocate_kernel_region(buffer_size, "Kernel Packet Buffer"sv, Memory::Region::Access::ReadWrite);
-    if (region_or_error.is_error())
-        TODO();
-    auto buffer_region = region_or_error.release_value();
-    auto buffer = (u8*)buffer_region->vaddr().get();
-    Time packet_timestamp;
+    spawn_receive_workers();
 
     for (;;) {
-        flush_delayed_tcp_acks();
+        flush_delayed_tcp_acks(worker);
         retransmit_tcp_packets();
-        size_t packet_size = dequeue_packet(buffer, buffer_size, packet_timestamp);
-        if (!packet_size) {
+
+        bool did_receive = false;
+        for (auto& adapter : *s_adapters) {
+            if (adapter.is_poll_scheduled())
+                adapter.poll(receive_batch_size);
+
+            NetworkAdapter::PacketList frames;
+            auto frame_count = adapter.dequeue_packets(frames, receive_batch_size);
+            if (frame_count == 0)
+                continue;
+            dbgln_if(NETWORK_TASK_DEBUG, "NetworkTask: Dequeued {} packets from {}", frame_count, adapter.name());
+            did_receive = true;
+            steer_frames(adapter, frames);
+        }
+
+        if (!did_receive) {
             auto timeout_time = Time::from_milliseconds(500);
             auto timeout = Thread::BlockTimeout { false, &timeout_time };
-            [[maybe_unused]] auto result = packet_wait_queue.wait_on(timeout, "NetworkTask"sv);
+            [[maybe_unused]] auto result = worker.wait_queue.wait_on(timeout, "NetworkTask"sv);
+        }
+    }
+}
+
+void ReceiveWorker_main(void* data)
+{
+    auto& worker = *static_cast<ReceiveWorker*>(data);
+    worker.thread = Thread::current();
+    Vector<ReceivedFrame, receive_batch_size> frames;
+
+    for (;;) {
+        flush_delayed_tcp_acks(worker);
+
+        worker.queued_frames.with([&](auto& queued_frames) {
+            while (frames.size() < receive_batch_size && !queued_frames.is_empty())
+                frames.unchecked_append(queued_frames.dequeue());
+        });
+
+        if (frames.is_empty()) {
+            auto timeout_time = Time::from_milliseconds(500);
+            auto timeout = Thread::BlockTimeout { false, &timeout_time };
+            [[maybe_unused]] auto result = worker.wait_queue.wait_on(timeout, "NetworkReceiveWorker"sv);
             continue;
         }
-        if (packet_size < sizeof(EthernetFrameHeader)) {
-            dbgln("NetworkTask: Packet is too small to be an Ethernet packet! ({})", packet_size);
+
+        for (auto& frame : frames)
+            process_frame(*frame.adapter, *frame.packet);
+        frames.clear_with_capacity();
+    }
+}
+
+ReceiveWorker& current_receive_worker()
+{
+    auto* current_thread = Thread::current();
+    for (size_t i = 0; i < s_receive_worker_count; ++i) {
+        if (s_receive_workers[i]->thread == current_thread)
+            return *s_receive_workers[i];
+    }
+    VERIFY_NOT_REACHED();
+}
+
+// Returns the worker that handles this frame. Everything that isn't the unfragmented
+// part of a TCP or UDP flow, like ARP and ICMP, is left to the network task.
+static size_t receive_worker_for_frame(ReadonlyBytes frame)
+{
+    if (s_receive_worker_count == 1)
+        return 0;
+
+    constexpr size_t minimum_flow_frame_size = sizeof(EthernetFrameHeader) + sizeof(IPv4Packet) + 2 * sizeof(u16);
+    if (frame.size() < minimum_flow_frame_size)
+        return 0;
+    auto& eth = *(EthernetFrameHeader const*)frame.data();
+    if (eth.ether_type() != EtherType::IPv4)
+        return 0;
+    auto& ipv4_packet = *static_cast<IPv4Packet const*>(eth.payload());
+    auto protocol = (IPv4Protocol)ipv4_packet.protocol();
+    if ((protocol != IPv4Protocol::TCP && protocol != IPv4Protocol::UDP) || ipv4_packet.is_a_fragment())
+        return 0;
+
+    // Both TCP and UDP start with the source and destination port.
+    u32 ports;
+    memcpy(&ports, ipv4_packet.payload(), sizeof(ports));
+    auto hash = pair_int_hash(pair_int_hash(ipv4_packet.source().to_u32(), ipv4_packet.destination().to_u32()), ports);
+    return hash % s_receive_worker_count;
+}
+
+void steer_frames(NetworkAdapter& adapter, NetworkAdapter::PacketList& frames)
+{
+    // Wake every worker at most once per batch.
+    Array<bool, max_receive_workers> should_wake {};
+
+    while (!frames.is_empty()) {
+        auto packet = frames.take_first();
+        auto index = receive_worker_for_frame(packet->bytes());
+        if (index == 0) {
+            process_frame(adapter, *packet);
             continue;
         }
-        auto& eth = *(EthernetFrameHeader const*)buffer;
-        dbgln_if(ETHERNET_DEBUG, "NetworkTask: From {} to {}, ether_type={:#04x}, packet_size={}", eth.source().to_string(), eth.destination().to_string(), eth.ether_type(), packet_size);
 
-        switch (eth.ether_type()) {
-        case EtherType::ARP:
-            handle_arp(eth, packet_size);
-            break;
-        case EtherType::IPv4:
-            handle_ipv4(eth, packet_size, packet_timestamp);
-            break;
-        case EtherType::IPv6:
-            // ignore
-            break;
-        default:
-            dbgln_if(ETHERNET_DEBUG, "NetworkTask: Unknown ethernet type {:#04x}", eth.ether_type());
+        auto& worker = *s_receive_workers[index];
+        bool did_queue = worker.queued_frames.with([&](auto& queued_frames) {
+            if (queued_frames.size() == queued_frames.capacity())
+                return false;
+            queued_frames.enqueue(ReceivedFrame { adapter, packet });
+            return true;
+        });
+        if (!did_queue) {
+            dbgln_if(NETWORK_TASK_DEBUG, "NetworkTask: Dropping packet, worker #{} is too far behind", index);
+            adapter.release_packet_buffer(*packet);
+            continue;
         }
+        should_wake[index] = true;
+    }
+
+    for (size_t index = 1; index < s_receive_worker_count; ++index) {
+        if (should_wake[index])
+            s_receive_workers[index]->wait_queue.wake_all();
+    }
+}
+
+void process_frame(NetworkAdapter& adapter, PacketWithTimestamp& packet)
+{
+    auto frame = packet.bytes();
+    ScopeGuard release_packet = [&] { adapter.release_packet_buffer(packet); };
+
+    if (frame.size() < sizeof(EthernetFrameHeader)) {
+        dbgln("NetworkTask: Packet is too small to be an Ethernet packet! ({})", frame.size());
+        return;
+    }
+    auto& eth = *(EthernetFrameHeader const*)frame.data();
+    dbgln_if(ETHERNET_DEBUG, "NetworkTask: From {} to {}, ether_type={:#04x}, packet_size={}", eth.source().to_string(), eth.destination().to_string(), eth.ether_type(), frame.size());
+
+    switch (eth.ether_type()) {
+    case EtherType::ARP:
+        handle_arp(eth, frame.size());
+        break;
+    case EtherType::IPv4:
+        handle_ipv4(eth, frame.size(), packet.timestamp);
+        break;
+    case EtherType::IPv6:
+        // ignore
+        break;
+    default:
+        dbgln_if(ETHERNET_DEBUG, "NetworkTask: Unknown ethernet type {:#04x}", eth.ether_type());
     }
 }
 
@@ -310,13 +466,15 @@ void send_delayed_tcp_ack(LockRefPtr<TCPSocket> socket)
         return;
     }
 
-    delayed_ack_sockets->set(move(socket));
+    // The flow's packets are all steered to this worker, so it will flush the ACK as well.
+    current_receive_worker().delayed_ack_sockets.set(move(socket));
 }
 
-void flush_delayed_tcp_acks()
+void flush_delayed_tcp_acks(ReceiveWorker& worker)
 {
+    auto& delayed_ack_sockets = worker.delayed_ack_sockets;
     Vector<LockRefPtr<TCPSocket>, 32> remaining_sockets;
-    for (auto& socket : *delayed_ack_sockets) {
+    for (auto& socket : delayed_ack_sockets) {
         MutexLocker locker(socket->mutex());
         if (socket->should_delay_next_ack()) {
             MUST(remaining_sockets.try_append(socket));
@@ -325,12 +483,12 @@ void flush_delayed_tcp_acks()
         [[maybe_unused]] auto result = socket->send_ack();
     }
 
-    if (remaining_sockets.size() != delayed_ack_sockets->size()) {
-        delayed_ack_sockets->clear();
+    if (remaining_sockets.size() != delayed_ack_sockets.size()) {
+        delayed_ack_sockets.clear();
         if (remaining_sockets.size() > 0)
             dbgln("flush_delayed_tcp_acks: {} sockets remaining", remaining_sockets.size());
         for (auto&& socket : remaining_sockets)
-            delayed_ack_sockets->set(move(socket));
+            delayed_ack_sockets.set(move(socket));
     }
 }
 
@@ -457,6 +615,7 @@ void handle_tcp(IPv4Packet const& ipv4_packet, Time const& packet_timestamp)
             auto client = client_or_error.release_value();
             MutexLocker locker(client->mutex());
             dbgln_if(TCP_DEBUG, "handle_tcp: created new client socket with tuple {}", client->tuple().to_string());
+            client->process_syn_options(tcp_packet);
             client->set_sequence_number(1000);
             client->set_ack_number(tcp_packet.sequence_number() + payload_size + 1);
             [[maybe_unused]] auto rc2 = client->send_tcp_packet(TCPFlags::SYN | TCPFlags::ACK);
@@ -471,11 +630,13 @@ void handle_tcp(IPv4Packet const& ipv4_packet, Time const& packet_timestamp)
     case TCPSocket::State::SynSent:
         switch (tcp_packet.flags()) {
         case TCPFlags::SYN:
+            socket->process_syn_options(tcp_packet);
             socket->set_ack_number(tcp_packet.sequence_number() + payload_size + 1);
             (void)socket->send_tcp_packet(TCPFlags::SYN | TCPFlags::ACK);
             socket->set_state(TCPSocket::State::SynReceived);
             return;
         case TCPFlags::ACK | TCPFlags::SYN:
+            socket->process_syn_options(tcp_packet);
             socket->set_ack_number(tcp_packet.sequence_number() + payload_size + 1);
             (void)socket->send_ack(true);
             socket->set_state(TCPSocket::State::Established);
@@ -620,6 +781,13 @@ void handle_tcp(IPv4Packet const& ipv4_packet, Time const& packet_timestamp)
         }
 
         if (tcp_packet.sequence_number() != socket->ack_number()) {
+            if (!tcp_packet.has_fin() && socket->queue_out_of_order_segment(tcp_packet, payload_size)) {
+                dbgln_if(TCP_DEBUG, "Queued out of order packet: seq {} vs. ack {}", tcp_packet.sequence_number(), socket->ack_number());
+                // RFC 5681 says to ACK out of order segments right away. The SACK blocks in the
+                // ACK tell the sender what we already have.
+                [[maybe_unused]] auto result = socket->send_ack(true);
+                return;
+            }
             dbgln_if(TCP_DEBUG, "Discarding out of order packet: seq {} vs. ack {}", tcp_packet.sequence_number(), socket->ack_number());
             if (socket->duplicate_acks() < TCPSocket::maximum_duplicate_acks) {
                 dbgln_if(TCP_DEBUG, "Sending ACK with same ack number to trigger fast retransmission");
@@ -645,9 +813,17 @@ void handle_tcp(IPv4Packet const& ipv4_packet, Time const& packet_timestamp)
         if (payload_size) {
             if (socket->did_receive(ipv4_packet.source(), tcp_packet.source_port(), { &ipv4_packet, sizeof(IPv4Packet) + ipv4_packet.payload_size() }, packet_timestamp)) {
                 socket->set_ack_number(tcp_packet.sequence_number() + payload_size);
+                // A segment that fills a hole is ACKed right away (RFC 5681, section 4.2).
+                bool did_fill_hole = socket->deliver_out_of_order_segments();
                 dbgln_if(TCP_DEBUG, "Got packet with ack_no={}, seq_no={}, payload_size={}, acking it with new ack_no={}, seq_no={}",
                     tcp_packet.ack_number(), tcp_packet.sequence_number(), payload_size, socket->ack_number(), socket->sequence_number());
-                send_delayed_tcp_ack(socket);
+                if (did_fill_hole)
+                    (void)socket->send_ack(true);
+                else
+                    send_delayed_tcp_ack(socket);
+            } else {
+                // Our receive buffer is full, let the sender know what our window looks like.
+                (void)socket->send_ack(true);
             }
         }
     }
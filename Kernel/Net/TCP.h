@@ -22,6 +22,19 @@ struct TCPFlags {
     };
 };
 
+enum class TCPOptionKind : u8 {
+    End = 0,
+    NoOperation = 1,
+    MSS = 2,
+    WindowScale = 3,
+    SACKPermitted = 4,
+    SACK = 5,
+};
+
+// Sequence numbers wrap around, so they are compared by their distance (RFC 793, section 3.3).
+inline bool tcp_sequence_before(u32 a, u32 b) { return static_cast<i32>(a - b) < 0; }
+inline bool tcp_sequence_before_or_equal(u32 a, u32 b) { return static_cast<i32>(a - b) <= 0; }
+
 class [[gnu::packed]] TCPOptionMSS {
 public:
     TCPOptionMSS(u16 value)
@@ -39,6 +52,62 @@ private:
 
 static_assert(AssertSize<TCPOptionMSS, 4>());
 
+// RFC 7323, section 2.2. Prefixed with a NOP to keep the following options aligned.
+class [[gnu::packed]] TCPOptionWindowScale {
+public:
+    TCPOptionWindowScale(u8 shift_count)
+        : m_shift_count(shift_count)
+    {
+    }
+
+    u8 shift_count() const { return m_shift_count; }
+
+private:
+    u8 m_padding { to_underlying(TCPOptionKind::NoOperation) };
+    u8 m_option_kind { to_underlying(TCPOptionKind::WindowScale) };
+    u8 m_option_length { 3 };
+    u8 m_shift_count { 0 };
+};
+
+static_assert(AssertSize<TCPOptionWindowScale, 4>());
+
+// RFC 2018, section 2. Prefixed with two NOPs to keep the following options aligned.
+class [[gnu::packed]] TCPOptionSACKPermitted {
+private:
+    u8 m_padding[2] { to_underlying(TCPOptionKind::NoOperation), to_underlying(TCPOptionKind::NoOperation) };
+    u8 m_option_kind { to_underlying(TCPOptionKind::SACKPermitted) };
+    u8 m_option_length { 2 };
+};
+
+static_assert(AssertSize<TCPOptionSACKPermitted, 4>());
+
+struct [[gnu::packed]] TCPSACKBlock {
+    NetworkOrdered<u32> left_edge;
+    NetworkOrdered<u32> right_edge;
+};
+
+static_assert(AssertSize<TCPSACKBlock, 8>());
+
+// RFC 2018, section 3. The header is followed by up to four blocks, and is prefixed with
+// two NOPs to keep them aligned.
+class [[gnu::packed]] TCPOptionSACKHeader {
+public:
+    static constexpr size_t maximum_block_count = 4;
+
+    TCPOptionSACKHeader(size_t block_count)
+        : m_option_length(2 + block_count * sizeof(TCPSACKBlock))
+    {
+        VERIFY(block_count > 0 && block_count <= maximum_block_count);
+    }
+
+private:
+    u8 m_padding[2] { to_underlying(TCPOptionKind::NoOperation), to_underlying(TCPOptionKind::NoOperation) };
+    u8 m_option_kind { to_underlying(TCPOptionKind::SACK) };
+    u8 m_option_length { 0 };
+};
+
+static_assert(AssertSize<TCPOptionSACKHeader, 4>());
+
 class [[gnu::packed]] TCPPacket {
 public:
     TCPPacket() = default;
@@ -78,6 +147,30 @@ public:
     u16 urgent() const { return m_urgent; }
     void set_urgent(u16 urgent) { m_urgent = urgent; }
 
+    // Calls the callback with the kind and data of every well-formed option in the header.
+    template<typename Callback>
+    void for_each_option(Callback callback) const
+    {
+        auto const* options = reinterpret_cast<u8 const*>(this) + sizeof(TCPPacket);
+        size_t options_size = header_size() > sizeof(TCPPacket) ? header_size() - sizeof(TCPPacket) : 0;
+        for (size_t offset = 0; offset < options_size;) {
+            auto kind = static_cast<TCPOptionKind>(options[offset]);
+            if (kind == TCPOptionKind::End)
+                return;
+            if (kind == TCPOptionKind::NoOperation) {
+                ++offset;
+                continue;
+            }
+            if (offset + 1 >= options_size)
+                return;
+            u8 length = options[offset + 1];
+            if (length < 2 || offset + length > options_size)
+                return;
+            callback(kind, ReadonlyBytes { options + offset + 2, length - 2u });
+            offset += length;
+        }
+    }
+
     void const* payload() const { return ((u8 const*)this) + header_size(); }
     void* payload() { return ((u8*)this) + header_size(); }
 
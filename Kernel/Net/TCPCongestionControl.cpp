@@ -0,0 +1,198 @@
+/*
+ * Copyright (c) 2022, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <AK/NumericLimits.h>
+#include <Kernel/Net/TCPCongestionControl.h>
+
+namespace Kernel {
+
+// Keeps the arithmetic below far away from overflowing. No peer can usefully receive more
+// than this per round trip anyway.
+static constexpr size_t maximum_congestion_window = 64 * MiB;
+
+Optional<TCPCongestionControl::Algorithm> TCPCongestionControl::algorithm_from_name(StringView name)
+{
+    if (name == to_string(Algorithm::Reno))
+        return Algorithm::Reno;
+    if (name == to_string(Algorithm::Cubic))
+        return Algorithm::Cubic;
+    return {};
+}
+
+TCPCongestionControl::TCPCongestionControl(Algorithm algorithm, size_t maximum_segment_size)
+    : m_algorithm(algorithm)
+{
+    set_maximum_segment_size(maximum_segment_size);
+}
+
+void TCPCongestionControl::set_algorithm(Algorithm algorithm)
+{
+    if (algorithm == this->algorithm())
+        return;
+
+    // The new algorithm's state is set up before it is published. An ACK that is being processed
+    // concurrently keeps using the old algorithm, whose state isn't touched here.
+    switch (algorithm) {
+    case Algorithm::Reno:
+        m_bytes_acked = 0;
+        break;
+    case Algorithm::Cubic:
+        cubic_reset();
+        break;
+    }
+    m_algorithm.store(algorithm, AK::MemoryOrder::memory_order_release);
+}
+
+void TCPCongestionControl::set_maximum_segment_size(size_t maximum_segment_size)
+{
+    VERIFY(maximum_segment_size > 0);
+    m_maximum_segment_size = maximum_segment_size;
+    // RFC 6928 says the initial window should be min(10*MSS, max(2*MSS, 14600)).
+    m_congestion_window = min(10 * maximum_segment_size, max(2 * maximum_segment_size, 14600));
+    m_slow_start_threshold = NumericLimits<size_t>::max();
+}
+
+void TCPCongestionControl::on_ack(size_t acked_bytes, size_t bytes_in_flight, Time const& now, Time const& smoothed_round_trip_time)
+{
+    // When the application or the peer's window keeps us from filling the congestion window,
+    // the ACKs say nothing about whether a larger window would work (RFC 7661).
+    if (bytes_in_flight + acked_bytes < m_congestion_window / 2)
+        return;
+
+    if (is_in_slow_start()) {
+        // RFC 3465 allows growing by up to two segments per ACK.
+        m_congestion_window += min(acked_bytes, 2 * m_maximum_segment_size);
+    } else {
+        switch (algorithm()) {
+        case Algorithm::Reno:
+            reno_increase_window(acked_bytes);
+            break;
+        case Algorithm::Cubic:
+            cubic_increase_window(acked_bytes, now, smoothed_round_trip_time);
+            break;
+        }
+    }
+    m_congestion_window = min(m_congestion_window, maximum_congestion_window);
+}
+
+void TCPCongestionControl::on_fast_retransmit(size_t bytes_in_flight)
+{
+    size_t window_after_loss = 0;
+    switch (algorithm()) {
+    case Algorithm::Reno:
+        window_after_loss = reno_window_after_loss(bytes_in_flight);
+        break;
+    case Algorithm::Cubic:
+        window_after_loss = cubic_window_after_loss();
+        break;
+    }
+    m_slow_start_threshold = max(window_after_loss, minimum_window());
+    m_congestion_window = m_slow_start_threshold;
+}
+
+void TCPCongestionControl::on_retransmit_timeout(size_t bytes_in_flight)
+{
+    if (algorithm() == Algorithm::Cubic)
+        cubic_reset();
+    // RFC 5681, section 3.1: after a timeout, fall back to a loss window of one segment.
+    m_slow_start_threshold = max(bytes_in_flight / 2, minimum_window());
+    m_congestion_window = m_maximum_segment_size;
+}
+
+void TCPCongestionControl::reno_increase_window(size_t acked_bytes)
+{
+    // Grow by one segment per window's worth of acknowledged bytes.
+    m_bytes_acked += acked_bytes;
+    if (m_bytes_acked >= m_congestion_window) {
+        m_bytes_acked -= m_congestion_window;
+        m_congestion_window += m_maximum_segment_size;
+    }
+}
+
+size_t TCPCongestionControl::reno_window_after_loss(size_t bytes_in_flight)
+{
+    m_bytes_acked = 0;
+    return bytes_in_flight / 2;
+}
+
+static u64 integer_cube_root(u64 value)
+{
+    // (2^22)^3 is larger than any u64, so the root is below that.
+    u64 low = 0;
+    u64 high = 1 << 22;
+    while (low < high) {
+        u64 middle = (low + high + 1) / 2;
+        if (middle * middle * middle <= value)
+            low = middle;
+        else
+            high = middle - 1;
+    }
+    return low;
+}
+
+void TCPCongestionControl::cubic_increase_window(size_t acked_bytes, Time const& now, Time const& smoothed_round_trip_time)
+{
+    auto mss = m_maximum_segment_size;
+    auto cwnd = m_congestion_window;
+
+    if (!m_epoch_start.has_value()) {
+        m_epoch_start = now;
+        if (cwnd < m_window_before_loss) {
+            // K = cbrt((W_max - cwnd) / C) seconds, with C = 0.4 segments per second cubed.
+            u64 distance_ms_cubed = static_cast<u64>(m_window_before_loss - cwnd) * 2'500'000'000ull / mss;
+            m_time_to_origin_ms = static_cast<i64>(integer_cube_root(distance_ms_cubed));
+        } else {
+            m_time_to_origin_ms = 0;
+            m_window_before_loss = cwnd;
+        }
+    }
+
+    i64 rtt_ms = smoothed_round_trip_time.to_milliseconds();
+    // The window is computed for where it should be one round trip from now.
+    i64 elapsed_ms = (now - *m_epoch_start).to_milliseconds() + rtt_ms;
+    i64 distance_ms = clamp<i64>(elapsed_ms - m_time_to_origin_ms, -100'000, 100'000);
+    // W_cubic(t) = C * (t - K)^3 + W_max, scaled from segments to bytes.
+    i64 offset = distance_ms * distance_ms * distance_ms * 4 / 10 / 1000 * static_cast<i64>(mss) / 1'000'000;
+    i64 target = max<i64>(static_cast<i64>(m_window_before_loss) + offset, 0);
+
+    // In the TCP-friendly region, don't grow any slower than Reno would (RFC 8312, section 4.2).
+    if (rtt_ms > 0) {
+        i64 reno_estimate = static_cast<i64>(m_window_before_loss) * 7 / 10 + 9 * elapsed_ms * static_cast<i64>(mss) / (17 * rtt_ms);
+        target = max(target, reno_estimate);
+    }
+
+    size_t increase;
+    if (static_cast<u64>(target) > cwnd) {
+        // Moves (target - cwnd) / cwnd segments per acknowledged segment, which is
+        // capped so the window grows by at most half per round trip.
+        increase = min<u64>((static_cast<u64>(target) - cwnd) * acked_bytes / cwnd, acked_bytes / 2);
+    } else {
+        increase = acked_bytes * mss / (100 * cwnd);
+    }
+    m_congestion_window += increase;
+}
+
+size_t TCPCongestionControl::cubic_window_after_loss()
+{
+    m_epoch_start.clear();
+    // Fast convergence (RFC 8312, section 4.6): if we lost before reaching the previous
+    // maximum, give up some more bandwidth to let newer flows catch up.
+    if (m_congestion_window < m_window_before_loss)
+        m_window_before_loss = m_congestion_window * 17 / 20;
+    else
+        m_window_before_loss = m_congestion_window;
+    // The multiplicative decrease factor is 0.7.
+    return m_congestion_window * 7 / 10;
+}
+
+void TCPCongestionControl::cubic_reset()
+{
+    m_epoch_start.clear();
+    m_window_before_loss = m_congestion_window;
+    m_time_to_origin_ms = 0;
+}
+
+}
@@ -0,0 +1,90 @@
+/*
+ * Copyright (c) 2022, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#pragma once
+
+#include <AK/Atomic.h>
+#include <AK/Optional.h>
+#include <AK/StringView.h>
+#include <AK/Time.h>
+
+namespace Kernel {
+
+// Decides how many bytes a TCP connection may have in flight. The common parts (slow start,
+// reacting to timeouts) are the same for every algorithm, while the algorithm decides how the
+// window grows during congestion avoidance and how far it shrinks when a loss is detected.
+// A connection keeps the same instance for its whole lifetime, even when it switches
+// algorithms, as the socket reads it without holding its mutex.
+class TCPCongestionControl {
+public:
+    enum class Algorithm {
+        Reno,
+        Cubic,
+    };
+
+    static constexpr Algorithm default_algorithm = Algorithm::Cubic;
+
+    static Optional<Algorithm> algorithm_from_name(StringView);
+
+    static StringView to_string(Algorithm algorithm)
+    {
+        switch (algorithm) {
+        case Algorithm::Reno:
+            return "reno"sv;
+        case Algorithm::Cubic:
+            return "cubic"sv;
+        default:
+            return "invalid"sv;
+        }
+    }
+
+    TCPCongestionControl(Algorithm, size_t maximum_segment_size);
+
+    Algorithm algorithm() const { return m_algorithm.load(AK::MemoryOrder::memory_order_acquire); }
+    // Keeps the current window, so the connection continues from where it is.
+    void set_algorithm(Algorithm);
+
+    size_t congestion_window() const { return m_congestion_window; }
+    size_t slow_start_threshold() const { return m_slow_start_threshold; }
+    bool is_in_slow_start() const { return m_congestion_window < m_slow_start_threshold; }
+
+    // Called once the handshake has settled the segment size, before any data is sent.
+    void set_maximum_segment_size(size_t);
+
+    // Called for every ACK that acknowledges new data.
+    void on_ack(size_t acked_bytes, size_t bytes_in_flight, Time const& now, Time const& smoothed_round_trip_time);
+    // Called when duplicate ACKs or SACK blocks show that a segment was lost.
+    void on_fast_retransmit(size_t bytes_in_flight);
+    void on_retransmit_timeout(size_t bytes_in_flight);
+
+private:
+    size_t minimum_window() const { return 2 * m_maximum_segment_size; }
+
+    // RFC 5681, with appropriate byte counting (RFC 3465).
+    void reno_increase_window(size_t acked_bytes);
+    size_t reno_window_after_loss(size_t bytes_in_flight);
+
+    // RFC 8312. The cubic function is evaluated with integer arithmetic, in milliseconds.
+    void cubic_increase_window(size_t acked_bytes, Time const& now, Time const& smoothed_round_trip_time);
+    size_t cubic_window_after_loss();
+    void cubic_reset();
+
+    Atomic<Algorithm> m_algorithm;
+
+    size_t m_maximum_segment_size { 0 };
+    size_t m_congestion_window { 0 };
+    size_t m_slow_start_threshold { 0 };
+
+    // Reno
+    size_t m_bytes_acked { 0 };
+
+    // CUBIC
+    size_t m_window_before_loss { 0 };
+    Optional<Time> m_epoch_start;
+    i64 m_time_to_origin_ms { 0 };
+};
+
+}
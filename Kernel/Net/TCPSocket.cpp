@@ -22,6 +22,20 @@
 
 namespace Kernel {
 
+// Receive buffers start out at the size IPv4Socket gives them, and grow up to this size.
+static constexpr size_t maximum_receive_buffer_size = 2 * MiB;
+
+// The smallest shift count that lets us announce the largest receive buffer (RFC 7323, section 2.3).
+static constexpr u8 receive_window_scale_for(size_t buffer_size)
+{
+    u8 shift_count = 0;
+    while ((static_cast<size_t>(NumericLimits<u16>::max()) << shift_count) < buffer_size)
+        ++shift_count;
+    return shift_count;
+}
+
+static constexpr u8 offered_receive_window_scale = receive_window_scale_for(maximum_receive_buffer_size);
+
 void TCPSocket::for_each(Function<void(TCPSocket const&)> callback)
 {
     sockets_by_tuple().for_each_shared([&](auto const& it) {
@@ -73,9 +87,14 @@ void TCPSocket::set_state(State new_state)
         // are packets on the way which we wouldn't want a new socket to get hit
         // with, so there's no point in keeping the receive buffer around.
         drop_receive_buffer();
+        m_out_of_order_segments.clear();
+        m_out_of_order_bytes = 0;
     }
 
     if (new_state == State::Closed) {
+        m_out_of_order_segments.clear();
+        m_out_of_order_bytes = 0;
+
         closing_sockets().with_exclusive([&](auto& table) {
             table.remove(tuple());
         });
@@ -130,7 +149,8 @@ ErrorOr<NonnullLockRefPtr<TCPSocket>> TCPSocket::try_create_client(IPv4Address c
             return EEXIST;
 
         auto receive_buffer = TRY(try_create_receive_buffer());
-        auto client = TRY(TCPSocket::try_create(protocol(), move(receive_buffer)));
+        // Like on other systems, accepted connections use the listening socket's congestion control.
+        auto client = TRY(TCPSocket::try_create(protocol(), move(receive_buffer), m_congestion_control.algorithm()));
 
         client->set_setup_state(SetupState::InProgress);
         client->set_local_address(new_local_address);
@@ -162,8 +182,9 @@ void TCPSocket::release_for_accept(NonnullLockRefPtr<TCPSocket> socket)
     [[maybe_unused]] auto rc = queue_connection_from(move(socket));
 }
 
-TCPSocket::TCPSocket(int protocol, NonnullOwnPtr<DoubleBuffer> receive_buffer, NonnullOwnPtr<KBuffer> scratch_buffer)
+TCPSocket::TCPSocket(int protocol, NonnullOwnPtr<DoubleBuffer> receive_buffer, NonnullOwnPtr<KBuffer> scratch_buffer, TCPCongestionControl::Algorithm congestion_control_algorithm)
     : IPv4Socket(SOCK_STREAM, protocol, move(receive_buffer), move(scratch_buffer))
+    , m_congestion_control(congestion_control_algorithm, default_maximum_segment_size)
 {
     m_last_retransmit_time = kgettimeofday();
 }
@@ -175,11 +196,11 @@ TCPSocket::~TCPSocket()
     dbgln_if(TCP_SOCKET_DEBUG, "~TCPSocket in state {}", to_string(state()));
 }
 
-ErrorOr<NonnullLockRefPtr<TCPSocket>> TCPSocket::try_create(int protocol, NonnullOwnPtr<DoubleBuffer> receive_buffer)
+ErrorOr<NonnullLockRefPtr<TCPSocket>> TCPSocket::try_create(int protocol, NonnullOwnPtr<DoubleBuffer> receive_buffer, TCPCongestionControl::Algorithm congestion_control_algorithm)
 {
     // Note: Scratch buffer is only used for SOCK_STREAM sockets.
     auto scratch_buffer = TRY(KBuffer::try_create_with_size("TCPSocket: Scratch buffer"sv, 65536));
-    return adopt_nonnull_lock_ref_or_enomem(new (nothrow) TCPSocket(protocol, move(receive_buffer), move(scratch_buffer)));
+    return adopt_nonnull_lock_ref_or_enomem(new (nothrow) TCPSocket(protocol, move(receive_buffer), move(scratch_buffer), congestion_control_algorithm));
 }
 
 ErrorOr<size_t> TCPSocket::protocol_size(ReadonlyBytes raw_ipv4_packet)
@@ -205,12 +226,51 @@ ErrorOr<size_t> TCPSocket::protocol_send(UserOrKernelBuffer const& data, size_t
     RoutingDecision routing_decision = route_to(peer_address(), local_address(), bound_interface());
     if (routing_decision.is_zero())
         return set_so_error(EHOSTUNREACH);
-    size_t mss = routing_decision.adapter->mtu() - sizeof(IPv4Packet) - sizeof(TCPPacket);
+    size_t mss = min<size_t>(routing_decision.adapter->mtu() - sizeof(IPv4Packet) - sizeof(TCPPacket), m_send_maximum_segment_size);
+    // The MSS doesn't account for TCP options (RFC 6691), so leave room for the SACK blocks
+    // that go out with every segment while we're missing data from the peer.
+    if (auto block_count = sack_blocks().size(); block_count > 0)
+        mss -= sizeof(TCPOptionSACKHeader) + block_count * sizeof(TCPSACKBlock);
+
+    auto sendable_or_error = m_unacked_packets.with_shared([&](auto const& unacked_packets) -> ErrorOr<size_t> {
+        if (unacked_packets.size == 0) {
+            // With nothing in flight we always send something, so a closed window gets probed.
+            return m_send_window_size > 0 ? m_send_window_size : mss;
+        }
+        auto sendable = sendable_bytes(unacked_packets);
+        if (sendable == 0)
+            return EAGAIN;
+        return sendable;
+    });
+    data_length = min(data_length, TRY(sendable_or_error));
     data_length = min(data_length, mss);
     TRY(send_tcp_packet(TCPFlags::PSH | TCPFlags::ACK, &data, data_length, &routing_decision));
     return data_length;
 }
 
+size_t TCPSocket::sendable_bytes(UnackedPackets const& unacked_packets) const
+{
+    // Everything that hasn't been acknowledged counts against the peer's window, but SACKed
+    // segments have left the network and don't count against the congestion window.
+    size_t window_space = unacked_packets.size < m_send_window_size ? m_send_window_size - unacked_packets.size : 0;
+    auto congestion_window = m_congestion_control.congestion_window();
+    auto in_flight = unacked_packets.bytes_in_flight();
+    size_t congestion_window_space = in_flight < congestion_window ? congestion_window - in_flight : 0;
+    return min(window_space, congestion_window_space);
+}
+
+size_t TCPSocket::receive_window_size() const
+{
+    auto const* buffer = receive_buffer();
+    return buffer ? buffer->space_for_writing() : 0;
+}
+
+size_t TCPSocket::advertised_window_size() const
+{
+    auto window = min(receive_window_size() >> m_receive_window_scale, NumericLimits<u16>::max());
+    return window << m_receive_window_scale;
+}
+
 ErrorOr<void> TCPSocket::send_ack(bool allow_duplicate)
 {
     if (!allow_duplicate && m_last_ack_number_sent == m_ack_number)
@@ -226,8 +286,23 @@ ErrorOr<void> TCPSocket::send_tcp_packet(u16 flags, UserOrKernelBuffer const* pa
 
     auto ipv4_payload_offset = routing_decision.adapter->ipv4_payload_offset();
 
-    bool const has_mss_option = flags == TCPFlags::SYN;
-    const size_t options_size = has_mss_option ? sizeof(TCPOptionMSS) : 0;
+    bool const has_syn = flags & TCPFlags::SYN;
+    // We offer window scaling and SACK in our own SYN, and accept them in a SYN-ACK if the peer offered them.
+    bool const has_window_scale_option = has_syn && (!(flags & TCPFlags::ACK) || m_peer_offered_window_scaling);
+    bool const has_sack_permitted_option = has_syn && (!(flags & TCPFlags::ACK) || m_sack_permitted);
+    Vector<TCPSACKBlock, TCPOptionSACKHeader::maximum_block_count> sack_blocks;
+    if (!has_syn && (flags & TCPFlags::ACK))
+        sack_blocks = this->sack_blocks();
+
+    size_t options_size = 0;
+    if (has_syn)
+        options_size += sizeof(TCPOptionMSS);
+    if (has_window_scale_option)
+        options_size += sizeof(TCPOptionWindowScale);
+    if (has_sack_permitted_option)
+        options_size += sizeof(TCPOptionSACKPermitted);
+    if (!sack_blocks.is_empty())
+        options_size += sizeof(TCPOptionSACKHeader) + sack_blocks.size() * sizeof(TCPSACKBlock);
     const size_t tcp_header_size = sizeof(TCPPacket) + options_size;
     const size_t buffer_size = ipv4_payload_offset + tcp_header_size + payload_size;
     auto packet = routing_decision.adapter->acquire_packet_buffer(buffer_size);
@@ -241,7 +316,17 @@ ErrorOr<void> TCPSocket::send_tcp_packet(u16 flags, UserOrKernelBuffer const* pa
     VERIFY(local_port());
     tcp_packet.set_source_port(local_port());
     tcp_packet.set_destination_port(peer_port());
-    tcp_packet.set_window_size(NumericLimits<u16>::max());
+    // The window in a SYN is never scaled (RFC 7323, section 2.2).
+    if (has_syn) {
+        tcp_packet.set_window_size(min(receive_window_size(), NumericLimits<u16>::max()));
+    } else {
+        auto window = advertised_window_size();
+        tcp_packet.set_window_size(window >> m_receive_window_scale);
+        m_last_advertised_window_end = m_ack_number + window;
+        if (window < m_receive_maximum_segment_size)
+            m_receive_window_was_exhausted = true;
+    }
+    auto first_sequence_number = m_sequence_number;
     tcp_packet.set_sequence_number(m_sequence_number);
     tcp_packet.set_data_offset(tcp_header_size / sizeof(u32));
     tcp_packet.set_flags(flags);
@@ -265,11 +350,24 @@ ErrorOr<void> TCPSocket::send_tcp_packet(u16 flags, UserOrKernelBuffer const* pa
         m_sequence_number += payload_size;
     }
 
-    if (has_mss_option) {
-        u16 mss = routing_decision.adapter->mtu() - sizeof(IPv4Packet) - sizeof(TCPPacket);
-        TCPOptionMSS mss_option { mss };
-        VERIFY(packet->buffer->size() >= ipv4_payload_offset + sizeof(TCPPacket) + sizeof(mss_option));
-        memcpy(packet->buffer->data() + ipv4_payload_offset + sizeof(TCPPacket), &mss_option, sizeof(mss_option));
+    VERIFY(packet->buffer->size() >= ipv4_payload_offset + tcp_header_size);
+    u8* options = packet->buffer->data() + ipv4_payload_offset + sizeof(TCPPacket);
+    auto append_option = [&](auto const& option) {
+        memcpy(options, &option, sizeof(option));
+        options += sizeof(option);
+    };
+    if (has_syn) {
+        m_receive_maximum_segment_size = routing_decision.adapter->mtu() - sizeof(IPv4Packet) - sizeof(TCPPacket);
+        append_option(TCPOptionMSS { m_receive_maximum_segment_size });
+    }
+    if (has_window_scale_option)
+        append_option(TCPOptionWindowScale { offered_receive_window_scale });
+    if (has_sack_permitted_option)
+        append_option(TCPOptionSACKPermitted {});
+    if (!sack_blocks.is_empty()) {
+        append_option(TCPOptionSACKHeader { sack_blocks.size() });
+        for (auto const& block : sack_blocks)
+            append_option(block);
     }
 
     tcp_packet.set_checksum(compute_tcp_checksum(local_address(), peer_address(), tcp_packet, payload_size));
@@ -277,8 +375,20 @@ ErrorOr<void> TCPSocket::send_tcp_packet(u16 flags, UserOrKernelBuffer const* pa
     bool expect_ack { tcp_packet.has_syn() || payload_size > 0 };
     if (expect_ack) {
         bool append_failed { false };
+        auto now = kgettimeofday();
         m_unacked_packets.with_exclusive([&](auto& unacked_packets) {
-            auto result = unacked_packets.packets.try_append({ m_sequence_number, packet, ipv4_payload_offset, *routing_decision.adapter });
+            // RFC 6298, (5.1): Start the retransmission timer if it isn't already running.
+            if (unacked_packets.packets.is_empty())
+                m_last_retransmit_time = now;
+            auto result = unacked_packets.packets.try_append({
+                .ack_number = m_sequence_number,
+                .sequence_number = first_sequence_number,
+                .payload_size = payload_size,
+                .buffer = packet,
+                .ipv4_payload_offset = ipv4_payload_offset,
+                .adapter = *routing_decision.adapter,
+                .sent_time = now,
+            });
             if (result.is_error()) {
                 dbgln("TCPSocket: Dropped outbound packet because try_append() failed");
                 append_failed = true;
@@ -304,24 +414,51 @@ void TCPSocket::receive_tcp_packet(TCPPacket const& packet, u16 size)
 {
     if (packet.has_ack()) {
         u32 ack_number = packet.ack_number();
+        auto now = kgettimeofday();
 
         dbgln_if(TCP_SOCKET_DEBUG, "TCPSocket: receive_tcp_packet: {}", ack_number);
 
+        // The window in a SYN is never scaled (RFC 7323, section 2.2).
+        auto previous_send_window_size = m_send_window_size;
+        m_send_window_size = static_cast<u32>(packet.window_size()) << (packet.has_syn() ? 0 : m_send_window_scale);
+
+        Vector<TCPSACKBlock, TCPOptionSACKHeader::maximum_block_count> sack_blocks;
+        if (m_sack_permitted) {
+            packet.for_each_option([&](TCPOptionKind kind, ReadonlyBytes data) {
+                if (kind != TCPOptionKind::SACK)
+                    return;
+                for (size_t offset = 0; offset + sizeof(TCPSACKBlock) <= data.size() && sack_blocks.size() < TCPOptionSACKHeader::maximum_block_count; offset += sizeof(TCPSACKBlock)) {
+                    TCPSACKBlock block;
+                    memcpy(&block, data.offset(offset), sizeof(block));
+                    sack_blocks.unchecked_append(block);
+                }
+            });
+        }
+
+        bool is_payload_free = size == packet.header_size() && !packet.has_syn() && !packet.has_fin();
         int removed = 0;
+        size_t acked_bytes = 0;
+        size_t bytes_in_flight = 0;
+        bool is_duplicate_ack = false;
+        bool sacks_indicate_loss = false;
+        Optional<Time> round_trip_time_sample;
         m_unacked_packets.with_exclusive([&](auto& unacked_packets) {
             while (!unacked_packets.packets.is_empty()) {
                 auto& packet = unacked_packets.packets.first();
 
                 dbgln_if(TCP_SOCKET_DEBUG, "TCPSocket: iterate: {}", packet.ack_number);
 
-                if (packet.ack_number <= ack_number) {
+                if (tcp_sequence_before_or_equal(packet.ack_number, ack_number)) {
                     auto old_adapter = packet.adapter.strong_ref();
                     if (old_adapter)
                         old_adapter->release_packet_buffer(*packet.buffer);
-                    TCPPacket& tcp_packet = *(TCPPacket*)(packet.buffer->buffer->data() + packet.ipv4_payload_offset);
-                    auto payload_size = packet.buffer->buffer->data() + packet.buffer->buffer->size() - (u8*)tcp_packet.payload();
-                    unacked_packets.size -= payload_size;
-                    evaluate_block_conditions();
+                    unacked_packets.size -= packet.payload_size;
+                    if (packet.is_sacked)
+                        unacked_packets.sacked_size -= packet.payload_size;
+                    acked_bytes += packet.payload_size;
+                    // Karn's algorithm: only packets that were sent once tell us the round trip time.
+                    if (packet.tx_counter == 0)
+                        round_trip_time_sample = now - packet.sent_time;
                     unacked_packets.packets.take_first();
                     removed++;
                 } else {
@@ -329,6 +466,26 @@ void TCPSocket::receive_tcp_packet(TCPPacket const& packet, u16 size)
                 }
             }
 
+            // RFC 5681, section 2: an ACK that doesn't move anything while data is outstanding.
+            // Answers to our probes of a closed window look the same, but don't mean anything was lost.
+            is_duplicate_ack = removed == 0 && is_payload_free && m_send_window_size > 0 && previous_send_window_size == m_send_window_size
+                && !unacked_packets.packets.is_empty() && unacked_packets.packets.first().sequence_number == ack_number;
+
+            for (auto& outgoing_packet : unacked_packets.packets) {
+                if (outgoing_packet.is_sacked || outgoing_packet.payload_size == 0)
+                    continue;
+                for (auto const& block : sack_blocks) {
+                    if (tcp_sequence_before_or_equal(block.left_edge, outgoing_packet.sequence_number) && tcp_sequence_before_or_equal(outgoing_packet.ack_number, block.right_edge)) {
+                        outgoing_packet.is_sacked = true;
+                        unacked_packets.sacked_size += outgoing_packet.payload_size;
+                        break;
+                    }
+                }
+            }
+            // RFC 6675, section 5: three segments' worth of SACKed data above a hole means it's lost.
+            sacks_indicate_loss = unacked_packets.sacked_size >= 3u * m_send_maximum_segment_size;
+            bytes_in_flight = unacked_packets.bytes_in_flight();
+
             if (unacked_packets.packets.is_empty()) {
                 m_retransmit_attempts = 0;
                 dequeue_for_retransmit();
@@ -336,19 +493,229 @@ void TCPSocket::receive_tcp_packet(TCPPacket const& packet, u16 size)
 
             dbgln_if(TCP_SOCKET_DEBUG, "TCPSocket: receive_tcp_packet acknowledged {} packets", removed);
         });
+
+        if (round_trip_time_sample.has_value())
+            update_round_trip_time(*round_trip_time_sample);
+
+        if (removed > 0) {
+            // RFC 6298, (5.3): Restart the retransmission timer whenever new data is acknowledged.
+            m_last_retransmit_time = now;
+            m_retransmit_attempts = 0;
+            m_duplicate_acks_received = 0;
+            if (m_recovery_point.has_value()) {
+                // A partial ACK means the next hole was lost too (RFC 6582, section 3.2).
+                if (tcp_sequence_before(ack_number, *m_recovery_point))
+                    retransmit_lost_packets();
+                else
+                    m_recovery_point.clear();
+            } else {
+                m_congestion_control.on_ack(acked_bytes, bytes_in_flight, now, m_smoothed_round_trip_time);
+            }
+        } else if (is_duplicate_ack) {
+            ++m_duplicate_acks_received;
+        }
+
+        if (!m_recovery_point.has_value() && (m_duplicate_acks_received >= 3 || sacks_indicate_loss)) {
+            dbgln_if(TCP_SOCKET_DEBUG, "TCPSocket({}) entering fast recovery at {}", this, ack_number);
+            m_recovery_point = m_sequence_number;
+            m_congestion_control.on_fast_retransmit(bytes_in_flight);
+            retransmit_lost_packets();
+        }
+
+        // While the peer's window is closed, our retransmissions are window probes, and the
+        // connection stays up for as long as the peer keeps answering them (RFC 1122, 4.2.2.17).
+        if (m_send_window_size == 0)
+            m_retransmit_attempts = 0;
+
+        if (removed > 0 || previous_send_window_size != m_send_window_size)
+            evaluate_block_conditions();
     }
 
     m_packets_in++;
     m_bytes_in += packet.header_size() + size;
 }
 
-bool TCPSocket::should_delay_next_ack() const
+void TCPSocket::process_syn_options(TCPPacket const& packet)
+{
+    VERIFY(packet.has_syn());
+
+    u16 peer_maximum_segment_size = default_maximum_segment_size;
+    Optional<u8> peer_window_scale;
+    bool peer_permits_sack = false;
+    packet.for_each_option([&](TCPOptionKind kind, ReadonlyBytes data) {
+        switch (kind) {
+        case TCPOptionKind::MSS:
+            if (data.size() == sizeof(u16))
+                peer_maximum_segment_size = (data[0] << 8) | data[1];
+            break;
+        case TCPOptionKind::WindowScale:
+            // RFC 7323, section 2.3: Shift counts above 14 are treated as 14.
+            if (data.size() == sizeof(u8))
+                peer_window_scale = min(data[0], 14);
+            break;
+        case TCPOptionKind::SACKPermitted:
+            peer_permits_sack = true;
+            break;
+        default:
+            break;
+        }
+    });
+
+    m_peer_offered_window_scaling = peer_window_scale.has_value();
+    m_send_window_scale = peer_window_scale.value_or(0);
+    m_receive_window_scale = m_peer_offered_window_scaling ? offered_receive_window_scale : 0;
+    m_sack_permitted = peer_permits_sack;
+    m_send_window_size = packet.window_size();
+
+    auto routing_decision = route_to(peer_address(), local_address(), bound_interface());
+    if (!routing_decision.is_zero())
+        peer_maximum_segment_size = min<size_t>(peer_maximum_segment_size, routing_decision.adapter->mtu() - sizeof(IPv4Packet) - sizeof(TCPPacket));
+    if (peer_maximum_segment_size == 0)
+        peer_maximum_segment_size = default_maximum_segment_size;
+    m_send_maximum_segment_size = peer_maximum_segment_size;
+    m_congestion_control.set_maximum_segment_size(m_send_maximum_segment_size);
+
+    dbgln_if(TCP_SOCKET_DEBUG, "TCPSocket({}) SYN options: mss={}, window_scale={}/{}, sack={}", this,
+        m_send_maximum_segment_size, m_send_window_scale, m_receive_window_scale, m_sack_permitted);
+}
+
+bool TCPSocket::queue_out_of_order_segment(TCPPacket const& packet, size_t payload_size)
+{
+    auto const* buffer = receive_buffer();
+    u32 sequence_number = packet.sequence_number();
+    if (!buffer || payload_size == 0 || !tcp_sequence_before(m_ack_number, sequence_number))
+        return false;
+    // Anything beyond our window wouldn't fit into the receive buffer once the hole is filled.
+    if (tcp_sequence_before(m_ack_number + buffer->space_for_writing(), sequence_number + payload_size))
+        return false;
+
+    // Only keep the part that isn't queued yet, so the queue never holds more than the window.
+    u32 start = sequence_number;
+    u32 end = sequence_number + payload_size;
+    size_t index = 0;
+    for (; index < m_out_of_order_segments.size(); ++index) {
+        auto const& segment = m_out_of_order_segments[index];
+        u32 segment_end = segment.sequence_number + segment.payload.size();
+        if (tcp_sequence_before(start, segment.sequence_number)) {
+            if (tcp_sequence_before(segment.sequence_number, end))
+                end = segment.sequence_number;
+            break;
+        }
+        if (tcp_sequence_before(start, segment_end))
+            start = segment_end;
+    }
+    // Even if all of it is queued already, this is what the peer sent most recently.
+    m_last_out_of_order_sequence_number = sequence_number;
+    if (!tcp_sequence_before(start, end))
+        return true;
+
+    if (m_out_of_order_segments.size() >= maximum_out_of_order_segments || m_out_of_order_bytes + (end - start) > buffer->space_for_writing())
+        return false;
+
+    auto payload_or_error = ByteBuffer::copy(static_cast<u8 const*>(packet.payload()) + (start - sequence_number), end - start);
+    if (payload_or_error.is_error()) {
+        dbgln("TCPSocket: Unable to allocate storage for out-of-order segment");
+        return false;
+    }
+    if (m_out_of_order_segments.try_insert(index, { start, payload_or_error.release_value() }).is_error())
+        return false;
+    m_out_of_order_bytes += end - start;
+    return true;
+}
+
+bool TCPSocket::deliver_out_of_order_segments()
+{
+    if (m_out_of_order_segments.is_empty())
+        return false;
+
+    while (!m_out_of_order_segments.is_empty()) {
+        auto& segment = m_out_of_order_segments.first();
+        if (tcp_sequence_before(m_ack_number, segment.sequence_number))
+            break;
+        // The in-order data may already have covered the start of the segment.
+        u32 segment_end = segment.sequence_number + segment.payload.size();
+        if (tcp_sequence_before(m_ack_number, segment_end)) {
+            auto payload = segment.payload.bytes().slice(m_ack_number - segment.sequence_number);
+            if (!did_receive_payload(payload))
+                break;
+            m_ack_number += payload.size();
+        }
+        m_out_of_order_bytes -= segment.payload.size();
+        m_out_of_order_segments.take_first();
+    }
+    return true;
+}
+
+Vector<TCPSACKBlock, TCPOptionSACKHeader::maximum_block_count> TCPSocket::sack_blocks() const
+{
+    Vector<TCPSACKBlock, TCPOptionSACKHeader::maximum_block_count> blocks;
+    if (!m_sack_permitted || m_out_of_order_segments.is_empty())
+        return blocks;
+
+    // Calls the callback for each run of contiguous segments.
+    auto contains_latest = [&](OutOfOrderSegment const& segment) {
+        return !tcp_sequence_before(m_last_out_of_order_sequence_number, segment.sequence_number)
+            && tcp_sequence_before(m_last_out_of_order_sequence_number, segment.sequence_number + segment.payload.size());
+    };
+    auto for_each_block = [&](auto callback) {
+        auto const& first = m_out_of_order_segments.first();
+        u32 left_edge = first.sequence_number;
+        u32 right_edge = first.sequence_number + first.payload.size();
+        bool has_latest = contains_latest(first);
+        for (size_t i = 1; i < m_out_of_order_segments.size(); ++i) {
+            auto const& segment = m_out_of_order_segments[i];
+            u32 segment_end = segment.sequence_number + segment.payload.size();
+            if (tcp_sequence_before(right_edge, segment.sequence_number)) {
+                callback(left_edge, right_edge, has_latest);
+                left_edge = segment.sequence_number;
+                right_edge = segment_end;
+                has_latest = false;
+            } else if (tcp_sequence_before(right_edge, segment_end)) {
+                right_edge = segment_end;
+            }
+            has_latest |= contains_latest(segment);
+        }
+        callback(left_edge, right_edge, has_latest);
+    };
+
+    // RFC 2018, section 4: The first block has to contain the most recently received segment.
+    for_each_block([&](u32 left_edge, u32 right_edge, bool has_latest) {
+        if (has_latest)
+            blocks.unchecked_append({ left_edge, right_edge });
+    });
+    for_each_block([&](u32 left_edge, u32 right_edge, bool has_latest) {
+        if (!has_latest && blocks.size() < TCPOptionSACKHeader::maximum_block_count)
+            blocks.unchecked_append({ left_edge, right_edge });
+    });
+    return blocks;
+}
+
+void TCPSocket::update_round_trip_time(Time const& sample)
 {
-    // FIXME: We don't know the MSS here so make a reasonable guess.
-    const size_t mss = 1500;
+    // RFC 6298, section 2.
+    i64 sample_ns = sample.to_nanoseconds();
+    i64 smoothed_ns = sample_ns;
+    i64 variance_ns = sample_ns / 2;
+    if (m_has_round_trip_time_sample) {
+        smoothed_ns = m_smoothed_round_trip_time.to_nanoseconds();
+        variance_ns = m_round_trip_time_variance.to_nanoseconds();
+        i64 deviation_ns = smoothed_ns > sample_ns ? smoothed_ns - sample_ns : sample_ns - smoothed_ns;
+        variance_ns = (3 * variance_ns + deviation_ns) / 4;
+        smoothed_ns = (7 * smoothed_ns + sample_ns) / 8;
+    }
+    m_has_round_trip_time_sample = true;
+    m_smoothed_round_trip_time = Time::from_nanoseconds(smoothed_ns);
+    m_round_trip_time_variance = Time::from_nanoseconds(variance_ns);
+
+    // We assume a clock granularity of 10ms, and stick to the one second minimum timeout.
+    auto timeout = m_smoothed_round_trip_time + Time::from_nanoseconds(max<i64>(4 * variance_ns, 10'000'000));
+    m_retransmission_timeout = max(timeout, Time::from_seconds(1));
+}
 
+bool TCPSocket::should_delay_next_ack() const
+{
     // RFC 1122 says we should send an ACK for every two full-sized segments.
-    if (m_ack_number >= m_last_ack_number_sent + 2 * mss)
+    if (m_ack_number - m_last_ack_number_sent >= 2u * m_receive_maximum_segment_size)
         return false;
 
     // RFC 1122 says we should not delay ACKs for more than 500 milliseconds.
@@ -569,13 +936,13 @@ void TCPSocket::retransmit_packets()
 {
     auto now = kgettimeofday();
 
-    // RFC6298 says we should have at least one second between retransmits. According to
-    // RFC1122 we must do exponential backoff - even for SYN packets.
-    i64 retransmit_interval = 1;
+    // RFC6298 says the timeout follows the measured round trip time, but stays at one second or
+    // more. According to RFC1122 we must do exponential backoff - even for SYN packets.
+    auto retransmit_interval = m_retransmission_timeout;
     for (decltype(m_retransmit_attempts) i = 0; i < m_retransmit_attempts; i++)
-        retransmit_interval *= 2;
+        retransmit_interval = retransmit_interval + retransmit_interval;
 
-    if (m_last_retransmit_time > now - Time::from_seconds(retransmit_interval))
+    if (m_last_retransmit_time > now - retransmit_interval)
         return;
 
     dbgln_if(TCP_SOCKET_DEBUG, "TCPSocket({}) handling retransmit", this);
@@ -594,44 +961,92 @@ void TCPSocket::retransmit_packets()
     if (routing_decision.is_zero())
         return;
 
+    m_recovery_point.clear();
+    m_duplicate_acks_received = 0;
+
     m_unacked_packets.with_exclusive([&](auto& unacked_packets) {
+        m_congestion_control.on_retransmit_timeout(unacked_packets.bytes_in_flight());
+
+        // RFC 6675, section 5.1: After a timeout, don't trust what the peer SACKed before.
+        unacked_packets.sacked_size = 0;
         for (auto& packet : unacked_packets.packets) {
+            packet.is_sacked = false;
+            packet.was_retransmitted_during_recovery = false;
             packet.tx_counter++;
+            send_outgoing_packet(packet, routing_decision);
+        }
+    });
+}
 
-            if constexpr (TCP_SOCKET_DEBUG) {
-                auto& tcp_packet = *(const TCPPacket*)(packet.buffer->buffer->data() + packet.ipv4_payload_offset);
-                dbgln("Sending TCP packet from {}:{} to {}:{} with ({}{}{}{}) seq_no={}, ack_no={}, tx_counter={}",
-                    local_address(), local_port(),
-                    peer_address(), peer_port(),
-                    (tcp_packet.has_syn() ? "SYN " : ""),
-                    (tcp_packet.has_ack() ? "ACK " : ""),
-                    (tcp_packet.has_fin() ? "FIN " : ""),
-                    (tcp_packet.has_rst() ? "RST " : ""),
-                    tcp_packet.sequence_number(),
-                    tcp_packet.ack_number(),
-                    packet.tx_counter);
-            }
-
-            size_t ipv4_payload_offset = routing_decision.adapter->ipv4_payload_offset();
-            if (ipv4_payload_offset != packet.ipv4_payload_offset) {
-                // FIXME: Add support for this. This can happen if after a route change
-                // we ended up on another adapter which doesn't have the same layer 2 type
-                // like the previous adapter.
-                VERIFY_NOT_REACHED();
-            }
+void TCPSocket::retransmit_lost_packets()
+{
+    auto routing_decision = route_to(peer_address(), local_address(), bound_interface());
+    if (routing_decision.is_zero())
+        return;
 
-            auto packet_buffer = packet.buffer->bytes();
+    m_unacked_packets.with_exclusive([&](auto& unacked_packets) {
+        // The first unacknowledged packet is lost, and so is everything below the highest
+        // SACKed packet that wasn't SACKed itself.
+        Optional<u32> highest_sacked_sequence_number;
+        for (auto const& packet : unacked_packets.packets) {
+            if (packet.is_sacked)
+                highest_sacked_sequence_number = packet.ack_number;
+        }
 
-            routing_decision.adapter->fill_in_ipv4_header(*packet.buffer,
-                local_address(), routing_decision.next_hop, peer_address(),
-                IPv4Protocol::TCP, packet_buffer.size() - ipv4_payload_offset, type_of_service(), ttl());
-            routing_decision.adapter->send_packet(packet_buffer);
-            m_packets_out++;
-            m_bytes_out += packet_buffer.size();
+        auto budget = m_congestion_control.congestion_window();
+        size_t retransmitted_bytes = 0;
+        bool is_first = true;
+        for (auto& packet : unacked_packets.packets) {
+            bool is_lost = is_first || (highest_sacked_sequence_number.has_value() && tcp_sequence_before(packet.sequence_number, *highest_sacked_sequence_number));
+            is_first = false;
+            if (!is_lost)
+                break;
+            if (packet.is_sacked || packet.was_retransmitted_during_recovery)
+                continue;
+            if (retransmitted_bytes > 0 && retransmitted_bytes + packet.payload_size > budget)
+                break;
+            packet.was_retransmitted_during_recovery = true;
+            packet.tx_counter++;
+            send_outgoing_packet(packet, routing_decision);
+            retransmitted_bytes += packet.payload_size;
         }
     });
 }
 
+void TCPSocket::send_outgoing_packet(OutgoingPacket& packet, RoutingDecision& routing_decision)
+{
+    if constexpr (TCP_SOCKET_DEBUG) {
+        auto& tcp_packet = *(const TCPPacket*)(packet.buffer->buffer->data() + packet.ipv4_payload_offset);
+        dbgln("Sending TCP packet from {}:{} to {}:{} with ({}{}{}{}) seq_no={}, ack_no={}, tx_counter={}",
+            local_address(), local_port(),
+            peer_address(), peer_port(),
+            (tcp_packet.has_syn() ? "SYN " : ""),
+            (tcp_packet.has_ack() ? "ACK " : ""),
+            (tcp_packet.has_fin() ? "FIN " : ""),
+            (tcp_packet.has_rst() ? "RST " : ""),
+            tcp_packet.sequence_number(),
+            tcp_packet.ack_number(),
+            packet.tx_counter);
+    }
+
+    size_t ipv4_payload_offset = routing_decision.adapter->ipv4_payload_offset();
+    if (ipv4_payload_offset != packet.ipv4_payload_offset) {
+        // FIXME: Add support for this. This can happen if after a route change
+        // we ended up on another adapter which doesn't have the same layer 2 type
+        // like the previous adapter.
+        VERIFY_NOT_REACHED();
+    }
+
+    auto packet_buffer = packet.buffer->bytes();
+
+    routing_decision.adapter->fill_in_ipv4_header(*packet.buffer,
+        local_address(), routing_decision.next_hop, peer_address(),
+        IPv4Protocol::TCP, packet_buffer.size() - ipv4_payload_offset, type_of_service(), ttl());
+    routing_decision.adapter->send_packet(packet_buffer);
+    m_packets_out++;
+    m_bytes_out += packet_buffer.size();
+}
+
 bool TCPSocket::can_write(OpenFileDescription const& file_description, u64 size) const
 {
     if (!IPv4Socket::can_write(file_description, size))
@@ -640,11 +1055,101 @@ bool TCPSocket::can_write(OpenFileDescription const& file_description, u64 size)
     if (m_state == State::SynSent || m_state == State::SynReceived)
         return false;
 
-    if (!file_description.is_blocking())
-        return true;
-
+    // NOTE: Non-blocking writers are held to the same windows, they just get EAGAIN instead of blocking.
     return m_unacked_packets.with_shared([&](auto& unacked_packets) {
-        return unacked_packets.size + size <= m_send_window_size;
+        return unacked_packets.size == 0 || sendable_bytes(unacked_packets) >= m_send_maximum_segment_size;
     });
 }
+
+void TCPSocket::protocol_did_read(size_t bytes_read)
+{
+    if (m_state != State::Established && m_state != State::FinWait1 && m_state != State::FinWait2)
+        return;
+    auto const* buffer = receive_buffer();
+    if (!buffer)
+        return;
+
+    maybe_grow_receive_buffer(bytes_read);
+
+    // RFC 1122, 4.2.3.3: Tell the peer about the space the application made, but only
+    // once the window has grown by a full segment or half the buffer.
+    u32 window_end = m_ack_number + advertised_window_size();
+    size_t threshold = min<size_t>(buffer->capacity() / 2, m_receive_maximum_segment_size);
+    if (tcp_sequence_before(m_last_advertised_window_end, window_end) && window_end - m_last_advertised_window_end >= threshold)
+        (void)send_ack(true);
+}
+
+void TCPSocket::maybe_grow_receive_buffer(size_t bytes_read)
+{
+    // Receive buffer auto-tuning: if the peer keeps filling the window we announce while the
+    // application keeps up with reading, the window is what limits the transfer. Without
+    // window scaling we can't announce more than 64 KiB anyway.
+    auto const* buffer = receive_buffer();
+    m_bytes_read_since_receive_buffer_grew += bytes_read;
+    if (!m_receive_window_was_exhausted || m_receive_window_scale == 0)
+        return;
+    if (m_bytes_read_since_receive_buffer_grew < buffer->capacity() || buffer->capacity() >= maximum_receive_buffer_size)
+        return;
+
+    auto new_capacity = min(buffer->capacity() * 2, maximum_receive_buffer_size);
+    if (auto result = try_grow_receive_buffer(new_capacity); result.is_error()) {
+        dbgln_if(TCP_SOCKET_DEBUG, "TCPSocket({}) couldn't grow receive buffer to {} bytes: {}", this, new_capacity, result.error());
+        return;
+    }
+    dbgln_if(TCP_SOCKET_DEBUG, "TCPSocket({}) grew receive buffer to {} bytes", this, new_capacity);
+    m_bytes_read_since_receive_buffer_grew = 0;
+    m_receive_window_was_exhausted = false;
+}
+
+ErrorOr<void> TCPSocket::setsockopt(OpenFileDescription& description, int level, int option, Userspace<void const*> user_value, socklen_t user_value_size)
+{
+    if (level != IPPROTO_TCP)
+        return IPv4Socket::setsockopt(description, level, option, user_value, user_value_size);
+
+    MutexLocker locker(mutex());
+
+    switch (option) {
+    case TCP_CONGESTION: {
+        if (user_value_size == 0 || user_value_size > TCP_CA_NAME_MAX)
+            return EINVAL;
+        auto name = TRY(try_copy_kstring_from_user(static_ptr_cast<char const*>(user_value), user_value_size));
+        // The name may or may not come with a null terminator.
+        auto name_view = name->view();
+        if (auto terminator = name_view.find('\0'); terminator.has_value())
+            name_view = name_view.substring_view(0, *terminator);
+        auto algorithm = TCPCongestionControl::algorithm_from_name(name_view);
+        if (!algorithm.has_value())
+            return ENOENT;
+        m_congestion_control.set_algorithm(*algorithm);
+        return {};
+    }
+    default:
+        return ENOPROTOOPT;
+    }
+}
+
+ErrorOr<void> TCPSocket::getsockopt(OpenFileDescription& description, int level, int option, Userspace<void*> value, Userspace<socklen_t*> value_size)
+{
+    if (level != IPPROTO_TCP)
+        return IPv4Socket::getsockopt(description, level, option, value, value_size);
+
+    MutexLocker locker(mutex());
+
+    socklen_t size;
+    TRY(copy_from_user(&size, value_size.unsafe_userspace_ptr()));
+
+    switch (option) {
+    case TCP_CONGESTION: {
+        char name[TCP_CA_NAME_MAX] {};
+        auto algorithm_name = TCPCongestionControl::to_string(m_congestion_control.algorithm());
+        memcpy(name, algorithm_name.characters_without_null_termination(), algorithm_name.length());
+        // Like on other systems, the name is cut short if the buffer is too small.
+        size = min<socklen_t>(size, sizeof(name));
+        TRY(copy_to_user(static_ptr_cast<char*>(value), name, size));
+        return copy_to_user(value_size, &size);
+    }
+    default:
+        return ENOPROTOOPT;
+    }
+}
 }
@@ -6,6 +6,7 @@
 
 #pragma once
 
+#include <AK/ByteBuffer.h>
 #include <AK/Error.h>
 #include <AK/Function.h>
 #include <AK/HashMap.h>
@@ -13,6 +14,8 @@
 #include <Kernel/Library/LockWeakPtr.h>
 #include <Kernel/Locking/MutexProtected.h>
 #include <Kernel/Net/IPv4Socket.h>
+#include <Kernel/Net/TCP.h>
+#include <Kernel/Net/TCPCongestionControl.h>
 
 namespace Kernel {
 
@@ -20,7 +23,7 @@ class TCPSocket final : public IPv4Socket {
 public:
     static void for_each(Function<void(TCPSocket const&)>);
     static ErrorOr<void> try_for_each(Function<ErrorOr<void>(TCPSocket const&)>);
-    static ErrorOr<NonnullLockRefPtr<TCPSocket>> try_create(int protocol, NonnullOwnPtr<DoubleBuffer> receive_buffer);
+    static ErrorOr<NonnullLockRefPtr<TCPSocket>> try_create(int protocol, NonnullOwnPtr<DoubleBuffer> receive_buffer, TCPCongestionControl::Algorithm = TCPCongestionControl::default_algorithm);
     virtual ~TCPSocket() override;
 
     virtual bool unref() const override;
@@ -143,6 +146,19 @@ public:
     ErrorOr<void> send_tcp_packet(u16 flags, UserOrKernelBuffer const* = nullptr, size_t = 0, RoutingDecision* = nullptr);
     void receive_tcp_packet(TCPPacket const&, u16 size);
 
+    // Picks up the MSS, window scale and SACK options the peer sent along with its SYN.
+    void process_syn_options(TCPPacket const&);
+
+    // Holds on to a segment that arrived ahead of a missing one, so it doesn't have to be sent again.
+    bool queue_out_of_order_segment(TCPPacket const&, size_t payload_size);
+    // Delivers the queued segments that have become contiguous. Returns whether any segments were queued.
+    bool deliver_out_of_order_segments();
+
+    TCPCongestionControl const& congestion_control() const { return m_congestion_control; }
+    u32 send_window_size() const { return m_send_window_size; }
+    size_t receive_window_size() const;
+    Time smoothed_round_trip_time() const { return m_smoothed_round_trip_time; }
+
     bool should_delay_next_ack() const;
 
     static MutexProtected<HashMap<IPv4SocketTuple, TCPSocket*>>& sockets_by_tuple();
@@ -162,13 +178,16 @@ public:
 
     virtual bool can_write(OpenFileDescription const&, u64) const override;
 
+    virtual ErrorOr<void> setsockopt(OpenFileDescription&, int level, int option, Userspace<void const*>, socklen_t) override;
+    virtual ErrorOr<void> getsockopt(OpenFileDescription&, int level, int option, Userspace<void*>, Userspace<socklen_t*>) override;
+
     static NetworkOrdered<u16> compute_tcp_checksum(IPv4Address const& source, IPv4Address const& destination, TCPPacket const&, u16 payload_size);
 
 protected:
     void set_direction(Direction direction) { m_direction = direction; }
 
 private:
-    explicit TCPSocket(int protocol, NonnullOwnPtr<DoubleBuffer> receive_buffer, NonnullOwnPtr<KBuffer> scratch_buffer);
+    explicit TCPSocket(int protocol, NonnullOwnPtr<DoubleBuffer> receive_buffer, NonnullOwnPtr<KBuffer> scratch_buffer, TCPCongestionControl::Algorithm);
     virtual StringView class_name() const override { return "TCPSocket"sv; }
 
     virtual void shut_down_for_writing() override;
@@ -179,12 +198,19 @@ private:
     virtual ErrorOr<u16> protocol_allocate_local_port() override;
     virtual ErrorOr<size_t> protocol_size(ReadonlyBytes raw_ipv4_packet) override;
     virtual bool protocol_is_disconnected() const override;
+    virtual void protocol_did_read(size_t) override;
     virtual ErrorOr<void> protocol_bind() override;
     virtual ErrorOr<void> protocol_listen(bool did_allocate_port) override;
 
     void enqueue_for_retransmit();
     void dequeue_for_retransmit();
 
+    Vector<TCPSACKBlock, TCPOptionSACKHeader::maximum_block_count> sack_blocks() const;
+    size_t advertised_window_size() const;
+    void update_round_trip_time(Time const& sample);
+    void retransmit_lost_packets();
+    void maybe_grow_receive_buffer(size_t bytes_read);
+
     LockWeakPtr<TCPSocket> m_originator;
     HashMap<IPv4SocketTuple, NonnullLockRefPtr<TCPSocket>> m_pending_release_for_accept;
     Direction m_direction { Direction::Unspecified };
@@ -199,33 +225,87 @@ private:
     u32 m_bytes_out { 0 };
 
     struct OutgoingPacket {
+        // The first sequence number after this packet, i.e. the ACK that acknowledges it.
         u32 ack_number { 0 };
+        u32 sequence_number { 0 };
+        size_t payload_size { 0 };
         LockRefPtr<PacketWithTimestamp> buffer;
         size_t ipv4_payload_offset;
         LockWeakPtr<NetworkAdapter> adapter;
         int tx_counter { 0 };
+        Time sent_time;
+        bool is_sacked { false };
+        bool was_retransmitted_during_recovery { false };
     };
 
     struct UnackedPackets {
         SinglyLinkedList<OutgoingPacket> packets;
         size_t size { 0 };
+        size_t sacked_size { 0 };
+
+        // RFC 6675 calls this the "pipe": what we believe is still on its way to the peer.
+        size_t bytes_in_flight() const { return size - sacked_size; }
     };
 
+    void send_outgoing_packet(OutgoingPacket&, RoutingDecision&);
+    size_t sendable_bytes(UnackedPackets const&) const;
+
     MutexProtected<UnackedPackets> m_unacked_packets;
 
     u32 m_duplicate_acks { 0 };
 
     u32 m_last_ack_number_sent { 0 };
     Time m_last_ack_sent_time;
+    u32 m_last_advertised_window_end { 0 };
 
     // FIXME: Make this configurable (sysctl)
     static constexpr u32 maximum_retransmits = 5;
     Time m_last_retransmit_time;
     u32 m_retransmit_attempts { 0 };
 
-    // FIXME: Parse window size TCP option from the peer
+    // RFC 6298 estimate of the round trip time, which sets the retransmission timeout.
+    Time m_smoothed_round_trip_time;
+    Time m_round_trip_time_variance;
+    Time m_retransmission_timeout { Time::from_seconds(1) };
+    bool m_has_round_trip_time_sample { false };
+
+    TCPCongestionControl m_congestion_control;
+    u32 m_duplicate_acks_received { 0 };
+    // While recovering from a loss, the sequence number that has to be acknowledged to leave recovery.
+    Optional<u32> m_recovery_point;
+
+    // The peer's receive window, in bytes.
     u32 m_send_window_size { 64 * KiB };
 
+    // RFC 879 says to assume 536 bytes unless the peer sends a larger MSS.
+    static constexpr u16 default_maximum_segment_size = 536;
+    u16 m_send_maximum_segment_size { default_maximum_segment_size };
+    u16 m_receive_maximum_segment_size { default_maximum_segment_size };
+
+    // RFC 7323 window scaling, which only happens if both sides offer it in their SYNs.
+    bool m_peer_offered_window_scaling { false };
+    u8 m_send_window_scale { 0 };
+    u8 m_receive_window_scale { 0 };
+
+    bool m_sack_permitted { false };
+
+    struct OutOfOrderSegment {
+        u32 sequence_number { 0 };
+        ByteBuffer payload;
+    };
+
+    // Every segment is a heap allocation, so a peer sending lots of tiny ones can't make us keep all of them.
+    static constexpr size_t maximum_out_of_order_segments = 256;
+
+    // Sorted by sequence number, and none of them overlap.
+    Vector<OutOfOrderSegment> m_out_of_order_segments;
+    size_t m_out_of_order_bytes { 0 };
+    u32 m_last_out_of_order_sequence_number { 0 };
+
+    // Receive buffer auto-tuning.
+    size_t m_bytes_read_since_receive_buffer_grew { 0 };
+    bool m_receive_window_was_exhausted { false };
+
     IntrusiveListNode<TCPSocket> m_retransmit_list_node;
 
 public:
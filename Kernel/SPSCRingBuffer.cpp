@@ -0,0 +1,116 @@
+/*
+ * Copyright (c) 2022, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <AK/BuiltinWrappers.h>
+#include <AK/StringView.h>
+#include <Kernel/SPSCRingBuffer.h>
+
+namespace Kernel {
+
+size_t SPSCRingBuffer::round_up_capacity(size_t capacity)
+{
+    capacity = clamp(capacity, minimum_capacity, maximum_capacity);
+    if (is_power_of_two(capacity))
+        return capacity;
+    return static_cast<size_t>(1) << (sizeof(size_t) * 8 - count_leading_zeroes(capacity));
+}
+
+ErrorOr<NonnullOwnPtr<SPSCRingBuffer>> SPSCRingBuffer::try_create(StringView name, size_t capacity)
+{
+    capacity = round_up_capacity(capacity);
+    auto storage = TRY(KBuffer::try_create_with_size(name, capacity, Memory::Region::Access::ReadWrite));
+    return adopt_nonnull_own_or_enomem(new (nothrow) SPSCRingBuffer(capacity, move(storage)));
+}
+
+SPSCRingBuffer::SPSCRingBuffer(size_t capacity, NonnullOwnPtr<KBuffer> storage)
+    : m_storage(move(storage))
+    , m_capacity(capacity)
+{
+}
+
+ErrorOr<size_t> SPSCRingBuffer::write(UserOrKernelBuffer const& data, size_t size)
+{
+    if (!size)
+        return 0;
+    MutexLocker locker(m_write_lock);
+
+    auto write_position = m_write_position.load(AK::MemoryOrder::memory_order_relaxed);
+    auto read_position = m_read_position.load();
+    size_t bytes_to_write = min(size, m_capacity - (write_position - read_position));
+    if (!bytes_to_write)
+        return 0;
+
+    size_t offset = write_position & (m_capacity - 1);
+    size_t first_chunk_size = min(bytes_to_write, m_capacity - offset);
+    TRY(data.read(m_storage->data() + offset, 0, first_chunk_size));
+    if (first_chunk_size < bytes_to_write)
+        TRY(data.read(m_storage->data(), first_chunk_size, bytes_to_write - first_chunk_size));
+    m_write_position.store(write_position + bytes_to_write);
+
+    // Only a reader that found the buffer empty can be waiting for us. Looking at the read
+    // position again after publishing the data makes sure we can't miss it going empty.
+    if (m_unblock_callback && m_read_position.load() == write_position)
+        m_unblock_callback();
+    return bytes_to_write;
+}
+
+ErrorOr<size_t> SPSCRingBuffer::read(UserOrKernelBuffer& data, size_t size)
+{
+    if (!size)
+        return 0;
+    MutexLocker locker(m_read_lock);
+
+    auto read_position = m_read_position.load(AK::MemoryOrder::memory_order_relaxed);
+    auto write_position = m_write_position.load();
+    size_t bytes_to_read = min(size, write_position - read_position);
+    if (!bytes_to_read)
+        return 0;
+
+    size_t offset = read_position & (m_capacity - 1);
+    size_t first_chunk_size = min(bytes_to_read, m_capacity - offset);
+    TRY(data.write(m_storage->data() + offset, 0, first_chunk_size));
+    if (first_chunk_size < bytes_to_read)
+        TRY(data.write(m_storage->data(), first_chunk_size, bytes_to_read - first_chunk_size));
+    m_read_position.store(read_position + bytes_to_read);
+
+    // Likewise, only a writer that found the buffer full can be waiting for us.
+    if (m_unblock_callback && m_write_position.load() - read_position == m_capacity)
+        m_unblock_callback();
+    return bytes_to_read;
+}
+
+ErrorOr<void> SPSCRingBuffer::try_resize(StringView name, size_t new_capacity)
+{
+    new_capacity = round_up_capacity(new_capacity);
+    if (new_capacity == m_capacity)
+        return {};
+    auto storage = TRY(KBuffer::try_create_with_size(name, new_capacity, Memory::Region::Access::ReadWrite));
+
+    MutexLocker write_locker(m_write_lock);
+    MutexLocker read_locker(m_read_lock);
+
+    auto read_position = m_read_position.load();
+    size_t unread = m_write_position.load() - read_position;
+    if (unread > new_capacity)
+        return EBUSY;
+
+    size_t offset = read_position & (m_capacity - 1);
+    size_t first_chunk_size = min(unread, m_capacity - offset);
+    memcpy(storage->data(), m_storage->data() + offset, first_chunk_size);
+    memcpy(storage->data() + first_chunk_size, m_storage->data(), unread - first_chunk_size);
+
+    bool was_full = unread == m_capacity;
+    m_storage = move(storage);
+    m_capacity = new_capacity;
+    m_read_position.store(0);
+    m_write_position.store(unread);
+
+    if (m_unblock_callback && was_full && unread < new_capacity)
+        m_unblock_callback();
+    return {};
+}
+
+}
@@ -0,0 +1,70 @@
+/*
+ * Copyright (c) 2022, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#pragma once
+
+#include <AK/Atomic.h>
+#include <AK/Function.h>
+#include <AK/NonnullOwnPtr.h>
+#include <AK/Types.h>
+#include <Kernel/KBuffer.h>
+#include <Kernel/Locking/Mutex.h>
+#include <Kernel/UserOrKernelBuffer.h>
+
+namespace Kernel {
+
+// A byte stream between one writer and one reader. The read and write positions only ever
+// grow, and each one is owned by its side, so the writer and the reader never have to wait
+// for each other. Concurrent writers (or readers) of the same stream are still serialized
+// against each other, but not against the other side.
+class SPSCRingBuffer {
+public:
+    static constexpr size_t default_capacity = 64 * KiB;
+    static constexpr size_t minimum_capacity = 4 * KiB;
+    static constexpr size_t maximum_capacity = 4 * MiB;
+
+    // The capacity is rounded up to the next power of two.
+    static ErrorOr<NonnullOwnPtr<SPSCRingBuffer>> try_create(StringView name, size_t capacity = default_capacity);
+
+    ErrorOr<size_t> write(UserOrKernelBuffer const&, size_t);
+    ErrorOr<size_t> read(UserOrKernelBuffer&, size_t);
+
+    // Moves the contents into new storage. Fails with EBUSY if they wouldn't fit.
+    ErrorOr<void> try_resize(StringView name, size_t new_capacity);
+
+    bool is_empty() const { return immediately_readable() == 0; }
+    size_t capacity() const { return m_capacity; }
+    size_t space_for_writing() const { return m_capacity - immediately_readable(); }
+    size_t immediately_readable() const
+    {
+        // The read position never passes the write position, so it has to be loaded first.
+        auto read_position = m_read_position.load();
+        return min(m_write_position.load() - read_position, m_capacity);
+    }
+
+    void set_unblock_callback(Function<void()> callback)
+    {
+        VERIFY(!m_unblock_callback);
+        m_unblock_callback = move(callback);
+    }
+
+private:
+    SPSCRingBuffer(size_t capacity, NonnullOwnPtr<KBuffer> storage);
+
+    static size_t round_up_capacity(size_t);
+
+    NonnullOwnPtr<KBuffer> m_storage;
+    Function<void()> m_unblock_callback;
+    size_t m_capacity { 0 };
+
+    Atomic<size_t> m_write_position { 0 };
+    Atomic<size_t> m_read_position { 0 };
+
+    Mutex m_write_lock { "SPSCRingBuffer writer"sv };
+    Mutex m_read_lock { "SPSCRingBuffer reader"sv };
+};
+
+}
@@ -6,8 +6,8 @@
 
 #include <AK/BuiltinWrappers.h>
 #include <AK/ScopeGuard.h>
-#include <AK/Singleton.h>
 #include <AK/Time.h>
+#include <Kernel/Arch/Processor.h>
 #include <Kernel/Arch/TrapFrame.h>
 #include <Kernel/Debug.h>
 #include <Kernel/InterruptDisabler.h>
@@ -46,7 +46,21 @@ struct ThreadReadyQueues {
     Array<ThreadReadyQueue, count> queues;
 };
 
-static Singleton<SpinlockProtected<ThreadReadyQueues>> g_ready_queues;
+// Each processor owns its own set of ready queues, so picking the next thread
+// to run only ever touches the local queues unless we run out of work and
+// have to steal from another processor.
+struct SchedulerPerProcessorData {
+    static ProcessorSpecificDataID processor_specific_data_id() { return ProcessorSpecificDataID::Scheduler; }
+
+    SpinlockProtected<ThreadReadyQueues> m_ready_queues { LockRank::None };
+
+    // Number of threads in m_ready_queues, readable without taking the lock.
+    // This is only used as a hint when looking for a processor to steal from.
+    Atomic<u32> m_ready_count { 0 };
+};
+
+static Array<SchedulerPerProcessorData*, MAX_CPU_COUNT> s_per_processor_data;
+static Atomic<u32> s_scheduler_processor_mask { 0 };
 
 static SpinlockProtected<TotalTimeScheduled> g_total_time_scheduled { LockRank::None };
 
@@ -55,7 +69,7 @@ static void dump_thread_list(bool = false);
 static inline u32 thread_priority_to_priority_index(u32 thread_priority)
 {
     // Converts the priority in the range of THREAD_PRIORITY_MIN...THREAD_PRIORITY_MAX
-    // to a index into g_ready_queues where 0 is the highest priority bucket
+    // to a index into the ready queues where 0 is the highest priority bucket
     VERIFY(thread_priority >= THREAD_PRIORITY_MIN && thread_priority <= THREAD_PRIORITY_MAX);
     constexpr u32 thread_priority_count = THREAD_PRIORITY_MAX - THREAD_PRIORITY_MIN + 1;
     static_assert(thread_priority_count > 0);
@@ -64,11 +78,56 @@ static inline u32 thread_priority_to_priority_index(u32 thread_priority)
     return priority_bucket;
 }
 
-Thread& Scheduler::pull_next_runnable_thread()
+static inline SchedulerPerProcessorData& scheduler_data_for(u32 cpu)
+{
+    VERIFY(cpu < MAX_CPU_COUNT);
+    auto* data = s_per_processor_data[cpu];
+    VERIFY(data);
+    return *data;
+}
+
+static u32 select_processor_for(Thread const& thread)
+{
+    auto current_cpu = Processor::current_id();
+    auto eligible_mask = thread.affinity() & s_scheduler_processor_mask.load(AK::MemoryOrder::memory_order_acquire);
+
+    // None of the processors this thread may run on are scheduling yet. Park it
+    // here; they will steal it once they come up.
+    if (eligible_mask == 0)
+        return current_cpu;
+
+    // Prefer the processor this thread last ran on, as its caches are most
+    // likely still warm. If that processor is backed up, idle processors will
+    // steal from it anyway.
+    auto last_cpu = thread.cpu();
+    if (eligible_mask & (1u << last_cpu))
+        return last_cpu;
+
+    if (eligible_mask & (1u << current_cpu))
+        return current_cpu;
+
+    // Otherwise pick the least loaded processor we are allowed to run on.
+    u32 best_cpu = bit_scan_forward(eligible_mask) - 1;
+    u32 best_count = scheduler_data_for(best_cpu).m_ready_count.load(AK::MemoryOrder::memory_order_relaxed);
+    for (auto mask = eligible_mask & ~(1u << best_cpu); mask != 0;) {
+        u32 cpu = bit_scan_forward(mask) - 1;
+        mask &= ~(1u << cpu);
+        auto count = scheduler_data_for(cpu).m_ready_count.load(AK::MemoryOrder::memory_order_relaxed);
+        if (count < best_count) {
+            best_cpu = cpu;
+            best_count = count;
+        }
+    }
+    return best_cpu;
+}
+
+// Finds the highest priority thread in the given ready queues that may run on
+// the current processor. If remove is true, the thread is taken off the queue.
+Thread* Scheduler::find_runnable_thread(SchedulerPerProcessorData& data, bool remove)
 {
     auto affinity_mask = 1u << Processor::current_id();
 
-    return g_ready_queues->with([&](auto& ready_queues) -> Thread& {
+    return data.m_ready_queues.with([&](auto& ready_queues) -> Thread* {
         auto priority_mask = ready_queues.mask;
         while (priority_mask != 0) {
             auto priority = bit_scan_forward(priority_mask);
@@ -80,10 +139,13 @@ Thread& Scheduler::pull_next_runnable_thread()
                     continue;
                 if (!(thread.affinity() & affinity_mask))
                     continue;
+                if (!remove)
+                    return &thread;
                 thread.m_runnable_priority = -1;
                 ready_queue.thread_list.remove(thread);
                 if (ready_queue.thread_list.is_empty())
                     ready_queues.mask &= ~(1u << priority);
+                data.m_ready_count.fetch_sub(1, AK::MemoryOrder::memory_order_relaxed);
                 // Mark it as active because we are using this thread. This is similar
                 // to comparing it with Processor::current_thread, but when there are
                 // multiple processors there's no easy way to check whether the thread
@@ -95,40 +157,66 @@ Thread& Scheduler::pull_next_runnable_thread()
                 // switching to it.
                 // FIXME: Figure out a better way maybe?
                 thread.set_active(true);
-                return thread;
+                return &thread;
             }
             priority_mask &= ~(1u << priority);
         }
-        return *Processor::idle_thread();
+        return nullptr;
     });
 }
 
-Thread* Scheduler::peek_next_runnable_thread()
+// Looks for work on the other processors, starting with the most loaded one.
+Thread* Scheduler::steal_runnable_thread(bool remove)
 {
-    auto affinity_mask = 1u << Processor::current_id();
-
-    return g_ready_queues->with([&](auto& ready_queues) -> Thread* {
-        auto priority_mask = ready_queues.mask;
-        while (priority_mask != 0) {
-            auto priority = bit_scan_forward(priority_mask);
-            VERIFY(priority > 0);
-            auto& ready_queue = ready_queues.queues[--priority];
-            for (auto& thread : ready_queue.thread_list) {
-                VERIFY(thread.m_runnable_priority == (int)priority);
-                if (thread.is_active())
-                    continue;
-                if (!(thread.affinity() & affinity_mask))
-                    continue;
-                return &thread;
+    auto current_cpu = Processor::current_id();
+    auto other_processors_mask = s_scheduler_processor_mask.load(AK::MemoryOrder::memory_order_acquire) & ~(1u << current_cpu);
+
+    while (other_processors_mask != 0) {
+        u32 busiest_cpu = 0;
+        u32 busiest_count = 0;
+        for (auto mask = other_processors_mask; mask != 0;) {
+            u32 cpu = bit_scan_forward(mask) - 1;
+            mask &= ~(1u << cpu);
+            auto count = scheduler_data_for(cpu).m_ready_count.load(AK::MemoryOrder::memory_order_relaxed);
+            if (count > busiest_count) {
+                busiest_cpu = cpu;
+                busiest_count = count;
             }
-            priority_mask &= ~(1u << priority);
         }
+        if (busiest_count == 0)
+            return nullptr;
+
+        if (auto* thread = find_runnable_thread(scheduler_data_for(busiest_cpu), remove)) {
+            dbgln_if(SCHEDULER_DEBUG, "Scheduler[{}]: {} thread {} from processor {}", current_cpu, remove ? "Stealing" : "Could steal", *thread, busiest_cpu);
+            return thread;
+        }
+
+        // Nothing on that processor is allowed to run here, try the next one.
+        other_processors_mask &= ~(1u << busiest_cpu);
+    }
+    return nullptr;
+}
+
+Thread& Scheduler::pull_next_runnable_thread()
+{
+    if (auto* thread = find_runnable_thread(scheduler_data_for(Processor::current_id()), true))
+        return *thread;
+    if (auto* thread = steal_runnable_thread(true))
+        return *thread;
+    return *Processor::idle_thread();
+}
 
-        // Unlike in pull_next_runnable_thread() we don't want to fall back to
-        // the idle thread. We just want to see if we have any other thread ready
-        // to be scheduled.
+Thread* Scheduler::peek_next_runnable_thread()
+{
+    if (!s_per_processor_data[Processor::current_id()])
         return nullptr;
-    });
+
+    // Unlike in pull_next_runnable_thread() we don't want to fall back to
+    // the idle thread. We just want to see if we have any other thread ready
+    // to be scheduled here. Threads queued on other processors are not a reason
+    // to preempt the current one: their own processors will run them, or an
+    // idle processor will steal them.
+    return find_runnable_thread(scheduler_data_for(Processor::current_id()), false);
 }
 
 bool Scheduler::dequeue_runnable_thread(Thread& thread, bool check_affinity)
@@ -136,22 +224,35 @@ bool Scheduler::dequeue_runnable_thread(Thread& thread, bool check_affinity)
     if (thread.is_idle_thread())
         return true;
 
-    return g_ready_queues->with([&](auto& ready_queues) {
-        auto priority = thread.m_runnable_priority;
+    auto priority = thread.m_runnable_priority;
+    if (priority < 0) {
+        VERIFY(!thread.m_ready_queue_node.is_in_list());
+        return false;
+    }
+
+    if (check_affinity && !(thread.affinity() & (1 << Processor::current_id())))
+        return false;
+
+    // Threads only move between queues while holding the scheduler lock,
+    // so m_runnable_cpu can't change under us.
+    VERIFY(g_scheduler_lock.is_locked_by_current_processor());
+    auto& data = scheduler_data_for(thread.m_runnable_cpu);
+    return data.m_ready_queues.with([&](auto& ready_queues) {
+        // The thread may have been pulled off the queue by a processor that
+        // was stealing work in the meantime.
+        priority = thread.m_runnable_priority;
         if (priority < 0) {
             VERIFY(!thread.m_ready_queue_node.is_in_list());
             return false;
         }
 
-        if (check_affinity && !(thread.affinity() & (1 << Processor::current_id())))
-            return false;
-
         VERIFY(ready_queues.mask & (1u << priority));
         auto& ready_queue = ready_queues.queues[priority];
         thread.m_runnable_priority = -1;
         ready_queue.thread_list.remove(thread);
         if (ready_queue.thread_list.is_empty())
             ready_queues.mask &= ~(1u << priority);
+        data.m_ready_count.fetch_sub(1, AK::MemoryOrder::memory_order_relaxed);
         return true;
     });
 }
@@ -161,17 +262,21 @@ void Scheduler::enqueue_runnable_thread(Thread& thread)
     VERIFY(g_scheduler_lock.is_locked_by_current_processor());
     if (thread.is_idle_thread())
         return;
-    auto priority = thread_priority_to_priority_index(thread.priority());
+    auto priority = thread_priority_to_priority_index(thread.effective_priority());
+    auto cpu = select_processor_for(thread);
+    auto& data = scheduler_data_for(cpu);
 
-    g_ready_queues->with([&](auto& ready_queues) {
+    data.m_ready_queues.with([&](auto& ready_queues) {
         VERIFY(thread.m_runnable_priority < 0);
         thread.m_runnable_priority = (int)priority;
+        thread.m_runnable_cpu = cpu;
         VERIFY(!thread.m_ready_queue_node.is_in_list());
         auto& ready_queue = ready_queues.queues[priority];
         bool was_empty = ready_queue.thread_list.is_empty();
         ready_queue.thread_list.append(thread);
         if (was_empty)
             ready_queues.mask |= (1u << priority);
+        data.m_ready_count.fetch_add(1, AK::MemoryOrder::memory_order_relaxed);
     });
 }
 
@@ -381,6 +486,12 @@ UNMAP_AFTER_INIT void Scheduler::initialize()
 
 UNMAP_AFTER_INIT void Scheduler::set_idle_thread(Thread* idle_thread)
 {
+    ProcessorSpecific<SchedulerPerProcessorData>::initialize();
+    auto cpu = Processor::current_id();
+    VERIFY(cpu < MAX_CPU_COUNT);
+    s_per_processor_data[cpu] = &ProcessorSpecific<SchedulerPerProcessorData>::get();
+    s_scheduler_processor_mask.fetch_or(1u << cpu, AK::MemoryOrder::memory_order_acq_rel);
+
     idle_thread->set_idle_thread();
     Processor::current().set_idle_thread(*idle_thread);
     Processor::set_current_thread(*idle_thread);
@@ -18,6 +18,7 @@
 namespace Kernel {
 
 struct RegisterState;
+struct SchedulerPerProcessorData;
 
 extern Thread* g_finalizer;
 extern WaitQueue* g_finalizer_wait_queue;
@@ -55,6 +56,10 @@ public:
     static bool is_initialized();
     static TotalTimeScheduled get_total_time_scheduled();
     static void add_time_scheduled(u64, bool);
+
+private:
+    static Thread* find_runnable_thread(SchedulerPerProcessorData&, bool remove);
+    static Thread* steal_runnable_thread(bool remove);
 };
 
 }
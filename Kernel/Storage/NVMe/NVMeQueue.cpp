@@ -14,21 +14,24 @@
 namespace Kernel {
 ErrorOr<NonnullLockRefPtr<NVMeQueue>> NVMeQueue::try_create(u16 qid, Optional<u8> irq, u32 q_depth, OwnPtr<Memory::Region> cq_dma_region, NonnullRefPtrVector<Memory::PhysicalPage> cq_dma_page, OwnPtr<Memory::Region> sq_dma_region, NonnullRefPtrVector<Memory::PhysicalPage> sq_dma_page, Memory::TypedMapping<volatile DoorbellRegister> db_regs)
 {
-    // Note: Allocate DMA region for RW operation. For now the requests don't exceed more than 4096 bytes (Storage device takes care of it)
-    RefPtr<Memory::PhysicalPage> rw_dma_page;
-    auto rw_dma_region = TRY(MM.allocate_dma_buffer_page("NVMe Queue Read/Write DMA"sv, Memory::Region::Access::ReadWrite, rw_dma_page));
+    IOBuffers io_buffers;
+    // Note: The admin queue never transfers data for the block layer, so it doesn't need any I/O buffers.
+    if (qid != 0) {
+        io_buffers.data_region = TRY(MM.allocate_dma_buffer_pages(MaximumOutstandingCommands * MaximumTransferSize, "NVMe Queue Read/Write DMA"sv, Memory::Region::Access::ReadWrite, io_buffers.data_pages));
+        RefPtr<Memory::PhysicalPage> prp_list_page;
+        io_buffers.prp_list_region = TRY(MM.allocate_dma_buffer_page("NVMe Queue PRP Lists"sv, Memory::Region::Access::ReadWrite, prp_list_page));
+        io_buffers.prp_list_page = move(prp_list_page);
+    }
     if (!irq.has_value()) {
-        auto queue = TRY(adopt_nonnull_lock_ref_or_enomem(new (nothrow) NVMePollQueue(move(rw_dma_region), *rw_dma_page, qid, q_depth, move(cq_dma_region), cq_dma_page, move(sq_dma_region), sq_dma_page, move(db_regs))));
+        auto queue = TRY(adopt_nonnull_lock_ref_or_enomem(new (nothrow) NVMePollQueue(move(io_buffers), qid, q_depth, move(cq_dma_region), cq_dma_page, move(sq_dma_region), sq_dma_page, move(db_regs))));
         return queue;
     }
-    auto queue = TRY(adopt_nonnull_lock_ref_or_enomem(new (nothrow) NVMeInterruptQueue(move(rw_dma_region), *rw_dma_page, qid, irq.value(), q_depth, move(cq_dma_region), cq_dma_page, move(sq_dma_region), sq_dma_page, move(db_regs))));
+    auto queue = TRY(adopt_nonnull_lock_ref_or_enomem(new (nothrow) NVMeInterruptQueue(move(io_buffers), qid, irq.value(), q_depth, move(cq_dma_region), cq_dma_page, move(sq_dma_region), sq_dma_page, move(db_regs))));
     return queue;
 }
 
-UNMAP_AFTER_INIT NVMeQueue::NVMeQueue(NonnullOwnPtr<Memory::Region> rw_dma_region, Memory::PhysicalPage const& rw_dma_page, u16 qid, u32 q_depth, OwnPtr<Memory::Region> cq_dma_region, NonnullRefPtrVector<Memory::PhysicalPage> cq_dma_page, OwnPtr<Memory::Region> sq_dma_region, NonnullRefPtrVector<Memory::PhysicalPage> sq_dma_page, Memory::TypedMapping<volatile DoorbellRegister> db_regs)
-    : m_current_request(nullptr)
-    , m_rw_dma_region(move(rw_dma_region))
-    , m_qid(qid)
+UNMAP_AFTER_INIT NVMeQueue::NVMeQueue(IOBuffers io_buffers, u16 qid, u32 q_depth, OwnPtr<Memory::Region> cq_dma_region, NonnullRefPtrVector<Memory::PhysicalPage> cq_dma_page, OwnPtr<Memory::Region> sq_dma_region, NonnullRefPtrVector<Memory::PhysicalPage> sq_dma_page, Memory::TypedMapping<volatile DoorbellRegister> db_regs)
+    : m_qid(qid)
     , m_admin_queue(qid == 0)
     , m_qdepth(q_depth)
     , m_cq_dma_region(move(cq_dma_region))
@@ -36,11 +39,12 @@ UNMAP_AFTER_INIT NVMeQueue::NVMeQueue(NonnullOwnPtr<Memory::Region> rw_dma_regio
     , m_sq_dma_region(move(sq_dma_region))
     , m_sq_dma_page(sq_dma_page)
     , m_db_regs(move(db_regs))
-    , m_rw_dma_page(rw_dma_page)
-
+    , m_io_buffers(move(io_buffers))
 {
     m_sqe_array = { reinterpret_cast<NVMeSubmission*>(m_sq_dma_region->vaddr().as_ptr()), m_qdepth };
     m_cqe_array = { reinterpret_cast<NVMeCompletion*>(m_cq_dma_region->vaddr().as_ptr()), m_qdepth };
+    // Every outstanding command needs a submission queue entry, and one entry always stays empty.
+    VERIFY(m_admin_queue || MaximumOutstandingCommands < m_qdepth);
 }
 
 bool NVMeQueue::cqe_available()
@@ -73,13 +77,9 @@ u32 NVMeQueue::process_cq()
         // TODO: We don't use AsyncBlockDevice requests for admin queue as it is only applicable for a block device (NVMe namespace)
         //  But admin commands precedes namespace creation. Unify requests to avoid special conditions
         if (m_admin_queue == false) {
-            // As the block layer calls are now sync (as we wait on each requests),
-            // everything is operated on a single request similar to BMIDE driver.
-            // TODO: Remove this constraint eventually.
-            VERIFY(cmdid == m_prev_sq_tail);
-            if (m_current_request) {
-                complete_current_request(status);
-            }
+            // I/O commands use their command slot as the command identifier.
+            VERIFY(cmdid < MaximumOutstandingCommands);
+            command_completed(cmdid, status);
         }
         update_cqe_head();
     }
@@ -92,9 +92,9 @@ u32 NVMeQueue::process_cq()
 void NVMeQueue::submit_sqe(NVMeSubmission& sub)
 {
     SpinlockLocker lock(m_sq_lock);
-    // For now let's use sq tail as a unique command id.
-    sub.cmdid = m_sq_tail;
-    m_prev_sq_tail = m_sq_tail;
+    // For now let's use sq tail as a unique command id for admin commands.
+    if (m_admin_queue)
+        sub.cmdid = m_sq_tail;
 
     memcpy(&m_sqe_array[m_sq_tail], &sub, sizeof(NVMeSubmission));
     {
@@ -133,42 +133,180 @@ u16 NVMeQueue::submit_sync_sqe(NVMeSubmission& sub)
     return status;
 }
 
-void NVMeQueue::read(AsyncBlockDeviceRequest& request, u16 nsid, u64 index, u32 count)
+void NVMeQueue::submit_request(AsyncBlockDeviceRequest& request, u16 nsid)
 {
-    NVMeSubmission sub {};
-    SpinlockLocker m_lock(m_request_lock);
-    m_current_request = request;
+    VERIFY(!m_admin_queue);
+    VERIFY(request.buffer_size() <= MaximumTransferSize);
+    {
+        SpinlockLocker lock(m_request_lock);
+        if (auto result = m_pending_requests.try_append({ request, nsid }); result.is_error()) {
+            lock.unlock();
+            request.complete(AsyncDeviceRequest::OutOfMemory);
+            return;
+        }
+    }
+    dispatch_pending_requests();
+}
 
-    sub.op = OP_NVME_READ;
-    sub.rw.nsid = nsid;
-    sub.rw.slba = AK::convert_between_host_and_little_endian(index);
-    // No. of lbas is 0 based
-    sub.rw.length = AK::convert_between_host_and_little_endian((count - 1) & 0xFFFF);
-    sub.rw.data_ptr.prp1 = reinterpret_cast<u64>(AK::convert_between_host_and_little_endian(m_rw_dma_page->paddr().as_ptr()));
+Optional<u16> NVMeQueue::find_free_command_while_locked() const
+{
+    VERIFY(m_request_lock.is_locked());
+    for (u16 command_id = 0; command_id < MaximumOutstandingCommands; ++command_id) {
+        if (!m_commands[command_id].is_in_use)
+            return command_id;
+    }
+    return {};
+}
 
-    full_memory_barrier();
-    submit_sqe(sub);
+bool NVMeQueue::is_command_in_use(u16 command_id) const
+{
+    SpinlockLocker lock(m_request_lock);
+    return m_commands[command_id].is_in_use;
+}
+
+void NVMeQueue::dispatch_pending_requests()
+{
+    SpinlockLocker lock(m_request_lock);
+    while (!m_pending_requests.is_empty()) {
+        auto command_id = find_free_command_while_locked();
+        if (!command_id.has_value())
+            return;
+
+        NVMeSubmission sub {};
+        LockRefPtr<AsyncBlockDeviceRequest> failed_request;
+        if (!prepare_command_while_locked(*command_id, sub, failed_request)) {
+            lock.unlock();
+            failed_request->complete(AsyncDeviceRequest::MemoryFault);
+            lock.lock();
+            continue;
+        }
+
+        // NOTE: Submitting may process completions right away (see NVMePollQueue), which takes m_request_lock.
+        lock.unlock();
+        submit_sqe(sub);
+        if (failed_request)
+            failed_request->complete(AsyncDeviceRequest::MemoryFault);
+        lock.lock();
+    }
 }
 
-void NVMeQueue::write(AsyncBlockDeviceRequest& request, u16 nsid, u64 index, u32 count)
+bool NVMeQueue::prepare_command_while_locked(u16 command_id, NVMeSubmission& sub, LockRefPtr<AsyncBlockDeviceRequest>& failed_request)
 {
-    NVMeSubmission sub {};
-    SpinlockLocker m_lock(m_request_lock);
-    m_current_request = request;
+    VERIFY(m_request_lock.is_locked());
+    auto& command = m_commands[command_id];
+    VERIFY(!command.is_in_use);
+    VERIFY(command.request_count == 0);
 
-    if (auto result = m_current_request->read_from_buffer(m_current_request->buffer(), m_rw_dma_region->vaddr().as_ptr(), m_current_request->buffer_size()); result.is_error()) {
-        complete_current_request(AsyncDeviceRequest::MemoryFault);
-        return;
+    auto first = m_pending_requests.take_first();
+    auto request_type = first.request->request_type();
+    auto nsid = first.nsid;
+    auto block_size = first.request->block_size();
+    u64 first_block = first.request->block_index();
+    u32 block_count = 0;
+    size_t transfer_size = 0;
+    auto* data = command_data(command_id);
+
+    auto append_request = [&](NonnullLockRefPtr<AsyncBlockDeviceRequest> request) {
+        // Write data has to be in the bounce buffer before the command is submitted.
+        if (request_type == AsyncBlockDeviceRequest::Write) {
+            if (request->read_from_buffer(request->buffer(), data + transfer_size, request->buffer_size()).is_error()) {
+                failed_request = move(request);
+                return false;
+            }
+        }
+        block_count += request->block_count();
+        transfer_size += request->buffer_size();
+        command.requests[command.request_count++] = move(request);
+        return true;
+    };
+
+    if (!append_request(move(first.request)))
+        return false;
+
+    // Merge pending requests that continue right where this command ends. They often
+    // come from other threads reading or writing neighbouring blocks at the same time.
+    while (command.request_count < MaximumMergedRequests) {
+        Optional<size_t> next_index;
+        for (size_t i = 0; i < m_pending_requests.size(); ++i) {
+            auto& candidate = m_pending_requests[i];
+            if (candidate.nsid != nsid || candidate.request->request_type() != request_type)
+                continue;
+            if (candidate.request->block_index() != first_block + block_count)
+                continue;
+            if (transfer_size + candidate.request->buffer_size() > MaximumTransferSize)
+                continue;
+            next_index = i;
+            break;
+        }
+        if (!next_index.has_value())
+            break;
+        auto next = m_pending_requests.take(*next_index);
+        if (!append_request(move(next.request)))
+            break;
     }
-    sub.op = OP_NVME_WRITE;
+
+    command.is_in_use = true;
+
+    sub.op = request_type == AsyncBlockDeviceRequest::Read ? OP_NVME_READ : OP_NVME_WRITE;
+    sub.cmdid = command_id;
     sub.rw.nsid = nsid;
-    sub.rw.slba = AK::convert_between_host_and_little_endian(index);
+    sub.rw.slba = AK::convert_between_host_and_little_endian(first_block);
     // No. of lbas is 0 based
-    sub.rw.length = AK::convert_between_host_and_little_endian((count - 1) & 0xFFFF);
-    sub.rw.data_ptr.prp1 = reinterpret_cast<u64>(AK::convert_between_host_and_little_endian(m_rw_dma_page->paddr().as_ptr()));
+    sub.rw.length = AK::convert_between_host_and_little_endian((block_count - 1) & 0xFFFF);
+
+    // Transfers of up to two pages point at the pages directly, anything larger needs a PRP list.
+    auto page_count = ceil_div(transfer_size, static_cast<size_t>(PAGE_SIZE));
+    auto first_page_index = command_id * MaximumTransferPages;
+    VERIFY(block_count * block_size == transfer_size);
+    sub.rw.data_ptr.prp1 = reinterpret_cast<u64>(AK::convert_between_host_and_little_endian(m_io_buffers.data_pages[first_page_index].paddr().as_ptr()));
+    if (page_count == 2) {
+        sub.rw.data_ptr.prp2 = reinterpret_cast<u64>(AK::convert_between_host_and_little_endian(m_io_buffers.data_pages[first_page_index + 1].paddr().as_ptr()));
+    } else if (page_count > 2) {
+        auto prp_list_offset = command_id * MaximumTransferPages * sizeof(u64);
+        auto* prp_list = reinterpret_cast<u64*>(m_io_buffers.prp_list_region->vaddr().offset(prp_list_offset).as_ptr());
+        for (size_t i = 1; i < page_count; ++i)
+            prp_list[i - 1] = AK::convert_between_host_and_little_endian(m_io_buffers.data_pages[first_page_index + i].paddr().get());
+        sub.rw.data_ptr.prp2 = AK::convert_between_host_and_little_endian(m_io_buffers.prp_list_page->paddr().offset(prp_list_offset).get());
+    }
 
     full_memory_barrier();
-    submit_sqe(sub);
+    return true;
+}
+
+void NVMeQueue::complete_command(u16 command_id, AsyncDeviceRequest::RequestResult result)
+{
+    Array<LockRefPtr<AsyncBlockDeviceRequest>, MaximumMergedRequests> requests;
+    size_t request_count = 0;
+    {
+        SpinlockLocker lock(m_request_lock);
+        auto& command = m_commands[command_id];
+        VERIFY(command.is_in_use);
+        request_count = command.request_count;
+        for (size_t i = 0; i < request_count; ++i)
+            requests[i] = move(command.requests[i]);
+        command.request_count = 0;
+    }
+
+    // NOTE: The command slot stays in use until its data has been copied out.
+    Array<AsyncDeviceRequest::RequestResult, MaximumMergedRequests> results;
+    size_t offset = 0;
+    for (size_t i = 0; i < request_count; ++i) {
+        auto& request = *requests[i];
+        results[i] = result;
+        if (result == AsyncDeviceRequest::Success && request.request_type() == AsyncBlockDeviceRequest::Read) {
+            if (request.write_to_buffer(request.buffer(), command_data(command_id) + offset, request.buffer_size()).is_error())
+                results[i] = AsyncDeviceRequest::MemoryFault;
+        }
+        offset += request.buffer_size();
+    }
+
+    {
+        SpinlockLocker lock(m_request_lock);
+        m_commands[command_id].is_in_use = false;
+    }
+
+    for (size_t i = 0; i < request_count; ++i)
+        requests[i]->complete(results[i]);
 }
 
 UNMAP_AFTER_INIT NVMeQueue::~NVMeQueue() = default;
@@ -6,11 +6,14 @@
 
 #pragma once
 
+#include <AK/Array.h>
 #include <AK/AtomicRefCounted.h>
 #include <AK/NonnullRefPtrVector.h>
 #include <AK/OwnPtr.h>
 #include <AK/Types.h>
+#include <AK/Vector.h>
 #include <Kernel/Bus/PCI/Device.h>
+#include <Kernel/Devices/AsyncDeviceRequest.h>
 #include <Kernel/Interrupts/IRQHandler.h>
 #include <Kernel/Library/LockRefPtr.h>
 #include <Kernel/Library/NonnullLockRefPtr.h>
@@ -30,42 +33,74 @@ struct DoorbellRegister {
 class AsyncBlockDeviceRequest;
 class NVMeQueue : public AtomicRefCounted<NVMeQueue> {
 public:
+    // Each I/O command gets its own slot with a DMA bounce buffer, so this many
+    // requests can be in flight on one queue at the same time.
+    static constexpr size_t MaximumOutstandingCommands = 16;
+    static constexpr size_t MaximumTransferPages = 16;
+    static constexpr size_t MaximumTransferSize = MaximumTransferPages * PAGE_SIZE;
+    // Adjacent requests waiting for a free slot are merged into a single command.
+    static constexpr size_t MaximumMergedRequests = 8;
+
     static ErrorOr<NonnullLockRefPtr<NVMeQueue>> try_create(u16 qid, Optional<u8> irq, u32 q_depth, OwnPtr<Memory::Region> cq_dma_region, NonnullRefPtrVector<Memory::PhysicalPage> cq_dma_page, OwnPtr<Memory::Region> sq_dma_region, NonnullRefPtrVector<Memory::PhysicalPage> sq_dma_page, Memory::TypedMapping<DoorbellRegister volatile> db_regs);
     bool is_admin_queue() { return m_admin_queue; };
     u16 submit_sync_sqe(NVMeSubmission&);
-    void read(AsyncBlockDeviceRequest& request, u16 nsid, u64 index, u32 count);
-    void write(AsyncBlockDeviceRequest& request, u16 nsid, u64 index, u32 count);
+    void submit_request(AsyncBlockDeviceRequest& request, u16 nsid);
     virtual void submit_sqe(NVMeSubmission&);
     virtual ~NVMeQueue();
 
 protected:
+    struct IOBuffers {
+        OwnPtr<Memory::Region> data_region;
+        NonnullRefPtrVector<Memory::PhysicalPage> data_pages;
+        OwnPtr<Memory::Region> prp_list_region;
+        RefPtr<Memory::PhysicalPage> prp_list_page;
+    };
+
+    struct Command {
+        Array<LockRefPtr<AsyncBlockDeviceRequest>, MaximumMergedRequests> requests;
+        size_t request_count { 0 };
+        bool is_in_use { false };
+    };
+
+    struct PendingRequest {
+        NonnullLockRefPtr<AsyncBlockDeviceRequest> request;
+        u16 nsid;
+    };
+
     u32 process_cq();
     void update_sq_doorbell()
     {
         m_db_regs->sq_tail = m_sq_tail;
     }
-    NVMeQueue(NonnullOwnPtr<Memory::Region> rw_dma_region, Memory::PhysicalPage const& rw_dma_page, u16 qid, u32 q_depth, OwnPtr<Memory::Region> cq_dma_region, NonnullRefPtrVector<Memory::PhysicalPage> cq_dma_page, OwnPtr<Memory::Region> sq_dma_region, NonnullRefPtrVector<Memory::PhysicalPage> sq_dma_page, Memory::TypedMapping<DoorbellRegister volatile> db_regs);
+    NVMeQueue(IOBuffers, u16 qid, u32 q_depth, OwnPtr<Memory::Region> cq_dma_region, NonnullRefPtrVector<Memory::PhysicalPage> cq_dma_page, OwnPtr<Memory::Region> sq_dma_region, NonnullRefPtrVector<Memory::PhysicalPage> sq_dma_page, Memory::TypedMapping<DoorbellRegister volatile> db_regs);
+
+    // Copies read data out of the command's buffer (if successful) and completes its requests.
+    void complete_command(u16 command_id, AsyncDeviceRequest::RequestResult);
+    // Starts as many pending requests as there are free command slots.
+    void dispatch_pending_requests();
+    bool is_command_in_use(u16 command_id) const;
 
 private:
     bool cqe_available();
     void update_cqe_head();
-    virtual void complete_current_request(u16 status) = 0;
+    virtual void command_completed(u16 command_id, u16 status) = 0;
     void update_cq_doorbell()
     {
         m_db_regs->cq_head = m_cq_head;
     }
 
+    Optional<u16> find_free_command_while_locked() const;
+    bool prepare_command_while_locked(u16 command_id, NVMeSubmission&, LockRefPtr<AsyncBlockDeviceRequest>& failed_request);
+    u8* command_data(u16 command_id) { return m_io_buffers.data_region->vaddr().offset(command_id * MaximumTransferSize).as_ptr(); }
+
 protected:
     Spinlock m_cq_lock { LockRank::Interrupts };
-    LockRefPtr<AsyncBlockDeviceRequest> m_current_request;
-    NonnullOwnPtr<Memory::Region> m_rw_dma_region;
-    Spinlock m_request_lock { LockRank::None };
+    mutable Spinlock m_request_lock { LockRank::None };
 
 private:
     u16 m_qid {};
     u8 m_cq_valid_phase { 1 };
     u16 m_sq_tail {};
-    u16 m_prev_sq_tail {};
     u16 m_cq_head {};
     bool m_admin_queue { false };
     u32 m_qdepth {};
@@ -77,6 +112,8 @@ private:
     NonnullRefPtrVector<Memory::PhysicalPage> m_sq_dma_page;
     Span<NVMeCompletion> m_cqe_array;
     Memory::TypedMapping<DoorbellRegister volatile> m_db_regs;
-    NonnullRefPtr<Memory::PhysicalPage> m_rw_dma_page;
+    IOBuffers m_io_buffers;
+    Array<Command, MaximumOutstandingCommands> m_commands;
+    Vector<PendingRequest> m_pending_requests;
 };
 }
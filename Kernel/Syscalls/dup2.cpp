@@ -21,6 +21,8 @@ ErrorOr<FlatPtr> Process::sys$dup2(int old_fd, int new_fd)
             return EINVAL;
         if (!fds.m_fds_metadatas[new_fd].is_allocated())
             fds.m_fds_metadatas[new_fd].allocate();
+        if (auto replaced_description = fds[new_fd].description())
+            replaced_description->did_close_fd(pid(), new_fd);
         fds[new_fd].set(move(description));
         return new_fd;
     });
@@ -0,0 +1,133 @@
+/*
+ * Copyright (c) 2022, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <AK/ScopeGuard.h>
+#include <Kernel/FileSystem/EventPoll.h>
+#include <Kernel/FileSystem/OpenFileDescription.h>
+#include <Kernel/Process.h>
+
+namespace Kernel {
+
+// Upper bound on the events collected into a kernel buffer by a single epoll_wait().
+static constexpr size_t max_events_per_wait = 1024;
+
+ErrorOr<FlatPtr> Process::sys$epoll_create(int flags)
+{
+    VERIFY_NO_PROCESS_BIG_LOCK(this);
+    TRY(require_promise(Pledge::stdio));
+
+    if ((flags & EPOLL_CLOEXEC) != flags)
+        return EINVAL;
+
+    auto event_poll = TRY(EventPoll::try_create());
+    auto description = TRY(OpenFileDescription::try_create(move(event_poll)));
+    description->set_readable(true);
+
+    u32 fd_flags = (flags & EPOLL_CLOEXEC) ? FD_CLOEXEC : 0;
+    return m_fds.with_exclusive([&](auto& fds) -> ErrorOr<FlatPtr> {
+        auto fd_allocation = TRY(fds.allocate());
+        fds[fd_allocation.fd].set(move(description), fd_flags);
+        return fd_allocation.fd;
+    });
+}
+
+ErrorOr<FlatPtr> Process::sys$epoll_ctl(Userspace<Syscall::SC_epoll_ctl_params const*> user_params)
+{
+    VERIFY_NO_PROCESS_BIG_LOCK(this);
+    TRY(require_promise(Pledge::stdio));
+    auto params = TRY(copy_typed_from_user(user_params));
+
+    auto epoll_description = TRY(open_file_description(params.epoll_fd));
+    if (!epoll_description->is_event_poll())
+        return EINVAL;
+    auto* event_poll = epoll_description->event_poll();
+
+    if (params.op == EPOLL_CTL_DEL) {
+        // Watches are addressed by fd number, so one can still be removed after its fd was closed.
+        auto description_or_error = open_file_description(params.fd);
+        TRY(event_poll->remove_watch(description_or_error.is_error() ? nullptr : description_or_error.value().ptr(), params.fd));
+        return 0;
+    }
+
+    auto description = TRY(open_file_description(params.fd));
+    if (description.ptr() == epoll_description.ptr())
+        return EINVAL;
+
+    epoll_event event {};
+    TRY(copy_from_user(&event, params.event));
+
+    switch (params.op) {
+    case EPOLL_CTL_ADD:
+        TRY(event_poll->add_watch(*description, params.fd, event));
+        return 0;
+    case EPOLL_CTL_MOD:
+        TRY(event_poll->modify_watch(*description, params.fd, event));
+        return 0;
+    default:
+        return EINVAL;
+    }
+}
+
+ErrorOr<FlatPtr> Process::sys$epoll_wait(Userspace<Syscall::SC_epoll_wait_params const*> user_params)
+{
+    VERIFY_NO_PROCESS_BIG_LOCK(this);
+    TRY(require_promise(Pledge::stdio));
+    auto params = TRY(copy_typed_from_user(user_params));
+
+    if (params.max_events <= 0)
+        return EINVAL;
+
+    auto epoll_description = TRY(open_file_description(params.epoll_fd));
+    if (!epoll_description->is_event_poll())
+        return EINVAL;
+    auto* event_poll = epoll_description->event_poll();
+
+    Thread::BlockTimeout timeout;
+    bool is_nonblocking = false;
+    if (params.timeout) {
+        auto timeout_time = TRY(copy_time_from_user(params.timeout));
+        is_nonblocking = timeout_time.is_zero();
+        timeout = Thread::BlockTimeout(false, &timeout_time);
+    }
+
+    sigset_t sigmask = {};
+    if (params.sigmask)
+        TRY(copy_from_user(&sigmask, params.sigmask));
+
+    Vector<epoll_event> events;
+    TRY(events.try_resize(min(static_cast<size_t>(params.max_events), max_events_per_wait)));
+
+    auto* current_thread = Thread::current();
+
+    u32 previous_signal_mask = 0;
+    if (params.sigmask)
+        previous_signal_mask = current_thread->update_signal_mask(sigmask);
+    ScopeGuard rollback_signal_mask([&]() {
+        if (params.sigmask)
+            current_thread->update_signal_mask(previous_signal_mask);
+    });
+
+    size_t event_count = 0;
+    for (;;) {
+        event_count = event_poll->collect_ready_events(events.span());
+        if (event_count > 0 || is_nonblocking)
+            break;
+
+        // NOTE: The timeout is absolute at this point, so waking up without
+        //       any events doesn't extend it.
+        auto result = event_poll->wait_for_events(timeout);
+        if (result.was_interrupted())
+            return EINTR;
+        if (result == Thread::BlockResult::InterruptedByTimeout)
+            break;
+    }
+
+    if (event_count > 0)
+        TRY(copy_to_user(params.events, events.data(), event_count * sizeof(epoll_event)));
+    return event_count;
+}
+
+}
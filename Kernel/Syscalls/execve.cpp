@@ -13,6 +13,7 @@
 #include <Kernel/FileSystem/VirtualFileSystem.h>
 #include <Kernel/Memory/MemoryManager.h>
 #include <Kernel/Memory/Region.h>
+#include <Kernel/Memory/ScopedAddressSpaceSwitcher.h>
 #include <Kernel/Memory/SharedInodeVMObject.h>
 #include <Kernel/Panic.h>
 #include <Kernel/PerformanceManager.h>
@@ -585,17 +586,32 @@ ErrorOr<void> Process::do_exec(NonnullLockRefPtr<OpenFileDescription> main_progr
         property = {};
     });
 
+    // NOTE: The current thread belongs to another process when a process is spawned by the kernel or by posix_spawn().
     auto* current_thread = Thread::current();
-    current_thread->reset_signals_for_exec();
+    new_main_thread = nullptr;
+    if (&current_thread->process() == this) {
+        new_main_thread = current_thread;
+    } else {
+        for_each_thread([&](auto& thread) {
+            new_main_thread = &thread;
+            return IterationDecision::Break;
+        });
+    }
+    VERIFY(new_main_thread);
+    new_main_thread->reset_signals_for_exec();
 
     clear_signal_handlers_for_exec();
 
     clear_futex_queues_on_exec();
 
     m_fds.with_exclusive([&](auto& fds) {
+        int fd = 0;
         fds.change_each([&](auto& file_description_metadata) {
-            if (file_description_metadata.is_valid() && file_description_metadata.flags() & FD_CLOEXEC)
+            if (file_description_metadata.is_valid() && file_description_metadata.flags() & FD_CLOEXEC) {
+                file_description_metadata.description()->did_close_fd(pid(), fd);
                 file_description_metadata = {};
+            }
+            ++fd;
         });
     });
 
@@ -604,17 +620,6 @@ ErrorOr<void> Process::do_exec(NonnullLockRefPtr<OpenFileDescription> main_progr
         m_fds.with_exclusive([&](auto& fds) { fds[main_program_fd_allocation->fd].set(move(main_program_description), FD_CLOEXEC); });
     }
 
-    new_main_thread = nullptr;
-    if (&current_thread->process() == this) {
-        new_main_thread = current_thread;
-    } else {
-        for_each_thread([&](auto& thread) {
-            new_main_thread = &thread;
-            return IterationDecision::Break;
-        });
-    }
-    VERIFY(new_main_thread);
-
     auto credentials = this->credentials();
     auto auxv = generate_auxiliary_vector(load_result.load_base, load_result.entry_eip, credentials->uid(), credentials->euid(), credentials->gid(), credentials->egid(), path->view(), main_program_fd_allocation);
 
@@ -887,6 +892,24 @@ ErrorOr<void> Process::exec(NonnullOwnPtr<KString> path, NonnullOwnPtrVector<KSt
     return do_exec(move(description), move(arguments), move(environment), move(interpreter_description), new_main_thread, prev_flags, *main_program_header);
 }
 
+static ErrorOr<void> copy_user_strings(Syscall::StringListArgument const& list, NonnullOwnPtrVector<KString>& output)
+{
+    if (!list.length)
+        return {};
+    Checked<size_t> size = sizeof(*list.strings);
+    size *= list.length;
+    if (size.has_overflow())
+        return EOVERFLOW;
+    Vector<Syscall::StringArgument, 32> strings;
+    TRY(strings.try_resize(list.length));
+    TRY(copy_from_user(strings.data(), list.strings, size.value()));
+    for (size_t i = 0; i < list.length; ++i) {
+        auto string = TRY(try_copy_kstring_from_user(strings[i]));
+        TRY(output.try_append(move(string)));
+    }
+    return {};
+}
+
 ErrorOr<FlatPtr> Process::sys$execve(Userspace<Syscall::SC_execve_params const*> user_params)
 {
     VERIFY_PROCESS_BIG_LOCK_ACQUIRED(this);
@@ -912,23 +935,6 @@ ErrorOr<FlatPtr> Process::sys$execve(Userspace<Syscall::SC_execve_params const*>
 
         auto path = TRY(get_syscall_path_argument(params.path));
 
-        auto copy_user_strings = [](auto const& list, auto& output) -> ErrorOr<void> {
-            if (!list.length)
-                return {};
-            Checked<size_t> size = sizeof(*list.strings);
-            size *= list.length;
-            if (size.has_overflow())
-                return EOVERFLOW;
-            Vector<Syscall::StringArgument, 32> strings;
-            TRY(strings.try_resize(list.length));
-            TRY(copy_from_user(strings.data(), list.strings, size.value()));
-            for (size_t i = 0; i < list.length; ++i) {
-                auto string = TRY(try_copy_kstring_from_user(strings[i]));
-                TRY(output.try_append(move(string)));
-            }
-            return {};
-        };
-
         NonnullOwnPtrVector<KString> arguments;
         TRY(copy_user_strings(params.arguments, arguments));
 
@@ -967,4 +973,104 @@ ErrorOr<FlatPtr> Process::sys$execve(Userspace<Syscall::SC_execve_params const*>
     return 0;
 }
 
+ErrorOr<FlatPtr> Process::sys$posix_spawn(Userspace<Syscall::SC_posix_spawn_params const*> user_params)
+{
+    VERIFY_PROCESS_BIG_LOCK_ACQUIRED(this);
+    TRY(require_promise(Pledge::proc));
+    TRY(require_promise(Pledge::exec));
+
+    auto params = TRY(copy_typed_from_user(user_params));
+
+    if (params.arguments.length > ARG_MAX || params.environment.length > ARG_MAX)
+        return E2BIG;
+    if (params.arguments.length == 0)
+        return EINVAL;
+    if (params.file_action_count > OpenFileDescriptions::max_open())
+        return E2BIG;
+
+    // NOTE: Everything has to be copied out of our address space before we switch to the child's.
+    auto path = TRY(get_syscall_path_argument(params.path));
+    NonnullOwnPtrVector<KString> arguments;
+    TRY(copy_user_strings(params.arguments, arguments));
+    NonnullOwnPtrVector<KString> environment;
+    TRY(copy_user_strings(params.environment, environment));
+
+    Vector<Syscall::SC_posix_spawn_file_action> file_actions;
+    TRY(file_actions.try_resize(params.file_action_count));
+    TRY(copy_n_from_user(file_actions.data(), params.file_actions, file_actions.size()));
+
+    LockRefPtr<Thread> child_first_thread;
+    ArmedScopeGuard thread_finalizer_guard = [&child_first_thread]() {
+        SpinlockLocker lock(g_scheduler_lock);
+        if (child_first_thread) {
+            child_first_thread->detach();
+            child_first_thread->set_state(Thread::State::Dying);
+        }
+    };
+
+    // Unlike fork(), this doesn't clone our address space at all, since exec() would throw it away right away.
+    auto child = TRY(create_child_process(child_first_thread));
+    dbgln_if(EXEC_DEBUG, "posix_spawn: child={}", child);
+
+    TRY(child->m_fds.with_exclusive([&](auto& fds) -> ErrorOr<void> {
+        for (auto const& action : file_actions) {
+            auto description = TRY(fds.open_file_description(action.fd));
+            switch (action.type) {
+            case Syscall::SC_posix_spawn_file_action::Type::Close:
+                // NOTE: We still hold this description, so closing it in the child wouldn't close the file.
+                fds[action.fd] = {};
+                break;
+            case Syscall::SC_posix_spawn_file_action::Type::Dup2:
+                if (action.fd == action.new_fd)
+                    break;
+                if (action.new_fd < 0 || static_cast<size_t>(action.new_fd) >= OpenFileDescriptions::max_open())
+                    return EBADF;
+                if (!fds.m_fds_metadatas[action.new_fd].is_allocated())
+                    fds.m_fds_metadatas[action.new_fd].allocate();
+                fds[action.new_fd].set(move(description));
+                break;
+            default:
+                return EINVAL;
+            }
+        }
+        return {};
+    }));
+
+    if (params.set_signal_default) {
+        for (size_t signal = 1; signal < NSIG; ++signal) {
+            if (params.signal_default & (1 << (signal - 1)))
+                child->m_signal_action_data[signal] = {};
+        }
+    }
+    if (params.set_signal_mask)
+        child_first_thread->update_signal_mask(params.signal_mask);
+
+    Thread* new_main_thread = nullptr;
+    u32 prev_flags = 0;
+    {
+        // NOTE: exec() enters the new address space on the current thread, so this makes sure we come back to ours.
+        ScopedAddressSpaceSwitcher switcher(*child);
+        TRY(child->exec(move(path), move(arguments), move(environment), new_main_thread, prev_flags));
+    }
+
+    // NOTE: Like in the non-syscall case of execve() above, exec() left us in a critical section.
+    VERIFY_INTERRUPTS_DISABLED();
+    VERIFY(Processor::in_critical());
+    if (prev_flags & 0x200)
+        sti();
+    Processor::leave_critical();
+
+    thread_finalizer_guard.disarm();
+
+    Process::register_new(*child);
+
+    PerformanceManager::add_process_created_event(*child);
+
+    SpinlockLocker lock(g_scheduler_lock);
+    new_main_thread->set_affinity(Thread::current()->affinity());
+    new_main_thread->set_state(Thread::State::Runnable);
+
+    return child->pid().value();
+}
+
 }
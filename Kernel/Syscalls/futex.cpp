@@ -88,6 +88,20 @@ ErrorOr<GlobalFutexKey> Process::get_futex_key(FlatPtr user_address, bool shared
     });
 }
 
+// Private futexes can only be held by threads in the same address space, shared ones by threads that map the same VMObject.
+static bool could_hold_futex(Thread& thread, GlobalFutexKey const& futex_key)
+{
+    return thread.process().address_space().with([&](auto& space) {
+        if (futex_key.raw.offset & futex_key_private_flag)
+            return space.ptr() == futex_key.private_.address_space;
+        for (auto const& region : space->region_tree().regions()) {
+            if (&region.vmobject() == futex_key.shared.vmobject)
+                return true;
+        }
+        return false;
+    });
+}
+
 ErrorOr<FlatPtr> Process::sys$futex(Userspace<Syscall::SC_futex_params const*> user_params)
 {
     VERIFY_PROCESS_BIG_LOCK_ACQUIRED(this);
@@ -97,7 +111,7 @@ ErrorOr<FlatPtr> Process::sys$futex(Userspace<Syscall::SC_futex_params const*> u
     u32 cmd = params.futex_op & FUTEX_CMD_MASK;
 
     bool use_realtime_clock = (params.futex_op & FUTEX_CLOCK_REALTIME) != 0;
-    if (use_realtime_clock && cmd != FUTEX_WAIT && cmd != FUTEX_WAIT_BITSET) {
+    if (use_realtime_clock && cmd != FUTEX_WAIT && cmd != FUTEX_WAIT_BITSET && cmd != FUTEX_LOCK_PI) {
         return ENOSYS;
     }
 
@@ -106,8 +120,8 @@ ErrorOr<FlatPtr> Process::sys$futex(Userspace<Syscall::SC_futex_params const*> u
     switch (cmd) {
     case FUTEX_WAIT:
     case FUTEX_WAIT_BITSET:
-    case FUTEX_REQUEUE:
-    case FUTEX_CMP_REQUEUE: {
+    case FUTEX_LOCK_PI: {
+        // NOTE: The requeueing commands use this as their val2 instead.
         if (params.timeout) {
             auto timeout_time = TRY(copy_time_from_user(params.timeout));
             bool is_absolute = cmd != FUTEX_WAIT;
@@ -214,30 +228,176 @@ ErrorOr<FlatPtr> Process::sys$futex(Userspace<Syscall::SC_futex_params const*> u
         atomic_thread_fence(AK::MemoryOrder::memory_order_acquire);
 
         auto futex_key = TRY(get_futex_key(user_address, shared));
+        auto futex_key2 = TRY(get_futex_key(user_address2, shared));
+        // Moving the waiters onto the same futex wouldn't change anything.
+        if (Traits<GlobalFutexKey>::equals(futex_key, futex_key2))
+            return TRY(do_wake(user_address, params.val, {}));
+
         auto futex_queue = TRY(find_futex_queue(futex_key, false));
         if (!futex_queue)
             return 0;
 
+        // Look up the target before taking the lock of the source queue, the global lock
+        // has to be taken first. Queue an imminent wait so it can't go away in the meantime.
         LockRefPtr<FutexQueue> target_futex_queue;
+        if (params.val2 > 0) {
+            bool did_create;
+            do {
+                did_create = false;
+                target_futex_queue = TRY(find_futex_queue(futex_key2, true, &did_create));
+            } while (!did_create && !target_futex_queue->queue_imminent_wait());
+        }
+
         bool is_empty = false;
         bool is_target_empty = false;
-        auto futex_key2 = TRY(get_futex_key(user_address2, shared));
-        auto woken_or_requeued = TRY(futex_queue->wake_n_requeue(
-            params.val, [&]() -> ErrorOr<FutexQueue*> {
-                // NOTE: futex_queue's lock is being held while this callback is called
-                // The reason we're doing this in a callback is that we don't want to always
-                // create a target queue, only if we actually have anything to move to it!
-                target_futex_queue = TRY(find_futex_queue(futex_key2, true));
-                return target_futex_queue.ptr();
-            },
-            params.val2, is_empty, is_target_empty));
+        auto woken_or_requeued = futex_queue->wake_n_requeue(params.val, target_futex_queue.ptr(), params.val2, is_empty, is_target_empty);
         if (is_empty)
             remove_futex_queue(futex_key);
-        if (is_target_empty && target_futex_queue)
-            remove_futex_queue(futex_key2);
+        if (target_futex_queue) {
+            target_futex_queue->cancel_imminent_wait();
+            if (target_futex_queue->is_empty_and_no_imminent_waits())
+                remove_futex_queue(futex_key2);
+        }
         return woken_or_requeued;
     };
 
+    auto do_lock_pi = [&](bool is_try) -> ErrorOr<FlatPtr> {
+        auto& current_thread = *Thread::current();
+        u32 tid = current_thread.tid().value();
+        auto futex_key = TRY(get_futex_key(user_address, shared));
+        // NOTE: The big process lock serializes us against FUTEX_UNLOCK_PI on private futexes,
+        //       other processes sharing the futex can be caught with the imminent waits.
+        for (;;) {
+            auto user_value = user_atomic_load_relaxed(params.userspace_address);
+            if (!user_value.has_value())
+                return EFAULT;
+            u32 value = user_value.value();
+            u32 owner_tid = value & FUTEX_TID_MASK;
+
+            if (owner_tid == 0) {
+                // Userspace takes an unlocked futex by itself, but it may be left with waiters to wake up.
+                u32 expected = value;
+                auto did_exchange = user_atomic_compare_exchange_relaxed(params.userspace_address, expected, (value & FUTEX_WAITERS) | tid);
+                if (!did_exchange.has_value())
+                    return EFAULT;
+                if (did_exchange.value()) {
+                    atomic_thread_fence(AK::MemoryOrder::memory_order_acquire);
+                    return 0;
+                }
+                continue;
+            }
+            if (owner_tid == tid)
+                return EDEADLK;
+            if (is_try)
+                return EAGAIN;
+
+            // The owner's TID comes from user memory, so don't boost a thread that couldn't have taken the futex.
+            auto owner = Thread::from_tid(owner_tid);
+            if (!owner || !could_hold_futex(*owner, futex_key))
+                return ESRCH;
+
+            // Make the owner come to us when it unlocks the futex.
+            if (!(value & FUTEX_WAITERS)) {
+                u32 expected = value;
+                auto did_exchange = user_atomic_compare_exchange_relaxed(params.userspace_address, expected, value | FUTEX_WAITERS);
+                if (!did_exchange.has_value())
+                    return EFAULT;
+                if (!did_exchange.value())
+                    continue;
+                value |= FUTEX_WAITERS;
+            }
+
+            bool did_create;
+            LockRefPtr<FutexQueue> futex_queue;
+            do {
+                did_create = false;
+                futex_queue = TRY(find_futex_queue(futex_key, true, &did_create));
+            } while (!did_create && !futex_queue->queue_imminent_wait());
+
+            // The owner might have let go of the futex while we were looking for its queue.
+            user_value = user_atomic_load_relaxed(params.userspace_address);
+            if (!user_value.has_value() || user_value.value() != value) {
+                futex_queue->cancel_imminent_wait();
+                if (futex_queue->is_empty_and_no_imminent_waits())
+                    remove_futex_queue(futex_key);
+                if (!user_value.has_value())
+                    return EFAULT;
+                continue;
+            }
+
+            // FIXME: This doesn't boost whoever the owner itself might be waiting for.
+            if (current_thread.effective_priority() > owner->inherited_priority())
+                owner->set_inherited_priority(current_thread.effective_priority());
+
+            auto block_result = futex_queue->wait_on(timeout, 0);
+            if (futex_queue->is_empty_and_no_imminent_waits())
+                remove_futex_queue(futex_key);
+
+            // FUTEX_UNLOCK_PI writes our TID into the futex before waking us up, but it may have
+            // picked us just as we gave up waiting.
+            user_value = user_atomic_load_relaxed(params.userspace_address);
+            if (!user_value.has_value())
+                return EFAULT;
+            if ((user_value.value() & FUTEX_TID_MASK) == tid) {
+                atomic_thread_fence(AK::MemoryOrder::memory_order_acquire);
+                return 0;
+            }
+            if (block_result == Thread::BlockResult::InterruptedByTimeout)
+                return ETIMEDOUT;
+            if (block_result.was_interrupted())
+                return EINTR;
+        }
+    };
+
+    auto do_unlock_pi = [&]() -> ErrorOr<FlatPtr> {
+        auto& current_thread = *Thread::current();
+        u32 tid = current_thread.tid().value();
+        auto futex_key = TRY(get_futex_key(user_address, shared));
+        atomic_thread_fence(AK::MemoryOrder::memory_order_release);
+        for (;;) {
+            auto user_value = user_atomic_load_relaxed(params.userspace_address);
+            if (!user_value.has_value())
+                return EFAULT;
+            u32 value = user_value.value();
+            if ((value & FUTEX_TID_MASK) != tid)
+                return EPERM;
+
+            // Hand the futex over to the most important waiter, instead of letting all of them fight over it.
+            u32 new_value = 0;
+            LockRefPtr<Thread> new_owner;
+            bool has_other_waiters = false;
+            u32 other_waiters_priority = 0;
+            auto futex_queue = TRY(find_futex_queue(futex_key, false));
+            if (futex_queue) {
+                new_owner = futex_queue->highest_priority_waiter(has_other_waiters, other_waiters_priority);
+                if (new_owner)
+                    new_value = new_owner->tid().value();
+                // Even without a thread to hand it to, whoever is about to block has to come to the kernel for the futex.
+                if (has_other_waiters)
+                    new_value |= FUTEX_WAITERS;
+            }
+
+            u32 expected = value;
+            auto did_exchange = user_atomic_compare_exchange_relaxed(params.userspace_address, expected, new_value);
+            if (!did_exchange.has_value())
+                return EFAULT;
+            if (!did_exchange.value())
+                continue;
+
+            // FIXME: Keep the priority of the waiters of other priority-inheriting futexes this thread still holds.
+            current_thread.set_inherited_priority(0);
+            if (!new_owner)
+                return 0;
+
+            new_owner->set_inherited_priority(other_waiters_priority);
+            bool is_empty;
+            futex_queue->wake_thread(*new_owner, is_empty);
+            if (is_empty)
+                remove_futex_queue(futex_key);
+            return 0;
+        }
+    };
+
     switch (cmd) {
     case FUTEX_WAIT:
         return do_wait(0);
@@ -250,8 +410,10 @@ ErrorOr<FlatPtr> Process::sys$futex(Userspace<Syscall::SC_futex_params const*> u
         u32 op_arg = _FUTEX_OP_ARG(params.val3);
         auto op = _FUTEX_OP(params.val3);
         if (op & FUTEX_OP_ARG_SHIFT) {
+            if (op_arg > 31)
+                return EINVAL;
             op_arg = 1 << op_arg;
-            op &= FUTEX_OP_ARG_SHIFT;
+            op &= ~FUTEX_OP_ARG_SHIFT;
         }
         atomic_thread_fence(AK::MemoryOrder::memory_order_release);
         switch (op) {
@@ -313,6 +475,15 @@ ErrorOr<FlatPtr> Process::sys$futex(Userspace<Syscall::SC_futex_params const*> u
     case FUTEX_CMP_REQUEUE:
         return do_requeue(params.val3);
 
+    case FUTEX_LOCK_PI:
+        return do_lock_pi(false);
+
+    case FUTEX_TRYLOCK_PI:
+        return do_lock_pi(true);
+
+    case FUTEX_UNLOCK_PI:
+        return do_unlock_pi();
+
     case FUTEX_WAIT_BITSET:
         VERIFY(params.val3 != FUTEX_BITSET_MATCH_ANY); // we should have turned it into FUTEX_WAIT
         if (params.val3 == 0)
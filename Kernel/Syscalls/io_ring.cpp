@@ -0,0 +1,255 @@
+/*
+ * Copyright (c) 2022, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <AK/NumericLimits.h>
+#include <Kernel/FileSystem/IORing.h>
+#include <Kernel/FileSystem/OpenFileDescription.h>
+#include <Kernel/Net/Socket.h>
+#include <Kernel/Process.h>
+
+namespace Kernel {
+
+using BlockFlags = Thread::FileBlocker::BlockFlags;
+
+static BlockFlags block_flags_for(IORingOperation operation)
+{
+    switch (operation) {
+    case IORingOperation::Accept:
+        // Like the AcceptBlocker, wait for a pending connection rather than for the socket to be readable.
+        return BlockFlags::Accept | BlockFlags::Exception;
+    case IORingOperation::Read:
+    case IORingOperation::Recv:
+        return BlockFlags::Read | BlockFlags::WriteError | BlockFlags::WriteHangUp;
+    default:
+        return BlockFlags::Write | BlockFlags::WriteError | BlockFlags::WriteHangUp;
+    }
+}
+
+static ErrorOr<FlatPtr> accept_connection(Process& process, Socket& accepted_socket, int flags)
+{
+    auto accepted_socket_description = TRY(OpenFileDescription::try_create(accepted_socket));
+    accepted_socket_description->set_readable(true);
+    accepted_socket_description->set_writable(true);
+    if (flags & SOCK_NONBLOCK)
+        accepted_socket_description->set_blocking(false);
+    int fd_flags = (flags & SOCK_CLOEXEC) ? FD_CLOEXEC : 0;
+
+    auto fd = TRY(process.fds().with_exclusive([&](auto& fds) -> ErrorOr<int> {
+        auto fd_allocation = TRY(fds.allocate());
+        fds[fd_allocation.fd].set(move(accepted_socket_description), fd_flags);
+        return fd_allocation.fd;
+    }));
+
+    // NOTE: Moving this state to Completed is what causes connect() to unblock on the client side.
+    accepted_socket.set_setup_state(Socket::SetupState::Completed);
+    return fd;
+}
+
+// Performs the submission like the equivalent syscall on a non-blocking description would,
+// except that it returns an empty Optional instead of failing with EAGAIN.
+static ErrorOr<Optional<FlatPtr>> try_perform(Process& process, IORingSubmission const& submission)
+{
+    if (submission.operation == IORingOperation::Nop)
+        return Optional<FlatPtr> { 0 };
+    if (submission.length > static_cast<u64>(NumericLimits<ssize_t>::max()))
+        return EINVAL;
+
+    auto description = TRY(process.open_file_description(submission.fd));
+    auto user_buffer = reinterpret_cast<u8*>(static_cast<FlatPtr>(submission.buffer));
+
+    switch (submission.operation) {
+    case IORingOperation::Read: {
+        if (!description->is_readable())
+            return EBADF;
+        if (description->is_directory())
+            return EISDIR;
+        if (!description->can_read())
+            return Optional<FlatPtr> {};
+        auto buffer = TRY(UserOrKernelBuffer::for_user_buffer(user_buffer, submission.length));
+        if (submission.offset < 0)
+            return Optional<FlatPtr> { TRY(description->read(buffer, submission.length)) };
+        if (!description->file().is_seekable())
+            return EINVAL;
+        return Optional<FlatPtr> { TRY(description->read(buffer, submission.offset, submission.length)) };
+    }
+    case IORingOperation::Write: {
+        if (!description->is_writable())
+            return EBADF;
+        if (!description->can_write())
+            return Optional<FlatPtr> {};
+        auto buffer = TRY(UserOrKernelBuffer::for_user_buffer(user_buffer, submission.length));
+        ErrorOr<size_t> nwritten_or_error = 0;
+        if (submission.offset < 0) {
+            if (description->should_append() && description->file().is_seekable())
+                TRY(description->seek(0, SEEK_END));
+            nwritten_or_error = description->write(buffer, submission.length);
+        } else {
+            if (!description->file().is_seekable())
+                return EINVAL;
+            nwritten_or_error = description->write(submission.offset, buffer, submission.length);
+        }
+        if (nwritten_or_error.is_error()) {
+            if (nwritten_or_error.error().code() == EAGAIN)
+                return Optional<FlatPtr> {};
+            if (nwritten_or_error.error().code() == EPIPE)
+                Thread::current()->send_signal(SIGPIPE, &process);
+            return nwritten_or_error.release_error();
+        }
+        return Optional<FlatPtr> { nwritten_or_error.value() };
+    }
+    case IORingOperation::Accept: {
+        TRY(process.require_promise(Pledge::accept));
+        if (!description->is_socket())
+            return ENOTSOCK;
+        // Nothing is ever going to be accepted on a socket that isn't listening, so don't wait for it.
+        if (description->socket()->role(*description) != Socket::Role::Listener)
+            return EINVAL;
+        auto accepted_socket = description->socket()->accept();
+        if (!accepted_socket)
+            return Optional<FlatPtr> {};
+        return Optional<FlatPtr> { TRY(accept_connection(process, *accepted_socket, submission.flags)) };
+    }
+    case IORingOperation::Recv: {
+        if (!description->is_socket())
+            return ENOTSOCK;
+        auto& socket = *description->socket();
+        if (socket.is_shut_down_for_reading())
+            return Optional<FlatPtr> { 0 };
+        if (!description->can_read())
+            return Optional<FlatPtr> {};
+        auto buffer = TRY(UserOrKernelBuffer::for_user_buffer(user_buffer, submission.length));
+        Time timestamp {};
+        auto nread_or_error = socket.recvfrom(*description, buffer, submission.length, submission.flags, {}, {}, timestamp, false);
+        if (nread_or_error.is_error() && nread_or_error.error().code() == EAGAIN)
+            return Optional<FlatPtr> {};
+        return Optional<FlatPtr> { TRY(nread_or_error) };
+    }
+    case IORingOperation::Send: {
+        if (!description->is_socket())
+            return ENOTSOCK;
+        auto& socket = *description->socket();
+        if (socket.is_shut_down_for_writing()) {
+            if ((submission.flags & MSG_NOSIGNAL) == 0)
+                Thread::current()->send_signal(SIGPIPE, &process);
+            return EPIPE;
+        }
+        if (!description->can_write())
+            return Optional<FlatPtr> {};
+        auto buffer = TRY(UserOrKernelBuffer::for_user_buffer(user_buffer, submission.length));
+        auto nsent_or_error = socket.sendto(*description, buffer, submission.length, submission.flags, {}, 0);
+        if (nsent_or_error.is_error()) {
+            if (nsent_or_error.error().code() == EAGAIN)
+                return Optional<FlatPtr> {};
+            if ((submission.flags & MSG_NOSIGNAL) == 0 && nsent_or_error.error().code() == EPIPE)
+                Thread::current()->send_signal(SIGPIPE, &process);
+            return nsent_or_error.release_error();
+        }
+        return Optional<FlatPtr> { nsent_or_error.value() };
+    }
+    default:
+        return EINVAL;
+    }
+}
+
+ErrorOr<FlatPtr> Process::sys$io_ring_create(u32 entries, int options)
+{
+    VERIFY_PROCESS_BIG_LOCK_ACQUIRED(this);
+    TRY(require_promise(Pledge::stdio));
+
+    if ((options & O_CLOEXEC) != options)
+        return EINVAL;
+
+    auto io_ring = TRY(IORing::try_create(entries));
+    auto description = TRY(OpenFileDescription::try_create(move(io_ring)));
+    description->set_readable(true);
+
+    u32 fd_flags = (options & O_CLOEXEC) ? FD_CLOEXEC : 0;
+    return m_fds.with_exclusive([&](auto& fds) -> ErrorOr<FlatPtr> {
+        auto fd_allocation = TRY(fds.allocate());
+        fds[fd_allocation.fd].set(move(description), fd_flags);
+        return fd_allocation.fd;
+    });
+}
+
+ErrorOr<FlatPtr> Process::sys$io_ring_enter(int fd, u32 min_completions)
+{
+    VERIFY_PROCESS_BIG_LOCK_ACQUIRED(this);
+    TRY(require_promise(Pledge::stdio));
+
+    auto ring_description = TRY(open_file_description(fd));
+    if (!ring_description->is_io_ring())
+        return EINVAL;
+    auto& ring = *ring_description->io_ring();
+
+    MutexLocker locker(ring.lock());
+    auto& pending_submissions = ring.pending_submissions();
+    size_t completion_count = 0;
+
+    // Returns false if the submission has to wait for its file.
+    auto complete = [&](IORingSubmission const& submission) {
+        auto result = try_perform(*this, submission);
+        if (result.is_error()) {
+            ring.post_completion(submission.user_data, result.release_error());
+        } else {
+            if (!result.value().has_value())
+                return false;
+            ring.post_completion(submission.user_data, result.value().value());
+        }
+        ++completion_count;
+        return true;
+    };
+
+    for (;;) {
+        // The files of the submissions that had to wait before may have become ready by now.
+        for (size_t i = 0; i < pending_submissions.size();) {
+            if (complete(pending_submissions[i]))
+                pending_submissions.remove(i);
+            else
+                ++i;
+        }
+
+        for (auto submission = ring.take_submission(); submission.has_value(); submission = ring.take_submission()) {
+            if (complete(*submission))
+                continue;
+            if (auto result = pending_submissions.try_append(*submission); result.is_error()) {
+                ring.post_completion(submission->user_data, result.release_error());
+                ++completion_count;
+            }
+        }
+
+        if (completion_count >= min_completions || pending_submissions.is_empty())
+            break;
+
+        // Wait for any of the waiting submissions to become ready, like poll() would.
+        Thread::SelectBlocker::FDVector fds_info;
+        TRY(fds_info.try_ensure_capacity(pending_submissions.size()));
+        bool has_closed_description = false;
+        for (auto& submission : pending_submissions) {
+            auto description_or_error = open_file_description(submission.fd);
+            if (description_or_error.is_error()) {
+                has_closed_description = true;
+                break;
+            }
+            fds_info.unchecked_append({ description_or_error.release_value(), block_flags_for(submission.operation) });
+        }
+        // The next round will complete that submission with EBADF.
+        if (has_closed_description)
+            continue;
+
+        locker.unlock();
+        auto block_result = Thread::current()->block<Thread::SelectBlocker>({}, fds_info);
+        locker.lock();
+        if (block_result.was_interrupted()) {
+            if (completion_count == 0)
+                return EINTR;
+            break;
+        }
+    }
+
+    return completion_count;
+}
+
+}
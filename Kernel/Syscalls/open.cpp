@@ -86,6 +86,7 @@ ErrorOr<FlatPtr> Process::sys$close(int fd)
     auto description = TRY(open_file_description(fd));
     auto result = description->close();
     m_fds.with_exclusive([fd](auto& fds) { fds[fd] = {}; });
+    description->did_close_fd(pid(), fd);
     if (result.is_error())
         return result.release_error();
     return 0;
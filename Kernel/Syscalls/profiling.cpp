@@ -4,6 +4,7 @@
  * SPDX-License-Identifier: BSD-2-Clause
  */
 
+#include <Kernel/Arch/PerformanceCounters.h>
 #include <Kernel/Coredump.h>
 #include <Kernel/PerformanceManager.h>
 #include <Kernel/Process.h>
@@ -49,8 +50,11 @@ ErrorOr<FlatPtr> Process::profiling_enable(pid_t pid, u64 event_mask)
         }
 
         SpinlockLocker lock(g_profiling_lock);
-        if (!TimeManagement::the().enable_profile_timer())
+        TRY(PerformanceCounters::enable(event_mask));
+        if (!TimeManagement::the().enable_profile_timer()) {
+            PerformanceCounters::disable();
             return ENOTSUP;
+        }
         g_profiling_all_threads = true;
         PerformanceManager::add_process_created_event(*Scheduler::colonel());
         TRY(Process::for_each_in_same_jail([](auto& process) -> ErrorOr<void> {
@@ -71,15 +75,18 @@ ErrorOr<FlatPtr> Process::profiling_enable(pid_t pid, u64 event_mask)
     if (!credentials->is_superuser() && profile_process_credentials->uid() != credentials->euid())
         return EPERM;
     SpinlockLocker lock(g_profiling_lock);
+    TRY(PerformanceCounters::enable(event_mask));
     g_profiling_event_mask = PERF_EVENT_PROCESS_CREATE | PERF_EVENT_THREAD_CREATE | PERF_EVENT_MMAP;
     process->set_profiling(true);
     if (!process->create_perf_events_buffer_if_needed()) {
         process->set_profiling(false);
+        PerformanceCounters::disable();
         return ENOMEM;
     }
     g_profiling_event_mask = event_mask;
     if (!TimeManagement::the().enable_profile_timer()) {
         process->set_profiling(false);
+        PerformanceCounters::disable();
         return ENOTSUP;
     }
     return 0;
@@ -97,6 +104,7 @@ ErrorOr<FlatPtr> Process::sys$profiling_disable(pid_t pid)
         ScopedCritical critical;
         if (!TimeManagement::the().disable_profile_timer())
             return ENOTSUP;
+        PerformanceCounters::disable();
         g_profiling_all_threads = false;
         return 0;
     }
@@ -114,6 +122,7 @@ ErrorOr<FlatPtr> Process::sys$profiling_disable(pid_t pid)
     // FIXME: If we enabled the profile timer and it's not supported, how do we disable it now?
     if (!TimeManagement::the().disable_profile_timer())
         return ENOTSUP;
+    PerformanceCounters::disable();
     process->set_profiling(false);
     return 0;
 }
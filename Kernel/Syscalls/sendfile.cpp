@@ -0,0 +1,213 @@
+/*
+ * Copyright (c) 2022, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <AK/NumericLimits.h>
+#include <Kernel/FileSystem/Inode.h>
+#include <Kernel/FileSystem/OpenFileDescription.h>
+#include <Kernel/KBuffer.h>
+#include <Kernel/Process.h>
+
+namespace Kernel {
+
+// Data that isn't in a page cache (i.e. data coming out of a pipe) is moved through a
+// kernel buffer of this size instead.
+static constexpr size_t splice_buffer_size = 64 * KiB;
+
+static bool is_regular_file(OpenFileDescription const& description)
+{
+    return !description.is_fifo() && description.inode() && description.inode()->metadata().is_regular_file();
+}
+
+// Data that was taken out of a pipe has nowhere else to go, so this blocks until
+// all of it is written, even if the description is non-blocking.
+static ErrorOr<void> write_all(OpenFileDescription& description, UserOrKernelBuffer const& data, size_t data_size)
+{
+    size_t total_nwritten = 0;
+    while (total_nwritten < data_size) {
+        if (!description.can_write()) {
+            auto unblock_flags = Thread::FileBlocker::BlockFlags::None;
+            if (Thread::current()->block<Thread::WriteBlocker>({}, description, unblock_flags).was_interrupted())
+                return EINTR;
+            continue;
+        }
+        auto nwritten_or_error = description.write(data.offset(total_nwritten), data_size - total_nwritten);
+        if (nwritten_or_error.is_error()) {
+            if (nwritten_or_error.error().code() == EAGAIN)
+                continue;
+            if (nwritten_or_error.error().code() == EPIPE)
+                Thread::current()->send_signal(SIGPIPE, &Process::current());
+            return nwritten_or_error.release_error();
+        }
+        total_nwritten += nwritten_or_error.value();
+    }
+    return {};
+}
+
+ErrorOr<size_t> Process::do_splice(OpenFileDescription& source, Optional<u64>& source_offset, OpenFileDescription& destination, Optional<u64>& destination_offset, size_t count, bool may_block_on_source)
+{
+    bool source_is_file = is_regular_file(source);
+    OwnPtr<KBuffer> bounce_buffer;
+
+    // Moves one run of data and returns how much of it was written, or 0 when there is nothing left to read.
+    auto move_run = [&](size_t max_count) -> ErrorOr<size_t> {
+        // Regular files are sent straight from their page cache, if they have one.
+        Optional<InodePageCache::PinnedBytes> pinned_bytes;
+        if (source_is_file)
+            pinned_bytes = TRY(source.inode()->pin_cached_bytes(*source_offset, max_count, &source));
+
+        u8* data = nullptr;
+        size_t nread = 0;
+        if (pinned_bytes.has_value()) {
+            data = const_cast<u8*>(pinned_bytes->bytes().data());
+            nread = pinned_bytes->bytes().size();
+        } else {
+            if (!bounce_buffer)
+                bounce_buffer = TRY(KBuffer::try_create_with_size("splice"sv, splice_buffer_size));
+            auto buffer = UserOrKernelBuffer::for_kernel_buffer(bounce_buffer->data());
+            auto read_size = min(max_count, splice_buffer_size);
+            if (source_is_file) {
+                nread = TRY(source.read(buffer, *source_offset, read_size));
+            } else {
+                if (!source.can_read()) {
+                    if (!may_block_on_source)
+                        return EAGAIN;
+                    auto unblock_flags = Thread::FileBlocker::BlockFlags::None;
+                    if (Thread::current()->block<Thread::ReadBlocker>({}, source, unblock_flags).was_interrupted())
+                        return EINTR;
+                }
+                nread = TRY(source.read(buffer, read_size));
+            }
+            data = bounce_buffer->data();
+        }
+        if (nread == 0)
+            return 0;
+
+        auto data_buffer = UserOrKernelBuffer::for_kernel_buffer(data);
+        size_t nwritten = 0;
+        if (destination_offset.has_value()) {
+            nwritten = TRY(destination.write(*destination_offset, data_buffer, nread));
+        } else if (!source_is_file) {
+            TRY(write_all(destination, data_buffer, nread));
+            nwritten = nread;
+        } else {
+            nwritten = TRY(do_write(destination, data_buffer, nread));
+        }
+
+        if (source_is_file)
+            *source_offset += nwritten;
+        if (destination_offset.has_value())
+            *destination_offset += nwritten;
+        return nwritten;
+    };
+
+    size_t total_nwritten = 0;
+    while (total_nwritten < count) {
+        auto nwritten_or_error = move_run(count - total_nwritten);
+        if (nwritten_or_error.is_error()) {
+            if (total_nwritten > 0)
+                break;
+            return nwritten_or_error.release_error();
+        }
+        if (nwritten_or_error.value() == 0)
+            break;
+        total_nwritten += nwritten_or_error.value();
+        // Once we've moved something, don't wait for more data from a pipe.
+        may_block_on_source = false;
+    }
+    return total_nwritten;
+}
+
+static ErrorOr<Optional<u64>> copy_offset_from_user(off_t* user_offset)
+{
+    if (!user_offset)
+        return Optional<u64> {};
+    off_t offset;
+    TRY(copy_from_user(&offset, user_offset));
+    if (offset < 0)
+        return EINVAL;
+    return Optional<u64> { static_cast<u64>(offset) };
+}
+
+ErrorOr<FlatPtr> Process::sys$sendfile(Userspace<Syscall::SC_sendfile_params const*> user_params)
+{
+    VERIFY_PROCESS_BIG_LOCK_ACQUIRED(this);
+    TRY(require_promise(Pledge::stdio));
+    auto params = TRY(copy_typed_from_user(user_params));
+    if (params.count > NumericLimits<ssize_t>::max())
+        return EINVAL;
+
+    auto in_description = TRY(open_file_description(params.in_fd));
+    auto out_description = TRY(open_file_description(params.out_fd));
+    if (!in_description->is_readable() || !out_description->is_writable())
+        return EBADF;
+    if (!is_regular_file(*in_description))
+        return EINVAL;
+    if (params.count == 0)
+        return 0;
+
+    auto in_offset = TRY(copy_offset_from_user(params.offset));
+    bool uses_file_offset = !in_offset.has_value();
+    if (uses_file_offset)
+        in_offset = in_description->offset();
+
+    Optional<u64> out_offset;
+    auto nwritten = TRY(do_splice(*in_description, in_offset, *out_description, out_offset, params.count, false));
+
+    if (uses_file_offset) {
+        TRY(in_description->seek(*in_offset, SEEK_SET));
+    } else {
+        off_t new_offset = *in_offset;
+        TRY(copy_to_user(params.offset, &new_offset));
+    }
+    return nwritten;
+}
+
+ErrorOr<FlatPtr> Process::sys$splice(Userspace<Syscall::SC_splice_params const*> user_params)
+{
+    VERIFY_PROCESS_BIG_LOCK_ACQUIRED(this);
+    TRY(require_promise(Pledge::stdio));
+    auto params = TRY(copy_typed_from_user(user_params));
+    if (params.length > NumericLimits<ssize_t>::max())
+        return EINVAL;
+    if (params.flags & ~(SPLICE_F_MOVE | SPLICE_F_NONBLOCK | SPLICE_F_MORE))
+        return EINVAL;
+
+    auto in_description = TRY(open_file_description(params.in_fd));
+    auto out_description = TRY(open_file_description(params.out_fd));
+    if (!in_description->is_readable() || !out_description->is_writable())
+        return EBADF;
+    if (!in_description->is_fifo() && !out_description->is_fifo())
+        return EINVAL;
+    if ((in_description->is_fifo() && params.in_offset) || (out_description->is_fifo() && params.out_offset))
+        return ESPIPE;
+    if (params.length == 0)
+        return 0;
+
+    // NOTE: Offsets only make sense for regular files, which are read and written at their
+    //       current offset if none is given.
+    auto in_offset = TRY(copy_offset_from_user(params.in_offset));
+    bool uses_in_file_offset = !in_offset.has_value() && is_regular_file(*in_description);
+    if (uses_in_file_offset)
+        in_offset = in_description->offset();
+    auto out_offset = TRY(copy_offset_from_user(params.out_offset));
+
+    bool may_block = !(params.flags & SPLICE_F_NONBLOCK) && in_description->is_blocking();
+    auto nwritten = TRY(do_splice(*in_description, in_offset, *out_description, out_offset, params.length, may_block));
+
+    if (uses_in_file_offset)
+        TRY(in_description->seek(*in_offset, SEEK_SET));
+    if (params.in_offset) {
+        off_t new_offset = *in_offset;
+        TRY(copy_to_user(params.in_offset, &new_offset));
+    }
+    if (params.out_offset) {
+        off_t new_offset = *out_offset;
+        TRY(copy_to_user(params.out_offset, &new_offset));
+    }
+    return nwritten;
+}
+
+}
@@ -1266,6 +1266,15 @@ ErrorOr<NonnullLockRefPtr<Thread>> Thread::try_clone(Process& process)
     return clone;
 }
 
+void Thread::set_inherited_priority(u32 priority)
+{
+    SpinlockLocker scheduler_lock(g_scheduler_lock);
+    m_inherited_priority = priority;
+    // A runnable thread waits in the ready queue of its old priority, move it over.
+    if (m_state == Thread::State::Runnable && Scheduler::dequeue_runnable_thread(*this))
+        Scheduler::enqueue_runnable_thread(*this);
+}
+
 void Thread::set_state(State new_state, u8 stop_signal)
 {
     State previous_state;
@@ -155,6 +155,11 @@ public:
     void set_priority(u32 p) { m_priority = p; }
     u32 priority() const { return m_priority; }
 
+    // A thread that holds a priority-inheriting futex runs with the priority of its most important waiter.
+    void set_inherited_priority(u32);
+    u32 inherited_priority() const { return m_inherited_priority; }
+    u32 effective_priority() const { return max(m_priority, m_inherited_priority); }
+
     void detach()
     {
         SpinlockLocker lock(m_lock);
@@ -473,7 +478,7 @@ public:
             Vector<BlockerInfo, 4> taken_blockers;
             taken_blockers.ensure_capacity(move_count);
             for (size_t i = 0; i < move_count; i++)
-                taken_blockers.append(m_blockers.take(i));
+                taken_blockers.unchecked_append(m_blockers[i]);
             m_blockers.remove(0, move_count);
             return taken_blockers;
         }
@@ -487,8 +492,8 @@ public:
                 return;
             }
             m_blockers.ensure_capacity(m_blockers.size() + blockers_to_append.size());
-            for (size_t i = 0; i < blockers_to_append.size(); i++)
-                m_blockers.append(blockers_to_append.take(i));
+            for (auto& info : blockers_to_append)
+                m_blockers.unchecked_append(info);
             blockers_to_append.clear();
         }
 
@@ -1122,6 +1127,15 @@ public:
         return m_handling_page_fault;
     }
     void set_handling_page_fault(bool b) { m_handling_page_fault = b; }
+
+    // The region that the last page fault of this thread was in, see MemoryManager::find_user_region_for_page_fault().
+    // It is only valid for the region tree it was found in, and is cleared whenever the thread changes address spaces.
+    struct PageFaultRegionCache {
+        Memory::RegionTree const* region_tree { nullptr };
+        Memory::Region* region { nullptr };
+        u32 region_tree_sequence { 0 };
+    };
+    PageFaultRegionCache& page_fault_region_cache() { return m_page_fault_region_cache; }
     void set_idle_thread() { m_is_idle_thread = true; }
     bool is_idle_thread() const { return m_is_idle_thread; }
 
@@ -1172,6 +1186,7 @@ private:
 
     IntrusiveListNode<Thread> m_process_thread_list_node;
     int m_runnable_priority { -1 };
+    u32 m_runnable_cpu { 0 };
 
     friend class WaitQueue;
 
@@ -1286,6 +1301,7 @@ private:
     Atomic<bool, AK::MemoryOrder::memory_order_relaxed> m_is_active { false };
     bool m_is_joinable { true };
     bool m_handling_page_fault { false };
+    PageFaultRegionCache m_page_fault_region_cache;
     PreviousMode m_previous_mode { PreviousMode::KernelMode }; // We always start out in kernel mode
 
     unsigned m_syscall_count { 0 };
@@ -1306,6 +1322,7 @@ private:
     State m_state { Thread::State::Invalid };
     NonnullOwnPtr<KString> m_name;
     u32 m_priority { THREAD_PRIORITY_NORMAL };
+    u32 m_inherited_priority { 0 };
 
     State m_stop_state { Thread::State::Invalid };
 
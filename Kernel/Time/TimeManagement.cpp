@@ -10,6 +10,7 @@
 #include <AK/Time.h>
 
 #if ARCH(I386) || ARCH(X86_64)
+#    include <Kernel/Arch/x86/ASM_wrapper.h>
 #    include <Kernel/Arch/x86/Time/APICTimer.h>
 #    include <Kernel/Arch/x86/Time/HPET.h>
 #    include <Kernel/Arch/x86/Time/HPETComparator.h>
@@ -24,7 +25,9 @@
 #endif
 
 #include <Kernel/Arch/CurrentTime.h>
+#include <Kernel/Arch/PerformanceCounters.h>
 #include <Kernel/CommandLine.h>
+#include <Kernel/Devices/SamplingDevice.h>
 #include <Kernel/Firmware/ACPI/Parser.h>
 #include <Kernel/InterruptDisabler.h>
 #include <Kernel/PerformanceManager.h>
@@ -82,11 +85,12 @@ Time TimeManagement::current_time(clockid_t clock_id) const
 {
     switch (clock_id) {
     case CLOCK_MONOTONIC:
-        return monotonic_time(TimePrecision::Precise);
+        // Userspace may already have read a time extrapolated past monotonic_time() from the time page.
+        return max(monotonic_time(TimePrecision::Precise), Time::from_nanoseconds(m_time_page_monotonic_time_ns.load(AK::MemoryOrder::memory_order_relaxed)));
     case CLOCK_MONOTONIC_COARSE:
         return monotonic_time(TimePrecision::Coarse);
     case CLOCK_MONOTONIC_RAW:
-        return monotonic_time_raw();
+        return max(monotonic_time_raw(), Time::from_nanoseconds(m_time_page_monotonic_time_ns.load(AK::MemoryOrder::memory_order_relaxed)));
     case CLOCK_REALTIME:
         return epoch_time(TimePrecision::Precise);
     case CLOCK_REALTIME_COARSE:
@@ -384,9 +388,44 @@ UNMAP_AFTER_INIT bool TimeManagement::probe_and_set_x86_non_legacy_hardware_time
         m_profile_timer->try_to_set_frequency(m_profile_timer->calculate_nearest_possible_frequency(1));
     }
 
+    calibrate_tsc();
+
     return true;
 }
 
+UNMAP_AFTER_INIT void TimeManagement::calibrate_tsc()
+{
+    // Userspace can only extrapolate the time from the TSC if it ticks at the same rate
+    // regardless of the frequency and the power state of the processor.
+    auto& processor = Processor::current();
+    if (!processor.has_feature(CPUFeature::TSC) || !processor.has_feature(CPUFeature::CONSTANT_TSC) || !processor.has_feature(CPUFeature::NONSTOP_TSC))
+        return;
+
+    auto& hpet = HPET::the();
+    auto calibration_ticks = hpet.ns_to_raw_counter_ticks(10'000'000);
+    auto start_counter = hpet.read_main_counter();
+    auto start_tsc = read_tsc();
+    u64 end_counter;
+    do {
+        end_counter = hpet.read_main_counter();
+    } while (end_counter - start_counter < calibration_ticks);
+    auto end_tsc = read_tsc();
+
+    u64 elapsed_ns = hpet.raw_counter_ticks_to_ns(end_counter - start_counter);
+    u64 tsc_frequency = (end_tsc - start_tsc) * 1'000'000'000ull / elapsed_ns;
+    if (tsc_frequency < 1'000'000) {
+        dmesgln("Time: TSC frequency too slow!");
+        return;
+    }
+
+    // Rather err on the slow side, so that the extrapolated time doesn't run ahead of the HPET.
+    m_tsc_to_ns_multiplier = (1'000'000'000ull << time_page_tsc_shift) / tsc_frequency;
+    m_tsc_to_ns_multiplier -= m_tsc_to_ns_multiplier >> 12;
+    // Keeps the multiplication in userspace from overflowing, and is way longer than a timer tick.
+    m_tsc_delta_limit = tsc_frequency / 10;
+    dmesgln("Time: TSC frequency: {}.{} MHz", tsc_frequency / 1000000, tsc_frequency % 1000000);
+}
+
 UNMAP_AFTER_INIT bool TimeManagement::probe_and_set_x86_legacy_hardware_timers()
 {
     if (ACPI::is_enabled()) {
@@ -509,6 +548,8 @@ void TimeManagement::system_timer_tick(RegisterState const& regs)
         // Don't expire timers while handling IRQs
         TimerQueue::the().fire();
     }
+    PerformanceCounters::timer_tick();
+    SamplingDevice::timer_tick(regs);
     Scheduler::timer_tick(regs);
 }
 
@@ -535,7 +576,31 @@ void TimeManagement::update_time_page()
     auto& page = time_page();
     u32 update_iteration = AK::atomic_fetch_add(&page.update2, 1u, AK::MemoryOrder::memory_order_acquire);
     page.clocks[CLOCK_REALTIME_COARSE] = m_epoch_time;
+    page.clocks[CLOCK_REALTIME] = m_epoch_time;
     page.clocks[CLOCK_MONOTONIC_COARSE] = monotonic_time(TimePrecision::Coarse).to_timespec();
+#if ARCH(I386) || ARCH(X86_64)
+    if (m_tsc_to_ns_multiplier != 0) {
+        auto tsc = read_tsc();
+        auto now = monotonic_time(TimePrecision::Precise);
+        if (page.tsc_to_ns_multiplier != 0) {
+            // Userspace must never see the clock go backwards, so if the TSC ran faster than
+            // it was calibrated to, continue from where it got to and slow it down a bit.
+            auto tsc_delta = min(tsc - page.tsc_base, page.tsc_delta_limit);
+            auto extrapolated = Time::from_timespec(page.clocks[CLOCK_MONOTONIC]) + Time::from_nanoseconds((tsc_delta * page.tsc_to_ns_multiplier) >> time_page_tsc_shift);
+            if (extrapolated > now) {
+                now = extrapolated;
+                m_tsc_to_ns_multiplier -= m_tsc_to_ns_multiplier >> 12;
+            }
+        }
+        // current_time() clamps to this, so sys$clock_gettime() agrees with the time page.
+        m_time_page_monotonic_time_ns.store(now.to_nanoseconds(), AK::MemoryOrder::memory_order_relaxed);
+        page.clocks[CLOCK_MONOTONIC] = now.to_timespec();
+        page.clocks[CLOCK_MONOTONIC_RAW] = page.clocks[CLOCK_MONOTONIC];
+        page.tsc_base = tsc;
+        page.tsc_delta_limit = m_tsc_delta_limit;
+        page.tsc_to_ns_multiplier = m_tsc_to_ns_multiplier;
+    }
+#endif
     AK::atomic_store(&page.update1, update_iteration + 1u, AK::MemoryOrder::memory_order_release);
 }
 
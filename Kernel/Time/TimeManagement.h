@@ -84,6 +84,7 @@ private:
 #if ARCH(I386) || ARCH(X86_64)
     bool probe_and_set_x86_legacy_hardware_timers();
     bool probe_and_set_x86_non_legacy_hardware_timers();
+    void calibrate_tsc();
     void increment_time_since_boot_hpet();
     static void update_time(RegisterState const&);
 #elif ARCH(AARCH64)
@@ -120,6 +121,11 @@ private:
     LockRefPtr<HardwareTimerBase> m_profile_timer;
 
     NonnullOwnPtr<Memory::Region> m_time_page_region;
+    // Only set if the TSC ticks at a constant rate, see calibrate_tsc().
+    u64 m_tsc_to_ns_multiplier { 0 };
+    u64 m_tsc_delta_limit { 0 };
+    // The precise monotonic time last published in the time page, which may be ahead of monotonic_time().
+    Atomic<i64> m_time_page_monotonic_time_ns { 0 };
 };
 
 }
@@ -0,0 +1,125 @@
+/*
+ * Copyright (c) 2022, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <AK/Vector.h>
+#include <LibCore/ElapsedTimer.h>
+#include <LibTest/TestCase.h>
+#include <pthread.h>
+#include <sched.h>
+#include <unistd.h>
+
+static constexpr int round_trip_count = 20000;
+
+struct PingPongPair {
+    int ping[2] { -1, -1 };
+    int pong[2] { -1, -1 };
+    pthread_t ping_thread {};
+    pthread_t pong_thread {};
+};
+
+static void* pong_thread(void* arg)
+{
+    auto& pair = *static_cast<PingPongPair*>(arg);
+    char byte = 0;
+    for (int i = 0; i < round_trip_count; ++i) {
+        if (read(pair.ping[0], &byte, 1) != 1)
+            return reinterpret_cast<void*>(1);
+        if (write(pair.pong[1], &byte, 1) != 1)
+            return reinterpret_cast<void*>(1);
+    }
+    return nullptr;
+}
+
+static void* ping_thread(void* arg)
+{
+    auto& pair = *static_cast<PingPongPair*>(arg);
+    char byte = 'x';
+    for (int i = 0; i < round_trip_count; ++i) {
+        if (write(pair.ping[1], &byte, 1) != 1)
+            return reinterpret_cast<void*>(1);
+        if (read(pair.pong[0], &byte, 1) != 1)
+            return reinterpret_cast<void*>(1);
+    }
+    return nullptr;
+}
+
+// Every round trip blocks both threads once, so it costs (at least) two context switches.
+static void run_ping_pong(size_t pair_count)
+{
+    Vector<PingPongPair> pairs;
+    pairs.resize(pair_count);
+    for (auto& pair : pairs) {
+        EXPECT_EQ(pipe(pair.ping), 0);
+        EXPECT_EQ(pipe(pair.pong), 0);
+    }
+
+    auto timer = Core::ElapsedTimer::start_new();
+    for (auto& pair : pairs) {
+        EXPECT_EQ(pthread_create(&pair.pong_thread, nullptr, pong_thread, &pair), 0);
+        EXPECT_EQ(pthread_create(&pair.ping_thread, nullptr, ping_thread, &pair), 0);
+    }
+    for (auto& pair : pairs) {
+        void* ping_result = nullptr;
+        void* pong_result = nullptr;
+        EXPECT_EQ(pthread_join(pair.ping_thread, &ping_result), 0);
+        EXPECT_EQ(pthread_join(pair.pong_thread, &pong_result), 0);
+        EXPECT_EQ(ping_result, nullptr);
+        EXPECT_EQ(pong_result, nullptr);
+    }
+    auto elapsed_ms = max(timer.elapsed(), 1);
+
+    for (auto& pair : pairs) {
+        close(pair.ping[0]);
+        close(pair.ping[1]);
+        close(pair.pong[0]);
+        close(pair.pong[1]);
+    }
+
+    u64 switch_count = 2ull * round_trip_count * pair_count;
+    outln("{} ping-pong pair(s): {} context switches in {} ms ({} switches/s)",
+        pair_count, switch_count, elapsed_ms, switch_count * 1000 / elapsed_ms);
+}
+
+BENCHMARK_CASE(context_switch_single_pair)
+{
+    run_ping_pong(1);
+}
+
+BENCHMARK_CASE(context_switch_pair_per_processor)
+{
+    auto processor_count = sysconf(_SC_NPROCESSORS_ONLN);
+    run_ping_pong(max(processor_count, 1l));
+}
+
+BENCHMARK_CASE(context_switch_oversubscribed)
+{
+    auto processor_count = sysconf(_SC_NPROCESSORS_ONLN);
+    run_ping_pong(4 * max(processor_count, 1l));
+}
+
+static void* yield_thread(void*)
+{
+    for (int i = 0; i < round_trip_count; ++i)
+        sched_yield();
+    return nullptr;
+}
+
+BENCHMARK_CASE(sched_yield_storm)
+{
+    auto thread_count = 2 * max(sysconf(_SC_NPROCESSORS_ONLN), 1l);
+    Vector<pthread_t> threads;
+    threads.resize(thread_count);
+
+    auto timer = Core::ElapsedTimer::start_new();
+    for (auto& thread : threads)
+        EXPECT_EQ(pthread_create(&thread, nullptr, yield_thread, nullptr), 0);
+    for (auto& thread : threads)
+        EXPECT_EQ(pthread_join(thread, nullptr), 0);
+    auto elapsed_ms = max(timer.elapsed(), 1);
+
+    u64 yield_count = static_cast<u64>(round_trip_count) * thread_count;
+    outln("{} threads: {} yields in {} ms ({} yields/s)", thread_count, yield_count, elapsed_ms, yield_count * 1000 / elapsed_ms);
+}
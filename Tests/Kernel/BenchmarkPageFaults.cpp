@@ -0,0 +1,129 @@
+/*
+ * Copyright (c) 2022, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <AK/Atomic.h>
+#include <AK/Vector.h>
+#include <LibCore/ElapsedTimer.h>
+#include <LibTest/TestCase.h>
+#include <pthread.h>
+#include <sys/mman.h>
+#include <unistd.h>
+
+static constexpr size_t pages_per_thread = 4096;
+
+struct FaultingThread {
+    pthread_t thread {};
+    u8* pages { nullptr };
+    size_t page_count { 0 };
+    bool touched_every_page { false };
+};
+
+// Every page is touched for the first time, so every write is a (zero) page fault.
+static void* touch_pages(void* arg)
+{
+    auto& faulting_thread = *static_cast<FaultingThread*>(arg);
+    for (size_t i = 0; i < faulting_thread.page_count; ++i)
+        faulting_thread.pages[i * PAGE_SIZE] = static_cast<u8>(i);
+
+    faulting_thread.touched_every_page = true;
+    for (size_t i = 0; i < faulting_thread.page_count; ++i) {
+        if (faulting_thread.pages[i * PAGE_SIZE] != static_cast<u8>(i))
+            faulting_thread.touched_every_page = false;
+    }
+    return nullptr;
+}
+
+static u8* map_pages(size_t page_count)
+{
+    auto* pages = mmap(nullptr, page_count * PAGE_SIZE, PROT_READ | PROT_WRITE, MAP_ANONYMOUS | MAP_PRIVATE, 0, 0);
+    VERIFY(pages != MAP_FAILED);
+    return static_cast<u8*>(pages);
+}
+
+static void run_faulting_threads(Vector<FaultingThread>& threads, StringView description)
+{
+    auto timer = Core::ElapsedTimer::start_new();
+    for (auto& thread : threads)
+        EXPECT_EQ(pthread_create(&thread.thread, nullptr, touch_pages, &thread), 0);
+    for (auto& thread : threads)
+        EXPECT_EQ(pthread_join(thread.thread, nullptr), 0);
+    auto elapsed_ms = max(timer.elapsed(), 1);
+
+    u64 fault_count = 0;
+    for (auto& thread : threads) {
+        EXPECT(thread.touched_every_page);
+        fault_count += thread.page_count;
+    }
+    outln("{} threads, {}: {} page faults in {} ms ({} faults/s)", threads.size(), description, fault_count, elapsed_ms, fault_count * 1000 / elapsed_ms);
+}
+
+static size_t thread_count()
+{
+    return 2 * max(sysconf(_SC_NPROCESSORS_ONLN), 1l);
+}
+
+BENCHMARK_CASE(page_faults_in_separate_regions)
+{
+    Vector<FaultingThread> threads;
+    threads.resize(thread_count());
+    for (auto& thread : threads) {
+        thread.pages = map_pages(pages_per_thread);
+        thread.page_count = pages_per_thread;
+    }
+
+    run_faulting_threads(threads, "separate regions"sv);
+
+    for (auto& thread : threads)
+        EXPECT_EQ(munmap(thread.pages, pages_per_thread * PAGE_SIZE), 0);
+}
+
+BENCHMARK_CASE(page_faults_in_shared_region)
+{
+    Vector<FaultingThread> threads;
+    threads.resize(thread_count());
+    auto* pages = map_pages(threads.size() * pages_per_thread);
+    for (size_t i = 0; i < threads.size(); ++i) {
+        threads[i].pages = pages + i * pages_per_thread * PAGE_SIZE;
+        threads[i].page_count = pages_per_thread;
+    }
+
+    run_faulting_threads(threads, "one shared region"sv);
+
+    EXPECT_EQ(munmap(pages, threads.size() * pages_per_thread * PAGE_SIZE), 0);
+}
+
+static Atomic<bool> s_stop_churning;
+
+// Keeps placing and removing regions, so the faulting threads can't rely on their cached regions.
+static void* churn_regions(void*)
+{
+    while (!s_stop_churning.load()) {
+        auto* region = map_pages(1);
+        region[0] = 1;
+        munmap(region, PAGE_SIZE);
+    }
+    return nullptr;
+}
+
+BENCHMARK_CASE(page_faults_while_regions_change)
+{
+    Vector<FaultingThread> threads;
+    threads.resize(thread_count());
+    for (auto& thread : threads) {
+        thread.pages = map_pages(pages_per_thread);
+        thread.page_count = pages_per_thread;
+    }
+
+    s_stop_churning.store(false);
+    pthread_t churning_thread {};
+    EXPECT_EQ(pthread_create(&churning_thread, nullptr, churn_regions, nullptr), 0);
+    run_faulting_threads(threads, "while regions change"sv);
+    s_stop_churning.store(true);
+    EXPECT_EQ(pthread_join(churning_thread, nullptr), 0);
+
+    for (auto& thread : threads)
+        EXPECT_EQ(munmap(thread.pages, pages_per_thread * PAGE_SIZE), 0);
+}
@@ -0,0 +1,139 @@
+/*
+ * Copyright (c) 2022, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <LibTest/TestCase.h>
+#include <errno.h>
+#include <sys/epoll.h>
+#include <unistd.h>
+
+static void add_watch(int epoll_fd, int fd, u32 events, u64 data)
+{
+    epoll_event event {};
+    event.events = events;
+    event.data.u64 = data;
+    EXPECT_EQ(epoll_ctl(epoll_fd, EPOLL_CTL_ADD, fd, &event), 0);
+}
+
+TEST_CASE(level_triggered_read)
+{
+    int epoll_fd = epoll_create1(EPOLL_CLOEXEC);
+    EXPECT(epoll_fd >= 0);
+    int pipe_fds[2];
+    EXPECT_EQ(pipe(pipe_fds), 0);
+    add_watch(epoll_fd, pipe_fds[0], EPOLLIN, 42);
+
+    epoll_event events[4];
+    EXPECT_EQ(epoll_wait(epoll_fd, events, 4, 0), 0);
+
+    EXPECT_EQ(write(pipe_fds[1], "x", 1), 1);
+    EXPECT_EQ(epoll_wait(epoll_fd, events, 4, 1000), 1);
+    EXPECT_EQ(events[0].events, EPOLLIN);
+    EXPECT_EQ(events[0].data.u64, 42u);
+
+    // Still readable, so it must be reported again.
+    EXPECT_EQ(epoll_wait(epoll_fd, events, 4, 0), 1);
+
+    char byte;
+    EXPECT_EQ(read(pipe_fds[0], &byte, 1), 1);
+    EXPECT_EQ(epoll_wait(epoll_fd, events, 4, 0), 0);
+
+    close(pipe_fds[0]);
+    close(pipe_fds[1]);
+    close(epoll_fd);
+}
+
+TEST_CASE(edge_triggered_and_oneshot)
+{
+    int epoll_fd = epoll_create1(0);
+    EXPECT(epoll_fd >= 0);
+    int pipe_fds[2];
+    EXPECT_EQ(pipe(pipe_fds), 0);
+    add_watch(epoll_fd, pipe_fds[0], EPOLLIN | EPOLLET, 1);
+
+    EXPECT_EQ(write(pipe_fds[1], "x", 1), 1);
+    epoll_event events[4];
+    EXPECT_EQ(epoll_wait(epoll_fd, events, 4, 1000), 1);
+    // No new data arrived, so there is no new edge.
+    EXPECT_EQ(epoll_wait(epoll_fd, events, 4, 0), 0);
+
+    epoll_event event {};
+    event.events = EPOLLIN | EPOLLONESHOT;
+    event.data.u64 = 2;
+    EXPECT_EQ(epoll_ctl(epoll_fd, EPOLL_CTL_MOD, pipe_fds[0], &event), 0);
+    EXPECT_EQ(epoll_wait(epoll_fd, events, 4, 0), 1);
+    EXPECT_EQ(events[0].data.u64, 2u);
+    EXPECT_EQ(epoll_wait(epoll_fd, events, 4, 0), 0);
+
+    close(pipe_fds[0]);
+    close(pipe_fds[1]);
+    close(epoll_fd);
+}
+
+TEST_CASE(writer_close_and_removal)
+{
+    int epoll_fd = epoll_create1(0);
+    EXPECT(epoll_fd >= 0);
+    int pipe_fds[2];
+    EXPECT_EQ(pipe(pipe_fds), 0);
+    add_watch(epoll_fd, pipe_fds[0], EPOLLIN, 0);
+
+    epoll_event event {};
+    EXPECT_EQ(epoll_ctl(epoll_fd, EPOLL_CTL_ADD, pipe_fds[0], &event), -1);
+    EXPECT_EQ(errno, EEXIST);
+
+    close(pipe_fds[1]);
+    epoll_event events[4];
+    EXPECT_EQ(epoll_wait(epoll_fd, events, 4, 1000), 1);
+    EXPECT(events[0].events & (EPOLLIN | EPOLLHUP));
+
+    EXPECT_EQ(epoll_ctl(epoll_fd, EPOLL_CTL_DEL, pipe_fds[0], nullptr), 0);
+    EXPECT_EQ(epoll_wait(epoll_fd, events, 4, 0), 0);
+    EXPECT_EQ(epoll_ctl(epoll_fd, EPOLL_CTL_DEL, pipe_fds[0], nullptr), -1);
+    EXPECT_EQ(errno, ENOENT);
+
+    // Closing a watched description must silently drop its watch.
+    add_watch(epoll_fd, pipe_fds[0], EPOLLIN, 0);
+    close(pipe_fds[0]);
+    EXPECT_EQ(epoll_wait(epoll_fd, events, 4, 0), 0);
+
+    close(epoll_fd);
+}
+
+TEST_CASE(closing_a_duplicated_fd)
+{
+    int epoll_fd = epoll_create1(0);
+    EXPECT(epoll_fd >= 0);
+    int pipe_fds[2];
+    EXPECT_EQ(pipe(pipe_fds), 0);
+    int duplicate_fd = dup(pipe_fds[0]);
+    EXPECT(duplicate_fd >= 0);
+    add_watch(epoll_fd, pipe_fds[0], EPOLLIN, 1);
+
+    EXPECT_EQ(write(pipe_fds[1], "x", 1), 1);
+    epoll_event events[4];
+    EXPECT_EQ(epoll_wait(epoll_fd, events, 4, 0), 1);
+
+    // The description stays open through the duplicate, but the watch goes away with its fd.
+    close(pipe_fds[0]);
+    EXPECT_EQ(epoll_wait(epoll_fd, events, 4, 0), 0);
+    EXPECT_EQ(epoll_ctl(epoll_fd, EPOLL_CTL_DEL, pipe_fds[0], nullptr), -1);
+    EXPECT_EQ(errno, ENOENT);
+
+    // The same goes for an fd that is replaced by dup2().
+    int other_fd = dup(duplicate_fd);
+    EXPECT(other_fd >= 0);
+    add_watch(epoll_fd, duplicate_fd, EPOLLIN, 2);
+    add_watch(epoll_fd, other_fd, EPOLLIN, 3);
+    EXPECT_EQ(epoll_wait(epoll_fd, events, 4, 0), 2);
+    EXPECT_EQ(dup2(pipe_fds[1], other_fd), other_fd);
+    EXPECT_EQ(epoll_wait(epoll_fd, events, 4, 0), 1);
+    EXPECT_EQ(events[0].data.u64, 2u);
+
+    close(other_fd);
+    close(duplicate_fd);
+    close(pipe_fds[1]);
+    close(epoll_fd);
+}
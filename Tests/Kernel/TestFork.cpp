@@ -0,0 +1,155 @@
+/*
+ * Copyright (c) 2022, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <AK/StringView.h>
+#include <LibCore/ElapsedTimer.h>
+#include <LibTest/TestCase.h>
+#include <sched.h>
+#include <spawn.h>
+#include <sys/mman.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+static constexpr size_t page_size = 4 * KiB;
+
+static u8* map_and_touch(size_t size)
+{
+    auto* data = static_cast<u8*>(mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_ANONYMOUS | MAP_PRIVATE, 0, 0));
+    EXPECT(data != MAP_FAILED);
+    for (size_t offset = 0; offset < size; offset += page_size)
+        data[offset] = static_cast<u8>(offset / page_size);
+    return data;
+}
+
+static bool exited_successfully(pid_t pid)
+{
+    int status = 0;
+    if (waitpid(pid, &status, 0) != pid)
+        return false;
+    return WIFEXITED(status) && WEXITSTATUS(status) == 0;
+}
+
+TEST_CASE(writes_after_fork_stay_private)
+{
+    auto* data = map_and_touch(4 * MiB);
+    auto* shared = static_cast<u8*>(mmap(nullptr, page_size, PROT_READ | PROT_WRITE, MAP_ANONYMOUS | MAP_SHARED, 0, 0));
+    EXPECT(shared != MAP_FAILED);
+
+    auto pid = fork();
+    EXPECT(pid >= 0);
+    if (pid == 0) {
+        // The parent writes first, so the child has to see what was there at fork() time.
+        while (shared[0] != 1)
+            sched_yield();
+        bool intact = data[0] == 0 && data[page_size] == 1;
+        data[2 * page_size] = 0xcc;
+        shared[0] = 2;
+        _exit(intact ? 0 : 1);
+    }
+
+    data[0] = 0xaa;
+    data[page_size] = 0xbb;
+    shared[0] = 1;
+    EXPECT(exited_successfully(pid));
+    EXPECT_EQ(shared[0], 2);
+    EXPECT_EQ(data[0], 0xaa);
+    EXPECT_EQ(data[page_size], 0xbb);
+    EXPECT_EQ(data[2 * page_size], 2);
+
+    EXPECT_EQ(munmap(shared, page_size), 0);
+    EXPECT_EQ(munmap(data, 4 * MiB), 0);
+}
+
+TEST_CASE(spawn_applies_file_actions)
+{
+    int fds[2];
+    EXPECT_EQ(pipe(fds), 0);
+
+    posix_spawn_file_actions_t file_actions;
+    posix_spawn_file_actions_init(&file_actions);
+    posix_spawn_file_actions_adddup2(&file_actions, fds[1], STDOUT_FILENO);
+    posix_spawn_file_actions_addclose(&file_actions, fds[0]);
+
+    char const* argv[] = { "echo", "hello", nullptr };
+    pid_t pid = 0;
+    EXPECT_EQ(posix_spawn(&pid, "/bin/echo", &file_actions, nullptr, const_cast<char**>(argv), environ), 0);
+    posix_spawn_file_actions_destroy(&file_actions);
+    close(fds[1]);
+
+    char buffer[16] {};
+    EXPECT_EQ(read(fds[0], buffer, sizeof(buffer)), 6);
+    EXPECT_EQ(StringView(buffer, 6), "hello\n"sv);
+    EXPECT(exited_successfully(pid));
+    close(fds[0]);
+
+    char const* missing_argv[] = { "missing", nullptr };
+    EXPECT_EQ(posix_spawn(&pid, "/bin/this-does-not-exist", nullptr, nullptr, const_cast<char**>(missing_argv), environ), ENOENT);
+}
+
+static constexpr int iteration_count = 200;
+static constexpr size_t resident_sizes[] = { 0, 16 * MiB, 64 * MiB, 256 * MiB };
+
+enum class SpawnMethod {
+    ForkExit,
+    ForkExec,
+    PosixSpawn,
+};
+
+static pid_t spawn_child(SpawnMethod method)
+{
+    char const* argv[] = { "true", nullptr };
+    if (method == SpawnMethod::PosixSpawn) {
+        pid_t pid = -1;
+        if (posix_spawn(&pid, "/bin/true", nullptr, nullptr, const_cast<char**>(argv), environ) != 0)
+            return -1;
+        return pid;
+    }
+    auto pid = fork();
+    if (pid == 0) {
+        if (method == SpawnMethod::ForkExec)
+            execve("/bin/true", const_cast<char**>(argv), environ);
+        _exit(0);
+    }
+    return pid;
+}
+
+// The parent's resident memory used to make fork() slower, even for a child that exec()s right away.
+static void run_spawn_benchmark(SpawnMethod method, StringView method_name)
+{
+    for (size_t resident_size : resident_sizes) {
+        u8* data = resident_size ? map_and_touch(resident_size) : nullptr;
+
+        auto timer = Core::ElapsedTimer::start_new();
+        for (int i = 0; i < iteration_count; ++i) {
+            auto pid = spawn_child(method);
+            EXPECT(pid > 0);
+            EXPECT(exited_successfully(pid));
+            // Write to the parent's memory like a real program would, which has to copy the pages once.
+            if (data)
+                data[(i * page_size) % resident_size] = static_cast<u8>(i);
+        }
+        auto elapsed_ms = max(timer.elapsed(), 1);
+        outln("{} with {} MiB resident: {} children in {} ms ({} us each)", method_name, resident_size / MiB, iteration_count, elapsed_ms, static_cast<u64>(elapsed_ms) * 1000 / iteration_count);
+
+        if (data)
+            EXPECT_EQ(munmap(data, resident_size), 0);
+    }
+}
+
+BENCHMARK_CASE(fork_and_exit)
+{
+    run_spawn_benchmark(SpawnMethod::ForkExit, "fork()+_exit()"sv);
+}
+
+BENCHMARK_CASE(fork_and_exec)
+{
+    run_spawn_benchmark(SpawnMethod::ForkExec, "fork()+execve()"sv);
+}
+
+BENCHMARK_CASE(spawn_with_posix_spawn)
+{
+    run_spawn_benchmark(SpawnMethod::PosixSpawn, "posix_spawn()"sv);
+}
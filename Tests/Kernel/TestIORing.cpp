@@ -0,0 +1,233 @@
+/*
+ * Copyright (c) 2022, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <AK/Atomic.h>
+#include <Kernel/API/IORing.h>
+#include <LibCore/EventLoop.h>
+#include <LibCore/IORing.h>
+#include <LibTest/TestCase.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <serenity.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+using Kernel::IORingCompletion;
+using Kernel::IORingHeader;
+using Kernel::IORingOperation;
+using Kernel::IORingSubmission;
+
+struct Ring {
+    int fd { -1 };
+    u8* base { nullptr };
+    size_t size { 0 };
+
+    IORingHeader& header() { return *reinterpret_cast<IORingHeader*>(base); }
+
+    void submit(IORingOperation operation, int target_fd, void const* buffer, size_t length, u64 user_data, int flags = 0)
+    {
+        auto* submissions = reinterpret_cast<IORingSubmission*>(base + header().submissions_offset);
+        auto tail = header().submission_tail;
+        auto& submission = submissions[tail & (header().submission_entries - 1)];
+        submission = {};
+        submission.operation = operation;
+        submission.fd = target_fd;
+        submission.buffer = reinterpret_cast<FlatPtr>(buffer);
+        submission.length = length;
+        submission.offset = -1;
+        submission.flags = flags;
+        submission.user_data = user_data;
+        AK::atomic_store(&header().submission_tail, tail + 1);
+    }
+
+    Optional<IORingCompletion> take_completion()
+    {
+        auto head = header().completion_head;
+        if (head == AK::atomic_load(&header().completion_tail))
+            return {};
+        auto* completions = reinterpret_cast<IORingCompletion*>(base + header().completions_offset);
+        auto completion = completions[head & (header().completion_entries - 1)];
+        AK::atomic_store(&header().completion_head, head + 1);
+        return completion;
+    }
+};
+
+static Ring create_ring(u32 entries)
+{
+    Ring ring;
+    ring.fd = io_ring_create(entries, O_CLOEXEC);
+    VERIFY(ring.fd >= 0);
+    ring.size = Kernel::io_ring_size(entries);
+    auto* base = mmap(nullptr, ring.size, PROT_READ | PROT_WRITE, MAP_SHARED, ring.fd, 0);
+    VERIFY(base != MAP_FAILED);
+    ring.base = static_cast<u8*>(base);
+    return ring;
+}
+
+static void destroy_ring(Ring& ring)
+{
+    munmap(ring.base, ring.size);
+    close(ring.fd);
+}
+
+TEST_CASE(invalid_entry_count)
+{
+    EXPECT_EQ(io_ring_create(0, 0), -1);
+    EXPECT_EQ(errno, EINVAL);
+    EXPECT_EQ(io_ring_create(3, 0), -1);
+    EXPECT_EQ(errno, EINVAL);
+}
+
+TEST_CASE(batched_pipe_write_and_read)
+{
+    auto ring = create_ring(8);
+    EXPECT_EQ(ring.header().submission_entries, 8u);
+    EXPECT_EQ(ring.header().completion_entries, 16u);
+
+    int pipe_fds[2];
+    EXPECT_EQ(pipe(pipe_fds), 0);
+
+    char buffer[16] {};
+    ring.submit(IORingOperation::Write, pipe_fds[1], "hello", 5, 1);
+    ring.submit(IORingOperation::Read, pipe_fds[0], buffer, sizeof(buffer), 2);
+    ring.submit(IORingOperation::Nop, -1, nullptr, 0, 3);
+    EXPECT_EQ(io_ring_enter(ring.fd, 3), 3);
+    EXPECT_EQ(ring.header().submission_head, 3u);
+
+    auto first = ring.take_completion();
+    auto second = ring.take_completion();
+    auto third = ring.take_completion();
+    EXPECT(first.has_value() && second.has_value() && third.has_value());
+    EXPECT_EQ(first->user_data, 1u);
+    EXPECT_EQ(first->result, 5);
+    EXPECT_EQ(second->user_data, 2u);
+    EXPECT_EQ(second->result, 5);
+    EXPECT_EQ(memcmp(buffer, "hello", 5), 0);
+    EXPECT_EQ(third->user_data, 3u);
+    EXPECT_EQ(third->result, 0);
+    EXPECT(!ring.take_completion().has_value());
+
+    close(pipe_fds[0]);
+    close(pipe_fds[1]);
+    destroy_ring(ring);
+}
+
+TEST_CASE(read_waits_for_data)
+{
+    auto ring = create_ring(4);
+    int pipe_fds[2];
+    EXPECT_EQ(pipe(pipe_fds), 0);
+
+    char byte = 0;
+    ring.submit(IORingOperation::Read, pipe_fds[0], &byte, 1, 7);
+    EXPECT_EQ(io_ring_enter(ring.fd, 0), 0);
+    EXPECT(!ring.take_completion().has_value());
+
+    EXPECT_EQ(write(pipe_fds[1], "x", 1), 1);
+    EXPECT_EQ(io_ring_enter(ring.fd, 1), 1);
+    auto completion = ring.take_completion();
+    EXPECT(completion.has_value());
+    EXPECT_EQ(completion->user_data, 7u);
+    EXPECT_EQ(completion->result, 1);
+    EXPECT_EQ(byte, 'x');
+
+    close(pipe_fds[0]);
+    close(pipe_fds[1]);
+    destroy_ring(ring);
+}
+
+TEST_CASE(errors_are_negated_errnos)
+{
+    auto ring = create_ring(4);
+    ring.submit(IORingOperation::Read, 12345, nullptr, 1, 1);
+    int pipe_fds[2];
+    EXPECT_EQ(pipe(pipe_fds), 0);
+    ring.submit(IORingOperation::Recv, pipe_fds[0], nullptr, 1, 2);
+    EXPECT_EQ(io_ring_enter(ring.fd, 2), 2);
+    EXPECT_EQ(ring.take_completion()->result, -EBADF);
+    EXPECT_EQ(ring.take_completion()->result, -ENOTSOCK);
+
+    close(pipe_fds[0]);
+    close(pipe_fds[1]);
+    destroy_ring(ring);
+}
+
+TEST_CASE(accept_on_a_connected_socket)
+{
+    auto ring = create_ring(4);
+    int fds[2];
+    EXPECT_EQ(socketpair(AF_LOCAL, SOCK_STREAM, 0, fds), 0);
+    // Being readable must not make the accept look like it could make progress.
+    EXPECT_EQ(write(fds[0], "ping", 4), 4);
+
+    ring.submit(IORingOperation::Accept, fds[1], nullptr, 0, 1);
+    EXPECT_EQ(io_ring_enter(ring.fd, 1), 1);
+    auto completion = ring.take_completion();
+    EXPECT(completion.has_value());
+    EXPECT_EQ(completion->user_data, 1u);
+    EXPECT_EQ(completion->result, -EINVAL);
+
+    close(fds[0]);
+    close(fds[1]);
+    destroy_ring(ring);
+}
+
+TEST_CASE(socket_send_and_recv)
+{
+    auto ring = create_ring(4);
+    int fds[2];
+    EXPECT_EQ(socketpair(AF_LOCAL, SOCK_STREAM, 0, fds), 0);
+
+    char buffer[8] {};
+    ring.submit(IORingOperation::Recv, fds[1], buffer, sizeof(buffer), 1);
+    ring.submit(IORingOperation::Send, fds[0], "ping", 4, 2);
+    // The receive waits until the send has been done, and is completed in the same call.
+    EXPECT_EQ(io_ring_enter(ring.fd, 2), 2);
+
+    u32 seen = 0;
+    for (auto completion = ring.take_completion(); completion.has_value(); completion = ring.take_completion()) {
+        EXPECT_EQ(completion->result, 4);
+        seen |= 1 << completion->user_data;
+    }
+    EXPECT_EQ(seen, 0b110u);
+    EXPECT_EQ(memcmp(buffer, "ping", 4), 0);
+
+    close(fds[0]);
+    close(fds[1]);
+    destroy_ring(ring);
+}
+
+TEST_CASE(core_io_ring_in_event_loop)
+{
+    Core::EventLoop loop;
+    auto ring = MUST(Core::IORing::create(4));
+    int pipe_fds[2];
+    EXPECT_EQ(pipe(pipe_fds), 0);
+
+    char buffer[8] {};
+    Optional<size_t> bytes_read;
+    MUST(ring->read(pipe_fds[0], { buffer, sizeof(buffer) }, {}, [&](ErrorOr<size_t> result) {
+        bytes_read = MUST(result);
+        loop.quit(0);
+    }));
+    // Nothing has been written yet, so the read has to wait for the event loop to notice the pipe.
+    MUST(ring->submit_and_wait());
+    EXPECT_EQ(ring->outstanding_operations(), 1u);
+
+    MUST(ring->write(pipe_fds[1], "abc"sv.bytes(), {}, [](ErrorOr<size_t> result) {
+        EXPECT_EQ(MUST(result), 3u);
+    }));
+    loop.exec();
+
+    EXPECT_EQ(bytes_read, 3u);
+    EXPECT_EQ(memcmp(buffer, "abc", 3), 0);
+    EXPECT_EQ(ring->outstanding_operations(), 0u);
+
+    close(pipe_fds[0]);
+    close(pipe_fds[1]);
+}
@@ -0,0 +1,123 @@
+/*
+ * Copyright (c) 2022, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <AK/JsonObject.h>
+#include <AK/JsonValue.h>
+#include <LibCore/File.h>
+#include <LibTest/TestCase.h>
+#include <sys/mman.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+static constexpr size_t large_page_size = 2 * MiB;
+static constexpr size_t page_size = 4 * KiB;
+
+static u64 large_pages_mapped()
+{
+    auto file = Core::File::construct("/sys/kernel/memstat");
+    if (!file->open(Core::OpenMode::ReadOnly))
+        return 0;
+    auto json = JsonValue::from_string(file->read_all());
+    if (json.is_error() || !json.value().is_object())
+        return 0;
+    return json.value().as_object().get("large_pages_mapped"sv).to_u64();
+}
+
+// Maps `size` bytes of anonymous memory starting at a large page boundary.
+static u8* map_aligned(size_t size)
+{
+    auto* mapping = static_cast<u8*>(mmap(nullptr, size + large_page_size, PROT_READ | PROT_WRITE, MAP_ANONYMOUS | MAP_PRIVATE, 0, 0));
+    EXPECT(mapping != MAP_FAILED);
+    auto* aligned = reinterpret_cast<u8*>(align_up_to(reinterpret_cast<FlatPtr>(mapping), large_page_size));
+    if (aligned != mapping)
+        EXPECT_EQ(munmap(mapping, aligned - mapping), 0);
+    if (auto tail = (mapping + size + large_page_size) - (aligned + size); tail > 0)
+        EXPECT_EQ(munmap(aligned + size, tail), 0);
+    return aligned;
+}
+
+static void fill(u8* data, size_t size)
+{
+    for (size_t offset = 0; offset < size; offset += page_size)
+        data[offset] = static_cast<u8>(offset / page_size);
+}
+
+static bool is_intact(u8 const* data, size_t begin, size_t end)
+{
+    for (size_t offset = begin; offset < end; offset += page_size) {
+        if (data[offset] != static_cast<u8>(offset / page_size))
+            return false;
+    }
+    return true;
+}
+
+TEST_CASE(touching_an_aligned_chunk)
+{
+    auto mapped_before = large_pages_mapped();
+    auto* data = map_aligned(2 * large_page_size);
+    fill(data, 2 * large_page_size);
+    EXPECT(is_intact(data, 0, 2 * large_page_size));
+    EXPECT(large_pages_mapped() > mapped_before);
+    EXPECT_EQ(munmap(data, 2 * large_page_size), 0);
+}
+
+TEST_CASE(mprotect_splits_and_collapses)
+{
+    auto* data = map_aligned(large_page_size);
+    fill(data, large_page_size);
+
+    // Making a single page read-only has to split the large page.
+    EXPECT_EQ(mprotect(data + 16 * page_size, page_size, PROT_READ), 0);
+    EXPECT(is_intact(data, 0, large_page_size));
+    data[0] = 0xaa;
+    data[large_page_size - page_size] = 0xbb;
+    EXPECT_EQ(data[16 * page_size], 16);
+
+    // Making all of it writable again allows it to collapse back into a large page.
+    EXPECT_EQ(mprotect(data, large_page_size, PROT_READ | PROT_WRITE), 0);
+    data[16 * page_size] = 0xcc;
+    EXPECT_EQ(data[0], 0xaa);
+    EXPECT_EQ(data[16 * page_size], 0xcc);
+    EXPECT_EQ(data[large_page_size - page_size], 0xbb);
+    EXPECT(is_intact(data, page_size, 16 * page_size));
+
+    EXPECT_EQ(munmap(data, large_page_size), 0);
+}
+
+TEST_CASE(partial_munmap)
+{
+    auto* data = map_aligned(2 * large_page_size);
+    fill(data, 2 * large_page_size);
+
+    // Punch a hole into the first large page, and drop the second one entirely.
+    EXPECT_EQ(munmap(data + large_page_size / 2, page_size), 0);
+    EXPECT_EQ(munmap(data + large_page_size, large_page_size), 0);
+
+    EXPECT(is_intact(data, 0, large_page_size / 2));
+    EXPECT(is_intact(data, large_page_size / 2 + page_size, large_page_size));
+
+    EXPECT_EQ(munmap(data, large_page_size), 0);
+}
+
+TEST_CASE(fork_keeps_large_pages_private)
+{
+    auto* data = map_aligned(large_page_size);
+    fill(data, large_page_size);
+
+    auto pid = fork();
+    EXPECT(pid >= 0);
+    if (pid == 0) {
+        // Both processes now copy on write, so the child's writes must not show up in the parent.
+        data[0] = 0xee;
+        _exit(is_intact(data, page_size, large_page_size) ? 0 : 1);
+    }
+    int status = 0;
+    EXPECT_EQ(waitpid(pid, &status, 0), pid);
+    EXPECT(WIFEXITED(status) && WEXITSTATUS(status) == 0);
+    EXPECT(is_intact(data, 0, large_page_size));
+
+    EXPECT_EQ(munmap(data, large_page_size), 0);
+}
@@ -0,0 +1,174 @@
+/*
+ * Copyright (c) 2022, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <AK/Vector.h>
+#include <LibCore/ElapsedTimer.h>
+#include <LibTest/TestCase.h>
+#include <errno.h>
+#include <pthread.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+static size_t buffer_size(int fd, int option)
+{
+    int size = 0;
+    socklen_t size_size = sizeof(size);
+    EXPECT_EQ(getsockopt(fd, SOL_SOCKET, option, &size, &size_size), 0);
+    return static_cast<size_t>(size);
+}
+
+static u8 pattern_byte(size_t offset)
+{
+    return static_cast<u8>(offset % 251);
+}
+
+TEST_CASE(buffer_size_options)
+{
+    int fds[2];
+    EXPECT_EQ(socketpair(AF_LOCAL, SOCK_STREAM, 0, fds), 0);
+    EXPECT_EQ(buffer_size(fds[0], SO_RCVBUF), 64 * KiB);
+
+    // Sizes are rounded up to a power of two.
+    int size = 100 * KiB;
+    EXPECT_EQ(setsockopt(fds[0], SOL_SOCKET, SO_RCVBUF, &size, sizeof(size)), 0);
+    EXPECT_EQ(buffer_size(fds[0], SO_RCVBUF), 128 * KiB);
+
+    // One side's receive buffer is the other side's send buffer.
+    EXPECT_EQ(buffer_size(fds[1], SO_SNDBUF), 128 * KiB);
+    EXPECT_EQ(buffer_size(fds[1], SO_RCVBUF), 64 * KiB);
+
+    close(fds[0]);
+    close(fds[1]);
+}
+
+TEST_CASE(resize_keeps_pending_data)
+{
+    int fds[2];
+    EXPECT_EQ(socketpair(AF_LOCAL, SOCK_STREAM, 0, fds), 0);
+
+    Vector<u8> data;
+    data.resize(48 * KiB);
+    for (size_t i = 0; i < data.size(); ++i)
+        data[i] = pattern_byte(i);
+    EXPECT_EQ(write(fds[0], data.data(), data.size()), static_cast<ssize_t>(data.size()));
+
+    // The pending data doesn't fit into the smallest buffer.
+    int size = 4 * KiB;
+    EXPECT_EQ(setsockopt(fds[1], SOL_SOCKET, SO_RCVBUF, &size, sizeof(size)), -1);
+    EXPECT_EQ(errno, EBUSY);
+
+    size = 256 * KiB;
+    EXPECT_EQ(setsockopt(fds[1], SOL_SOCKET, SO_RCVBUF, &size, sizeof(size)), 0);
+
+    Vector<u8> received;
+    received.resize(data.size());
+    EXPECT_EQ(read(fds[1], received.data(), received.size()), static_cast<ssize_t>(received.size()));
+    EXPECT(received == data);
+
+    close(fds[0]);
+    close(fds[1]);
+}
+
+TEST_CASE(data_survives_wrapping_around)
+{
+    int fds[2];
+    EXPECT_EQ(socketpair(AF_LOCAL, SOCK_STREAM, 0, fds), 0);
+    int size = 4 * KiB;
+    EXPECT_EQ(setsockopt(fds[1], SOL_SOCKET, SO_RCVBUF, &size, sizeof(size)), 0);
+
+    // Chunks that don't divide the buffer size end up split across its end all the time.
+    u8 chunk[1000];
+    size_t written = 0;
+    size_t read_so_far = 0;
+    for (int i = 0; i < 1000; ++i) {
+        for (size_t j = 0; j < sizeof(chunk); ++j)
+            chunk[j] = pattern_byte(written + j);
+        EXPECT_EQ(write(fds[0], chunk, sizeof(chunk)), static_cast<ssize_t>(sizeof(chunk)));
+        written += sizeof(chunk);
+
+        auto nread = read(fds[1], chunk, sizeof(chunk));
+        EXPECT_EQ(nread, static_cast<ssize_t>(sizeof(chunk)));
+        for (ssize_t j = 0; j < nread; ++j)
+            EXPECT_EQ(chunk[j], pattern_byte(read_so_far + j));
+        read_so_far += nread;
+    }
+
+    close(fds[0]);
+    close(fds[1]);
+}
+
+static constexpr int round_trip_count = 20000;
+
+struct PingPong {
+    int fds[2] { -1, -1 };
+    size_t message_size { 0 };
+};
+
+static bool transfer(int fd, u8* buffer, size_t size, bool send)
+{
+    for (size_t offset = 0; offset < size;) {
+        auto result = send ? write(fd, buffer + offset, size - offset) : read(fd, buffer + offset, size - offset);
+        if (result <= 0)
+            return false;
+        offset += result;
+    }
+    return true;
+}
+
+static void* pong_thread(void* argument)
+{
+    auto& ping_pong = *static_cast<PingPong*>(argument);
+    Vector<u8> message;
+    message.resize(ping_pong.message_size);
+    for (int i = 0; i < round_trip_count; ++i) {
+        if (!transfer(ping_pong.fds[1], message.data(), message.size(), false))
+            return reinterpret_cast<void*>(1);
+        if (!transfer(ping_pong.fds[1], message.data(), message.size(), true))
+            return reinterpret_cast<void*>(1);
+    }
+    return nullptr;
+}
+
+// This is what IPC between a client and a server looks like: a request, then a reply.
+static void run_ping_pong(size_t message_size)
+{
+    PingPong ping_pong { .message_size = message_size };
+    EXPECT_EQ(socketpair(AF_LOCAL, SOCK_STREAM, 0, ping_pong.fds), 0);
+
+    Vector<u8> message;
+    message.resize(message_size);
+    pthread_t thread;
+    auto timer = Core::ElapsedTimer::start_new();
+    EXPECT_EQ(pthread_create(&thread, nullptr, pong_thread, &ping_pong), 0);
+    for (int i = 0; i < round_trip_count; ++i) {
+        EXPECT(transfer(ping_pong.fds[0], message.data(), message.size(), true));
+        EXPECT(transfer(ping_pong.fds[0], message.data(), message.size(), false));
+    }
+    void* result = nullptr;
+    EXPECT_EQ(pthread_join(thread, &result), 0);
+    EXPECT_EQ(result, nullptr);
+    auto elapsed_ms = max(timer.elapsed(), 1);
+
+    close(ping_pong.fds[0]);
+    close(ping_pong.fds[1]);
+
+    outln("{}-byte messages: {} round trips in {} ms ({} round trips/s)", message_size, round_trip_count, elapsed_ms, static_cast<u64>(round_trip_count) * 1000 / elapsed_ms);
+}
+
+BENCHMARK_CASE(ipc_ping_pong_small_messages)
+{
+    run_ping_pong(64);
+}
+
+BENCHMARK_CASE(ipc_ping_pong_medium_messages)
+{
+    run_ping_pong(4 * KiB);
+}
+
+BENCHMARK_CASE(ipc_ping_pong_large_messages)
+{
+    run_ping_pong(48 * KiB);
+}
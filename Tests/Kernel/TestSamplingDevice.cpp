@@ -0,0 +1,96 @@
+/*
+ * Copyright (c) 2022, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <AK/Atomic.h>
+#include <AK/Vector.h>
+#include <Kernel/API/SampleRing.h>
+#include <LibCore/ElapsedTimer.h>
+#include <LibTest/TestCase.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <sys/ioctl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+
+using Kernel::SampleRecord;
+using Kernel::SampleRecordType;
+using Kernel::SampleRingHeader;
+
+static constexpr size_t data_size = 64 * KiB;
+static constexpr size_t ring_size = Kernel::sample_ring_size(data_size);
+
+static void spin_for_milliseconds(i64 milliseconds)
+{
+    auto timer = Core::ElapsedTimer::start_new();
+    while (timer.elapsed() < milliseconds)
+        ;
+}
+
+TEST_CASE(only_one_sampler_at_a_time)
+{
+    int fd = open("/dev/samples", O_RDWR);
+    EXPECT(fd >= 0);
+    int other_fd = open("/dev/samples", O_RDWR);
+    EXPECT(other_fd >= 0);
+
+    // Nothing can be mapped before there are any rings.
+    EXPECT_EQ(mmap(nullptr, ring_size, PROT_READ, MAP_SHARED, fd, 0), MAP_FAILED);
+
+    EXPECT_EQ(ioctl(fd, SAMPLING_IOCTL_ENABLE, data_size), 0);
+    EXPECT_EQ(ioctl(other_fd, SAMPLING_IOCTL_ENABLE, data_size), -1);
+    EXPECT_EQ(errno, EBUSY);
+
+    // Closing the description that enabled sampling disables it again.
+    close(fd);
+    EXPECT_EQ(ioctl(other_fd, SAMPLING_IOCTL_ENABLE, data_size), 0);
+    EXPECT_EQ(ioctl(other_fd, SAMPLING_IOCTL_DISABLE), 0);
+    close(other_fd);
+}
+
+TEST_CASE(samples_show_up_while_running)
+{
+    int fd = open("/dev/samples", O_RDWR);
+    EXPECT(fd >= 0);
+    EXPECT_EQ(ioctl(fd, SAMPLING_IOCTL_ENABLE, data_size), 0);
+
+    auto cpu_count = sysconf(_SC_NPROCESSORS_ONLN);
+    Vector<u8*> rings;
+    for (long cpu = 0; cpu < cpu_count; ++cpu) {
+        auto* ring = static_cast<u8*>(mmap(nullptr, ring_size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, cpu * ring_size));
+        EXPECT(ring != MAP_FAILED);
+        auto& header = *reinterpret_cast<SampleRingHeader*>(ring);
+        EXPECT_EQ(header.cpu, static_cast<u32>(cpu));
+        EXPECT_EQ(header.data_size, data_size);
+        rings.append(ring);
+    }
+
+    // Two rounds, so the second one starts at a read position that isn't 0.
+    for (int round = 0; round < 2; ++round) {
+        spin_for_milliseconds(200);
+
+        size_t own_samples = 0;
+        for (auto* ring : rings) {
+            auto& header = *reinterpret_cast<SampleRingHeader*>(ring);
+            auto write_position = AK::atomic_load(&header.write_position, AK::MemoryOrder::memory_order_acquire);
+            auto read_position = header.read_position;
+            while (read_position < write_position) {
+                auto const& record = *reinterpret_cast<SampleRecord const*>(ring + header.data_offset + (read_position & (data_size - 1)));
+                EXPECT(record.size >= sizeof(u64) && record.size % 8 == 0);
+                if (record.type == SampleRecordType::Sample && record.pid == getpid()) {
+                    EXPECT(record.kernel_frame_count + record.user_frame_count > 0);
+                    ++own_samples;
+                }
+                read_position += record.size;
+            }
+            AK::atomic_store(&header.read_position, read_position, AK::MemoryOrder::memory_order_release);
+        }
+        EXPECT(own_samples > 0);
+    }
+
+    for (auto* ring : rings)
+        EXPECT_EQ(munmap(ring, ring_size), 0);
+    close(fd);
+}
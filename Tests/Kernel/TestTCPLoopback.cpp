@@ -0,0 +1,204 @@
+/*
+ * Copyright (c) 2022, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <AK/StringView.h>
+#include <AK/Vector.h>
+#include <LibCore/ElapsedTimer.h>
+#include <LibTest/TestCase.h>
+#include <arpa/inet.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <pthread.h>
+#include <string.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+static constexpr size_t transfer_size = 64 * MiB;
+
+// A healthy stack moves data over the loopback adapter much faster than this. Falling back
+// to retransmission timeouts or a stuck window brings throughput far below it, though.
+static constexpr u64 minimum_bytes_per_second = 8 * MiB;
+
+struct Connection {
+    int client_fd { -1 };
+    int server_fd { -1 };
+};
+
+static Connection connect_over_loopback()
+{
+    Connection connection;
+    int listen_fd = socket(AF_INET, SOCK_STREAM, 0);
+    EXPECT(listen_fd >= 0);
+
+    sockaddr_in address {};
+    address.sin_family = AF_INET;
+    address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    address.sin_port = 0;
+    EXPECT_EQ(bind(listen_fd, reinterpret_cast<sockaddr const*>(&address), sizeof(address)), 0);
+    EXPECT_EQ(listen(listen_fd, 1), 0);
+    socklen_t address_size = sizeof(address);
+    EXPECT_EQ(getsockname(listen_fd, reinterpret_cast<sockaddr*>(&address), &address_size), 0);
+
+    connection.client_fd = socket(AF_INET, SOCK_STREAM, 0);
+    EXPECT(connection.client_fd >= 0);
+    EXPECT_EQ(connect(connection.client_fd, reinterpret_cast<sockaddr const*>(&address), sizeof(address)), 0);
+    connection.server_fd = accept(listen_fd, nullptr, nullptr);
+    EXPECT(connection.server_fd >= 0);
+    close(listen_fd);
+    return connection;
+}
+
+static u8 pattern_byte(size_t offset)
+{
+    return static_cast<u8>(offset % 251);
+}
+
+struct Receiver {
+    int fd { -1 };
+    size_t received { 0 };
+    bool data_was_intact { true };
+};
+
+static void* run_receiver(void* argument)
+{
+    auto& receiver = *static_cast<Receiver*>(argument);
+    Vector<u8> buffer;
+    buffer.resize(256 * KiB);
+    for (;;) {
+        auto nread = read(receiver.fd, buffer.data(), buffer.size());
+        if (nread <= 0)
+            break;
+        for (ssize_t i = 0; i < nread; ++i) {
+            if (buffer[i] != pattern_byte(receiver.received + i))
+                receiver.data_was_intact = false;
+        }
+        receiver.received += nread;
+    }
+    return nullptr;
+}
+
+static void set_congestion_control(int fd, StringView name)
+{
+    EXPECT_EQ(setsockopt(fd, IPPROTO_TCP, TCP_CONGESTION, name.characters_without_null_termination(), name.length()), 0);
+}
+
+// With faults, the loopback adapter loses and reorders some packets. That makes the receiver
+// queue out-of-order segments and report the holes in SACK blocks, and the sender has to
+// recover through fast retransmits and timeouts.
+static void set_loopback_fault_injection(bool enabled)
+{
+    int fd = open("/sys/kernel/variables/loopback_fault_injection", O_WRONLY);
+    EXPECT(fd >= 0);
+    if (fd < 0)
+        return;
+    EXPECT_EQ(write(fd, enabled ? "1" : "0", 1), 1);
+    close(fd);
+}
+
+enum class SwitchAlgorithms {
+    No,
+    Yes,
+};
+
+static void run_transfer(StringView congestion_control, u64 required_bytes_per_second, SwitchAlgorithms switch_algorithms = SwitchAlgorithms::No)
+{
+    auto connection = connect_over_loopback();
+    set_congestion_control(connection.client_fd, congestion_control);
+
+    Receiver receiver { connection.server_fd };
+    pthread_t receiver_thread;
+    EXPECT_EQ(pthread_create(&receiver_thread, nullptr, run_receiver, &receiver), 0);
+
+    Vector<u8> buffer;
+    buffer.resize(64 * KiB);
+    size_t sent = 0;
+    auto timer = Core::ElapsedTimer::start_new();
+    while (sent < transfer_size) {
+        auto chunk_size = min(buffer.size(), transfer_size - sent);
+        for (size_t i = 0; i < chunk_size; ++i)
+            buffer[i] = pattern_byte(sent + i);
+        for (size_t offset = 0; offset < chunk_size;) {
+            auto nwritten = write(connection.client_fd, buffer.data() + offset, chunk_size - offset);
+            EXPECT(nwritten > 0);
+            if (nwritten <= 0)
+                break;
+            offset += nwritten;
+        }
+        sent += chunk_size;
+
+        // Switching while data is in flight races with the ACKs that update the window.
+        if (switch_algorithms == SwitchAlgorithms::Yes && sent % (4 * MiB) == 0)
+            set_congestion_control(connection.client_fd, (sent / (4 * MiB)) % 2 ? "reno"sv : "cubic"sv);
+    }
+    EXPECT_EQ(shutdown(connection.client_fd, SHUT_WR), 0);
+    EXPECT_EQ(pthread_join(receiver_thread, nullptr), 0);
+    auto elapsed_ms = max<i64>(timer.elapsed(), 1);
+
+    EXPECT_EQ(receiver.received, transfer_size);
+    EXPECT(receiver.data_was_intact);
+
+    u64 bytes_per_second = static_cast<u64>(transfer_size) * 1000 / elapsed_ms;
+    outln("{}: {} bytes in {} ms ({} bytes/s)", congestion_control, transfer_size, elapsed_ms, bytes_per_second);
+    EXPECT(bytes_per_second >= required_bytes_per_second);
+
+    close(connection.client_fd);
+    close(connection.server_fd);
+}
+
+TEST_CASE(loopback_throughput_cubic)
+{
+    run_transfer("cubic"sv, minimum_bytes_per_second);
+}
+
+TEST_CASE(loopback_throughput_reno)
+{
+    run_transfer("reno"sv, minimum_bytes_per_second);
+}
+
+// Recovering from losses takes a while, so these only check that all data arrives intact.
+TEST_CASE(loss_and_reordering_cubic)
+{
+    set_loopback_fault_injection(true);
+    run_transfer("cubic"sv, 0);
+    set_loopback_fault_injection(false);
+}
+
+TEST_CASE(loss_and_reordering_reno)
+{
+    set_loopback_fault_injection(true);
+    run_transfer("reno"sv, 0);
+    set_loopback_fault_injection(false);
+}
+
+TEST_CASE(switching_algorithms_during_a_transfer)
+{
+    set_loopback_fault_injection(true);
+    run_transfer("cubic"sv, 0, SwitchAlgorithms::Yes);
+    set_loopback_fault_injection(false);
+}
+
+TEST_CASE(congestion_control_option)
+{
+    auto connection = connect_over_loopback();
+
+    char name[TCP_CA_NAME_MAX] {};
+    socklen_t name_size = sizeof(name);
+    EXPECT_EQ(getsockopt(connection.client_fd, IPPROTO_TCP, TCP_CONGESTION, name, &name_size), 0);
+    EXPECT_EQ(StringView(name, strlen(name)), "cubic"sv);
+
+    set_congestion_control(connection.client_fd, "reno"sv);
+    name_size = sizeof(name);
+    EXPECT_EQ(getsockopt(connection.client_fd, IPPROTO_TCP, TCP_CONGESTION, name, &name_size), 0);
+    EXPECT_EQ(StringView(name, strlen(name)), "reno"sv);
+
+    EXPECT_EQ(setsockopt(connection.client_fd, IPPROTO_TCP, TCP_CONGESTION, "bogus", 5), -1);
+    EXPECT_EQ(errno, ENOENT);
+
+    close(connection.client_fd);
+    close(connection.server_fd);
+}
@@ -5,7 +5,9 @@
  */
 
 #include <AK/StringView.h>
+#include <AK/Time.h>
 #include <LibTest/TestCase.h>
+#include <syscall.h>
 #include <time.h>
 
 auto const expected_epoch = "Thu Jan  1 00:00:00 1970\n"sv;
@@ -119,3 +121,25 @@ TEST_CASE(tzset)
     EXPECT_EQ(tzname[0], "CET"sv);
     EXPECT_EQ(tzname[1], "CEST"sv);
 }
+
+TEST_CASE(monotonic_clock_from_time_page)
+{
+    // Most of these are served from the kernel's time page without a syscall.
+    timespec previous {};
+    EXPECT_EQ(clock_gettime(CLOCK_MONOTONIC, &previous), 0);
+    for (size_t i = 0; i < 100'000; ++i) {
+        timespec now {};
+        EXPECT_EQ(clock_gettime(CLOCK_MONOTONIC, &now), 0);
+        EXPECT(now.tv_nsec >= 0 && now.tv_nsec < 1'000'000'000);
+        EXPECT(Time::from_timespec(now) >= Time::from_timespec(previous));
+        previous = now;
+    }
+
+    timespec from_kernel {};
+    EXPECT_EQ(syscall(SC_clock_gettime, CLOCK_MONOTONIC, &from_kernel), 0u);
+    timespec from_time_page {};
+    EXPECT_EQ(clock_gettime(CLOCK_MONOTONIC, &from_time_page), 0);
+    // The extrapolated time may lag a little behind the kernel's own.
+    EXPECT(Time::from_timespec(from_time_page) + Time::from_milliseconds(1) >= Time::from_timespec(from_kernel));
+    EXPECT(Time::from_timespec(from_time_page) < Time::from_timespec(from_kernel) + Time::from_milliseconds(100));
+}
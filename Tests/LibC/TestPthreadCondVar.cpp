@@ -0,0 +1,199 @@
+/*
+ * Copyright (c) 2022, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <AK/Atomic.h>
+#include <AK/Vector.h>
+#include <LibTest/TestCase.h>
+#include <pthread.h>
+#include <unistd.h>
+
+static constexpr size_t waiter_count = 32;
+
+struct SharedState {
+    pthread_mutex_t mutex;
+    pthread_cond_t cond;
+    u32 generation { 0 };
+    size_t waiting { 0 };
+    size_t woken { 0 };
+};
+
+static void* wait_for_next_generation(void* argument)
+{
+    auto& state = *static_cast<SharedState*>(argument);
+    pthread_mutex_lock(&state.mutex);
+    u32 generation = state.generation;
+    state.waiting++;
+    while (state.generation == generation)
+        pthread_cond_wait(&state.cond, &state.mutex);
+    state.woken++;
+    pthread_mutex_unlock(&state.mutex);
+    return nullptr;
+}
+
+static void init_state(SharedState& state, int protocol)
+{
+    pthread_mutexattr_t attributes;
+    pthread_mutexattr_init(&attributes);
+    EXPECT_EQ(pthread_mutexattr_setprotocol(&attributes, protocol), 0);
+    pthread_mutex_init(&state.mutex, &attributes);
+    pthread_mutexattr_destroy(&attributes);
+    pthread_cond_init(&state.cond, nullptr);
+}
+
+static Vector<pthread_t> start_waiters(SharedState& state, size_t count)
+{
+    Vector<pthread_t> threads;
+    for (size_t i = 0; i < count; ++i) {
+        pthread_t thread;
+        EXPECT_EQ(pthread_create(&thread, nullptr, wait_for_next_generation, &state), 0);
+        threads.append(thread);
+    }
+
+    // Wait until all of them are blocked in pthread_cond_wait().
+    for (;;) {
+        pthread_mutex_lock(&state.mutex);
+        bool all_waiting = state.waiting == count;
+        pthread_mutex_unlock(&state.mutex);
+        if (all_waiting)
+            break;
+        usleep(1000);
+    }
+    return threads;
+}
+
+static void broadcast_wakes_all_waiters(int protocol)
+{
+    SharedState state;
+    init_state(state, protocol);
+    auto threads = start_waiters(state, waiter_count);
+
+    pthread_mutex_lock(&state.mutex);
+    state.generation++;
+    pthread_cond_broadcast(&state.cond);
+    pthread_mutex_unlock(&state.mutex);
+
+    for (auto thread : threads)
+        EXPECT_EQ(pthread_join(thread, nullptr), 0);
+    EXPECT_EQ(state.woken, waiter_count);
+}
+
+TEST_CASE(broadcast_wakes_all_waiters)
+{
+    broadcast_wakes_all_waiters(PTHREAD_PRIO_NONE);
+}
+
+TEST_CASE(broadcast_wakes_all_waiters_of_priority_inheriting_mutex)
+{
+    broadcast_wakes_all_waiters(PTHREAD_PRIO_INHERIT);
+}
+
+TEST_CASE(priority_inheriting_mutex)
+{
+    pthread_mutexattr_t attributes;
+    pthread_mutexattr_init(&attributes);
+    int protocol = -1;
+    pthread_mutexattr_getprotocol(&attributes, &protocol);
+    EXPECT_EQ(protocol, PTHREAD_PRIO_NONE);
+    EXPECT_EQ(pthread_mutexattr_setprotocol(&attributes, PTHREAD_PRIO_INHERIT), 0);
+    EXPECT_EQ(pthread_mutexattr_settype(&attributes, PTHREAD_MUTEX_RECURSIVE), 0);
+
+    pthread_mutex_t mutex;
+    pthread_mutex_init(&mutex, &attributes);
+    pthread_mutexattr_destroy(&attributes);
+
+    EXPECT_EQ(pthread_mutex_lock(&mutex), 0);
+    EXPECT_EQ(mutex.lock, static_cast<u32>(pthread_self()));
+    EXPECT_EQ(pthread_mutex_trylock(&mutex), 0);
+    EXPECT_EQ(pthread_mutex_unlock(&mutex), 0);
+    EXPECT_EQ(pthread_mutex_unlock(&mutex), 0);
+    EXPECT_EQ(mutex.lock, 0u);
+}
+
+struct Counter {
+    pthread_mutex_t mutex;
+    size_t value { 0 };
+};
+
+static void* increment_counter(void* argument)
+{
+    auto& counter = *static_cast<Counter*>(argument);
+    for (size_t i = 0; i < 10'000; ++i) {
+        pthread_mutex_lock(&counter.mutex);
+        counter.value++;
+        pthread_mutex_unlock(&counter.mutex);
+    }
+    return nullptr;
+}
+
+TEST_CASE(priority_inheriting_mutex_contention)
+{
+    pthread_mutexattr_t attributes;
+    pthread_mutexattr_init(&attributes);
+    pthread_mutexattr_setprotocol(&attributes, PTHREAD_PRIO_INHERIT);
+    Counter counter;
+    pthread_mutex_init(&counter.mutex, &attributes);
+    pthread_mutexattr_destroy(&attributes);
+
+    Vector<pthread_t> threads;
+    for (size_t i = 0; i < 8; ++i) {
+        pthread_t thread;
+        EXPECT_EQ(pthread_create(&thread, nullptr, increment_counter, &counter), 0);
+        threads.append(thread);
+    }
+    for (auto thread : threads)
+        EXPECT_EQ(pthread_join(thread, nullptr), 0);
+    EXPECT_EQ(counter.value, 8 * 10'000u);
+    EXPECT_EQ(counter.mutex.lock, 0u);
+}
+
+BENCHMARK_CASE(broadcast_to_many_waiters)
+{
+    SharedState state;
+    init_state(state, PTHREAD_PRIO_NONE);
+    for (size_t round = 0; round < 100; ++round) {
+        state.waiting = 0;
+        state.woken = 0;
+        auto threads = start_waiters(state, waiter_count);
+
+        pthread_mutex_lock(&state.mutex);
+        state.generation++;
+        pthread_cond_broadcast(&state.cond);
+        pthread_mutex_unlock(&state.mutex);
+
+        for (auto thread : threads)
+            pthread_join(thread, nullptr);
+        EXPECT_EQ(state.woken, waiter_count);
+    }
+}
+
+BENCHMARK_CASE(signal_many_waiters_one_by_one)
+{
+    SharedState state;
+    init_state(state, PTHREAD_PRIO_NONE);
+    for (size_t round = 0; round < 100; ++round) {
+        state.waiting = 0;
+        state.woken = 0;
+        auto threads = start_waiters(state, waiter_count);
+
+        pthread_mutex_lock(&state.mutex);
+        state.generation++;
+        pthread_mutex_unlock(&state.mutex);
+        for (size_t i = 0; i < waiter_count; ++i)
+            pthread_cond_signal(&state.cond);
+
+        // A signal may have been eaten by a waiter that already went away, so keep going until everyone is out.
+        for (;;) {
+            pthread_mutex_lock(&state.mutex);
+            bool all_woken = state.woken == waiter_count;
+            pthread_mutex_unlock(&state.mutex);
+            if (all_woken)
+                break;
+            pthread_cond_signal(&state.cond);
+        }
+        for (auto thread : threads)
+            pthread_join(thread, nullptr);
+    }
+}
@@ -0,0 +1,97 @@
+/*
+ * Copyright (c) 2022, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <LibCore/ElapsedTimer.h>
+#include <LibJS/Interpreter.h>
+#include <LibJS/Runtime/Array.h>
+#include <LibJS/Runtime/GlobalObject.h>
+#include <LibJS/Runtime/VM.h>
+#include <LibJS/Script.h>
+#include <LibTest/TestCase.h>
+
+static JS::ThrowCompletionOr<JS::Value> run(JS::Interpreter& interpreter, StringView source)
+{
+    auto script_or_error = JS::Script::parse(source, interpreter.realm());
+    VERIFY(!script_or_error.is_error());
+    return interpreter.run(*script_or_error.release_value());
+}
+
+static Optional<JS::ElementKind> element_kind_of(JS::Interpreter& interpreter, StringView source)
+{
+    auto result = run(interpreter, source);
+    VERIFY(!result.is_error());
+    auto* storage = result.value().as_object().indexed_properties().simple_storage();
+    if (!storage)
+        return {};
+    return storage->element_kind();
+}
+
+TEST_CASE(element_kinds)
+{
+    auto vm = JS::VM::create();
+    auto interpreter = JS::Interpreter::create<JS::GlobalObject>(*vm);
+
+    EXPECT_EQ(element_kind_of(*interpreter, "[1, 2, 3]"sv), JS::ElementKind::Int32);
+    EXPECT_EQ(element_kind_of(*interpreter, "[1, 2.5, 3]"sv), JS::ElementKind::Double);
+    EXPECT_EQ(element_kind_of(*interpreter, "[1, 2, NaN]"sv), JS::ElementKind::Double);
+    EXPECT_EQ(element_kind_of(*interpreter, "[1, 'foo', 3]"sv), JS::ElementKind::Value);
+    EXPECT_EQ(element_kind_of(*interpreter, "[1, , 3]"sv), JS::ElementKind::Value);
+
+    EXPECT_EQ(element_kind_of(*interpreter, "const a = []; for (let i = 0; i < 100; ++i) a.push(i); a"sv), JS::ElementKind::Int32);
+    EXPECT_EQ(element_kind_of(*interpreter, "const b = [1, 2]; b.push(0.5); b"sv), JS::ElementKind::Double);
+    EXPECT_EQ(element_kind_of(*interpreter, "const c = [1, 2]; c[3] = 4; c"sv), JS::ElementKind::Value);
+    EXPECT_EQ(element_kind_of(*interpreter, "const d = [1, 2, 3]; d.length = 1; d"sv), JS::ElementKind::Int32);
+    EXPECT_EQ(element_kind_of(*interpreter, "[1, 2, 3].fill(0.5, 1)"sv), JS::ElementKind::Double);
+    EXPECT_EQ(element_kind_of(*interpreter, "[1, 2, 3].map(x => x * 2)"sv), JS::ElementKind::Int32);
+    EXPECT_EQ(element_kind_of(*interpreter, "[1, 2, 3].map(x => x / 2)"sv), JS::ElementKind::Double);
+    EXPECT_EQ(element_kind_of(*interpreter, "new Array(3).fill(1)"sv), JS::ElementKind::Value);
+}
+
+static void run_kernel(StringView name, StringView source)
+{
+    auto vm = JS::VM::create();
+    auto interpreter = JS::Interpreter::create<JS::GlobalObject>(*vm);
+
+    auto timer = Core::ElapsedTimer::start_new();
+    auto result = run(*interpreter, source);
+    EXPECT(!result.is_error());
+    outln("{}: {} ms", name, timer.elapsed());
+}
+
+BENCHMARK_CASE(numeric_array_kernels)
+{
+    run_kernel("push"sv, R"(
+        const a = [];
+        for (let i = 0; i < 1000000; ++i)
+            a.push(i);
+    )"sv);
+
+    run_kernel("fill and indexOf"sv, R"(
+        const a = [];
+        for (let i = 0; i < 100000; ++i)
+            a.push(i * 0.5);
+        for (let i = 0; i < 100; ++i) {
+            a.fill(i, 50000);
+            a.indexOf(i);
+        }
+    )"sv);
+
+    run_kernel("map"sv, R"(
+        let a = [];
+        for (let i = 0; i < 100000; ++i)
+            a.push(i);
+        for (let i = 0; i < 10; ++i)
+            a = a.map(x => x + 1);
+    )"sv);
+
+    run_kernel("sort"sv, R"(
+        const a = [];
+        for (let i = 0; i < 100000; ++i)
+            a.push((i * 7919) % 100003);
+        a.sort();
+        a.sort((x, y) => x - y);
+    )"sv);
+}
@@ -139,3 +139,152 @@ TEST_CASE(catch_exception)
                             "if (hitCatch !== true) throw new Exception('failed');\n"
                             "if (hitFinally !== true) throw new Exception('failed');");
 }
+
+TEST_CASE(property_lookup_cache_sees_shape_changes)
+{
+    EXPECT_NO_EXCEPTION_ALL("function get(o) { return o.x; }\n"
+                            "function put(o, v) { o.x = v; }\n"
+                            "var objects = [{ x: 1 }, { a: 0, x: 2 }, { a: 0, b: 0, x: 3 }, { b: 0, x: 4 }, { c: 0, x: 5 }, { d: 0, x: 6 }];\n"
+                            "for (var i = 0; i < 3; ++i) {\n"
+                            "    for (var j = 0; j < objects.length; ++j) {\n"
+                            "        if (get(objects[j]) !== j + 1) throw new Exception('failed');\n"
+                            "        put(objects[j], j + 1);\n"
+                            "    }\n"
+                            "}\n"
+                            "var o = objects[1];\n"
+                            "delete o.a;\n"
+                            "if (get(o) !== 2) throw new Exception('failed');\n"
+                            "Object.defineProperty(o, 'x', { writable: false });\n"
+                            "put(o, 42);\n"
+                            "if (get(o) !== 2) throw new Exception('failed');\n"
+                            "Object.defineProperty(o, 'x', { get() { return 'getter'; } });\n"
+                            "if (get(o) !== 'getter') throw new Exception('failed');");
+}
+
+TEST_CASE(property_lookup_cache_sees_unique_shape_changes)
+{
+    EXPECT_NO_EXCEPTION_ALL("var o = {};\n"
+                            "for (var i = 0; i < 200; ++i) o['p' + i] = i;\n"
+                            "o.x = 1;\n"
+                            "function get() { return o.x; }\n"
+                            "function put(v) { o.x = v; }\n"
+                            "if (get() !== 1) throw new Exception('failed');\n"
+                            "put(2);\n"
+                            "if (get() !== 2) throw new Exception('failed');\n"
+                            "delete o.p0;\n"
+                            "if (get() !== 2) throw new Exception('failed');\n"
+                            "delete o.x;\n"
+                            "if (get() !== undefined) throw new Exception('failed');\n"
+                            "Object.freeze(o);\n"
+                            "put(3);\n"
+                            "if (get() !== undefined) throw new Exception('failed');");
+}
+
+TEST_CASE(property_lookup_cache_sees_prototype_changes)
+{
+    EXPECT_NO_EXCEPTION_ALL("var proto = { x: 1 };\n"
+                            "var o = Object.create(proto);\n"
+                            "function get() { return o.x; }\n"
+                            "for (var i = 0; i < 3; ++i) {\n"
+                            "    if (get() !== 1) throw new Exception('failed');\n"
+                            "}\n"
+                            "proto.x = 2;\n"
+                            "if (get() !== 2) throw new Exception('failed');\n"
+                            "delete proto.x;\n"
+                            "if (get() !== undefined) throw new Exception('failed');\n"
+                            "proto.x = 3;\n"
+                            "if (get() !== 3) throw new Exception('failed');\n"
+                            "Object.setPrototypeOf(o, { x: 4 });\n"
+                            "if (get() !== 4) throw new Exception('failed');\n"
+                            "o.x = 5;\n"
+                            "if (get() !== 5) throw new Exception('failed');\n"
+                            "var deep = Object.create(Object.create({ y: 6 }));\n"
+                            "function get_deep() { return deep.y; }\n"
+                            "if (get_deep() !== 6) throw new Exception('failed');\n"
+                            "Object.getPrototypeOf(Object.getPrototypeOf(deep)).y = 7;\n"
+                            "if (get_deep() !== 7) throw new Exception('failed');");
+}
+
+TEST_CASE(property_lookup_cache_skips_exotic_objects)
+{
+    EXPECT_NO_EXCEPTION_ALL("Uint8Array.prototype.Infinity = 5;\n"
+                            "function get(o) { return o.Infinity; }\n"
+                            "function put(o, v) { o.Infinity = v; }\n"
+                            "get(Object.create(Uint8Array.prototype));\n"
+                            "get(Object.create(Uint8Array.prototype));\n"
+                            "if (get(new Uint8Array(1)) !== undefined) throw new Exception('failed');\n"
+                            "var ordinary = Object.create(Uint8Array.prototype);\n"
+                            "ordinary.Infinity = 1;\n"
+                            "put(ordinary, 2);\n"
+                            "put(ordinary, 3);\n"
+                            "var typed_array = new Uint8Array(1);\n"
+                            "put(typed_array, 4);\n"
+                            "if (get(typed_array) !== undefined || Object.hasOwn(typed_array, 'Infinity')) throw new Exception('failed');\n"
+                            "if (get(Object.create(new Uint8Array(1))) !== undefined) throw new Exception('failed');\n"
+                            "if (get(new Proxy({}, { get() { return 6; } })) !== 6) throw new Exception('failed');");
+}
+
+TEST_CASE(register_allocation_shrinks_register_window)
+{
+    SETUP_AND_PARSE("var a = [1, 2, 3];\n"
+                    "var b = a[0] + a[1] * a[2] - (a[0] + a[1]) * (a[1] + a[2]);\n"
+                    "var c = [a[0], a[1], ...a, b];\n"
+                    "if (b !== -8 || c.length !== 6 || c[5] !== -8) throw new Exception('failed');");
+
+    auto executable = MUST(JS::Bytecode::Generator::generate(program));
+    auto number_of_registers_before_optimizations = executable->number_of_registers;
+    auto& passes = JS::Bytecode::Interpreter::optimization_pipeline();
+    passes.perform(*executable);
+    EXPECT(executable->number_of_registers < number_of_registers_before_optimizations);
+
+    auto result = bytecode_interpreter.run(*executable);
+    EXPECT(!result.is_error());
+}
+
+TEST_CASE(register_allocation_keeps_values_alive_across_blocks)
+{
+    EXPECT_NO_EXCEPTION_ALL("function f(o) {\n"
+                            "    var log = [];\n"
+                            "    for (var i = 0; i < 3; ++i) {\n"
+                            "        try {\n"
+                            "            log.push(o.a[i]);\n"
+                            "            if (i == 1) throw i;\n"
+                            "        } catch (e) {\n"
+                            "            log.push('c' + e);\n"
+                            "        } finally {\n"
+                            "            log.push('f');\n"
+                            "        }\n"
+                            "    }\n"
+                            "    return log.join();\n"
+                            "}\n"
+                            "if (f({ a: [4, 5, 6] }) !== '4,f,5,c1,f,6,f') throw new Exception('failed');\n"
+                            "function* g(n) {\n"
+                            "    for (var i = 0; i < n; ++i) {\n"
+                            "        var x = yield i * 2;\n"
+                            "        if (x) n += x;\n"
+                            "    }\n"
+                            "}\n"
+                            "var it = g(2);\n"
+                            "var values = [it.next().value, it.next(1).value, it.next().value, it.next().value];\n"
+                            "if (values.join() !== '0,2,4,') throw new Exception('failed');\n"
+                            "function sum() {\n"
+                            "    var s = 0;\n"
+                            "    for (var i = 0; i < arguments.length; ++i) s += arguments[i];\n"
+                            "    return s;\n"
+                            "}\n"
+                            "if (sum(1, ...[2, 3], 4) !== 10) throw new Exception('failed');");
+}
+
+BENCHMARK_CASE(property_access)
+{
+    EXPECT_NO_EXCEPTION_ALL("function Point(x, y) { this.x = x; this.y = y; }\n"
+                            "Point.prototype.length = function () { return this.x + this.y; };\n"
+                            "var points = [new Point(1, 2), new Point(3, 4), { x: 5, y: 6, length: Point.prototype.length }];\n"
+                            "var sum = 0;\n"
+                            "for (var i = 0; i < 300000; ++i) {\n"
+                            "    var point = points[i % 3];\n"
+                            "    point.x = point.y;\n"
+                            "    sum += point.length();\n"
+                            "}\n"
+                            "if (sum <= 0) throw new Exception('failed');");
+}
@@ -0,0 +1,281 @@
+/*
+ * Copyright (c) 2022, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <AK/Platform.h>
+#include <AK/TemporaryChange.h>
+#include <LibCore/ElapsedTimer.h>
+#include <LibJS/AST.h>
+#include <LibJS/Bytecode/Generator.h>
+#include <LibJS/Bytecode/Interpreter.h>
+#include <LibJS/Interpreter.h>
+#include <LibJS/JIT/Compiler.h>
+#include <LibJS/Runtime/GlobalObject.h>
+#include <LibJS/Runtime/VM.h>
+#include <LibJS/Script.h>
+#include <LibTest/TestCase.h>
+
+// Runs the source in the bytecode interpreter, compiling every executable the first time it runs.
+static void run_with_jit(StringView source, bool enable_jit = true)
+{
+    TemporaryChange enable { JS::JIT::g_jit_enabled, enable_jit };
+    TemporaryChange threshold { JS::JIT::g_jit_threshold, static_cast<size_t>(0) };
+
+    auto vm = JS::VM::create();
+    auto ast_interpreter = JS::Interpreter::create<JS::GlobalObject>(*vm);
+    auto script_or_error = JS::Script::parse(source, ast_interpreter->realm());
+    EXPECT(!script_or_error.is_error());
+    if (script_or_error.is_error())
+        return;
+
+    auto script = script_or_error.release_value();
+    auto executable = MUST(JS::Bytecode::Generator::generate(script->parse_node()));
+    JS::Bytecode::Interpreter::optimization_pipeline().perform(*executable);
+
+    JS::Bytecode::Interpreter bytecode_interpreter(ast_interpreter->realm());
+    auto result = bytecode_interpreter.run(*executable);
+    EXPECT(!result.is_error());
+    if (result.is_error())
+        dbgln("Error: {}", MUST(result.throw_completion().value()->to_string(*vm)));
+
+#if ARCH(X86_64)
+    EXPECT_EQ(executable->native_executable != nullptr, enable_jit);
+#endif
+}
+
+TEST_CASE(int32_arithmetic)
+{
+    run_with_jit(R"~~~(
+        function sum(n) {
+            let total = 0;
+            for (let i = 0; i < n; ++i)
+                total = total + i;
+            return total;
+        }
+        if (sum(100) !== 4950)
+            throw new Error("sum(100)");
+        if (sum(100000) !== 4999950000)
+            throw new Error("sum overflowed wrongly");
+
+        let x = 2147483647;
+        x++;
+        if (x !== 2147483648)
+            throw new Error("increment overflow");
+        let y = -2147483648;
+        y--;
+        if (y !== -2147483649)
+            throw new Error("decrement overflow");
+
+        if (!Object.is(0 * -5, -0) || !Object.is(-5 * 0, -0))
+            throw new Error("multiplication must produce -0");
+        if ((65536 * 65536) !== 4294967296)
+            throw new Error("multiplication overflow");
+        if ((6 & 3) !== 2 || (6 | 3) !== 7 || (6 ^ 3) !== 5)
+            throw new Error("bitwise ops");
+        if (-2147483648 - 1 !== -2147483649)
+            throw new Error("subtraction overflow");
+    )~~~"sv);
+}
+
+TEST_CASE(slow_cases)
+{
+    run_with_jit(R"~~~(
+        if ("a" + 1 !== "a1" || 1.5 + 1 !== 2.5 || 10n - 1n !== 9n)
+            throw new Error("add/sub on other types");
+        let counter = { valueOf() { return 41; } };
+        counter++;
+        if (counter !== 42)
+            throw new Error("increment of an object");
+        if (!(1 < 1.5) || "b" < "a" || !(2 >= 2) || 3 <= 2)
+            throw new Error("comparisons");
+        if (1 === 1.5 || !(NaN !== NaN) || 1 !== 1.0)
+            throw new Error("strict equality");
+        let truthy = 0;
+        for (const value of [1, -1, "x", {}, true, 0.5, 1n])
+            if (value) ++truthy;
+        for (const value of [0, -0, "", null, undefined, false, NaN, 0n])
+            if (value) ++truthy;
+        if (truthy !== 7)
+            throw new Error("conditional jumps");
+        if ((null ?? 1) !== 1 || (0 ?? 1) !== 0)
+            throw new Error("nullish jumps");
+        const { a = 5, b = 6 } = { b: 1 };
+        if (a !== 5 || b !== 1)
+            throw new Error("undefined jumps");
+    )~~~"sv);
+}
+
+TEST_CASE(exceptions)
+{
+    run_with_jit(R"~~~(
+        function thrower(value) {
+            if (value > 2)
+                throw new Error("too big");
+            return value;
+        }
+        function catcher() {
+            let caught = 0;
+            for (let i = 0; i < 5; ++i) {
+                try {
+                    thrower(i);
+                } catch (e) {
+                    ++caught;
+                } finally {
+                    caught += 10;
+                }
+            }
+            return caught;
+        }
+        if (catcher() !== 52)
+            throw new Error("try/catch/finally in native code");
+
+        let propagated = false;
+        try {
+            (function () { null.foo; })();
+        } catch (e) {
+            propagated = e instanceof TypeError;
+        }
+        if (!propagated)
+            throw new Error("exception from a callee");
+    )~~~"sv);
+}
+
+TEST_CASE(properties_and_generators)
+{
+    run_with_jit(R"~~~(
+        function Point(x, y) {
+            this.x = x;
+            this.y = y;
+        }
+        let sum = 0;
+        for (let i = 0; i < 100; ++i) {
+            const point = i % 2 ? new Point(i, 1) : { y: 1, x: i };
+            point.x = point.x + point.y;
+            sum = sum + point.x;
+        }
+        if (sum !== 5050)
+            throw new Error("GetById/PutById");
+
+        function* counter(n) {
+            for (let i = 0; i < n; ++i)
+                yield i;
+            return "done";
+        }
+        let total = 0;
+        for (const value of counter(10))
+            total += value;
+        if (total !== 45)
+            throw new Error("generators");
+    )~~~"sv);
+}
+
+TEST_CASE(inline_property_caches)
+{
+    run_with_jit(R"~~~(
+        function getX(object) { return object.x; }
+        function setX(object, value) { object.x = value; }
+
+        // Own properties, and a shape that changes in place once it has become unique.
+        const object = { x: 1 };
+        for (let i = 0; i < 10; ++i)
+            setX(object, getX(object) + 1);
+        if (getX(object) !== 11)
+            throw new Error("own property");
+        for (let i = 0; i < 200; ++i)
+            object["p" + i] = i;
+        delete object.x;
+        if (getX(object) !== undefined)
+            throw new Error("deleted property");
+        object.x = 5;
+        if (getX(object) !== 5)
+            throw new Error("re-added property");
+
+        // Properties on the prototype, which the object itself can shadow.
+        function Base() {}
+        Base.prototype.x = "proto";
+        const derived = new Base();
+        for (let i = 0; i < 3; ++i)
+            if (getX(derived) !== "proto")
+                throw new Error("prototype property");
+        Base.prototype.x = "changed";
+        if (getX(derived) !== "changed")
+            throw new Error("changed prototype property");
+        Object.setPrototypeOf(derived, { x: "other" });
+        if (getX(derived) !== "other")
+            throw new Error("new prototype");
+        setX(derived, "own");
+        if (getX(derived) !== "own")
+            throw new Error("shadowing property");
+
+        // Accessors and exotic objects always take the slow path.
+        let setter_calls = 0;
+        const accessor = { get x() { return "getter"; }, set x(value) { ++setter_calls; } };
+        setX(accessor, 1);
+        if (getX(accessor) !== "getter" || setter_calls !== 1)
+            throw new Error("accessor");
+        const frozen = Object.freeze({ x: 1 });
+        setX(frozen, 2);
+        if (getX(frozen) !== 1)
+            throw new Error("non-writable property");
+        if (getX([1, 2]) !== undefined || getX("string") !== undefined || getX(new Proxy({}, { get() { return "proxy"; } })) !== "proxy")
+            throw new Error("exotic objects and primitives");
+    )~~~"sv);
+}
+
+TEST_CASE(disabled)
+{
+    run_with_jit("let x = 1 + 2;"sv, false);
+}
+
+static void run_kernel(StringView name, StringView source)
+{
+    for (auto enable_jit : { false, true }) {
+        TemporaryChange enable { JS::JIT::g_jit_enabled, enable_jit };
+        TemporaryChange threshold { JS::JIT::g_jit_threshold, static_cast<size_t>(0) };
+
+        auto vm = JS::VM::create();
+        auto ast_interpreter = JS::Interpreter::create<JS::GlobalObject>(*vm);
+        auto script = MUST(JS::Script::parse(source, ast_interpreter->realm()));
+        auto executable = MUST(JS::Bytecode::Generator::generate(script->parse_node()));
+        JS::Bytecode::Interpreter::optimization_pipeline().perform(*executable);
+        JS::Bytecode::Interpreter bytecode_interpreter(ast_interpreter->realm());
+
+        auto timer = Core::ElapsedTimer::start_new();
+        auto result = bytecode_interpreter.run(*executable);
+        EXPECT(!result.is_error());
+        outln("{} ({}): {} ms", name, enable_jit ? "jit" : "interpreter", timer.elapsed());
+    }
+}
+
+BENCHMARK_CASE(int32_kernels)
+{
+    run_kernel("loop"sv, R"~~~(
+        function loop(n) {
+            let total = 0;
+            for (let i = 0; i < n; ++i)
+                total = (total + (i & 255)) | 0;
+            return total;
+        }
+        for (let i = 0; i < 20; ++i)
+            loop(200000);
+    )~~~"sv);
+
+    run_kernel("fib"sv, R"~~~(
+        function fib(n) {
+            return n < 2 ? n : fib(n - 1) + fib(n - 2);
+        }
+        fib(25);
+    )~~~"sv);
+
+    run_kernel("properties"sv, R"~~~(
+        function step(point) {
+            point.x = point.x + point.dx;
+            point.y = point.y + point.dy;
+        }
+        const point = { x: 0, y: 0, dx: 1, dy: 2 };
+        for (let i = 0; i < 300000; ++i)
+            step(point);
+    )~~~"sv);
+}
@@ -41,6 +41,8 @@ Profile::Profile(Vector<Process> processes, Vector<Event> events)
     for (size_t i = 0; i < m_events.size(); ++i) {
         if (m_events[i].data.has<Event::SignpostData>())
             m_signpost_indices.append(i);
+        if (auto const* counter_data = m_events[i].data.get_pointer<Event::HardwareCounterData>(); counter_data && !m_hardware_counters.contains_slow(counter_data->counter))
+            m_hardware_counters.append(counter_data->counter);
     }
 
     m_first_timestamp = m_events.first().timestamp;
@@ -122,6 +124,14 @@ void Profile::rebuild_tree()
             continue;
         }
 
+        // Samples of different counters (or the timer) don't add up to anything meaningful.
+        if (auto const* counter_data = event.data.get_pointer<Event::HardwareCounterData>()) {
+            if (!m_hardware_counter_filter.has_value() || m_hardware_counter_filter.value() != counter_data->counter)
+                continue;
+        } else if (m_hardware_counter_filter.has_value()) {
+            continue;
+        }
+
         m_filtered_event_indices.append(event_index);
 
         if (auto* malloc_data = event.data.get_pointer<Event::MallocData>(); malloc_data && !live_allocations.contains(malloc_data->ptr))
@@ -387,6 +397,11 @@ ErrorOr<NonnullOwnPtr<Profile>> Profile::load_from_perfcore_file(StringView path
             if (it != current_processes.end())
                 it->value->handle_thread_exit(event.tid, event.serial);
             continue;
+        } else if (type_string.is_one_of("cpu_cycles"sv, "instructions"sv, "cache_misses"sv, "branch_misses"sv)) {
+            event.data = Event::HardwareCounterData {
+                .counter = type_string,
+                .period = perf_event.get("period"sv).to_number<u32>(),
+            };
         } else if (type_string == "read"sv) {
             auto const string_index = perf_event.get("filename_index"sv).to_number<FlatPtr>();
             event.data = Event::ReadData {
@@ -542,6 +557,18 @@ bool Profile::process_filter_contains(pid_t pid, EventSerialNumber serial)
         [&](auto const& process_filter) { return pid == process_filter.pid && serial >= process_filter.start_valid && serial <= process_filter.end_valid; });
 }
 
+void Profile::set_hardware_counter_filter(Optional<String> counter)
+{
+    if (m_hardware_counter_filter == counter)
+        return;
+    m_hardware_counter_filter = move(counter);
+
+    rebuild_tree();
+    if (m_disassembly_model)
+        m_disassembly_model->invalidate();
+    m_samples_model->invalidate();
+}
+
 void Profile::set_inverted(bool inverted)
 {
     if (m_inverted == inverted)
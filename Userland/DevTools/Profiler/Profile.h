@@ -231,7 +231,14 @@ public:
             bool success;
         };
 
-        Variant<std::nullptr_t, SampleData, MallocData, FreeData, SignpostData, MmapData, MunmapData, ProcessCreateData, ProcessExecData, ThreadCreateData, ReadData> data { nullptr };
+        struct HardwareCounterData {
+            // The event type in the perfcore file, e.g. "cache_misses".
+            String counter;
+            // How many times the counter went up since the previous sample.
+            u32 period {};
+        };
+
+        Variant<std::nullptr_t, SampleData, MallocData, FreeData, SignpostData, MmapData, MunmapData, ProcessCreateData, ProcessExecData, ThreadCreateData, ReadData, HardwareCounterData> data { nullptr };
     };
 
     Vector<Event> const& events() const { return m_events; }
@@ -253,6 +260,11 @@ public:
     bool has_process_filter() const { return !m_process_filters.is_empty(); }
     bool process_filter_contains(pid_t pid, EventSerialNumber serial);
 
+    // The hardware counters that were sampled, the tree is built from one of them or from everything else.
+    Vector<String> const& hardware_counters() const { return m_hardware_counters; }
+    Optional<String> const& hardware_counter_filter() const { return m_hardware_counter_filter; }
+    void set_hardware_counter_filter(Optional<String>);
+
     bool is_inverted() const { return m_inverted; }
     void set_inverted(bool);
 
@@ -317,6 +329,9 @@ private:
 
     Vector<ProcessFilter> m_process_filters;
 
+    Vector<String> m_hardware_counters;
+    Optional<String> m_hardware_counter_filter;
+
     NonnullRefPtr<FileEventNode> m_file_event_nodes;
 
     bool m_inverted { false };
@@ -20,6 +20,7 @@
 #include <LibCore/Timer.h>
 #include <LibDesktop/Launcher.h>
 #include <LibGUI/Action.h>
+#include <LibGUI/ActionGroup.h>
 #include <LibGUI/Application.h>
 #include <LibGUI/BoxLayout.h>
 #include <LibGUI/Button.h>
@@ -41,14 +42,29 @@
 
 using namespace Profiler;
 
-static bool generate_profile(pid_t& pid);
+static bool generate_profile(pid_t& pid, bool sample_hardware_counters);
+
+static StringView hardware_counter_title(StringView counter)
+{
+    if (counter == "cpu_cycles"sv)
+        return "&Cycles"sv;
+    if (counter == "instructions"sv)
+        return "&Instructions"sv;
+    if (counter == "cache_misses"sv)
+        return "C&ache Misses"sv;
+    if (counter == "branch_misses"sv)
+        return "&Branch Misses"sv;
+    return counter;
+}
 
 ErrorOr<int> serenity_main(Main::Arguments arguments)
 {
     int pid = 0;
     char const* perfcore_file_arg = nullptr;
+    bool sample_hardware_counters = false;
     Core::ArgsParser args_parser;
     args_parser.add_option(pid, "PID to profile", "pid", 'p', "PID");
+    args_parser.add_option(sample_hardware_counters, "Also sample the hardware performance counters of the CPU", "hardware-counters", 'c');
     args_parser.add_positional_argument(perfcore_file_arg, "Path of perfcore file", "perfcore-file", Core::ArgsParser::Required::No);
     args_parser.parse(arguments);
 
@@ -62,7 +78,7 @@ ErrorOr<int> serenity_main(Main::Arguments arguments)
 
     String perfcore_file;
     if (!perfcore_file_arg) {
-        if (!generate_profile(pid))
+        if (!generate_profile(pid, sample_hardware_counters))
             return 0;
         perfcore_file = String::formatted("/proc/{}/perf_events", pid);
     } else {
@@ -299,6 +315,28 @@ ErrorOr<int> serenity_main(Main::Arguments arguments)
     TRY(view_menu->try_add_action(disassembly_action));
     TRY(view_menu->try_add_action(source_action));
 
+    GUI::ActionGroup event_actions;
+    event_actions.set_exclusive(true);
+    if (!profile->hardware_counters().is_empty()) {
+        TRY(view_menu->try_add_separator());
+        auto events_menu = TRY(view_menu->try_add_submenu("&Events"));
+
+        auto timer_samples_action = GUI::Action::create_checkable("&Timer Samples", [&](auto&) {
+            profile->set_hardware_counter_filter({});
+        });
+        timer_samples_action->set_checked(true);
+        event_actions.add_action(*timer_samples_action);
+        TRY(events_menu->try_add_action(timer_samples_action));
+
+        for (auto const& counter : profile->hardware_counters()) {
+            auto counter_action = GUI::Action::create_checkable(hardware_counter_title(counter), [&profile, counter](auto&) {
+                profile->set_hardware_counter_filter(counter);
+            });
+            event_actions.add_action(*counter_action);
+            TRY(events_menu->try_add_action(counter_action));
+        }
+    }
+
     auto help_menu = TRY(window->try_add_menu("&Help"));
     TRY(help_menu->try_add_action(GUI::CommonActions::make_command_palette_action(window)));
     TRY(help_menu->try_add_action(GUI::CommonActions::make_help_action([](auto&) {
@@ -340,7 +378,7 @@ static bool prompt_to_stop_profiling(pid_t pid, String const& process_name)
     return GUI::Application::the()->exec() == 0;
 }
 
-bool generate_profile(pid_t& pid)
+bool generate_profile(pid_t& pid, bool sample_hardware_counters)
 {
     if (!pid) {
         auto process_chooser = GUI::ProcessChooser::construct("Profiler"sv, "Profile"sv, Gfx::Bitmap::try_load_from_file("/res/icons/16x16/app-profiler.png"sv).release_value_but_fixme_should_propagate_errors());
@@ -362,8 +400,10 @@ bool generate_profile(pid_t& pid)
         process_name = "(unknown)";
     }
 
-    static constexpr u64 event_mask = PERF_EVENT_SAMPLE | PERF_EVENT_MMAP | PERF_EVENT_MUNMAP | PERF_EVENT_PROCESS_CREATE
+    u64 event_mask = PERF_EVENT_SAMPLE | PERF_EVENT_MMAP | PERF_EVENT_MUNMAP | PERF_EVENT_PROCESS_CREATE
         | PERF_EVENT_PROCESS_EXEC | PERF_EVENT_PROCESS_EXIT | PERF_EVENT_THREAD_CREATE | PERF_EVENT_THREAD_EXIT;
+    if (sample_hardware_counters)
+        event_mask |= PERF_EVENT_HARDWARE_COUNTERS;
 
     if (profiling_enable(pid, event_mask) < 0) {
         int saved_errno = errno;
@@ -181,6 +181,9 @@ u32 Emulator::virt_syscall(u32 function, u32 arg1, u32 arg2, u32 arg3)
         return virt$pledge(arg1);
     case SC_poll:
         return virt$poll(arg1);
+    case SC_posix_spawn:
+        // NOTE: LibC falls back to fork() and execve(), which we know how to emulate.
+        return -ENOSYS;
     case SC_profiling_disable:
         return virt$profiling_disable(arg1);
     case SC_profiling_enable:
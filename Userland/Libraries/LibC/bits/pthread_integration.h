@@ -26,6 +26,10 @@ void __pthread_key_destroy_for_current_thread(void);
 
 #define __PTHREAD_MUTEX_NORMAL 0
 #define __PTHREAD_MUTEX_RECURSIVE 1
+#define __PTHREAD_PRIO_NONE 0
+#define __PTHREAD_PRIO_INHERIT 1
+#define __PTHREAD_PRIO_PROTECT 2
+
 #define __PTHREAD_MUTEX_INITIALIZER     \
     {                                   \
         0, 0, 0, __PTHREAD_MUTEX_NORMAL \
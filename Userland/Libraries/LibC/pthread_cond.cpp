@@ -155,7 +155,24 @@ int pthread_cond_broadcast(pthread_cond_t* cond)
     pthread_mutex_t* mutex = AK::atomic_load(&cond->mutex, AK::memory_order_relaxed);
     VERIFY(mutex);
 
-    int rc = futex(&cond->value, FUTEX_REQUEUE | FUTEX_PRIVATE_FLAG, 1, nullptr, &mutex->lock, INT_MAX);
-    VERIFY(rc >= 0);
-    return 0;
+    // The lock of a priority-inheriting mutex only ever contains the TID of its owner, so
+    // nobody can be waiting on it without the kernel knowing. Just wake everyone up instead.
+    if (mutex->protocol == PTHREAD_PRIO_INHERIT) {
+        int rc = futex_wake(&cond->value, INT_MAX, false);
+        VERIFY(rc >= 0);
+        return 0;
+    }
+
+    // Wake up one waiter, and move the rest over to the mutex, so they don't all wake up
+    // just to fight over it. They'll be woken up one by one as the mutex gets unlocked,
+    // which works because they lock it with __pthread_mutex_lock_pessimistic_np().
+    // Since somebody might start waiting in the meantime, make the kernel check that the
+    // value is still what we expect, and start over if it isn't.
+    for (;;) {
+        value = AK::atomic_load(&cond->value, AK::memory_order_relaxed);
+        int rc = futex(&cond->value, FUTEX_CMP_REQUEUE | FUTEX_PRIVATE_FLAG, 1, reinterpret_cast<timespec const*>(INT_MAX), &mutex->lock, value);
+        if (rc >= 0)
+            return 0;
+        VERIFY(errno == EAGAIN);
+    }
 }
@@ -104,12 +104,59 @@ int pthread_mutex_init(pthread_mutex_t* mutex, pthread_mutexattr_t const* attrib
     mutex->owner = 0;
     mutex->level = 0;
     mutex->type = attributes ? attributes->type : __PTHREAD_MUTEX_NORMAL;
+    mutex->protocol = attributes ? attributes->protocol : __PTHREAD_PRIO_NONE;
+    return 0;
+}
+
+// A priority-inheriting mutex contains the TID of its owner (and FUTEX_WAITERS) instead,
+// so the kernel knows whose priority to raise while somebody is waiting for it.
+static int pi_mutex_lock(pthread_mutex_t* mutex, bool try_only)
+{
+    u32 tid = pthread_self();
+    u32 value = MUTEX_UNLOCKED;
+    if (AK::atomic_compare_exchange_strong(&mutex->lock, value, tid, AK::memory_order_acquire)) [[likely]] {
+        mutex->level = 0;
+        return 0;
+    }
+    if (mutex->type == __PTHREAD_MUTEX_RECURSIVE && (value & FUTEX_TID_MASK) == tid) {
+        mutex->level++;
+        return 0;
+    }
+
+    // The kernel takes the mutex for us, and hands it over directly when it gets unlocked.
+    int op = (try_only ? FUTEX_TRYLOCK_PI : FUTEX_LOCK_PI) | FUTEX_PRIVATE_FLAG;
+    while (futex(&mutex->lock, op, 0, nullptr, nullptr, 0) < 0) {
+        if (errno == EINTR)
+            continue;
+        if (try_only && errno == EAGAIN)
+            return EBUSY;
+        return errno;
+    }
+    mutex->level = 0;
+    return 0;
+}
+
+static int pi_mutex_unlock(pthread_mutex_t* mutex)
+{
+    if (mutex->type == __PTHREAD_MUTEX_RECURSIVE && mutex->level > 0) {
+        mutex->level--;
+        return 0;
+    }
+
+    u32 value = pthread_self();
+    if (AK::atomic_compare_exchange_strong(&mutex->lock, value, MUTEX_UNLOCKED, AK::memory_order_release)) [[likely]]
+        return 0;
+    if (futex(&mutex->lock, FUTEX_UNLOCK_PI | FUTEX_PRIVATE_FLAG, 0, nullptr, nullptr, 0) < 0)
+        return errno;
     return 0;
 }
 
 // https://pubs.opengroup.org/onlinepubs/009695399/functions/pthread_mutex_trylock.html
 int pthread_mutex_trylock(pthread_mutex_t* mutex)
 {
+    if (mutex->protocol == __PTHREAD_PRIO_INHERIT) [[unlikely]]
+        return pi_mutex_lock(mutex, true);
+
     u32 expected = MUTEX_UNLOCKED;
     bool exchanged = AK::atomic_compare_exchange_strong(&mutex->lock, expected, MUTEX_LOCKED_NO_NEED_TO_WAKE, AK::memory_order_acquire);
 
@@ -132,6 +179,9 @@ int pthread_mutex_trylock(pthread_mutex_t* mutex)
 // https://pubs.opengroup.org/onlinepubs/009695399/functions/pthread_mutex_lock.html
 int pthread_mutex_lock(pthread_mutex_t* mutex)
 {
+    if (mutex->protocol == __PTHREAD_PRIO_INHERIT) [[unlikely]]
+        return pi_mutex_lock(mutex, false);
+
     // Fast path: attempt to claim the mutex without waiting.
     u32 value = MUTEX_UNLOCKED;
     bool exchanged = AK::atomic_compare_exchange_strong(&mutex->lock, value, MUTEX_LOCKED_NO_NEED_TO_WAKE, AK::memory_order_acquire);
@@ -170,6 +220,9 @@ int __pthread_mutex_lock_pessimistic_np(pthread_mutex_t* mutex)
     // Same as pthread_mutex_lock(), but always set MUTEX_LOCKED_NEED_TO_WAKE,
     // and also don't bother checking for already owning the mutex recursively,
     // because we know we don't. Used in the condition variable implementation.
+    if (mutex->protocol == __PTHREAD_PRIO_INHERIT) [[unlikely]]
+        return pi_mutex_lock(mutex, false);
+
     u32 value = AK::atomic_exchange(&mutex->lock, MUTEX_LOCKED_NEED_TO_WAKE, AK::memory_order_acquire);
     while (value != MUTEX_UNLOCKED) {
         futex_wait(&mutex->lock, value, nullptr, 0, false);
@@ -185,6 +238,9 @@ int __pthread_mutex_lock_pessimistic_np(pthread_mutex_t* mutex)
 // https://pubs.opengroup.org/onlinepubs/009695399/functions/pthread_mutex_unlock.html
 int pthread_mutex_unlock(pthread_mutex_t* mutex)
 {
+    if (mutex->protocol == __PTHREAD_PRIO_INHERIT) [[unlikely]]
+        return pi_mutex_unlock(mutex);
+
     if (mutex->type == __PTHREAD_MUTEX_RECURSIVE && mutex->level > 0) {
         mutex->level--;
         return 0;
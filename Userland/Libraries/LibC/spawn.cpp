@@ -14,17 +14,26 @@
 #include <spawn.h>
 
 #include <AK/Function.h>
+#include <AK/String.h>
 #include <AK/Vector.h>
+#include <LibCore/File.h>
 #include <errno.h>
 #include <fcntl.h>
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
 #include <sys/stat.h>
 #include <sys/types.h>
+#include <syscall.h>
 #include <unistd.h>
 
 struct posix_spawn_file_actions_state {
     Vector<Function<int()>, 4> actions;
+
+    // The kernel can only apply some of the file actions itself. If there are others,
+    // we have to fork() and apply them in the child instead.
+    Vector<Syscall::SC_posix_spawn_file_action, 4> kernel_actions;
+    bool can_spawn_in_kernel { true };
 };
 
 extern "C" {
@@ -99,9 +108,54 @@ extern "C" {
     _exit(127);
 }
 
+// Creates the child without cloning our address space first, which fork() would do in vain.
+// Returns an empty Optional if the kernel can't apply all of the file actions and attributes.
+static Optional<int> spawn_in_kernel(pid_t* out_pid, char const* path, posix_spawn_file_actions_t const* file_actions, posix_spawnattr_t const* attr, char* const argv[], char* const envp[])
+{
+    if (file_actions && !file_actions->state->can_spawn_in_kernel)
+        return {};
+    if (attr && (attr->flags & ~(POSIX_SPAWN_SETSIGDEF | POSIX_SPAWN_SETSIGMASK)))
+        return {};
+
+    auto copy_strings = [](char* const strings[], Vector<Syscall::StringArgument, 32>& output) {
+        for (size_t i = 0; strings[i]; ++i)
+            output.append({ strings[i], strlen(strings[i]) });
+    };
+    Vector<Syscall::StringArgument, 32> arguments;
+    copy_strings(argv, arguments);
+    Vector<Syscall::StringArgument, 32> environment;
+    copy_strings(envp, environment);
+
+    Syscall::SC_posix_spawn_params params {};
+    params.path = { path, strlen(path) };
+    params.arguments = { arguments.data(), arguments.size() };
+    params.environment = { environment.data(), environment.size() };
+    if (file_actions) {
+        params.file_actions = file_actions->state->kernel_actions.data();
+        params.file_action_count = file_actions->state->kernel_actions.size();
+    }
+    if (attr) {
+        params.set_signal_default = attr->flags & POSIX_SPAWN_SETSIGDEF;
+        params.set_signal_mask = attr->flags & POSIX_SPAWN_SETSIGMASK;
+        params.signal_default = attr->sigdefault;
+        params.signal_mask = attr->sigmask;
+    }
+
+    int rc = syscall(SC_posix_spawn, &params);
+    if (rc == -ENOSYS)
+        return {};
+    if (rc < 0)
+        return -rc;
+    *out_pid = rc;
+    return 0;
+}
+
 // https://pubs.opengroup.org/onlinepubs/9699919799/functions/posix_spawn.html
 int posix_spawn(pid_t* out_pid, char const* path, posix_spawn_file_actions_t const* file_actions, posix_spawnattr_t const* attr, char* const argv[], char* const envp[])
 {
+    if (auto result = spawn_in_kernel(out_pid, path, file_actions, attr, argv, envp); result.has_value())
+        return result.value();
+
     pid_t child_pid = fork();
     if (child_pid < 0)
         return errno;
@@ -117,6 +171,23 @@ int posix_spawn(pid_t* out_pid, char const* path, posix_spawn_file_actions_t con
 // https://pubs.opengroup.org/onlinepubs/9699919799/functions/posix_spawnp.html
 int posix_spawnp(pid_t* out_pid, char const* file, posix_spawn_file_actions_t const* file_actions, posix_spawnattr_t const* attr, char* const argv[], char* const envp[])
 {
+    if (strchr(file, '/'))
+        return posix_spawn(out_pid, file, file_actions, attr, argv, envp);
+
+    // NOTE: This searches PATH the same way execvpe() does.
+    String path = getenv("PATH");
+    if (path.is_empty())
+        path = DEFAULT_PATH;
+    Optional<int> result;
+    for (auto& part : path.split(':')) {
+        auto candidate = String::formatted("{}/{}", part, file);
+        result = spawn_in_kernel(out_pid, candidate.characters(), file_actions, attr, argv, envp);
+        if (!result.has_value() || result.value() != ENOENT)
+            break;
+    }
+    if (result.has_value())
+        return result.value();
+
     pid_t child_pid = fork();
     if (child_pid < 0)
         return errno;
@@ -133,12 +204,14 @@ int posix_spawnp(pid_t* out_pid, char const* file, posix_spawn_file_actions_t co
 int posix_spawn_file_actions_addchdir(posix_spawn_file_actions_t* actions, char const* path)
 {
     actions->state->actions.append([path]() { return chdir(path); });
+    actions->state->can_spawn_in_kernel = false;
     return 0;
 }
 
 int posix_spawn_file_actions_addfchdir(posix_spawn_file_actions_t* actions, int fd)
 {
     actions->state->actions.append([fd]() { return fchdir(fd); });
+    actions->state->can_spawn_in_kernel = false;
     return 0;
 }
 
@@ -146,6 +219,7 @@ int posix_spawn_file_actions_addfchdir(posix_spawn_file_actions_t* actions, int
 int posix_spawn_file_actions_addclose(posix_spawn_file_actions_t* actions, int fd)
 {
     actions->state->actions.append([fd]() { return close(fd); });
+    actions->state->kernel_actions.append({ Syscall::SC_posix_spawn_file_action::Type::Close, fd, -1 });
     return 0;
 }
 
@@ -153,6 +227,7 @@ int posix_spawn_file_actions_addclose(posix_spawn_file_actions_t* actions, int f
 int posix_spawn_file_actions_adddup2(posix_spawn_file_actions_t* actions, int old_fd, int new_fd)
 {
     actions->state->actions.append([old_fd, new_fd]() { return dup2(old_fd, new_fd); });
+    actions->state->kernel_actions.append({ Syscall::SC_posix_spawn_file_action::Type::Dup2, old_fd, new_fd });
     return 0;
 }
 
@@ -167,6 +242,7 @@ int posix_spawn_file_actions_addopen(posix_spawn_file_actions_t* actions, int wa
             return rc;
         return close(opened_fd);
     });
+    actions->state->can_spawn_in_kernel = false;
     return 0;
 }
 
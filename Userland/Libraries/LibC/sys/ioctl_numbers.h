@@ -128,6 +128,8 @@ enum IOCtlNumber {
     KCOV_SETBUFSIZE,
     KCOV_ENABLE,
     KCOV_DISABLE,
+    SAMPLING_IOCTL_ENABLE,
+    SAMPLING_IOCTL_DISABLE,
     SOUNDCARD_IOCTL_SET_SAMPLE_RATE,
     SOUNDCARD_IOCTL_GET_SAMPLE_RATE,
     STORAGE_DEVICE_GET_SIZE,
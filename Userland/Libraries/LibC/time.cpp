@@ -435,33 +435,58 @@ clock_t clock()
 static Kernel::TimePage* get_kernel_time_page()
 {
     static Kernel::TimePage* s_kernel_time_page;
-    // FIXME: Thread safety
-    if (!s_kernel_time_page) {
+    auto* kernel_time_page = AK::atomic_load(&s_kernel_time_page, AK::memory_order_acquire);
+    if (!kernel_time_page) {
         auto rc = syscall(SC_map_time_page);
         if ((int)rc < 0 && (int)rc > -EMAXERRNO) {
             errno = -(int)rc;
             return nullptr;
         }
-        s_kernel_time_page = (Kernel::TimePage*)rc;
+        // If another thread got here first, keep its mapping around instead; the second one is just wasted.
+        Kernel::TimePage* expected = nullptr;
+        kernel_time_page = (Kernel::TimePage*)rc;
+        if (!AK::atomic_compare_exchange_strong(&s_kernel_time_page, expected, kernel_time_page, AK::memory_order_acq_rel))
+            kernel_time_page = expected;
     }
-    return s_kernel_time_page;
+    return kernel_time_page;
+}
+
+// Returns false if the kernel has to be asked instead.
+static bool read_kernel_time_page(Kernel::TimePage const& kernel_time_page, clockid_t clock_id, struct timespec& ts)
+{
+    u32 update_iteration;
+    do {
+        update_iteration = AK::atomic_load(&kernel_time_page.update1, AK::memory_order_acquire);
+        ts = kernel_time_page.clocks[clock_id];
+        if (Kernel::time_page_extrapolates(clock_id)) {
+#if ARCH(I386) || ARCH(X86_64)
+            if (kernel_time_page.tsc_to_ns_multiplier == 0)
+                return false;
+            u64 tsc_delta = __builtin_ia32_rdtsc() - kernel_time_page.tsc_base;
+            if (tsc_delta > kernel_time_page.tsc_delta_limit)
+                return false;
+            u64 nanoseconds = ts.tv_nsec + ((tsc_delta * kernel_time_page.tsc_to_ns_multiplier) >> Kernel::time_page_tsc_shift);
+            ts.tv_sec += nanoseconds / 1'000'000'000;
+            ts.tv_nsec = nanoseconds % 1'000'000'000;
+#else
+            return false;
+#endif
+        }
+    } while (update_iteration != AK::atomic_load(&kernel_time_page.update2, AK::memory_order_acquire));
+    return true;
 }
 
 int clock_gettime(clockid_t clock_id, struct timespec* ts)
 {
-    if (Kernel::time_page_supports(clock_id)) {
+    if (Kernel::time_page_supports(clock_id) || Kernel::time_page_extrapolates(clock_id)) {
         if (!ts) {
             errno = EFAULT;
             return -1;
         }
 
         if (auto* kernel_time_page = get_kernel_time_page()) {
-            u32 update_iteration;
-            do {
-                update_iteration = AK::atomic_load(&kernel_time_page->update1, AK::memory_order_acquire);
-                *ts = kernel_time_page->clocks[clock_id];
-            } while (update_iteration != AK::atomic_load(&kernel_time_page->update2, AK::memory_order_acquire));
-            return 0;
+            if (read_kernel_time_page(*kernel_time_page, clock_id, *ts))
+                return 0;
         }
     }
 
@@ -0,0 +1,188 @@
+/*
+ * Copyright (c) 2022, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <AK/Atomic.h>
+#include <LibCore/EventLoop.h>
+#include <LibCore/IORing.h>
+#include <LibCore/System.h>
+#include <fcntl.h>
+#include <sys/mman.h>
+
+namespace Core {
+
+ErrorOr<NonnullRefPtr<IORing>> IORing::create(u32 entries)
+{
+    auto fd = TRY(System::io_ring_create(entries, O_CLOEXEC));
+    auto ring_size = Kernel::io_ring_size(entries);
+    auto ring_or_error = System::mmap(nullptr, ring_size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0, 0, "IORing"sv);
+    if (ring_or_error.is_error()) {
+        (void)System::close(fd);
+        return ring_or_error.release_error();
+    }
+    return adopt_nonnull_ref_or_enomem(new (nothrow) IORing(fd, entries, static_cast<u8*>(ring_or_error.value()), ring_size));
+}
+
+IORing::IORing(int fd, u32 entries, u8* ring, size_t ring_size)
+    : m_fd(fd)
+    , m_submission_entries(entries)
+    , m_completion_entries(Kernel::io_ring_completion_entries(entries))
+    , m_ring(ring)
+    , m_ring_size(ring_size)
+    , m_header(reinterpret_cast<Kernel::IORingHeader*>(ring))
+    , m_submissions(reinterpret_cast<Kernel::IORingSubmission*>(ring + m_header->submissions_offset))
+    , m_completions(reinterpret_cast<Kernel::IORingCompletion const*>(ring + m_header->completions_offset))
+{
+}
+
+IORing::~IORing()
+{
+    for (auto& it : m_read_notifiers)
+        it.value->close();
+    for (auto& it : m_write_notifiers)
+        it.value->close();
+    (void)System::munmap(m_ring, m_ring_size);
+    (void)System::close(m_fd);
+}
+
+static Kernel::IORingSubmission make_submission(Kernel::IORingOperation operation, int fd, void const* buffer, size_t length, i64 offset, int flags)
+{
+    Kernel::IORingSubmission submission {};
+    submission.operation = operation;
+    submission.fd = fd;
+    submission.buffer = reinterpret_cast<FlatPtr>(buffer);
+    submission.length = length;
+    submission.offset = offset;
+    submission.flags = flags;
+    return submission;
+}
+
+ErrorOr<void> IORing::read(int fd, Bytes buffer, Optional<off_t> offset, Callback callback)
+{
+    return enqueue(make_submission(Kernel::IORingOperation::Read, fd, buffer.data(), buffer.size(), offset.value_or(-1), 0), true, move(callback));
+}
+
+ErrorOr<void> IORing::write(int fd, ReadonlyBytes buffer, Optional<off_t> offset, Callback callback)
+{
+    return enqueue(make_submission(Kernel::IORingOperation::Write, fd, buffer.data(), buffer.size(), offset.value_or(-1), 0), false, move(callback));
+}
+
+ErrorOr<void> IORing::accept(int fd, int flags, Callback callback)
+{
+    return enqueue(make_submission(Kernel::IORingOperation::Accept, fd, nullptr, 0, -1, flags), true, move(callback));
+}
+
+ErrorOr<void> IORing::recv(int fd, Bytes buffer, int flags, Callback callback)
+{
+    return enqueue(make_submission(Kernel::IORingOperation::Recv, fd, buffer.data(), buffer.size(), -1, flags), true, move(callback));
+}
+
+ErrorOr<void> IORing::send(int fd, ReadonlyBytes buffer, int flags, Callback callback)
+{
+    return enqueue(make_submission(Kernel::IORingOperation::Send, fd, buffer.data(), buffer.size(), -1, flags), false, move(callback));
+}
+
+bool IORing::try_enqueue(Kernel::IORingSubmission const& submission)
+{
+    auto submission_head = AK::atomic_load(&m_header->submission_head, AK::MemoryOrder::memory_order_acquire);
+    auto submission_tail = m_header->submission_tail;
+    if (submission_tail - submission_head >= m_submission_entries)
+        return false;
+    m_submissions[submission_tail & (m_submission_entries - 1)] = submission;
+    AK::atomic_store(&m_header->submission_tail, submission_tail + 1, AK::MemoryOrder::memory_order_release);
+    return true;
+}
+
+ErrorOr<void> IORing::enqueue(Kernel::IORingSubmission submission, bool waits_for_reading, Callback callback)
+{
+    submission.user_data = m_next_user_data++;
+    if (!try_enqueue(submission)) {
+        // The kernel only takes submissions it has room to complete, so make room for those first.
+        TRY(submit_and_wait());
+        if (!try_enqueue(submission))
+            return Error::from_errno(EBUSY);
+    }
+    TRY(m_operations.try_set(submission.user_data, { submission.fd, waits_for_reading, move(callback) }));
+
+    if (!m_submission_is_scheduled) {
+        m_submission_is_scheduled = true;
+        deferred_invoke([self = NonnullRefPtr(*this)] {
+            if (!self->m_submission_is_scheduled)
+                return;
+            if (auto result = self->submit_and_wait(); result.is_error())
+                dbgln("IORing: Failed to submit: {}", result.error());
+        });
+    }
+    return {};
+}
+
+ErrorOr<void> IORing::submit_and_wait(u32 min_completions)
+{
+    NonnullRefPtr protector = *this;
+    m_submission_is_scheduled = false;
+    TRY(System::io_ring_enter(m_fd, min_completions));
+    dispatch_completions();
+    update_notifiers();
+    return {};
+}
+
+void IORing::dispatch_completions()
+{
+    for (;;) {
+        // The callbacks may queue and submit more operations, so always start from the shared header.
+        auto completion_head = m_header->completion_head;
+        auto completion_tail = AK::atomic_load(&m_header->completion_tail, AK::MemoryOrder::memory_order_acquire);
+        if (completion_head == completion_tail)
+            break;
+        auto completion = m_completions[completion_head & (m_completion_entries - 1)];
+        AK::atomic_store(&m_header->completion_head, completion_head + 1, AK::MemoryOrder::memory_order_release);
+
+        auto it = m_operations.find(completion.user_data);
+        if (it == m_operations.end())
+            continue;
+        auto callback = move(it->value.callback);
+        m_operations.remove(it);
+        if (completion.result < 0)
+            callback(Error::from_errno(static_cast<int>(-completion.result)));
+        else
+            callback(static_cast<size_t>(completion.result));
+    }
+}
+
+void IORing::update_notifiers()
+{
+    // Whatever is still outstanding now is waiting for its file.
+    HashTable<int> read_fds;
+    HashTable<int> write_fds;
+    for (auto& it : m_operations)
+        (it.value.waits_for_reading ? read_fds : write_fds).set(it.value.fd);
+
+    auto update = [this](HashMap<int, NonnullRefPtr<Notifier>>& notifiers, HashTable<int> const& fds, Notifier::Event event) {
+        notifiers.remove_all_matching([&](int fd, auto& notifier) {
+            if (fds.contains(fd))
+                return false;
+            notifier->close();
+            return true;
+        });
+        for (auto fd : fds) {
+            if (notifiers.contains(fd))
+                continue;
+            auto notifier = Notifier::construct(fd, event);
+            auto on_ready = [this] {
+                if (auto result = submit_and_wait(); result.is_error())
+                    dbgln("IORing: Failed to submit: {}", result.error());
+            };
+            if (event == Notifier::Event::Read)
+                notifier->on_ready_to_read = move(on_ready);
+            else
+                notifier->on_ready_to_write = move(on_ready);
+            notifiers.set(fd, move(notifier));
+        }
+    };
+    update(m_read_notifiers, read_fds, Notifier::Event::Read);
+    update(m_write_notifiers, write_fds, Notifier::Event::Write);
+}
+
+}
@@ -0,0 +1,82 @@
+/*
+ * Copyright (c) 2022, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#pragma once
+
+#include <AK/Function.h>
+#include <AK/HashMap.h>
+#include <AK/Noncopyable.h>
+#include <AK/NonnullRefPtr.h>
+#include <AK/RefCounted.h>
+#include <Kernel/API/IORing.h>
+#include <LibCore/Notifier.h>
+
+namespace Core {
+
+// Batches reads, writes and socket operations through a kernel IORing, see Kernel/API/IORing.h.
+// Operations are only queued in memory shared with the kernel, and everything that has been
+// queued during an event loop iteration is handed to the kernel with a single syscall.
+// Operations that have to wait for their file are retried once the event loop sees the file
+// become ready. The buffers have to stay alive until the callback of their operation has run.
+class IORing final : public RefCounted<IORing> {
+    AK_MAKE_NONCOPYABLE(IORing);
+    AK_MAKE_NONMOVABLE(IORing);
+
+public:
+    // The result of the operation, like the equivalent syscall would have returned it.
+    // For accept() that is the fd of the new connection.
+    using Callback = Function<void(ErrorOr<size_t>)>;
+
+    static ErrorOr<NonnullRefPtr<IORing>> create(u32 entries = 256);
+    ~IORing();
+
+    // Reads and writes at the current offset of the description, unless an offset is given.
+    ErrorOr<void> read(int fd, Bytes, Optional<off_t> offset, Callback);
+    ErrorOr<void> write(int fd, ReadonlyBytes, Optional<off_t> offset, Callback);
+    ErrorOr<void> accept(int fd, int flags, Callback);
+    ErrorOr<void> recv(int fd, Bytes, int flags, Callback);
+    ErrorOr<void> send(int fd, ReadonlyBytes, int flags, Callback);
+
+    // Hands everything that has been queued to the kernel right away, waits until at least
+    // `min_completions` operations have completed, and runs the callbacks of all of them.
+    // This doesn't need an event loop.
+    ErrorOr<void> submit_and_wait(u32 min_completions = 0);
+
+    size_t outstanding_operations() const { return m_operations.size(); }
+
+private:
+    struct Operation {
+        int fd { -1 };
+        bool waits_for_reading { false };
+        Callback callback;
+    };
+
+    IORing(int fd, u32 entries, u8* ring, size_t ring_size);
+
+    ErrorOr<void> enqueue(Kernel::IORingSubmission, bool waits_for_reading, Callback);
+    bool try_enqueue(Kernel::IORingSubmission const&);
+    void dispatch_completions();
+    void update_notifiers();
+
+    int m_fd { -1 };
+    u32 m_submission_entries { 0 };
+    u32 m_completion_entries { 0 };
+    u8* m_ring { nullptr };
+    size_t m_ring_size { 0 };
+    Kernel::IORingHeader* m_header { nullptr };
+    Kernel::IORingSubmission* m_submissions { nullptr };
+    Kernel::IORingCompletion const* m_completions { nullptr };
+
+    u64 m_next_user_data { 1 };
+    HashMap<u64, Operation> m_operations;
+    bool m_submission_is_scheduled { false };
+
+    // The event loop tells us when the files of the operations the kernel is holding on to become ready.
+    HashMap<int, NonnullRefPtr<Notifier>> m_read_notifiers;
+    HashMap<int, NonnullRefPtr<Notifier>> m_write_notifiers;
+};
+
+}
@@ -47,6 +47,9 @@ ErrorOr<void> disown(pid_t pid);
 ErrorOr<void> profiling_enable(pid_t, u64 event_mask);
 ErrorOr<void> profiling_disable(pid_t);
 ErrorOr<void> profiling_free_buffer(pid_t);
+ErrorOr<size_t> sendfile(int out_fd, int in_fd, off_t* offset, size_t count);
+ErrorOr<int> io_ring_create(u32 entries, int options);
+ErrorOr<size_t> io_ring_enter(int fd, u32 min_completions);
 #else
 inline ErrorOr<void> unveil(StringView, StringView)
 {
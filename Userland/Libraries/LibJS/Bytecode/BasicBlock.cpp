@@ -64,4 +64,28 @@ void BasicBlock::grow(size_t additional_size)
     VERIFY(m_buffer_size <= m_buffer_capacity);
 }
 
+void BasicBlock::remove_instructions(Span<size_t const> offsets)
+{
+    size_t next_offset_to_remove = 0;
+    size_t new_size = 0;
+    Bytecode::InstructionStreamIterator it(instruction_stream());
+    while (!it.at_end()) {
+        auto offset = it.offset();
+        auto& instruction = const_cast<Instruction&>(*it);
+        auto length = instruction.length();
+        ++it;
+        if (next_offset_to_remove < offsets.size() && offsets[next_offset_to_remove] == offset) {
+            ++next_offset_to_remove;
+            Instruction::destroy(instruction);
+            continue;
+        }
+        // NOTE: The instruction is relocated, not copied: the bytes left behind are overwritten and never destroyed.
+        if (new_size != offset)
+            memmove(m_buffer + new_size, m_buffer + offset, length);
+        new_size += length;
+    }
+    VERIFY(next_offset_to_remove == offsets.size());
+    m_buffer_size = new_size;
+}
+
 }
@@ -6,14 +6,37 @@
 
 #pragma once
 
+#include <AK/Array.h>
 #include <AK/FlyString.h>
 #include <AK/NonnullOwnPtrVector.h>
+#include <AK/WeakPtr.h>
 #include <LibJS/Bytecode/BasicBlock.h>
 #include <LibJS/Bytecode/IdentifierTable.h>
 #include <LibJS/Bytecode/StringTable.h>
+#include <LibJS/JIT/NativeExecutable.h>
+#include <LibJS/Runtime/Shape.h>
 
 namespace JS::Bytecode {
 
+// Remembers where a GetById or PutById instruction found its property, for the last few shapes
+// it has seen. An entry is only used while the object (and, for properties found on the direct
+// prototype, the prototype) still has the exact shape it had when the entry was made.
+struct PropertyLookupCache {
+    static constexpr size_t max_number_of_shapes = 4;
+
+    struct Entry {
+        WeakPtr<Shape> shape;
+        u32 unique_shape_serial_number { 0 };
+        bool property_is_on_prototype { false };
+        WeakPtr<Shape> prototype_shape;
+        u32 prototype_unique_shape_serial_number { 0 };
+        u32 property_offset { 0 };
+    };
+
+    AK::Array<Entry, max_number_of_shapes> entries;
+    size_t next_entry_to_replace { 0 };
+};
+
 struct Executable {
     FlyString name;
     NonnullOwnPtrVector<BasicBlock> basic_blocks;
@@ -21,6 +44,12 @@ struct Executable {
     NonnullOwnPtr<IdentifierTable> identifier_table;
     size_t number_of_registers { 0 };
     bool is_strict_mode { false };
+    mutable Vector<PropertyLookupCache> property_lookup_caches;
+
+    // How often the executable has run, to decide whether it's worth compiling to native code.
+    mutable size_t run_count { 0 };
+    mutable bool did_try_to_compile { false };
+    mutable OwnPtr<JIT::NativeExecutable> native_executable {};
 
     String const& get_string(StringTableIndex index) const { return string_table->get(index); }
     FlyString const& get_identifier(IdentifierTableIndex index) const { return identifier_table->get(index); }
@@ -111,6 +111,16 @@ public:
     void replace_references(BasicBlock const&, BasicBlock const&);
     static void destroy(Instruction&);
 
+    // Calls the callback with every register the instruction refers to, except for the accumulator.
+    // The callback may change the registers. Only Store writes its register, ConcatString reads and
+    // writes it, every other instruction only reads its registers.
+    template<typename Callback>
+    void visit_registers(Callback);
+
+    // Instructions that refer to registers hide this.
+    template<typename Callback>
+    void visit_registers_impl(Callback) { }
+
 protected:
     explicit Instruction(Type type)
         : m_type(type)
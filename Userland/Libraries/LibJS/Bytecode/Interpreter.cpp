@@ -11,6 +11,7 @@
 #include <LibJS/Bytecode/Interpreter.h>
 #include <LibJS/Bytecode/Op.h>
 #include <LibJS/Interpreter.h>
+#include <LibJS/JIT/Compiler.h>
 #include <LibJS/Runtime/GlobalEnvironment.h>
 #include <LibJS/Runtime/GlobalObject.h>
 #include <LibJS/Runtime/Realm.h>
@@ -20,6 +21,17 @@ namespace JS::Bytecode {
 static Interpreter* s_current;
 bool g_dump_bytecode = false;
 
+static JIT::NativeExecutable const* native_executable_for(Executable const& executable)
+{
+    if (!JIT::g_jit_enabled)
+        return nullptr;
+    if (!executable.did_try_to_compile && executable.run_count++ >= JIT::g_jit_threshold) {
+        executable.did_try_to_compile = true;
+        executable.native_executable = JIT::Compiler::compile(executable);
+    }
+    return executable.native_executable.ptr();
+}
+
 Interpreter* Interpreter::current()
 {
     return s_current;
@@ -69,67 +81,10 @@ Interpreter::ValueAndFrame Interpreter::run_and_return_frame(Executable const& e
 
     registers().resize(executable.number_of_registers);
 
-    for (;;) {
-        Bytecode::InstructionStreamIterator pc(m_current_block->instruction_stream());
-        TemporaryChange temp_change { m_pc, &pc };
-
-        bool will_jump = false;
-        bool will_return = false;
-        while (!pc.at_end()) {
-            auto& instruction = *pc;
-            auto ran_or_error = instruction.execute(*this);
-            if (ran_or_error.is_error()) {
-                auto exception_value = *ran_or_error.throw_completion().value();
-                m_saved_exception = make_handle(exception_value);
-                if (unwind_contexts().is_empty())
-                    break;
-                auto& unwind_context = unwind_contexts().last();
-                if (unwind_context.executable != m_current_executable)
-                    break;
-                if (unwind_context.handler) {
-                    m_current_block = unwind_context.handler;
-                    unwind_context.handler = nullptr;
-
-                    // If there's no finalizer, there's nowhere for the handler block to unwind to, so the unwind context is no longer needed.
-                    if (!unwind_context.finalizer)
-                        unwind_contexts().take_last();
-
-                    accumulator() = exception_value;
-                    m_saved_exception = {};
-                    will_jump = true;
-                    break;
-                }
-                if (unwind_context.finalizer) {
-                    m_current_block = unwind_context.finalizer;
-                    unwind_contexts().take_last();
-                    will_jump = true;
-                    break;
-                }
-                // An unwind context with no handler or finalizer? We have nowhere to jump, and continuing on will make us crash on the next `Call` to a non-native function if there's an exception! So let's crash here instead.
-                // If you run into this, you probably forgot to remove the current unwind_context somewhere.
-                VERIFY_NOT_REACHED();
-            }
-            if (m_pending_jump.has_value()) {
-                m_current_block = m_pending_jump.release_value();
-                will_jump = true;
-                break;
-            }
-            if (!m_return_value.is_empty()) {
-                will_return = true;
-                break;
-            }
-            ++pc;
-        }
-
-        if (will_return)
-            break;
-
-        if (pc.at_end() && !will_jump)
-            break;
-
-        if (!m_saved_exception.is_null())
-            break;
-    }
+    if (auto const* native_executable = native_executable_for(executable))
+        run_native_code(*native_executable);
+    else
+        run_bytecode();
 
     dbgln_if(JS_BYTECODE_DEBUG, "Bytecode::Interpreter did run unit {:p}", &executable);
 
@@ -177,6 +132,104 @@ Interpreter::ValueAndFrame Interpreter::run_and_return_frame(Executable const& e
     return { return_value, nullptr };
 }
 
+void Interpreter::run_bytecode()
+{
+    for (;;) {
+        Bytecode::InstructionStreamIterator pc(m_current_block->instruction_stream());
+        TemporaryChange temp_change { m_pc, &pc };
+
+        bool will_jump = false;
+        bool will_return = false;
+        while (!pc.at_end()) {
+            auto& instruction = *pc;
+            auto ran_or_error = instruction.execute(*this);
+            if (ran_or_error.is_error()) {
+                will_jump = unwind_to_exception_handler(*ran_or_error.throw_completion().value());
+                break;
+            }
+            if (m_pending_jump.has_value()) {
+                m_current_block = m_pending_jump.release_value();
+                will_jump = true;
+                break;
+            }
+            if (!m_return_value.is_empty()) {
+                will_return = true;
+                break;
+            }
+            ++pc;
+        }
+
+        if (will_return)
+            break;
+
+        if (pc.at_end() && !will_jump)
+            break;
+
+        if (!m_saved_exception.is_null())
+            break;
+    }
+}
+
+void Interpreter::run_native_code(JIT::NativeExecutable const& native_executable)
+{
+    // Native code doesn't keep track of its position in the bytecode.
+    TemporaryChange reset_pc { m_pc, static_cast<InstructionStreamIterator*>(nullptr) };
+
+    // Native code only gives control back when it leaves the executable, or when it has to continue at a block
+    // it didn't jump to by itself.
+    while (native_executable.run(*this, registers().data(), *m_current_block) == JIT::Exit::Jump) {
+    }
+}
+
+JIT::Exit Interpreter::did_run_instruction_from_native_code(ThrowCompletionOr<void> const& result)
+{
+    // This mirrors what run_bytecode() does after every instruction.
+    if (result.is_error()) {
+        if (unwind_to_exception_handler(*result.throw_completion().value()) && m_saved_exception.is_null())
+            return JIT::Exit::Jump;
+        return JIT::Exit::Exception;
+    }
+    if (m_pending_jump.has_value()) {
+        m_current_block = m_pending_jump.release_value();
+        return JIT::Exit::Jump;
+    }
+    if (!m_return_value.is_empty())
+        return JIT::Exit::Return;
+    return JIT::Exit::Continue;
+}
+
+// Saves the exception, and moves on to the handler or finalizer of the innermost unwind context if that belongs
+// to the current executable. Returns whether there was somewhere to go.
+bool Interpreter::unwind_to_exception_handler(Value exception_value)
+{
+    m_saved_exception = make_handle(exception_value);
+    if (unwind_contexts().is_empty())
+        return false;
+    auto& unwind_context = unwind_contexts().last();
+    if (unwind_context.executable != m_current_executable)
+        return false;
+    if (unwind_context.handler) {
+        m_current_block = unwind_context.handler;
+        unwind_context.handler = nullptr;
+
+        // If there's no finalizer, there's nowhere for the handler block to unwind to, so the unwind context is no longer needed.
+        if (!unwind_context.finalizer)
+            unwind_contexts().take_last();
+
+        accumulator() = exception_value;
+        m_saved_exception = {};
+        return true;
+    }
+    if (unwind_context.finalizer) {
+        m_current_block = unwind_context.finalizer;
+        unwind_contexts().take_last();
+        return true;
+    }
+    // An unwind context with no handler or finalizer? We have nowhere to jump, and continuing on will make us crash on the next `Call` to a non-native function if there's an exception! So let's crash here instead.
+    // If you run into this, you probably forgot to remove the current unwind_context somewhere.
+    VERIFY_NOT_REACHED();
+}
+
 void Interpreter::enter_unwind_context(Optional<Label> handler_target, Optional<Label> finalizer_target)
 {
     unwind_contexts().empend(m_current_executable, handler_target.has_value() ? &handler_target->block() : nullptr, finalizer_target.has_value() ? &finalizer_target->block() : nullptr);
@@ -221,17 +274,23 @@ Bytecode::PassManager& Interpreter::optimization_pipeline(Interpreter::Optimizat
     auto pm = make<PassManager>();
     if (level == OptimizationLevel::None) {
         // No optimization.
-    } else if (level == OptimizationLevel::Optimize) {
-        pm->add<Passes::GenerateCFG>();
-        pm->add<Passes::UnifySameBlocks>();
-        pm->add<Passes::GenerateCFG>();
-        pm->add<Passes::MergeBlocks>();
-        pm->add<Passes::GenerateCFG>();
-        pm->add<Passes::UnifySameBlocks>();
-        pm->add<Passes::GenerateCFG>();
-        pm->add<Passes::MergeBlocks>();
-        pm->add<Passes::GenerateCFG>();
-        pm->add<Passes::PlaceBlocks>();
+    } else if (level == OptimizationLevel::OptimizeRegisters || level == OptimizationLevel::Optimize) {
+        if (level == OptimizationLevel::Optimize) {
+            pm->add<Passes::GenerateCFG>();
+            pm->add<Passes::UnifySameBlocks>();
+            pm->add<Passes::GenerateCFG>();
+            pm->add<Passes::MergeBlocks>();
+            pm->add<Passes::GenerateCFG>();
+            pm->add<Passes::UnifySameBlocks>();
+            pm->add<Passes::GenerateCFG>();
+            pm->add<Passes::MergeBlocks>();
+            pm->add<Passes::GenerateCFG>();
+            pm->add<Passes::PlaceBlocks>();
+        }
+        pm->add<Passes::EliminateLoads>();
+        pm->add<Passes::EliminateDeadStores>();
+        pm->add<Passes::AllocateRegisters>();
+        pm->add<Passes::EliminateLoads>();
     } else {
         VERIFY_NOT_REACHED();
     }
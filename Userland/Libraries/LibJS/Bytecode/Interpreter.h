@@ -13,6 +13,7 @@
 #include <LibJS/Forward.h>
 #include <LibJS/Heap/Cell.h>
 #include <LibJS/Heap/Handle.h>
+#include <LibJS/JIT/NativeExecutable.h>
 #include <LibJS/Runtime/VM.h>
 #include <LibJS/Runtime/Value.h>
 
@@ -65,21 +66,30 @@ public:
     void leave_unwind_context();
     ThrowCompletionOr<void> continue_pending_unwind(Label const& resume_label);
 
+    // Native code calls this after it had an instruction run in C++, to find out whether it can go on with the next one.
+    JIT::Exit did_run_instruction_from_native_code(ThrowCompletionOr<void> const&);
+
     Executable const& current_executable() { return *m_current_executable; }
     BasicBlock const& current_block() const { return *m_current_block; }
     size_t pc() const { return m_pc ? m_pc->offset() : 0; }
 
     enum class OptimizationLevel {
         None,
+        // Only the passes that leave the blocks and the jumps between them alone.
+        OptimizeRegisters,
         Optimize,
         __Count,
-        Default = None,
+        Default = OptimizeRegisters,
     };
     static Bytecode::PassManager& optimization_pipeline(OptimizationLevel = OptimizationLevel::Default);
 
     VM::InterpreterExecutionScope ast_interpreter_scope();
 
 private:
+    void run_bytecode();
+    void run_native_code(JIT::NativeExecutable const&);
+    bool unwind_to_exception_handler(Value exception_value);
+
     RegisterWindow& window()
     {
         return m_register_windows.last().visit([](auto& x) -> RegisterWindow& { return *x; });
@@ -48,7 +48,7 @@ String Instruction::to_string(Bytecode::Executable const& executable) const
 
 namespace JS::Bytecode::Op {
 
-static ThrowCompletionOr<void> put_by_property_key(Object* object, Value value, PropertyKey name, Bytecode::Interpreter& interpreter, PropertyKind kind)
+static ThrowCompletionOr<void> put_by_property_key(Object* object, Value value, PropertyKey name, Bytecode::Interpreter& interpreter, PropertyKind kind, CacheablePropertyMetadata* cacheable_metadata = nullptr)
 {
     auto& vm = interpreter.vm();
 
@@ -72,7 +72,7 @@ static ThrowCompletionOr<void> put_by_property_key(Object* object, Value value,
         break;
     }
     case PropertyKind::KeyValue: {
-        bool succeeded = TRY(object->internal_set(name, interpreter.accumulator(), object));
+        bool succeeded = TRY(object->internal_set(name, interpreter.accumulator(), object, cacheable_metadata));
         if (!succeeded && vm.in_strict_mode())
             return vm.throw_completion<TypeError>(ErrorType::ReferenceNullishSetProperty, name, interpreter.accumulator().to_string_without_side_effects());
         break;
@@ -89,6 +89,87 @@ static ThrowCompletionOr<void> put_by_property_key(Object* object, Value value,
     return {};
 }
 
+// Objects of different classes can share a shape, so exotic objects must never hit an entry that an ordinary one filled.
+static PropertyLookupCache::Entry const* find_property_lookup_cache_entry(PropertyLookupCache const& cache, Object const& object)
+{
+    if (!object.has_ordinary_property_access())
+        return nullptr;
+
+    auto const& shape = object.shape();
+    for (auto const& entry : cache.entries) {
+        if (entry.shape.ptr() == &shape && entry.unique_shape_serial_number == shape.unique_shape_serial_number())
+            return &entry;
+    }
+    return nullptr;
+}
+
+// Returns an empty value if the cache can't tell where the property is.
+static Value get_cached_property(PropertyLookupCache const& cache, Object const& object)
+{
+    auto const* entry = find_property_lookup_cache_entry(cache, object);
+    if (!entry)
+        return {};
+
+    auto const* holder = &object;
+    if (entry->property_is_on_prototype) {
+        holder = object.shape().prototype();
+        if (!holder || !holder->has_ordinary_property_access() || entry->prototype_shape.ptr() != &holder->shape() || entry->prototype_unique_shape_serial_number != holder->shape().unique_shape_serial_number())
+            return {};
+    }
+
+    // Intrinsic accessors that haven't been created yet are empty, and a non-writable data property
+    // can be redefined as an accessor without its attributes (and thus the shape) changing.
+    auto value = holder->get_direct(entry->property_offset);
+    if (value.is_accessor())
+        return {};
+    return value;
+}
+
+static bool put_cached_property(PropertyLookupCache const& cache, Object& object, Value value)
+{
+    auto const* entry = find_property_lookup_cache_entry(cache, object);
+    if (!entry || entry->property_is_on_prototype)
+        return false;
+
+    auto old_value = object.get_direct(entry->property_offset);
+    if (old_value.is_empty() || old_value.is_accessor())
+        return false;
+    object.put_direct(entry->property_offset, value);
+    return true;
+}
+
+static void update_property_lookup_cache(PropertyLookupCache& cache, Object& object, CacheablePropertyMetadata const& cacheable_metadata)
+{
+    if (cacheable_metadata.type == CacheablePropertyMetadata::Type::NotCacheable)
+        return;
+    if (!object.has_ordinary_property_access())
+        return;
+
+    auto& shape = object.shape();
+    PropertyLookupCache::Entry new_entry;
+    new_entry.shape = shape.make_weak_ptr();
+    new_entry.unique_shape_serial_number = shape.unique_shape_serial_number();
+    new_entry.property_offset = cacheable_metadata.property_offset.value();
+    if (cacheable_metadata.type == CacheablePropertyMetadata::Type::InPrototypeChain) {
+        if (!shape.prototype()->has_ordinary_property_access())
+            return;
+        auto& prototype_shape = shape.prototype()->shape();
+        new_entry.property_is_on_prototype = true;
+        new_entry.prototype_shape = prototype_shape.make_weak_ptr();
+        new_entry.prototype_unique_shape_serial_number = prototype_shape.unique_shape_serial_number();
+    }
+
+    // Prefer replacing what we knew about this shape before it was changed in place, then unused entries.
+    for (auto& entry : cache.entries) {
+        if (entry.shape.ptr() == &shape || !entry.shape) {
+            entry = move(new_entry);
+            return;
+        }
+    }
+    cache.entries[cache.next_entry_to_replace] = move(new_entry);
+    cache.next_entry_to_replace = (cache.next_entry_to_replace + 1) % PropertyLookupCache::max_number_of_shapes;
+}
+
 ThrowCompletionOr<void> Load::execute_impl(Bytecode::Interpreter& interpreter) const
 {
     interpreter.accumulator() = interpreter.reg(m_src);
@@ -477,7 +558,16 @@ ThrowCompletionOr<void> GetById::execute_impl(Bytecode::Interpreter& interpreter
 {
     auto& vm = interpreter.vm();
     auto* object = TRY(interpreter.accumulator().to_object(vm));
-    interpreter.accumulator() = TRY(object->get(interpreter.current_executable().get_identifier(m_property)));
+
+    auto& cache = interpreter.current_executable().property_lookup_caches[m_cache_index];
+    if (auto value = get_cached_property(cache, *object); !value.is_empty()) {
+        interpreter.accumulator() = value;
+        return {};
+    }
+
+    CacheablePropertyMetadata cacheable_metadata;
+    interpreter.accumulator() = TRY(object->internal_get(interpreter.current_executable().get_identifier(m_property), object, &cacheable_metadata));
+    update_property_lookup_cache(cache, *object, cacheable_metadata);
     return {};
 }
 
@@ -487,7 +577,17 @@ ThrowCompletionOr<void> PutById::execute_impl(Bytecode::Interpreter& interpreter
     auto* object = TRY(interpreter.reg(m_base).to_object(vm));
     PropertyKey name = interpreter.current_executable().get_identifier(m_property);
     auto value = interpreter.accumulator();
-    return put_by_property_key(object, value, name, interpreter, m_kind);
+    if (m_kind != PropertyKind::KeyValue)
+        return put_by_property_key(object, value, name, interpreter, m_kind);
+
+    auto& cache = interpreter.current_executable().property_lookup_caches[m_cache_index];
+    if (put_cached_property(cache, *object, value))
+        return {};
+
+    CacheablePropertyMetadata cacheable_metadata;
+    TRY(put_by_property_key(object, value, name, interpreter, m_kind, &cacheable_metadata));
+    update_property_lookup_cache(cache, *object, cacheable_metadata);
+    return {};
 }
 
 ThrowCompletionOr<void> DeleteById::execute_impl(Bytecode::Interpreter& interpreter) const
@@ -1118,12 +1218,12 @@ String PutById::to_string_impl(Bytecode::Executable const& executable) const
         ? "setter"
         : "property";
 
-    return String::formatted("PutById kind:{} base:{}, property:{} ({})", kind, m_base, m_property, executable.identifier_table->get(m_property));
+    return String::formatted("PutById kind:{} base:{}, property:{} ({}), cache:{}", kind, m_base, m_property, executable.identifier_table->get(m_property), m_cache_index);
 }
 
 String GetById::to_string_impl(Bytecode::Executable const& executable) const
 {
-    return String::formatted("GetById {} ({})", m_property, executable.identifier_table->get(m_property));
+    return String::formatted("GetById {} ({}), cache:{}", m_property, executable.identifier_table->get(m_property), m_cache_index);
 }
 
 String DeleteById::to_string_impl(Bytecode::Executable const& executable) const
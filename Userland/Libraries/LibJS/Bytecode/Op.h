@@ -35,6 +35,11 @@ public:
     String to_string_impl(Bytecode::Executable const&) const;
     void replace_references_impl(BasicBlock const&, BasicBlock const&) { }
 
+    template<typename Callback>
+    void visit_registers_impl(Callback callback) { callback(m_src); }
+
+    Register src() const { return m_src; }
+
 private:
     Register m_src;
 };
@@ -51,6 +56,8 @@ public:
     String to_string_impl(Bytecode::Executable const&) const;
     void replace_references_impl(BasicBlock const&, BasicBlock const&) { }
 
+    Value value() const { return m_value; }
+
 private:
     Value m_value;
 };
@@ -67,6 +74,11 @@ public:
     String to_string_impl(Bytecode::Executable const&) const;
     void replace_references_impl(BasicBlock const&, BasicBlock const&) { }
 
+    template<typename Callback>
+    void visit_registers_impl(Callback callback) { callback(m_dst); }
+
+    Register dst() const { return m_dst; }
+
 private:
     Register m_dst;
 };
@@ -108,6 +120,11 @@ private:
         String to_string_impl(Bytecode::Executable const&) const;              \
         void replace_references_impl(BasicBlock const&, BasicBlock const&) { } \
                                                                                \
+        template<typename Callback>                                            \
+        void visit_registers_impl(Callback callback) { callback(m_lhs_reg); }  \
+                                                                               \
+        Register lhs() const { return m_lhs_reg; }                             \
+                                                                               \
     private:                                                                   \
         Register m_lhs_reg;                                                    \
     };
@@ -202,6 +219,14 @@ public:
 
     size_t length_impl() const { return sizeof(*this) + sizeof(Register) * m_excluded_names_count; }
 
+    template<typename Callback>
+    void visit_registers_impl(Callback callback)
+    {
+        callback(m_from_object);
+        for (size_t i = 0; i < m_excluded_names_count; i++)
+            callback(m_excluded_names[i]);
+    }
+
 private:
     Register m_from_object;
     size_t m_excluded_names_count { 0 };
@@ -250,6 +275,24 @@ public:
         return sizeof(*this) + sizeof(Register) * (m_element_count == 0 ? 0 : 2);
     }
 
+    // Every register of the range is visited, but only its ends are stored. The optimization passes
+    // keep the registers of a range contiguous, so renaming the ends renames the whole range.
+    template<typename Callback>
+    void visit_registers_impl(Callback callback)
+    {
+        if (m_element_count == 0)
+            return;
+        auto first_index = m_elements[0].index();
+        for (size_t i = 0; i < m_element_count; i++) {
+            Register element(first_index + i);
+            callback(element);
+            if (i == 0)
+                m_elements[0] = element;
+            if (i == m_element_count - 1)
+                m_elements[1] = element;
+        }
+    }
+
 private:
     size_t m_element_count { 0 };
     Register m_elements[];
@@ -268,6 +311,9 @@ public:
     String to_string_impl(Bytecode::Executable const&) const;
     void replace_references_impl(BasicBlock const&, BasicBlock const&) { }
 
+    template<typename Callback>
+    void visit_registers_impl(Callback callback) { callback(m_lhs); }
+
 private:
     Register m_lhs;
     bool m_is_spread = false;
@@ -297,6 +343,9 @@ public:
     String to_string_impl(Bytecode::Executable const&) const;
     void replace_references_impl(BasicBlock const&, BasicBlock const&) { }
 
+    template<typename Callback>
+    void visit_registers_impl(Callback callback) { callback(m_lhs); }
+
 private:
     Register m_lhs;
 };
@@ -417,9 +466,10 @@ private:
 
 class GetById final : public Instruction {
 public:
-    explicit GetById(IdentifierTableIndex property)
+    GetById(IdentifierTableIndex property, u32 cache_index)
         : Instruction(Type::GetById)
         , m_property(property)
+        , m_cache_index(cache_index)
     {
     }
 
@@ -427,8 +477,11 @@ public:
     String to_string_impl(Bytecode::Executable const&) const;
     void replace_references_impl(BasicBlock const&, BasicBlock const&) { }
 
+    u32 cache_index() const { return m_cache_index; }
+
 private:
     IdentifierTableIndex m_property;
+    u32 m_cache_index { 0 };
 };
 
 enum class PropertyKind {
@@ -441,11 +494,12 @@ enum class PropertyKind {
 
 class PutById final : public Instruction {
 public:
-    explicit PutById(Register base, IdentifierTableIndex property, PropertyKind kind = PropertyKind::KeyValue)
+    PutById(Register base, IdentifierTableIndex property, u32 cache_index, PropertyKind kind = PropertyKind::KeyValue)
         : Instruction(Type::PutById)
         , m_base(base)
         , m_property(property)
         , m_kind(kind)
+        , m_cache_index(cache_index)
     {
     }
 
@@ -453,10 +507,18 @@ public:
     String to_string_impl(Bytecode::Executable const&) const;
     void replace_references_impl(BasicBlock const&, BasicBlock const&) { }
 
+    template<typename Callback>
+    void visit_registers_impl(Callback callback) { callback(m_base); }
+
+    Register base() const { return m_base; }
+    PropertyKind kind() const { return m_kind; }
+    u32 cache_index() const { return m_cache_index; }
+
 private:
     Register m_base;
     IdentifierTableIndex m_property;
     PropertyKind m_kind;
+    u32 m_cache_index { 0 };
 };
 
 class DeleteById final : public Instruction {
@@ -487,6 +549,9 @@ public:
     String to_string_impl(Bytecode::Executable const&) const;
     void replace_references_impl(BasicBlock const&, BasicBlock const&) { }
 
+    template<typename Callback>
+    void visit_registers_impl(Callback callback) { callback(m_base); }
+
 private:
     Register m_base;
 };
@@ -505,6 +570,13 @@ public:
     String to_string_impl(Bytecode::Executable const&) const;
     void replace_references_impl(BasicBlock const&, BasicBlock const&) { }
 
+    template<typename Callback>
+    void visit_registers_impl(Callback callback)
+    {
+        callback(m_base);
+        callback(m_property);
+    }
+
 private:
     Register m_base;
     Register m_property;
@@ -523,6 +595,9 @@ public:
     String to_string_impl(Bytecode::Executable const&) const;
     void replace_references_impl(BasicBlock const&, BasicBlock const&) { }
 
+    template<typename Callback>
+    void visit_registers_impl(Callback callback) { callback(m_base); }
+
 private:
     Register m_base;
 };
@@ -619,6 +694,13 @@ public:
 
     Completion throw_type_error_for_callee(Bytecode::Interpreter&, StringView callee_type) const;
 
+    template<typename Callback>
+    void visit_registers_impl(Callback callback)
+    {
+        callback(m_callee);
+        callback(m_this_value);
+    }
+
 private:
     Register m_callee;
     Register m_this_value;
@@ -793,6 +875,8 @@ public:
     String to_string_impl(Bytecode::Executable const&) const;
     void replace_references_impl(BasicBlock const&, BasicBlock const&);
 
+    auto& next_target() const { return m_next_target; }
+
 private:
     Label m_next_target;
 };
@@ -992,6 +1076,22 @@ ALWAYS_INLINE void Instruction::replace_references(BasicBlock const& from, Basic
 #undef __BYTECODE_OP
 }
 
+template<typename Callback>
+ALWAYS_INLINE void Instruction::visit_registers(Callback callback)
+{
+#define __BYTECODE_OP(op)       \
+    case Instruction::Type::op: \
+        return static_cast<Bytecode::Op::op&>(*this).visit_registers_impl(callback);
+
+    switch (type()) {
+        ENUMERATE_BYTECODE_OPS(__BYTECODE_OP)
+    default:
+        VERIFY_NOT_REACHED();
+    }
+
+#undef __BYTECODE_OP
+}
+
 ALWAYS_INLINE size_t Instruction::length() const
 {
     if (type() == Type::NewArray)
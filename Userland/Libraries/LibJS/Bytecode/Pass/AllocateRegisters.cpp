@@ -0,0 +1,204 @@
+/*
+ * Copyright (c) 2022, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <AK/QuickSort.h>
+#include <LibJS/Bytecode/PassManager.h>
+
+namespace JS::Bytecode::Passes {
+
+// The accumulator and register 1 are never handed out by the Generator, so they keep their index.
+static constexpr u32 first_allocatable_register = 2;
+
+void AllocateRegisters::perform(PassPipelineExecutable& executable)
+{
+    started();
+
+    auto register_count = executable.executable.number_of_registers;
+    auto liveness = compute_register_liveness(executable.executable);
+
+    // Number the instructions in block order, and find the first and last position at which each register
+    // is used or live. The start and end of each block get positions of their own, so a register that is
+    // live across a block boundary extends to it. Two registers can share an index if their ranges don't overlap.
+    struct LiveRange {
+        size_t start { 0 };
+        size_t end { 0 };
+    };
+    Vector<Optional<LiveRange>> live_ranges;
+    live_ranges.resize(register_count);
+
+    auto extend_live_range = [&](u32 index, size_t position) {
+        if (index < first_allocatable_register)
+            return;
+        VERIFY(index < register_count);
+        auto& live_range = live_ranges[index];
+        if (!live_range.has_value()) {
+            live_range = LiveRange { position, position };
+            return;
+        }
+        live_range->start = min(live_range->start, position);
+        live_range->end = max(live_range->end, position);
+    };
+
+    // Registers that are stored to right after another register was loaded, i.e. copies of that register.
+    HashMap<u32, u32> copied_from;
+    Vector<AK::Array<u32, 2>> element_ranges;
+
+    size_t position = 0;
+    for (auto& block : executable.executable.basic_blocks) {
+        auto block_start = position++;
+        if (auto live_at_start = liveness.live_at_start.find(&block); live_at_start != liveness.live_at_start.end()) {
+            for (auto index : live_at_start->value)
+                extend_live_range(index, block_start);
+        }
+
+        Optional<u32> loaded_register;
+        InstructionStreamIterator it { block.instruction_stream() };
+        while (!it.at_end()) {
+            auto& instruction = const_cast<Instruction&>(*it);
+            ++it;
+
+            auto instruction_position = position++;
+            Optional<u32> first_register;
+            u32 last_register = 0;
+            instruction.visit_registers([&](Register& reg) {
+                extend_live_range(reg.index(), instruction_position);
+                if (!first_register.has_value())
+                    first_register = reg.index();
+                last_register = reg.index();
+            });
+
+            if (instruction.type() == Instruction::Type::NewArray && first_register.has_value())
+                element_ranges.append({ *first_register, last_register });
+
+            if (instruction.type() == Instruction::Type::Store && loaded_register.has_value()) {
+                auto index = static_cast<Op::Store const&>(instruction).dst().index();
+                if (!copied_from.contains(index))
+                    copied_from.set(index, *loaded_register);
+            }
+
+            loaded_register = {};
+            if (instruction.type() == Instruction::Type::Load && *first_register >= first_allocatable_register)
+                loaded_register = first_register;
+        }
+
+        auto block_end = position++;
+        if (auto live_at_end = liveness.live_at_end.find(&block); live_at_end != liveness.live_at_end.end()) {
+            for (auto index : live_at_end->value)
+                extend_live_range(index, block_end);
+        }
+    }
+
+    for (auto index : liveness.live_everywhere) {
+        extend_live_range(index, 0);
+        extend_live_range(index, position);
+    }
+
+    // The registers of a NewArray range have to stay contiguous, so they are allocated as one.
+    struct Allocation {
+        LiveRange live_range;
+        u32 first_register { 0 };
+        u32 register_count { 1 };
+    };
+    Vector<Allocation> allocations;
+    Vector<Optional<size_t>> allocation_of_register;
+    allocation_of_register.resize(register_count);
+
+    for (auto& element_range : element_ranges) {
+        auto first_register = element_range[0];
+        auto count = element_range[1] - first_register + 1;
+        if (auto existing = allocation_of_register[first_register]; existing.has_value()) {
+            auto& allocation = allocations[*existing];
+            if (allocation.first_register == first_register && allocation.register_count == count)
+                continue;
+        }
+
+        Allocation allocation { *live_ranges[first_register], first_register, count };
+        for (auto index = first_register; index < first_register + count; ++index) {
+            // The Generator never makes ranges that overlap without being the same, so don't bother allocating those.
+            if (index < first_allocatable_register || allocation_of_register[index].has_value()) {
+                finished();
+                return;
+            }
+            allocation.live_range.start = min(allocation.live_range.start, live_ranges[index]->start);
+            allocation.live_range.end = max(allocation.live_range.end, live_ranges[index]->end);
+            allocation_of_register[index] = allocations.size();
+        }
+        allocations.append(allocation);
+    }
+
+    for (u32 index = first_allocatable_register; index < register_count; ++index) {
+        if (live_ranges[index].has_value() && !allocation_of_register[index].has_value())
+            allocations.append({ *live_ranges[index], index, 1 });
+    }
+
+    quick_sort(allocations, [](auto const& a, auto const& b) { return a.live_range.start < b.live_range.start; });
+
+    // Hand out the lowest free indices in the order the ranges start (linear scan), freeing the
+    // indices of every range that has ended before the next one starts.
+    Vector<Optional<u32>> new_indices;
+    new_indices.resize(register_count);
+    Vector<bool> index_is_taken;
+    for (u32 index = 0; index < first_allocatable_register; ++index) {
+        new_indices[index] = index;
+        index_is_taken.append(true);
+    }
+
+    auto is_free = [&](u32 index, u32 count) {
+        for (auto i = index; i < index + count && i < index_is_taken.size(); ++i) {
+            if (index_is_taken[i])
+                return false;
+        }
+        return true;
+    };
+
+    Vector<Allocation const*> active_allocations;
+    for (auto const& allocation : allocations) {
+        active_allocations.remove_all_matching([&](auto const* active_allocation) {
+            if (active_allocation->live_range.end >= allocation.live_range.start)
+                return false;
+            auto first_index = *new_indices[active_allocation->first_register];
+            for (u32 i = 0; i < active_allocation->register_count; ++i)
+                index_is_taken[first_index + i] = false;
+            return true;
+        });
+
+        Optional<u32> new_index;
+        if (auto source = copied_from.get(allocation.first_register); source.has_value() && allocation.register_count == 1) {
+            if (auto source_index = new_indices[*source]; source_index.has_value() && is_free(*source_index, 1))
+                new_index = source_index;
+        }
+        if (!new_index.has_value()) {
+            u32 candidate = first_allocatable_register;
+            while (!is_free(candidate, allocation.register_count))
+                ++candidate;
+            new_index = candidate;
+        }
+
+        if (index_is_taken.size() < *new_index + allocation.register_count)
+            index_is_taken.resize(*new_index + allocation.register_count);
+        for (u32 i = 0; i < allocation.register_count; ++i) {
+            index_is_taken[*new_index + i] = true;
+            new_indices[allocation.first_register + i] = *new_index + i;
+        }
+        active_allocations.append(&allocation);
+    }
+
+    for (auto& block : executable.executable.basic_blocks) {
+        InstructionStreamIterator it { block.instruction_stream() };
+        while (!it.at_end()) {
+            auto& instruction = const_cast<Instruction&>(*it);
+            ++it;
+            instruction.visit_registers([&](Register& reg) {
+                reg = Register { *new_indices[reg.index()] };
+            });
+        }
+    }
+    executable.executable.number_of_registers = index_is_taken.size();
+
+    finished();
+}
+
+}
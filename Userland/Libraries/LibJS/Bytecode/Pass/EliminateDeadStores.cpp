@@ -0,0 +1,56 @@
+/*
+ * Copyright (c) 2022, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <LibJS/Bytecode/PassManager.h>
+
+namespace JS::Bytecode::Passes {
+
+void EliminateDeadStores::perform(PassPipelineExecutable& executable)
+{
+    started();
+
+    auto liveness = compute_register_liveness(executable.executable);
+
+    for (auto& block : executable.executable.basic_blocks) {
+        Vector<Instruction*> instructions;
+        Vector<size_t> offsets;
+        InstructionStreamIterator it { block.instruction_stream() };
+        while (!it.at_end()) {
+            instructions.append(&const_cast<Instruction&>(*it));
+            offsets.append(it.offset());
+            ++it;
+        }
+
+        // Walk the block backwards, keeping track of the registers that will still be read.
+        HashTable<u32> live;
+        if (auto live_at_end = liveness.live_at_end.find(&block); live_at_end != liveness.live_at_end.end())
+            live = live_at_end->value;
+        Vector<size_t> dead_stores;
+        for (size_t i = instructions.size(); i > 0; --i) {
+            auto& instruction = *instructions[i - 1];
+            if (instruction.type() == Instruction::Type::Store) {
+                auto index = static_cast<Op::Store const&>(instruction).dst().index();
+                if (index == Register::accumulator_index || liveness.live_everywhere.contains(index))
+                    continue;
+                if (!live.remove(index))
+                    dead_stores.append(offsets[i - 1]);
+                continue;
+            }
+            instruction.visit_registers([&](Register& reg) {
+                live.set(reg.index());
+            });
+        }
+
+        if (dead_stores.is_empty())
+            continue;
+        dead_stores.reverse();
+        block.remove_instructions(dead_stores);
+    }
+
+    finished();
+}
+
+}
@@ -0,0 +1,54 @@
+/*
+ * Copyright (c) 2022, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <LibJS/Bytecode/PassManager.h>
+
+namespace JS::Bytecode::Passes {
+
+void EliminateLoads::perform(PassPipelineExecutable& executable)
+{
+    started();
+
+    for (auto& block : executable.executable.basic_blocks) {
+        Vector<size_t> redundant_instructions;
+
+        // The register the accumulator was last loaded from or stored to, if nothing has changed either since.
+        // Every instruction other than Load and Store may change the accumulator, and ConcatString may change its
+        // register, so those make us forget. Blocks are only ever entered at their start, so this is per block.
+        Optional<u32> register_in_accumulator;
+
+        InstructionStreamIterator it { block.instruction_stream() };
+        while (!it.at_end()) {
+            auto& instruction = *it;
+            auto offset = it.offset();
+            ++it;
+
+            Optional<u32> index;
+            if (instruction.type() == Instruction::Type::Load)
+                index = static_cast<Op::Load const&>(instruction).src().index();
+            else if (instruction.type() == Instruction::Type::Store)
+                index = static_cast<Op::Store const&>(instruction).dst().index();
+
+            if (!index.has_value()) {
+                register_in_accumulator = {};
+                continue;
+            }
+
+            if (*index == Register::accumulator_index || register_in_accumulator == index) {
+                redundant_instructions.append(offset);
+                continue;
+            }
+            register_in_accumulator = index;
+        }
+
+        if (!redundant_instructions.is_empty())
+            block.remove_instructions(redundant_instructions);
+    }
+
+    finished();
+}
+
+}
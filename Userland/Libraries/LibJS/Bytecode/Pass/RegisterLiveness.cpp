@@ -0,0 +1,135 @@
+/*
+ * Copyright (c) 2022, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <LibJS/Bytecode/PassManager.h>
+
+namespace JS::Bytecode {
+
+// Unlike GenerateCFG, this also follows FinishUnwind, which doesn't have to end its block.
+static void for_each_successor(Instruction const& instruction, Function<void(BasicBlock const&)> const& callback)
+{
+    auto visit = [&](auto const& label) {
+        if (label.has_value())
+            callback(label->block());
+    };
+
+    switch (instruction.type()) {
+    case Instruction::Type::Jump:
+    case Instruction::Type::JumpConditional:
+    case Instruction::Type::JumpNullish:
+    case Instruction::Type::JumpUndefined:
+        visit(static_cast<Op::Jump const&>(instruction).true_target());
+        visit(static_cast<Op::Jump const&>(instruction).false_target());
+        break;
+    case Instruction::Type::EnterUnwindContext: {
+        auto& enter_unwind_context = static_cast<Op::EnterUnwindContext const&>(instruction);
+        callback(enter_unwind_context.entry_point().block());
+        visit(enter_unwind_context.handler_target());
+        visit(enter_unwind_context.finalizer_target());
+        break;
+    }
+    case Instruction::Type::ContinuePendingUnwind:
+        callback(static_cast<Op::ContinuePendingUnwind const&>(instruction).resume_target().block());
+        break;
+    case Instruction::Type::FinishUnwind:
+        callback(static_cast<Op::FinishUnwind const&>(instruction).next_target().block());
+        break;
+    case Instruction::Type::Yield:
+        visit(static_cast<Op::Yield const&>(instruction).continuation());
+        break;
+    default:
+        break;
+    }
+}
+
+RegisterLiveness compute_register_liveness(Executable& executable)
+{
+    struct BlockSummary {
+        Vector<BasicBlock const*> successors;
+        // Registers that are read before the block writes them.
+        HashTable<u32> reads;
+        HashTable<u32> writes;
+    };
+
+    HashMap<BasicBlock const*, BlockSummary> summaries;
+    HashTable<BasicBlock const*> unwind_targets;
+
+    for (auto& block : executable.basic_blocks) {
+        BlockSummary summary;
+        InstructionStreamIterator it { block.instruction_stream() };
+        while (!it.at_end()) {
+            auto& instruction = const_cast<Instruction&>(*it);
+            ++it;
+            if (instruction.type() == Instruction::Type::Store) {
+                auto index = static_cast<Op::Store const&>(instruction).dst().index();
+                if (index != Register::accumulator_index)
+                    summary.writes.set(index);
+            } else {
+                instruction.visit_registers([&](Register& reg) {
+                    if (reg.index() != Register::accumulator_index && !summary.writes.contains(reg.index()))
+                        summary.reads.set(reg.index());
+                });
+            }
+
+            for_each_successor(instruction, [&](BasicBlock const& successor) {
+                if (!summary.successors.contains_slow(&successor))
+                    summary.successors.append(&successor);
+            });
+            if (instruction.type() == Instruction::Type::EnterUnwindContext) {
+                auto& enter_unwind_context = static_cast<Op::EnterUnwindContext const&>(instruction);
+                if (enter_unwind_context.handler_target().has_value())
+                    unwind_targets.set(&enter_unwind_context.handler_target()->block());
+                if (enter_unwind_context.finalizer_target().has_value())
+                    unwind_targets.set(&enter_unwind_context.finalizer_target()->block());
+            }
+        }
+        summaries.set(&block, move(summary));
+    }
+
+    RegisterLiveness liveness;
+
+    // Registers only ever become live, so we're done once no block has gained a live register.
+    // Going backwards through the blocks lets most of them see their successors' final state right away.
+    bool changed = true;
+    while (changed) {
+        changed = false;
+        for (size_t i = executable.basic_blocks.size(); i > 0; --i) {
+            auto const* block = executable.basic_blocks.ptr_at(i - 1).ptr();
+            auto& summary = summaries.find(block)->value;
+
+            auto& live_at_end = liveness.live_at_end.ensure(block);
+            for (auto const* successor : summary.successors) {
+                auto live_at_successor_start = liveness.live_at_start.find(successor);
+                if (live_at_successor_start == liveness.live_at_start.end())
+                    continue;
+                for (auto index : live_at_successor_start->value)
+                    live_at_end.set(index);
+            }
+
+            auto& live_at_start = liveness.live_at_start.ensure(block);
+            auto live_count = live_at_start.size();
+            for (auto index : summary.reads)
+                live_at_start.set(index);
+            for (auto index : live_at_end) {
+                if (!summary.writes.contains(index))
+                    live_at_start.set(index);
+            }
+            if (live_at_start.size() != live_count)
+                changed = true;
+        }
+    }
+
+    for (auto const* block : unwind_targets) {
+        if (auto live_at_start = liveness.live_at_start.find(block); live_at_start != liveness.live_at_start.end()) {
+            for (auto index : live_at_start->value)
+                liveness.live_everywhere.set(index);
+        }
+    }
+
+    return liveness;
+}
+
+}
@@ -20,6 +20,19 @@ struct PassPipelineExecutable {
     Optional<HashTable<BasicBlock const*>> exported_blocks {};
 };
 
+// The indices of the registers that hold a value which may still be read at the start and at the
+// end of each block. The accumulator isn't included.
+struct RegisterLiveness {
+    HashMap<BasicBlock const*, HashTable<u32>> live_at_start;
+    HashMap<BasicBlock const*, HashTable<u32>> live_at_end;
+
+    // Exception handlers and finalizers can be entered from any instruction in their unwind context,
+    // so the registers they read are treated as live everywhere.
+    HashTable<u32> live_everywhere;
+};
+
+RegisterLiveness compute_register_liveness(Executable&);
+
 class Pass {
 public:
     Pass() = default;
@@ -121,6 +134,40 @@ private:
     virtual void perform(PassPipelineExecutable&) override;
 };
 
+// Removes a Load or Store when the accumulator already holds the value of that register,
+// because the register was just loaded from or stored to.
+class EliminateLoads : public Pass {
+public:
+    EliminateLoads() = default;
+    ~EliminateLoads() override = default;
+
+private:
+    virtual void perform(PassPipelineExecutable&) override;
+};
+
+// Removes a Store when the register isn't read again before it's overwritten.
+class EliminateDeadStores : public Pass {
+public:
+    EliminateDeadStores() = default;
+    ~EliminateDeadStores() override = default;
+
+private:
+    virtual void perform(PassPipelineExecutable&) override;
+};
+
+// Renames the registers so that registers which are never live at the same time share an index,
+// which shrinks the register window of the executable. A register that is only loaded into the
+// accumulator to be stored into another register gets the same index as that register if possible,
+// so running EliminateLoads afterwards removes the copy.
+class AllocateRegisters : public Pass {
+public:
+    AllocateRegisters() = default;
+    ~AllocateRegisters() override = default;
+
+private:
+    virtual void perform(PassPipelineExecutable&) override;
+};
+
 class DumpCFG : public Pass {
 public:
     DumpCFG(FILE* file)
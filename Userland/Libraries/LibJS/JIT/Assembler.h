@@ -0,0 +1,311 @@
+/*
+ * Copyright (c) 2022, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#pragma once
+
+#include <AK/Optional.h>
+#include <AK/Types.h>
+#include <AK/Vector.h>
+
+namespace JS::JIT {
+
+// Just enough of an x86-64 assembler for the code the Compiler emits. Every memory operand is
+// a base register plus a 32-bit displacement, and every jump uses a 32-bit relative offset.
+class Assembler {
+public:
+    enum class Reg : u8 {
+        RAX = 0,
+        RCX,
+        RDX,
+        RBX,
+        RSP,
+        RBP,
+        RSI,
+        RDI,
+        R8,
+        R9,
+        R10,
+        R11,
+        R12,
+        R13,
+        R14,
+        R15,
+    };
+
+    enum class Condition : u8 {
+        Overflow = 0x0,
+        EqualTo = 0x4,
+        NotEqualTo = 0x5,
+        SignedLessThan = 0xC,
+        SignedGreaterThanOrEqualTo = 0xD,
+        SignedLessThanOrEqualTo = 0xE,
+        SignedGreaterThan = 0xF,
+    };
+
+    struct Label {
+        Optional<size_t> offset;
+        // Offsets of the rel32 operands that have to be patched once the label is linked.
+        Vector<size_t> jump_sites;
+    };
+
+    explicit Assembler(Vector<u8>& output)
+        : m_output(output)
+    {
+    }
+
+    size_t offset() const { return m_output.size(); }
+
+    void link(Label& label)
+    {
+        VERIFY(!label.offset.has_value());
+        label.offset = offset();
+        for (auto jump_site : label.jump_sites)
+            patch_rel32(jump_site, *label.offset);
+        label.jump_sites.clear();
+    }
+
+    // mov dst, src
+    void mov(Reg dst, Reg src)
+    {
+        emit_rex(true, src, dst);
+        emit8(0x89);
+        emit_modrm_reg(src, dst);
+    }
+
+    // mov dst, imm64
+    void mov(Reg dst, u64 imm)
+    {
+        emit_rex(true, Reg::RAX, dst);
+        emit8(0xB8 | (to_underlying(dst) & 7));
+        emit64(imm);
+    }
+
+    // mov dst32, imm32 (zero-extends into the upper half of dst)
+    void mov32(Reg dst, u32 imm)
+    {
+        emit_rex(false, Reg::RAX, dst);
+        emit8(0xB8 | (to_underlying(dst) & 7));
+        emit32(imm);
+    }
+
+    // mov dst, [base + displacement]
+    void load(Reg dst, Reg base, i32 displacement)
+    {
+        emit_rex(true, dst, base);
+        emit8(0x8B);
+        emit_modrm_memory(dst, base, displacement);
+    }
+
+    // mov dst32, [base + displacement] (zero-extends into the upper half of dst)
+    void load32(Reg dst, Reg base, i32 displacement)
+    {
+        emit_rex(false, dst, base);
+        emit8(0x8B);
+        emit_modrm_memory(dst, base, displacement);
+    }
+
+    // movzx dst32, byte [base + displacement]
+    void load8(Reg dst, Reg base, i32 displacement)
+    {
+        emit_rex(false, dst, base);
+        emit8(0x0F);
+        emit8(0xB6);
+        emit_modrm_memory(dst, base, displacement);
+    }
+
+    // mov [base + displacement], src
+    void store(Reg base, i32 displacement, Reg src)
+    {
+        emit_rex(true, src, base);
+        emit8(0x89);
+        emit_modrm_memory(src, base, displacement);
+    }
+
+    // Two-operand 32-bit arithmetic, dst32 = dst32 op src32. Like every 32-bit operation,
+    // these clear the upper half of dst.
+    void add32(Reg dst, Reg src) { emit_alu32(0x01, dst, src); }
+    void sub32(Reg dst, Reg src) { emit_alu32(0x29, dst, src); }
+    void and32(Reg dst, Reg src) { emit_alu32(0x21, dst, src); }
+    void or32(Reg dst, Reg src) { emit_alu32(0x09, dst, src); }
+    void xor32(Reg dst, Reg src) { emit_alu32(0x31, dst, src); }
+    void cmp32(Reg lhs, Reg rhs) { emit_alu32(0x39, lhs, rhs); }
+    void test32(Reg lhs, Reg rhs) { emit_alu32(0x85, lhs, rhs); }
+
+    // imul dst32, src32
+    void imul32(Reg dst, Reg src)
+    {
+        emit_rex(false, dst, src);
+        emit8(0x0F);
+        emit8(0xAF);
+        emit_modrm_reg(dst, src);
+    }
+
+    // add dst32, imm32 / sub dst32, imm32 / and dst32, imm32 / cmp dst32, imm32
+    void add32(Reg dst, u32 imm) { emit_alu32_imm(0, dst, imm); }
+    void sub32(Reg dst, u32 imm) { emit_alu32_imm(5, dst, imm); }
+    void and32(Reg dst, u32 imm) { emit_alu32_imm(4, dst, imm); }
+    void cmp32(Reg dst, u32 imm) { emit_alu32_imm(7, dst, imm); }
+
+    // add dst, src / or dst, src / cmp lhs, rhs / test lhs, rhs
+    void add64(Reg dst, Reg src) { emit_alu64(0x01, dst, src); }
+    void or64(Reg dst, Reg src) { emit_alu64(0x09, dst, src); }
+    void cmp64(Reg lhs, Reg rhs) { emit_alu64(0x39, lhs, rhs); }
+    void test64(Reg lhs, Reg rhs) { emit_alu64(0x85, lhs, rhs); }
+
+    // shl dst, imm8 / shr dst, imm8 / sar dst, imm8
+    void shl64(Reg dst, u8 imm) { emit_shift64(4, dst, imm); }
+    void shr64(Reg dst, u8 imm) { emit_shift64(5, dst, imm); }
+    void sar64(Reg dst, u8 imm) { emit_shift64(7, dst, imm); }
+
+    // setcc dst8. Only the registers whose low byte can be named without a REX prefix are supported.
+    void set_if(Condition condition, Reg dst)
+    {
+        VERIFY(to_underlying(dst) <= to_underlying(Reg::RBX));
+        emit8(0x0F);
+        emit8(0x90 | to_underlying(condition));
+        emit_modrm_reg(Reg::RAX, dst);
+    }
+
+    // jmp label
+    void jump(Label& label)
+    {
+        emit8(0xE9);
+        emit_rel32(label);
+    }
+
+    // jcc label
+    void jump_if(Condition condition, Label& label)
+    {
+        emit8(0x0F);
+        emit8(0x80 | to_underlying(condition));
+        emit_rel32(label);
+    }
+
+    // jmp target
+    void jump(Reg target)
+    {
+        emit_rex(false, Reg::RAX, target);
+        emit8(0xFF);
+        emit_modrm_reg(static_cast<Reg>(4), target);
+    }
+
+    // call target
+    void call(Reg target)
+    {
+        emit_rex(false, Reg::RAX, target);
+        emit8(0xFF);
+        emit_modrm_reg(static_cast<Reg>(2), target);
+    }
+
+    void push(Reg reg)
+    {
+        emit_rex(false, Reg::RAX, reg);
+        emit8(0x50 | (to_underlying(reg) & 7));
+    }
+
+    void pop(Reg reg)
+    {
+        emit_rex(false, Reg::RAX, reg);
+        emit8(0x58 | (to_underlying(reg) & 7));
+    }
+
+    void ret() { emit8(0xC3); }
+
+private:
+    void emit8(u8 value) { m_output.append(value); }
+
+    void emit32(u32 value)
+    {
+        for (size_t i = 0; i < 4; ++i)
+            emit8((value >> (i * 8)) & 0xFF);
+    }
+
+    void emit64(u64 value)
+    {
+        for (size_t i = 0; i < 8; ++i)
+            emit8((value >> (i * 8)) & 0xFF);
+    }
+
+    // The REX prefix extends the ModRM reg and r/m fields to the upper eight registers, and W selects 64-bit operands.
+    void emit_rex(bool is_64_bit, Reg reg, Reg rm)
+    {
+        u8 rex = 0x40;
+        if (is_64_bit)
+            rex |= 0x08;
+        if (to_underlying(reg) & 8)
+            rex |= 0x04;
+        if (to_underlying(rm) & 8)
+            rex |= 0x01;
+        if (rex != 0x40)
+            emit8(rex);
+    }
+
+    void emit_modrm_reg(Reg reg, Reg rm)
+    {
+        emit8(0xC0 | ((to_underlying(reg) & 7) << 3) | (to_underlying(rm) & 7));
+    }
+
+    void emit_modrm_memory(Reg reg, Reg base, i32 displacement)
+    {
+        emit8(0x80 | ((to_underlying(reg) & 7) << 3) | (to_underlying(base) & 7));
+        // RSP and R12 as a base can only be encoded with a SIB byte.
+        if ((to_underlying(base) & 7) == to_underlying(Reg::RSP))
+            emit8(0x24);
+        emit32(static_cast<u32>(displacement));
+    }
+
+    void emit_alu32(u8 opcode, Reg dst, Reg src)
+    {
+        emit_rex(false, src, dst);
+        emit8(opcode);
+        emit_modrm_reg(src, dst);
+    }
+
+    void emit_alu64(u8 opcode, Reg dst, Reg src)
+    {
+        emit_rex(true, src, dst);
+        emit8(opcode);
+        emit_modrm_reg(src, dst);
+    }
+
+    void emit_shift64(u8 extension, Reg dst, u8 imm)
+    {
+        emit_rex(true, Reg::RAX, dst);
+        emit8(0xC1);
+        emit_modrm_reg(static_cast<Reg>(extension), dst);
+        emit8(imm);
+    }
+
+    void emit_alu32_imm(u8 extension, Reg dst, u32 imm)
+    {
+        emit_rex(false, Reg::RAX, dst);
+        emit8(0x81);
+        emit_modrm_reg(static_cast<Reg>(extension), dst);
+        emit32(imm);
+    }
+
+    void emit_rel32(Label& label)
+    {
+        auto jump_site = offset();
+        emit32(0);
+        if (label.offset.has_value())
+            patch_rel32(jump_site, *label.offset);
+        else
+            label.jump_sites.append(jump_site);
+    }
+
+    void patch_rel32(size_t jump_site, size_t target)
+    {
+        // The offset is relative to the end of the instruction, which the rel32 operand always ends.
+        auto relative_offset = static_cast<i32>(static_cast<ssize_t>(target) - static_cast<ssize_t>(jump_site + 4));
+        for (size_t i = 0; i < 4; ++i)
+            m_output[jump_site + i] = (static_cast<u32>(relative_offset) >> (i * 8)) & 0xFF;
+    }
+
+    Vector<u8>& m_output;
+};
+
+}
@@ -0,0 +1,518 @@
+/*
+ * Copyright (c) 2022, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <AK/Platform.h>
+#include <LibJS/Bytecode/BasicBlock.h>
+#include <LibJS/Bytecode/Executable.h>
+#include <LibJS/Bytecode/Interpreter.h>
+#include <LibJS/JIT/Compiler.h>
+#include <LibJS/Runtime/Object.h>
+#include <LibJS/Runtime/Shape.h>
+
+namespace JS::JIT {
+
+bool g_jit_enabled = false;
+size_t g_jit_threshold = 10;
+
+// Native code keeps the address of the current register window in RBX and the interpreter in R12, both
+// of which survive calls. RAX, RCX and RDX are scratch registers, and so are RDI and RSI, which also pass
+// arguments to C++.
+static constexpr auto s_registers_base = Assembler::Reg::RBX;
+static constexpr auto s_interpreter = Assembler::Reg::R12;
+
+static_assert(sizeof(Value) == sizeof(u64));
+
+// Called instead of an instruction that has no inline code, or whose inline code hit a case it doesn't handle.
+template<typename OpType>
+static u32 run_instruction(Bytecode::Interpreter& interpreter, OpType const& instruction)
+{
+    return to_underlying(interpreter.did_run_instruction_from_native_code(instruction.execute_impl(interpreter)));
+}
+
+static u32 to_boolean(Value const* value)
+{
+    return value->to_boolean();
+}
+
+Compiler::Compiler(Bytecode::Executable const& executable)
+    : m_executable(executable)
+    , m_assembler(m_output)
+{
+    m_block_labels.resize(executable.basic_blocks.size());
+    for (size_t i = 0; i < executable.basic_blocks.size(); ++i)
+        m_block_indices.set(&executable.basic_blocks[i], i);
+}
+
+OwnPtr<NativeExecutable> Compiler::compile(Bytecode::Executable const& executable)
+{
+#if ARCH(X86_64)
+    Compiler compiler { executable };
+    compiler.compile_prologue_and_exit();
+    for (auto& block : executable.basic_blocks)
+        compiler.compile_block(block);
+
+    HashMap<Bytecode::BasicBlock const*, size_t> block_offsets;
+    for (auto& block : executable.basic_blocks)
+        block_offsets.set(&block, *compiler.label_for(block).offset);
+    return NativeExecutable::create(compiler.m_output, move(block_offsets));
+#else
+    (void)executable;
+    return nullptr;
+#endif
+}
+
+void Compiler::compile_prologue_and_exit()
+{
+    // u32 entry(Value* registers, Bytecode::Interpreter*, u8 const* block_entry_point)
+    // Saving three registers (and the return address) keeps the stack 16-byte aligned for the calls we make.
+    m_assembler.push(Reg::RBP);
+    m_assembler.mov(Reg::RBP, Reg::RSP);
+    m_assembler.push(s_registers_base);
+    m_assembler.push(s_interpreter);
+    m_assembler.mov(s_registers_base, Reg::RDI);
+    m_assembler.mov(s_interpreter, Reg::RSI);
+    m_assembler.jump(Reg::RDX);
+
+    // Everything that leaves native code jumps here with the Exit in EAX.
+    m_assembler.link(m_exit);
+    m_assembler.pop(s_interpreter);
+    m_assembler.pop(s_registers_base);
+    m_assembler.pop(Reg::RBP);
+    m_assembler.ret();
+}
+
+void Compiler::compile_block(Bytecode::BasicBlock const& block)
+{
+    m_assembler.link(label_for(block));
+
+    Bytecode::InstructionStreamIterator it { block.instruction_stream() };
+    while (!it.at_end()) {
+        auto& instruction = *it;
+        ++it;
+
+        switch (instruction.type()) {
+        case Bytecode::Instruction::Type::Load:
+            compile_load(static_cast<Bytecode::Op::Load const&>(instruction));
+            break;
+        case Bytecode::Instruction::Type::LoadImmediate:
+            compile_load_immediate(static_cast<Bytecode::Op::LoadImmediate const&>(instruction));
+            break;
+        case Bytecode::Instruction::Type::Store:
+            compile_store(static_cast<Bytecode::Op::Store const&>(instruction));
+            break;
+        case Bytecode::Instruction::Type::Jump:
+            compile_jump(static_cast<Bytecode::Op::Jump const&>(instruction));
+            break;
+        case Bytecode::Instruction::Type::JumpConditional:
+            compile_jump_conditional(static_cast<Bytecode::Op::JumpConditional const&>(instruction));
+            break;
+        case Bytecode::Instruction::Type::JumpNullish:
+            compile_jump_nullish(static_cast<Bytecode::Op::JumpNullish const&>(instruction));
+            break;
+        case Bytecode::Instruction::Type::JumpUndefined:
+            compile_jump_undefined(static_cast<Bytecode::Op::JumpUndefined const&>(instruction));
+            break;
+        case Bytecode::Instruction::Type::Increment:
+            compile_increment(static_cast<Bytecode::Op::Increment const&>(instruction));
+            break;
+        case Bytecode::Instruction::Type::Decrement:
+            compile_decrement(static_cast<Bytecode::Op::Decrement const&>(instruction));
+            break;
+        case Bytecode::Instruction::Type::Add:
+            compile_int32_binary_op(static_cast<Bytecode::Op::Add const&>(instruction), [&](Label& slow_case) {
+                m_assembler.add32(Reg::RAX, Reg::RCX);
+                m_assembler.jump_if(Assembler::Condition::Overflow, slow_case);
+                box_int32(Reg::RAX);
+            });
+            break;
+        case Bytecode::Instruction::Type::Sub:
+            compile_int32_binary_op(static_cast<Bytecode::Op::Sub const&>(instruction), [&](Label& slow_case) {
+                m_assembler.sub32(Reg::RAX, Reg::RCX);
+                m_assembler.jump_if(Assembler::Condition::Overflow, slow_case);
+                box_int32(Reg::RAX);
+            });
+            break;
+        case Bytecode::Instruction::Type::Mul:
+            compile_int32_binary_op(static_cast<Bytecode::Op::Mul const&>(instruction), [&](Label& slow_case) {
+                m_assembler.imul32(Reg::RAX, Reg::RCX);
+                m_assembler.jump_if(Assembler::Condition::Overflow, slow_case);
+                // A zero result might have to be -0, which isn't an int32.
+                m_assembler.test32(Reg::RAX, Reg::RAX);
+                m_assembler.jump_if(Assembler::Condition::EqualTo, slow_case);
+                box_int32(Reg::RAX);
+            });
+            break;
+        case Bytecode::Instruction::Type::BitwiseAnd:
+            compile_int32_binary_op(static_cast<Bytecode::Op::BitwiseAnd const&>(instruction), [&](Label&) {
+                m_assembler.and32(Reg::RAX, Reg::RCX);
+                box_int32(Reg::RAX);
+            });
+            break;
+        case Bytecode::Instruction::Type::BitwiseOr:
+            compile_int32_binary_op(static_cast<Bytecode::Op::BitwiseOr const&>(instruction), [&](Label&) {
+                m_assembler.or32(Reg::RAX, Reg::RCX);
+                box_int32(Reg::RAX);
+            });
+            break;
+        case Bytecode::Instruction::Type::BitwiseXor:
+            compile_int32_binary_op(static_cast<Bytecode::Op::BitwiseXor const&>(instruction), [&](Label&) {
+                m_assembler.xor32(Reg::RAX, Reg::RCX);
+                box_int32(Reg::RAX);
+            });
+            break;
+        case Bytecode::Instruction::Type::LessThan:
+            compile_int32_comparison(static_cast<Bytecode::Op::LessThan const&>(instruction), Assembler::Condition::SignedLessThan);
+            break;
+        case Bytecode::Instruction::Type::LessThanEquals:
+            compile_int32_comparison(static_cast<Bytecode::Op::LessThanEquals const&>(instruction), Assembler::Condition::SignedLessThanOrEqualTo);
+            break;
+        case Bytecode::Instruction::Type::GreaterThan:
+            compile_int32_comparison(static_cast<Bytecode::Op::GreaterThan const&>(instruction), Assembler::Condition::SignedGreaterThan);
+            break;
+        case Bytecode::Instruction::Type::GreaterThanEquals:
+            compile_int32_comparison(static_cast<Bytecode::Op::GreaterThanEquals const&>(instruction), Assembler::Condition::SignedGreaterThanOrEqualTo);
+            break;
+        case Bytecode::Instruction::Type::StrictlyEquals:
+            compile_int32_comparison(static_cast<Bytecode::Op::StrictlyEquals const&>(instruction), Assembler::Condition::EqualTo);
+            break;
+        case Bytecode::Instruction::Type::StrictlyInequals:
+            compile_int32_comparison(static_cast<Bytecode::Op::StrictlyInequals const&>(instruction), Assembler::Condition::NotEqualTo);
+            break;
+        case Bytecode::Instruction::Type::GetById:
+            compile_get_by_id(static_cast<Bytecode::Op::GetById const&>(instruction));
+            break;
+        case Bytecode::Instruction::Type::PutById:
+            compile_put_by_id(static_cast<Bytecode::Op::PutById const&>(instruction));
+            break;
+        default:
+            compile_call_to_execute_impl(instruction);
+            break;
+        }
+    }
+
+    // Blocks that don't end in a terminator end the executable, just like in the interpreter.
+    compile_exit(Exit::Finished);
+}
+
+void Compiler::compile_load(Bytecode::Op::Load const& instruction)
+{
+    load_vm_register(Reg::RAX, instruction.src());
+    store_vm_register(Bytecode::Register::accumulator(), Reg::RAX);
+}
+
+void Compiler::compile_load_immediate(Bytecode::Op::LoadImmediate const& instruction)
+{
+    m_assembler.mov(Reg::RAX, instruction.value().encoded());
+    store_vm_register(Bytecode::Register::accumulator(), Reg::RAX);
+}
+
+void Compiler::compile_store(Bytecode::Op::Store const& instruction)
+{
+    load_vm_register(Reg::RAX, Bytecode::Register::accumulator());
+    store_vm_register(instruction.dst(), Reg::RAX);
+}
+
+void Compiler::compile_jump(Bytecode::Op::Jump const& instruction)
+{
+    m_assembler.jump(label_for(instruction.true_target()->block()));
+}
+
+void Compiler::compile_jump_conditional(Bytecode::Op::JumpConditional const& instruction)
+{
+    Label check_low_bits;
+    load_vm_register(Reg::RAX, Bytecode::Register::accumulator());
+    m_assembler.mov(Reg::RDX, Reg::RAX);
+    m_assembler.shr64(Reg::RDX, TAG_SHIFT);
+
+    // Booleans and int32s are truthy if their low 32 bits aren't all zero.
+    m_assembler.cmp32(Reg::RDX, static_cast<u32>(BOOLEAN_TAG));
+    m_assembler.jump_if(Assembler::Condition::EqualTo, check_low_bits);
+    m_assembler.cmp32(Reg::RDX, static_cast<u32>(INT32_TAG));
+    m_assembler.jump_if(Assembler::Condition::EqualTo, check_low_bits);
+
+    // The accumulator is the first register.
+    m_assembler.mov(Reg::RDI, s_registers_base);
+    m_assembler.mov(Reg::RAX, bit_cast<u64>(&to_boolean));
+    m_assembler.call(Reg::RAX);
+
+    m_assembler.link(check_low_bits);
+    m_assembler.test32(Reg::RAX, Reg::RAX);
+    branch_to_targets(Assembler::Condition::NotEqualTo, instruction);
+}
+
+void Compiler::compile_jump_nullish(Bytecode::Op::JumpNullish const& instruction)
+{
+    load_vm_register(Reg::RDX, Bytecode::Register::accumulator());
+    m_assembler.shr64(Reg::RDX, TAG_SHIFT);
+    m_assembler.and32(Reg::RDX, static_cast<u32>(IS_NULLISH_EXTRACT_PATTERN));
+    m_assembler.cmp32(Reg::RDX, static_cast<u32>(IS_NULLISH_PATTERN));
+    branch_to_targets(Assembler::Condition::EqualTo, instruction);
+}
+
+void Compiler::compile_jump_undefined(Bytecode::Op::JumpUndefined const& instruction)
+{
+    load_vm_register(Reg::RDX, Bytecode::Register::accumulator());
+    m_assembler.shr64(Reg::RDX, TAG_SHIFT);
+    m_assembler.cmp32(Reg::RDX, static_cast<u32>(UNDEFINED_TAG));
+    branch_to_targets(Assembler::Condition::EqualTo, instruction);
+}
+
+void Compiler::compile_increment(Bytecode::Op::Increment const& instruction)
+{
+    Label slow_case;
+    Label done;
+    load_vm_register(Reg::RAX, Bytecode::Register::accumulator());
+    branch_if_not_int32(Reg::RAX, slow_case);
+    m_assembler.add32(Reg::RAX, 1u);
+    m_assembler.jump_if(Assembler::Condition::Overflow, slow_case);
+    box_int32(Reg::RAX);
+    store_vm_register(Bytecode::Register::accumulator(), Reg::RAX);
+    m_assembler.jump(done);
+
+    m_assembler.link(slow_case);
+    compile_call_to_execute_impl(instruction);
+    m_assembler.link(done);
+}
+
+void Compiler::compile_decrement(Bytecode::Op::Decrement const& instruction)
+{
+    Label slow_case;
+    Label done;
+    load_vm_register(Reg::RAX, Bytecode::Register::accumulator());
+    branch_if_not_int32(Reg::RAX, slow_case);
+    m_assembler.sub32(Reg::RAX, 1u);
+    m_assembler.jump_if(Assembler::Condition::Overflow, slow_case);
+    box_int32(Reg::RAX);
+    store_vm_register(Bytecode::Register::accumulator(), Reg::RAX);
+    m_assembler.jump(done);
+
+    m_assembler.link(slow_case);
+    compile_call_to_execute_impl(instruction);
+    m_assembler.link(done);
+}
+
+void Compiler::compile_get_by_id(Bytecode::Op::GetById const& instruction)
+{
+    Label slow_case;
+    Label done;
+    load_vm_register(Reg::RAX, Bytecode::Register::accumulator());
+    compile_property_lookup_cache_check(m_executable.property_lookup_caches[instruction.cache_index()], true, slow_case);
+    m_assembler.load(Reg::RAX, Reg::RSI, 0);
+    branch_if_empty_or_accessor(Reg::RAX, slow_case);
+    store_vm_register(Bytecode::Register::accumulator(), Reg::RAX);
+    m_assembler.jump(done);
+
+    m_assembler.link(slow_case);
+    compile_call_to_execute_impl(instruction);
+    m_assembler.link(done);
+}
+
+void Compiler::compile_put_by_id(Bytecode::Op::PutById const& instruction)
+{
+    if (instruction.kind() != Bytecode::Op::PropertyKind::KeyValue) {
+        compile_call_to_execute_impl(instruction);
+        return;
+    }
+
+    Label slow_case;
+    Label done;
+    load_vm_register(Reg::RAX, instruction.base());
+    compile_property_lookup_cache_check(m_executable.property_lookup_caches[instruction.cache_index()], false, slow_case);
+    m_assembler.load(Reg::RAX, Reg::RSI, 0);
+    branch_if_empty_or_accessor(Reg::RAX, slow_case);
+    load_vm_register(Reg::RAX, Bytecode::Register::accumulator());
+    m_assembler.store(Reg::RSI, 0, Reg::RAX);
+    m_assembler.jump(done);
+
+    m_assembler.link(slow_case);
+    compile_call_to_execute_impl(instruction);
+    m_assembler.link(done);
+}
+
+void Compiler::compile_property_lookup_cache_check(Bytecode::PropertyLookupCache const& cache, bool may_be_on_prototype, Label& slow_case)
+{
+    using Entry = Bytecode::PropertyLookupCache::Entry;
+
+    // Loads a Shape* from a WeakPtr<Shape>, which is null if the WeakPtr was never set or the shape died.
+    auto load_weak_shape_pointer = [&](Reg dst, Reg entry, size_t weak_ptr_offset, Label& if_null) {
+        m_assembler.load(dst, entry, weak_ptr_offset + WeakPtr<Shape>::link_offset());
+        m_assembler.test64(dst, dst);
+        m_assembler.jump_if(Assembler::Condition::EqualTo, if_null);
+        m_assembler.load(dst, dst, AK::WeakLink::ptr_offset());
+    };
+
+    // Like find_property_lookup_cache_entry(), this takes the object's shape in RSI and the entry's address in RCX,
+    // and checks that they still describe each other.
+    auto branch_if_shape_does_not_match = [&](size_t weak_ptr_offset, size_t serial_number_offset, Label& mismatch) {
+        load_weak_shape_pointer(Reg::RDX, Reg::RCX, weak_ptr_offset, mismatch);
+        m_assembler.cmp64(Reg::RDX, Reg::RSI);
+        m_assembler.jump_if(Assembler::Condition::NotEqualTo, mismatch);
+        m_assembler.load32(Reg::RDX, Reg::RCX, serial_number_offset);
+        m_assembler.load32(Reg::RDI, Reg::RSI, Shape::unique_shape_serial_number_offset());
+        m_assembler.cmp32(Reg::RDX, Reg::RDI);
+        m_assembler.jump_if(Assembler::Condition::NotEqualTo, mismatch);
+    };
+
+    // Leaves the Object* in RAX and its shape in RSI, as long as the object's property access is ordinary.
+    auto load_ordinary_object_and_shape = [&] {
+        m_assembler.load8(Reg::RDX, Reg::RAX, Object::has_ordinary_property_access_offset());
+        m_assembler.test32(Reg::RDX, Reg::RDX);
+        m_assembler.jump_if(Assembler::Condition::EqualTo, slow_case);
+        m_assembler.load(Reg::RSI, Reg::RAX, Object::shape_offset());
+    };
+
+    m_assembler.mov(Reg::RDX, Reg::RAX);
+    m_assembler.shr64(Reg::RDX, TAG_SHIFT);
+    m_assembler.cmp32(Reg::RDX, static_cast<u32>(OBJECT_TAG));
+    m_assembler.jump_if(Assembler::Condition::NotEqualTo, slow_case);
+    // The pointer bits are sign-extended from bit 47, see Value::extract_pointer_bits().
+    m_assembler.shl64(Reg::RAX, 16);
+    m_assembler.sar64(Reg::RAX, 16);
+    load_ordinary_object_and_shape();
+
+    // The cache's entries live as long as the executable, so their addresses can be baked into the code.
+    Label found;
+    for (auto const& entry : cache.entries) {
+        Label next_entry;
+        m_assembler.mov(Reg::RCX, bit_cast<u64>(&entry));
+        branch_if_shape_does_not_match(OFFSET_OF(Entry, shape), OFFSET_OF(Entry, unique_shape_serial_number), next_entry);
+        m_assembler.jump(found);
+        m_assembler.link(next_entry);
+    }
+    m_assembler.jump(slow_case);
+
+    m_assembler.link(found);
+    Label holder_is_object;
+    m_assembler.load8(Reg::RDX, Reg::RCX, OFFSET_OF(Entry, property_is_on_prototype));
+    m_assembler.test32(Reg::RDX, Reg::RDX);
+    if (may_be_on_prototype) {
+        m_assembler.jump_if(Assembler::Condition::EqualTo, holder_is_object);
+        m_assembler.load(Reg::RAX, Reg::RSI, Shape::prototype_offset());
+        m_assembler.test64(Reg::RAX, Reg::RAX);
+        m_assembler.jump_if(Assembler::Condition::EqualTo, slow_case);
+        load_ordinary_object_and_shape();
+        branch_if_shape_does_not_match(OFFSET_OF(Entry, prototype_shape), OFFSET_OF(Entry, prototype_unique_shape_serial_number), slow_case);
+    } else {
+        m_assembler.jump_if(Assembler::Condition::NotEqualTo, slow_case);
+    }
+
+    // RSI = &holder->m_storage[entry.property_offset]
+    m_assembler.link(holder_is_object);
+    m_assembler.load32(Reg::RDX, Reg::RCX, OFFSET_OF(Entry, property_offset));
+    m_assembler.shl64(Reg::RDX, 3);
+    m_assembler.load(Reg::RSI, Reg::RAX, Object::storage_offset() + Vector<Value>::outline_buffer_offset());
+    m_assembler.add64(Reg::RSI, Reg::RDX);
+}
+
+template<typename OpType, typename EmitFastCase>
+void Compiler::compile_int32_binary_op(OpType const& instruction, EmitFastCase emit_fast_case)
+{
+    Label slow_case;
+    Label done;
+    load_vm_register(Reg::RAX, instruction.lhs());
+    load_vm_register(Reg::RCX, Bytecode::Register::accumulator());
+    branch_if_not_int32(Reg::RAX, slow_case);
+    branch_if_not_int32(Reg::RCX, slow_case);
+    emit_fast_case(slow_case);
+    store_vm_register(Bytecode::Register::accumulator(), Reg::RAX);
+    m_assembler.jump(done);
+
+    // The fast case never writes a VM register before it knows it can finish.
+    m_assembler.link(slow_case);
+    compile_call_to_execute_impl(instruction);
+    m_assembler.link(done);
+}
+
+template<typename OpType>
+void Compiler::compile_int32_comparison(OpType const& instruction, Assembler::Condition condition)
+{
+    compile_int32_binary_op(instruction, [&](Label&) {
+        m_assembler.cmp32(Reg::RAX, Reg::RCX);
+        // Loading the tag leaves the flags alone, and the low byte then becomes 0 or 1.
+        m_assembler.mov(Reg::RAX, BOOLEAN_TAG << TAG_SHIFT);
+        m_assembler.set_if(condition, Reg::RAX);
+    });
+}
+
+void Compiler::compile_call_to_execute_impl(Bytecode::Instruction const& instruction)
+{
+    FlatPtr function = 0;
+    switch (instruction.type()) {
+#define __BYTECODE_OP(op)                                                   \
+    case Bytecode::Instruction::Type::op:                                   \
+        function = bit_cast<FlatPtr>(&run_instruction<Bytecode::Op::op>); \
+        break;
+        ENUMERATE_BYTECODE_OPS(__BYTECODE_OP)
+#undef __BYTECODE_OP
+    default:
+        VERIFY_NOT_REACHED();
+    }
+
+    m_assembler.mov(Reg::RDI, s_interpreter);
+    m_assembler.mov(Reg::RSI, bit_cast<u64>(&instruction));
+    m_assembler.mov(Reg::RAX, static_cast<u64>(function));
+    m_assembler.call(Reg::RAX);
+    m_assembler.test32(Reg::RAX, Reg::RAX);
+    m_assembler.jump_if(Assembler::Condition::NotEqualTo, m_exit);
+}
+
+void Compiler::compile_exit(Exit exit)
+{
+    m_assembler.mov32(Reg::RAX, to_underlying(exit));
+    m_assembler.jump(m_exit);
+}
+
+void Compiler::load_vm_register(Reg dst, Bytecode::Register reg)
+{
+    m_assembler.load(dst, s_registers_base, reg.index() * sizeof(Value));
+}
+
+void Compiler::store_vm_register(Bytecode::Register reg, Reg src)
+{
+    m_assembler.store(s_registers_base, reg.index() * sizeof(Value), src);
+}
+
+void Compiler::box_int32(Reg reg)
+{
+    // 32-bit operations have already cleared the upper half.
+    m_assembler.mov(Reg::RDX, SHIFTED_INT32_TAG);
+    m_assembler.or64(reg, Reg::RDX);
+}
+
+void Compiler::branch_if_not_int32(Reg reg, Label& label)
+{
+    m_assembler.mov(Reg::RDX, reg);
+    m_assembler.shr64(Reg::RDX, TAG_SHIFT);
+    m_assembler.cmp32(Reg::RDX, static_cast<u32>(INT32_TAG));
+    m_assembler.jump_if(Assembler::Condition::NotEqualTo, label);
+}
+
+void Compiler::branch_if_empty_or_accessor(Reg reg, Label& label)
+{
+    m_assembler.mov(Reg::RDX, reg);
+    m_assembler.shr64(Reg::RDX, TAG_SHIFT);
+    m_assembler.cmp32(Reg::RDX, static_cast<u32>(EMPTY_TAG));
+    m_assembler.jump_if(Assembler::Condition::EqualTo, label);
+    m_assembler.cmp32(Reg::RDX, static_cast<u32>(ACCESSOR_TAG));
+    m_assembler.jump_if(Assembler::Condition::EqualTo, label);
+}
+
+void Compiler::branch_to_targets(Assembler::Condition if_true, Bytecode::Op::Jump const& instruction)
+{
+    VERIFY(instruction.true_target().has_value());
+    VERIFY(instruction.false_target().has_value());
+    m_assembler.jump_if(if_true, label_for(instruction.true_target()->block()));
+    m_assembler.jump(label_for(instruction.false_target()->block()));
+}
+
+Assembler::Label& Compiler::label_for(Bytecode::BasicBlock const& block)
+{
+    auto index = m_block_indices.get(&block);
+    VERIFY(index.has_value());
+    return m_block_labels[*index];
+}
+
+}
@@ -0,0 +1,83 @@
+/*
+ * Copyright (c) 2022, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#pragma once
+
+#include <AK/HashMap.h>
+#include <AK/OwnPtr.h>
+#include <AK/Vector.h>
+#include <LibJS/Bytecode/Executable.h>
+#include <LibJS/Bytecode/Op.h>
+#include <LibJS/JIT/Assembler.h>
+#include <LibJS/JIT/NativeExecutable.h>
+
+namespace JS::JIT {
+
+extern bool g_jit_enabled;
+// How many times an executable runs in the interpreter before it gets compiled.
+extern size_t g_jit_threshold;
+
+// A baseline compiler: every instruction becomes a fixed sequence of machine code, without any
+// analysis across instructions. Loads, stores, jumps, arithmetic and comparisons on int32s, and property
+// accesses that hit their inline cache run inline; everything else, including the slow cases of those,
+// calls the instruction's execute_impl().
+class Compiler {
+public:
+    // Returns null if there's no compiler for this architecture.
+    static OwnPtr<NativeExecutable> compile(Bytecode::Executable const&);
+
+private:
+    using Reg = Assembler::Reg;
+    using Label = Assembler::Label;
+
+    explicit Compiler(Bytecode::Executable const&);
+
+    void compile_prologue_and_exit();
+    void compile_block(Bytecode::BasicBlock const&);
+
+    void compile_load(Bytecode::Op::Load const&);
+    void compile_load_immediate(Bytecode::Op::LoadImmediate const&);
+    void compile_store(Bytecode::Op::Store const&);
+    void compile_jump(Bytecode::Op::Jump const&);
+    void compile_jump_conditional(Bytecode::Op::JumpConditional const&);
+    void compile_jump_nullish(Bytecode::Op::JumpNullish const&);
+    void compile_jump_undefined(Bytecode::Op::JumpUndefined const&);
+    void compile_increment(Bytecode::Op::Increment const&);
+    void compile_decrement(Bytecode::Op::Decrement const&);
+    void compile_get_by_id(Bytecode::Op::GetById const&);
+    void compile_put_by_id(Bytecode::Op::PutById const&);
+
+    // Looks up the object Value in RAX in a property lookup cache, just like the interpreter does. On a hit, this
+    // falls through with the address of the property's storage slot in RSI; on anything else, it jumps to slow_case.
+    void compile_property_lookup_cache_check(Bytecode::PropertyLookupCache const&, bool may_be_on_prototype, Label& slow_case);
+
+    // Emits the fast case with the lhs in EAX and the rhs in ECX, leaving the result Value in RAX.
+    template<typename OpType, typename EmitFastCase>
+    void compile_int32_binary_op(OpType const&, EmitFastCase);
+    template<typename OpType>
+    void compile_int32_comparison(OpType const&, Assembler::Condition);
+
+    void compile_call_to_execute_impl(Bytecode::Instruction const&);
+    void compile_exit(Exit);
+
+    void load_vm_register(Reg dst, Bytecode::Register);
+    void store_vm_register(Bytecode::Register, Reg src);
+    void box_int32(Reg);
+    void branch_if_not_int32(Reg, Label&);
+    void branch_if_empty_or_accessor(Reg, Label&);
+    void branch_to_targets(Assembler::Condition if_true, Bytecode::Op::Jump const&);
+
+    Label& label_for(Bytecode::BasicBlock const&);
+
+    Bytecode::Executable const& m_executable;
+    Vector<u8> m_output;
+    Assembler m_assembler;
+    Label m_exit;
+    Vector<Label> m_block_labels;
+    HashMap<Bytecode::BasicBlock const*, size_t> m_block_indices;
+};
+
+}
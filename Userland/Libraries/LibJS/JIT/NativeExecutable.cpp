@@ -0,0 +1,69 @@
+/*
+ * Copyright (c) 2022, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <AK/BitCast.h>
+#include <AK/ScopeGuard.h>
+#include <LibCore/System.h>
+#include <LibJS/JIT/NativeExecutable.h>
+#include <fcntl.h>
+#include <stdio.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <unistd.h>
+
+namespace JS::JIT {
+
+// The code is written through one mapping of an anonymous file and run from another, so no region is ever
+// writable and executable at the same time. Simply using mprotect() wouldn't do, as SerenityOS never lets a
+// region that has been writable become executable.
+static ErrorOr<u8*> map_executable_copy(ReadonlyBytes code, size_t size)
+{
+    auto fd = TRY(Core::System::anon_create(size, O_CLOEXEC));
+    ScopeGuard close_fd = [&] { MUST(Core::System::close(fd)); };
+
+    auto* writable_code = TRY(Core::System::mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0));
+    memcpy(writable_code, code.data(), code.size());
+    auto executable_code = Core::System::mmap(nullptr, size, PROT_READ | PROT_EXEC, MAP_SHARED, fd, 0);
+    MUST(Core::System::munmap(writable_code, size));
+    return static_cast<u8*>(TRY(executable_code));
+}
+
+OwnPtr<NativeExecutable> NativeExecutable::create(ReadonlyBytes code, HashMap<Bytecode::BasicBlock const*, size_t> block_offsets)
+{
+    auto page_size = static_cast<size_t>(sysconf(_SC_PAGESIZE));
+    auto size = (code.size() + page_size - 1) & ~(page_size - 1);
+
+    auto executable_code = map_executable_copy(code, size);
+    if (executable_code.is_error())
+        return nullptr;
+
+    return adopt_own_if_nonnull(new (nothrow) NativeExecutable(executable_code.value(), size, move(block_offsets)));
+}
+
+NativeExecutable::NativeExecutable(u8* code, size_t size, HashMap<Bytecode::BasicBlock const*, size_t> block_offsets)
+    : m_code(code)
+    , m_size(size)
+    , m_block_offsets(move(block_offsets))
+{
+}
+
+NativeExecutable::~NativeExecutable()
+{
+    if (munmap(m_code, m_size) < 0)
+        perror("munmap");
+}
+
+Exit NativeExecutable::run(Bytecode::Interpreter& interpreter, Value* registers, Bytecode::BasicBlock const& entry_block) const
+{
+    // The code starts with a prologue that takes the entry point for the block as its third argument.
+    using EntryPoint = u32 (*)(Value*, Bytecode::Interpreter*, u8 const*);
+    auto entry_offset = m_block_offsets.get(&entry_block);
+    VERIFY(entry_offset.has_value());
+    auto entry_point = bit_cast<EntryPoint>(m_code);
+    return static_cast<Exit>(entry_point(registers, &interpreter, m_code + *entry_offset));
+}
+
+}
@@ -0,0 +1,51 @@
+/*
+ * Copyright (c) 2022, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#pragma once
+
+#include <AK/HashMap.h>
+#include <AK/Noncopyable.h>
+#include <AK/OwnPtr.h>
+#include <LibJS/Forward.h>
+
+namespace JS::JIT {
+
+// What native code tells the Bytecode::Interpreter when it gives control back.
+enum class Exit : u32 {
+    // Only ever seen by native code itself: the instruction it called out for is done, go on with the next one.
+    Continue = 0,
+    // Continue at the interpreter's current block, which native code couldn't jump to by itself.
+    Jump,
+    // An exception is pending, and there's no handler for it in this executable.
+    Exception,
+    Return,
+    // The block ended without a terminator.
+    Finished,
+};
+
+// Machine code for a Bytecode::Executable, with an entry point for every basic block.
+class NativeExecutable {
+    AK_MAKE_NONCOPYABLE(NativeExecutable);
+    AK_MAKE_NONMOVABLE(NativeExecutable);
+
+public:
+    // Returns null if the system won't give us executable memory.
+    static OwnPtr<NativeExecutable> create(ReadonlyBytes code, HashMap<Bytecode::BasicBlock const*, size_t> block_offsets);
+    ~NativeExecutable();
+
+    Exit run(Bytecode::Interpreter&, Value* registers, Bytecode::BasicBlock const& entry_block) const;
+
+    size_t size() const { return m_size; }
+
+private:
+    NativeExecutable(u8* code, size_t size, HashMap<Bytecode::BasicBlock const*, size_t> block_offsets);
+
+    u8* m_code { nullptr };
+    size_t m_size { 0 };
+    HashMap<Bytecode::BasicBlock const*, size_t> m_block_offsets;
+};
+
+}
@@ -6,6 +6,7 @@
  */
 
 #include <AK/Function.h>
+#include <AK/TypeCasts.h>
 #include <LibJS/Runtime/AbstractOperations.h>
 #include <LibJS/Runtime/Array.h>
 #include <LibJS/Runtime/ArrayPrototype.h>
@@ -13,6 +14,7 @@
 #include <LibJS/Runtime/Error.h>
 #include <LibJS/Runtime/GlobalObject.h>
 #include <LibJS/Runtime/NativeFunction.h>
+#include <LibJS/Runtime/ObjectPrototype.h>
 
 namespace JS {
 
@@ -65,6 +67,43 @@ Array::Array(Object& prototype)
 {
 }
 
+SimpleIndexedPropertyStorage* Array::packed_number_elements(size_t length)
+{
+    auto* storage = indexed_properties().simple_storage();
+    if (!storage || !storage->has_packed_number_elements() || storage->array_like_size() != length)
+        return nullptr;
+    return storage;
+}
+
+SimpleIndexedPropertyStorage const* Array::packed_number_elements(size_t length) const
+{
+    return const_cast<Array&>(*this).packed_number_elements(length);
+}
+
+bool Array::can_append_elements_directly() const
+{
+    if (!m_length_writable || !m_is_extensible || !indexed_properties().simple_storage())
+        return false;
+
+    auto& intrinsics = shape().realm().intrinsics();
+    auto* array_prototype = intrinsics.array_prototype();
+    auto* object_prototype = intrinsics.object_prototype();
+
+    // %Object.prototype% is an immutable prototype exotic object, so its own [[Prototype]] is always null.
+    return shape().prototype() == array_prototype
+        && array_prototype->indexed_properties().is_empty()
+        && MUST(array_prototype->internal_get_prototype_of()) == object_prototype
+        && object_prototype->indexed_properties().is_empty();
+}
+
+bool Array::can_create_element_directly(u32 index) const
+{
+    auto const* storage = indexed_properties().simple_storage();
+    if (!storage || !m_is_extensible)
+        return false;
+    return index < storage->array_like_size() || m_length_writable;
+}
+
 // 10.4.2.4 ArraySetLength ( A, Desc ), https://tc39.es/ecma262/#sec-arraysetlength
 ThrowCompletionOr<bool> Array::set_length(PropertyDescriptor const& property_descriptor)
 {
@@ -215,35 +254,44 @@ ThrowCompletionOr<MarkedVector<Value>> sort_indexed_properties(VM& vm, Object co
     // 1. Let items be a new empty List.
     auto items = MarkedVector<Value> { vm.heap() };
 
-    // 2. Let k be 0.
-    // 3. Repeat, while k < len,
-    for (size_t k = 0; k < length; ++k) {
-        // a. Let Pk be ! ToString(𝔽(k)).
-        auto property_key = PropertyKey { k };
-
-        bool k_read;
-
-        // b. If skipHoles is true, then
-        if (skip_holes) {
-            // i. Let kRead be ? HasProperty(obj, Pk).
-            k_read = TRY(object.has_property(property_key));
+    // NOTE: Elements of an array of packed numbers are all present own data properties, and reading them can't run any
+    //       user code, so they can be copied over directly.
+    auto const* elements = is<Array>(object) ? static_cast<Array const&>(object).packed_number_elements(length) : nullptr;
+    if (elements) {
+        items.ensure_capacity(length);
+        for (size_t k = 0; k < length; ++k)
+            items.append(elements->get(k)->value);
+    } else {
+        // 2. Let k be 0.
+        // 3. Repeat, while k < len,
+        for (size_t k = 0; k < length; ++k) {
+            // a. Let Pk be ! ToString(𝔽(k)).
+            auto property_key = PropertyKey { k };
+
+            bool k_read;
+
+            // b. If skipHoles is true, then
+            if (skip_holes) {
+                // i. Let kRead be ? HasProperty(obj, Pk).
+                k_read = TRY(object.has_property(property_key));
+            }
+            // c. Else,
+            else {
+                // i. Let kRead be true.
+                k_read = true;
+            }
+
+            // d. If kRead is true, then
+            if (k_read) {
+                // i. Let kValue be ? Get(obj, Pk).
+                auto k_value = TRY(object.get(property_key));
+
+                // ii. Append kValue to items.
+                items.append(k_value);
+            }
+
+            // e. Set k to k + 1.
         }
-        // c. Else,
-        else {
-            // i. Let kRead be true.
-            k_read = true;
-        }
-
-        // d. If kRead is true, then
-        if (k_read) {
-            // i. Let kValue be ? Get(obj, Pk).
-            auto k_value = TRY(object.get(property_key));
-
-            // ii. Append kValue to items.
-            items.append(k_value);
-        }
-
-        // e. Set k to k + 1.
     }
 
     // 4. Sort items using an implementation-defined sequence of calls to SortCompare. If any such call returns an abrupt completion, stop before performing any further calls to SortCompare or steps in this algorithm and return that Completion Record.
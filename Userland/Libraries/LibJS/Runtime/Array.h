@@ -44,6 +44,18 @@ public:
 
     [[nodiscard]] bool length_is_writable() const { return m_length_writable; };
 
+    // Non-standard: Returns the element storage if every index below length is an own data property holding a number.
+    // Such elements can be read and overwritten directly, as [[Get]] and [[Set]] would never look any further.
+    SimpleIndexedPropertyStorage* packed_number_elements(size_t length);
+    SimpleIndexedPropertyStorage const* packed_number_elements(size_t length) const;
+
+    // Non-standard: Whether elements can be appended to the storage directly instead of through [[Set]], which is the
+    // case if nothing on the (default) prototype chain could intercept the new indices.
+    bool can_append_elements_directly() const;
+
+    // Non-standard: Whether CreateDataProperty(index) can store into the storage directly.
+    bool can_create_element_directly(u32 index) const;
+
 protected:
     explicit Array(Object& prototype);
 
@@ -9,8 +9,10 @@
 
 #include <AK/Function.h>
 #include <AK/HashTable.h>
+#include <AK/QuickSort.h>
 #include <AK/ScopeGuard.h>
 #include <AK/StringBuilder.h>
+#include <AK/TypeCasts.h>
 #include <LibJS/Runtime/AbstractOperations.h>
 #include <LibJS/Runtime/Array.h>
 #include <LibJS/Runtime/ArrayConstructor.h>
@@ -382,6 +384,14 @@ JS_DEFINE_NATIVE_FUNCTION(ArrayPrototype::fill)
     else
         to = min(relative_end, length);
 
+    // Fast path: Every index being filled is an own writable data property, so each Set would just store the value.
+    if (from < to && is<Array>(*this_object)) {
+        if (auto* elements = static_cast<Array&>(*this_object).packed_number_elements(length)) {
+            elements->fill(from, to, vm.argument(0));
+            return this_object;
+        }
+    }
+
     for (u64 i = from; i < to; i++)
         TRY(this_object->set(i, vm.argument(0), Object::ShouldThrowExceptions::Yes));
 
@@ -955,6 +965,29 @@ JS_DEFINE_NATIVE_FUNCTION(ArrayPrototype::index_of)
         k = max(length + n, 0);
     }
 
+    // Fast path: Every element of an array of packed numbers is present, and only a number can be strictly equal to one.
+    if (is<Array>(*object)) {
+        if (auto const* elements = static_cast<Array const&>(*object).packed_number_elements(length)) {
+            if (!search_element.is_number())
+                return Value(-1);
+            auto search_number = search_element.as_double();
+            if (elements->element_kind() == ElementKind::Int32) {
+                auto int32_elements = elements->int32_elements();
+                for (; k < length; ++k) {
+                    if (int32_elements[k] == search_number)
+                        return Value(k);
+                }
+            } else {
+                auto double_elements = elements->double_elements();
+                for (; k < length; ++k) {
+                    if (double_elements[k] == search_number)
+                        return Value(k);
+                }
+            }
+            return Value(-1);
+        }
+    }
+
     // 10. Repeat, while k < len,
     for (; k < length; ++k) {
         auto property_key = PropertyKey { k };
@@ -1112,30 +1145,47 @@ JS_DEFINE_NATIVE_FUNCTION(ArrayPrototype::map)
     // 4. Let A be ? ArraySpeciesCreate(O, len).
     auto* array = TRY(array_species_create(vm, *object, length));
 
+    // NOTE: As long as O is an array of packed numbers, its elements can be read directly, and as long as A is an
+    //       extensible array with simple storage, the mapped values can be stored directly. The callback can change
+    //       both arrays, so this is checked again for every element.
+    auto* source_array = is<Array>(*object) ? static_cast<Array*>(object) : nullptr;
+    auto* target_array = is<Array>(*array) ? static_cast<Array*>(array) : nullptr;
+
     // 5. Let k be 0.
     // 6. Repeat, while k < len,
     for (size_t k = 0; k < length; ++k) {
         // a. Let Pk be ! ToString(𝔽(k)).
         auto property_key = PropertyKey { k };
 
+        auto const* elements = source_array ? source_array->packed_number_elements(length) : nullptr;
+
         // b. Let kPresent be ? HasProperty(O, Pk).
-        auto k_present = TRY(object->has_property(property_key));
+        auto k_present = elements != nullptr || TRY(object->has_property(property_key));
 
         // c. If kPresent is true, then
         if (k_present) {
             // i. Let kValue be ? Get(O, Pk).
-            auto k_value = TRY(object->get(property_key));
+            auto k_value = elements ? elements->get(k)->value : TRY(object->get(property_key));
 
             // ii. Let mappedValue be ? Call(callbackfn, thisArg, « kValue, 𝔽(k), O »).
             auto mapped_value = TRY(call(vm, callback_function.as_function(), this_arg, k_value, Value(k), object));
 
             // iii. Perform ? CreateDataPropertyOrThrow(A, Pk, mappedValue).
-            TRY(array->create_data_property_or_throw(property_key, mapped_value));
+            if (target_array && target_array->can_create_element_directly(k))
+                target_array->indexed_properties().put(k, mapped_value);
+            else
+                TRY(array->create_data_property_or_throw(property_key, mapped_value));
         }
 
         // d. Set k to k + 1.
     }
 
+    // The mapped values were stored into the holes of A one by one, so it has to be checked afterwards whether they're all numbers.
+    if (target_array) {
+        if (auto* storage = target_array->indexed_properties().simple_storage())
+            storage->narrow_element_kind();
+    }
+
     // 7. Return A.
     return array;
 }
@@ -1165,6 +1215,14 @@ JS_DEFINE_NATIVE_FUNCTION(ArrayPrototype::push)
     auto new_length = length + argument_count;
     if (new_length > MAX_ARRAY_LIKE_INDEX)
         return vm.throw_completion<TypeError>(ErrorType::ArrayMaxSize);
+
+    // Fast path: Nothing can intercept setting the new elements, and the length follows the storage.
+    if (is<Array>(*this_object) && new_length <= NumericLimits<i32>::max() && static_cast<Array&>(*this_object).can_append_elements_directly()) {
+        for (size_t i = 0; i < argument_count; ++i)
+            this_object->indexed_properties().append(vm.argument(i));
+        return Value(new_length);
+    }
+
     for (size_t i = 0; i < argument_count; ++i)
         TRY(this_object->set(length + i, vm.argument(i), Object::ShouldThrowExceptions::Yes));
     auto new_length_value = Value(new_length);
@@ -1555,6 +1613,35 @@ ThrowCompletionOr<void> array_merge_sort(VM& vm, Function<ThrowCompletionOr<doub
     return {};
 }
 
+// Sorts packed numbers the way SortCompare without a comparator would, i.e. by comparing their string representations.
+static void sort_packed_numbers(VM& vm, SimpleIndexedPropertyStorage& elements)
+{
+    struct Item {
+        String string;
+        Value value;
+        size_t index { 0 };
+    };
+
+    auto length = elements.array_like_size();
+    Vector<Item> items;
+    items.ensure_capacity(length);
+    for (size_t i = 0; i < length; ++i) {
+        auto value = elements.get(i)->value;
+        items.unchecked_append({ MUST(value.to_string(vm)), value, i });
+    }
+
+    // Number strings are all ASCII, so comparing their bytes is the same as comparing their code units. Items with equal
+    // strings (like +0 and -0) keep their order, as the sort has to be stable.
+    quick_sort(items, [](auto const& a, auto const& b) {
+        if (a.string == b.string)
+            return a.index < b.index;
+        return a.string < b.string;
+    });
+
+    for (size_t i = 0; i < length; ++i)
+        elements.put(i, items[i].value);
+}
+
 // 23.1.3.30 Array.prototype.sort ( comparefn ), https://tc39.es/ecma262/#sec-array.prototype.sort
 // 1.1.1.1 Array.prototype.sort ( comparefn ), https://tc39.es/proposal-change-array-by-copy/#sec-array.prototype.sort
 JS_DEFINE_NATIVE_FUNCTION(ArrayPrototype::sort)
@@ -1570,6 +1657,15 @@ JS_DEFINE_NATIVE_FUNCTION(ArrayPrototype::sort)
     // 3. Let len be ? LengthOfArrayLike(obj).
     auto length = TRY(length_of_array_like(vm, *object));
 
+    // Fast path: Without a comparator, packed numbers are sorted by their string representations, which doesn't run
+    //            any user code, so each one only has to be converted once and the result can be stored back directly.
+    if (comparefn.is_undefined() && is<Array>(*object)) {
+        if (auto* elements = static_cast<Array&>(*object).packed_number_elements(length)) {
+            sort_packed_numbers(vm, *elements);
+            return object;
+        }
+    }
+
     // 4. Let SortCompare be a new Abstract Closure with parameters (x, y) that captures comparefn and performs the following steps when called:
     Function<ThrowCompletionOr<double>(Value, Value)> sort_compare = [&](auto x, auto y) -> ThrowCompletionOr<double> {
         // a. Return ? CompareArrayElements(x, y, comparefn).
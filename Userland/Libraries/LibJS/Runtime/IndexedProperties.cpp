@@ -4,31 +4,78 @@
  * SPDX-License-Identifier: BSD-2-Clause
  */
 
+#include <AK/NumericLimits.h>
 #include <AK/QuickSort.h>
 #include <LibJS/Runtime/Accessor.h>
 #include <LibJS/Runtime/IndexedProperties.h>
+#include <math.h>
 
 namespace JS {
 
 constexpr const size_t SPARSE_ARRAY_HOLE_THRESHOLD = 200;
 constexpr const size_t LENGTH_SETTER_GENERIC_STORAGE_THRESHOLD = 4 * MiB;
 
+// Whether the number survives a round trip through an i32, which rules out -0.
+static bool is_int32_number(Value value)
+{
+    if (!value.is_number())
+        return false;
+    auto number = value.as_double();
+    if (!(number >= NumericLimits<i32>::min() && number <= NumericLimits<i32>::max()))
+        return false;
+    return number == static_cast<i32>(number) && !(number == 0 && signbit(number));
+}
+
+ElementKind SimpleIndexedPropertyStorage::element_kind_for(Value value)
+{
+    if (is_int32_number(value))
+        return ElementKind::Int32;
+    if (value.is_number())
+        return ElementKind::Double;
+    return ElementKind::Value;
+}
+
 SimpleIndexedPropertyStorage::SimpleIndexedPropertyStorage(Vector<Value>&& initial_values)
     : m_array_size(initial_values.size())
+    , m_element_kind(ElementKind::Value)
     , m_packed_elements(move(initial_values))
 {
+    narrow_element_kind();
 }
 
 bool SimpleIndexedPropertyStorage::has_index(u32 index) const
 {
-    return index < m_array_size && !m_packed_elements[index].is_empty();
+    if (index >= m_array_size)
+        return false;
+    return m_element_kind != ElementKind::Value || !m_packed_elements[index].is_empty();
 }
 
 Optional<ValueAndAttributes> SimpleIndexedPropertyStorage::get(u32 index) const
 {
     if (!has_index(index))
         return {};
-    return ValueAndAttributes { m_packed_elements[index], default_attributes };
+    switch (m_element_kind) {
+    case ElementKind::Int32:
+        return ValueAndAttributes { Value(m_int32_elements[index]), default_attributes };
+    case ElementKind::Double:
+        return ValueAndAttributes { Value(m_double_elements[index]), default_attributes };
+    case ElementKind::Value:
+        return ValueAndAttributes { m_packed_elements[index], default_attributes };
+    }
+    VERIFY_NOT_REACHED();
+}
+
+size_t SimpleIndexedPropertyStorage::size() const
+{
+    switch (m_element_kind) {
+    case ElementKind::Int32:
+        return m_int32_elements.size();
+    case ElementKind::Double:
+        return m_double_elements.size();
+    case ElementKind::Value:
+        return m_packed_elements.size();
+    }
+    VERIFY_NOT_REACHED();
 }
 
 void SimpleIndexedPropertyStorage::grow_storage_if_needed()
@@ -44,32 +91,143 @@ void SimpleIndexedPropertyStorage::grow_storage_if_needed()
     }
 }
 
+void SimpleIndexedPropertyStorage::transition_to(ElementKind kind)
+{
+    VERIFY(kind > m_element_kind);
+
+    if (kind == ElementKind::Double) {
+        m_double_elements.ensure_capacity(m_int32_elements.size());
+        for (auto element : m_int32_elements)
+            m_double_elements.unchecked_append(element);
+        m_int32_elements.clear();
+    } else {
+        m_packed_elements.ensure_capacity(m_array_size);
+        for (auto element : m_int32_elements)
+            m_packed_elements.unchecked_append(Value(element));
+        for (auto element : m_double_elements)
+            m_packed_elements.unchecked_append(Value(element));
+        m_int32_elements.clear();
+        m_double_elements.clear();
+    }
+    m_element_kind = kind;
+}
+
+void SimpleIndexedPropertyStorage::narrow_element_kind()
+{
+    if (m_element_kind != ElementKind::Value)
+        return;
+
+    auto kind = ElementKind::Int32;
+    for (size_t i = 0; i < m_array_size; ++i) {
+        auto element_kind = element_kind_for(m_packed_elements[i]);
+        if (element_kind == ElementKind::Value)
+            return;
+        kind = max(kind, element_kind);
+    }
+
+    if (kind == ElementKind::Int32) {
+        m_int32_elements.ensure_capacity(m_array_size);
+        for (size_t i = 0; i < m_array_size; ++i)
+            m_int32_elements.unchecked_append(static_cast<i32>(m_packed_elements[i].as_double()));
+    } else {
+        m_double_elements.ensure_capacity(m_array_size);
+        for (size_t i = 0; i < m_array_size; ++i)
+            m_double_elements.unchecked_append(m_packed_elements[i].as_double());
+    }
+    m_packed_elements.clear();
+    m_element_kind = kind;
+}
+
 void SimpleIndexedPropertyStorage::put(u32 index, Value value, PropertyAttributes attributes)
 {
     VERIFY(attributes == default_attributes);
 
-    if (index >= m_array_size) {
-        m_array_size = index + 1;
-        grow_storage_if_needed();
+    // Storing past the end of the array leaves holes, which only the Value kind can represent.
+    auto kind = index > m_array_size ? ElementKind::Value : element_kind_for(value);
+    if (kind > m_element_kind)
+        transition_to(kind);
+
+    switch (m_element_kind) {
+    case ElementKind::Int32:
+        if (index == m_array_size) {
+            m_int32_elements.append(static_cast<i32>(value.as_double()));
+            ++m_array_size;
+        } else {
+            m_int32_elements[index] = static_cast<i32>(value.as_double());
+        }
+        break;
+    case ElementKind::Double:
+        if (index == m_array_size) {
+            m_double_elements.append(value.as_double());
+            ++m_array_size;
+        } else {
+            m_double_elements[index] = value.as_double();
+        }
+        break;
+    case ElementKind::Value:
+        if (index >= m_array_size) {
+            m_array_size = index + 1;
+            grow_storage_if_needed();
+        }
+        m_packed_elements[index] = value;
+        break;
+    }
+}
+
+void SimpleIndexedPropertyStorage::fill(u32 from, u32 to, Value value)
+{
+    VERIFY(from <= to && to <= m_array_size);
+
+    auto kind = element_kind_for(value);
+    if (kind > m_element_kind)
+        transition_to(kind);
+
+    switch (m_element_kind) {
+    case ElementKind::Int32:
+        m_int32_elements.span().slice(from, to - from).fill(static_cast<i32>(value.as_double()));
+        break;
+    case ElementKind::Double:
+        m_double_elements.span().slice(from, to - from).fill(value.as_double());
+        break;
+    case ElementKind::Value:
+        m_packed_elements.span().slice(from, to - from).fill(value);
+        break;
     }
-    m_packed_elements[index] = value;
 }
 
 void SimpleIndexedPropertyStorage::remove(u32 index)
 {
     VERIFY(index < m_array_size);
+    if (m_element_kind != ElementKind::Value)
+        transition_to(ElementKind::Value);
     m_packed_elements[index] = {};
 }
 
 ValueAndAttributes SimpleIndexedPropertyStorage::take_first()
 {
     m_array_size--;
-    return { m_packed_elements.take_first(), default_attributes };
+    switch (m_element_kind) {
+    case ElementKind::Int32:
+        return { Value(m_int32_elements.take_first()), default_attributes };
+    case ElementKind::Double:
+        return { Value(m_double_elements.take_first()), default_attributes };
+    case ElementKind::Value:
+        return { m_packed_elements.take_first(), default_attributes };
+    }
+    VERIFY_NOT_REACHED();
 }
 
 ValueAndAttributes SimpleIndexedPropertyStorage::take_last()
 {
     m_array_size--;
+    switch (m_element_kind) {
+    case ElementKind::Int32:
+        return { Value(m_int32_elements.take_last()), default_attributes };
+    case ElementKind::Double:
+        return { Value(m_double_elements.take_last()), default_attributes };
+    case ElementKind::Value:
+        break;
+    }
     auto last_element = m_packed_elements[m_array_size];
     m_packed_elements[m_array_size] = {};
     return { last_element, default_attributes };
@@ -77,18 +235,31 @@ ValueAndAttributes SimpleIndexedPropertyStorage::take_last()
 
 bool SimpleIndexedPropertyStorage::set_array_like_size(size_t new_size)
 {
+    // Growing the array leaves holes at the end.
+    if (new_size > m_array_size && m_element_kind != ElementKind::Value)
+        transition_to(ElementKind::Value);
+
     m_array_size = new_size;
-    m_packed_elements.resize_and_keep_capacity(new_size);
+    switch (m_element_kind) {
+    case ElementKind::Int32:
+        m_int32_elements.resize_and_keep_capacity(new_size);
+        break;
+    case ElementKind::Double:
+        m_double_elements.resize_and_keep_capacity(new_size);
+        break;
+    case ElementKind::Value:
+        m_packed_elements.resize_and_keep_capacity(new_size);
+        break;
+    }
     return true;
 }
 
 GenericIndexedPropertyStorage::GenericIndexedPropertyStorage(SimpleIndexedPropertyStorage&& storage)
 {
     m_array_size = storage.array_like_size();
-    for (size_t i = 0; i < storage.m_packed_elements.size(); ++i) {
-        auto value = storage.m_packed_elements[i];
-        if (!value.is_empty())
-            m_sparse_elements.set(i, { value, default_attributes });
+    for (size_t i = 0; i < m_array_size; ++i) {
+        if (auto value_and_attributes = storage.get(i); value_and_attributes.has_value())
+            m_sparse_elements.set(i, value_and_attributes.release_value());
     }
 }
 
@@ -264,10 +435,11 @@ size_t IndexedProperties::real_size() const
 {
     if (!m_storage)
         return 0;
-    if (m_storage->is_simple_storage()) {
-        auto& packed_elements = static_cast<SimpleIndexedPropertyStorage const&>(*m_storage).elements();
+    if (auto const* storage = simple_storage()) {
+        if (storage->has_packed_number_elements())
+            return storage->array_like_size();
         size_t size = 0;
-        for (auto& element : packed_elements) {
+        for (auto& element : storage->elements()) {
             if (!element.is_empty())
                 ++size;
         }
@@ -280,13 +452,11 @@ Vector<u32> IndexedProperties::indices() const
 {
     if (!m_storage)
         return {};
-    if (m_storage->is_simple_storage()) {
-        auto const& storage = static_cast<SimpleIndexedPropertyStorage const&>(*m_storage);
-        auto const& elements = storage.elements();
+    if (auto const* storage = simple_storage()) {
         Vector<u32> indices;
-        indices.ensure_capacity(storage.array_like_size());
-        for (size_t i = 0; i < elements.size(); ++i) {
-            if (!elements.at(i).is_empty())
+        indices.ensure_capacity(storage->array_like_size());
+        for (size_t i = 0; i < storage->array_like_size(); ++i) {
+            if (storage->has_index(i))
                 indices.unchecked_append(i);
         }
         return indices;
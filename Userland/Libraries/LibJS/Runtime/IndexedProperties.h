@@ -15,6 +15,7 @@ namespace JS {
 struct ValueAndAttributes {
     Value value;
     PropertyAttributes attributes { default_attributes };
+    Optional<u32> property_offset {};
 };
 
 class IndexedProperties;
@@ -40,6 +41,17 @@ public:
     virtual bool is_simple_storage() const { return false; }
 };
 
+// The kinds of elements a SimpleIndexedPropertyStorage can hold, from the most to the least specific.
+// Storage only ever moves to a less specific kind, whenever an element that doesn't fit is stored.
+enum class ElementKind : u8 {
+    // Every element up to the array size is present and an int32.
+    Int32,
+    // Every element up to the array size is present and a number, stored as a double.
+    Double,
+    // Any value, including holes.
+    Value,
+};
+
 class SimpleIndexedPropertyStorage final : public IndexedPropertyStorage {
 public:
     SimpleIndexedPropertyStorage() = default;
@@ -53,19 +65,46 @@ public:
     virtual ValueAndAttributes take_first() override;
     virtual ValueAndAttributes take_last() override;
 
-    virtual size_t size() const override { return m_packed_elements.size(); }
+    virtual size_t size() const override;
     virtual size_t array_like_size() const override { return m_array_size; }
     virtual bool set_array_like_size(size_t new_size) override;
 
     virtual bool is_simple_storage() const override { return true; }
-    Vector<Value> const& elements() const { return m_packed_elements; }
 
-private:
-    friend GenericIndexedPropertyStorage;
+    ElementKind element_kind() const { return m_element_kind; }
+    bool has_packed_number_elements() const { return m_element_kind != ElementKind::Value; }
+
+    Span<i32 const> int32_elements() const
+    {
+        VERIFY(m_element_kind == ElementKind::Int32);
+        return m_int32_elements;
+    }
+    Span<double const> double_elements() const
+    {
+        VERIFY(m_element_kind == ElementKind::Double);
+        return m_double_elements;
+    }
+    Vector<Value> const& elements() const
+    {
+        VERIFY(m_element_kind == ElementKind::Value);
+        return m_packed_elements;
+    }
+
+    // Stores value at every index from `from` up to (but not including) `to`, which must all be below the array size.
+    void fill(u32 from, u32 to, Value value);
 
+    // Switches back to a number kind if every element is present and a number.
+    void narrow_element_kind();
+
+private:
     void grow_storage_if_needed();
+    static ElementKind element_kind_for(Value);
+    void transition_to(ElementKind);
 
     size_t m_array_size { 0 };
+    ElementKind m_element_kind { ElementKind::Int32 };
+    Vector<i32> m_int32_elements;
+    Vector<double> m_double_elements;
     Vector<Value> m_packed_elements;
 };
 
@@ -140,14 +179,33 @@ public:
 
     Vector<u32> indices() const;
 
+    SimpleIndexedPropertyStorage* simple_storage() { return m_storage && m_storage->is_simple_storage() ? static_cast<SimpleIndexedPropertyStorage*>(m_storage.ptr()) : nullptr; }
+    SimpleIndexedPropertyStorage const* simple_storage() const { return const_cast<IndexedProperties&>(*this).simple_storage(); }
+
     template<typename Callback>
     void for_each_value(Callback callback)
     {
         if (!m_storage)
             return;
-        if (m_storage->is_simple_storage()) {
-            for (auto& value : static_cast<SimpleIndexedPropertyStorage&>(*m_storage).elements())
-                callback(value);
+        if (auto* storage = simple_storage()) {
+            switch (storage->element_kind()) {
+            case ElementKind::Int32:
+                for (auto element : storage->int32_elements()) {
+                    Value value { element };
+                    callback(value);
+                }
+                break;
+            case ElementKind::Double:
+                for (auto element : storage->double_elements()) {
+                    Value value { element };
+                    callback(value);
+                }
+                break;
+            case ElementKind::Value:
+                for (auto& value : storage->elements())
+                    callback(value);
+                break;
+            }
         } else {
             for (auto& element : static_cast<GenericIndexedPropertyStorage const&>(*m_storage).sparse_elements())
                 callback(element.value.value);
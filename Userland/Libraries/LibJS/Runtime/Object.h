@@ -40,6 +40,19 @@ struct PrivateElement {
     Value value;
 };
 
+// Filled in by the ordinary [[Get]] and [[Set]] when the property can be found again through the
+// object's shape alone, see Bytecode::PropertyLookupCache. Exotic objects never fill it in.
+struct CacheablePropertyMetadata {
+    enum class Type {
+        NotCacheable,
+        OwnProperty,
+        InPrototypeChain,
+    };
+
+    Type type { Type::NotCacheable };
+    Optional<u32> property_offset;
+};
+
 class Object : public Cell {
     JS_CELL(Object, Cell);
 
@@ -118,8 +131,8 @@ public:
     virtual ThrowCompletionOr<Optional<PropertyDescriptor>> internal_get_own_property(PropertyKey const&) const;
     virtual ThrowCompletionOr<bool> internal_define_own_property(PropertyKey const&, PropertyDescriptor const&);
     virtual ThrowCompletionOr<bool> internal_has_property(PropertyKey const&) const;
-    virtual ThrowCompletionOr<Value> internal_get(PropertyKey const&, Value receiver) const;
-    virtual ThrowCompletionOr<bool> internal_set(PropertyKey const&, Value value, Value receiver);
+    virtual ThrowCompletionOr<Value> internal_get(PropertyKey const&, Value receiver, CacheablePropertyMetadata* = nullptr) const;
+    virtual ThrowCompletionOr<bool> internal_set(PropertyKey const&, Value value, Value receiver, CacheablePropertyMetadata* = nullptr);
     virtual ThrowCompletionOr<bool> internal_delete(PropertyKey const&);
     virtual ThrowCompletionOr<MarkedVector<Value>> internal_own_property_keys() const;
 
@@ -171,9 +184,14 @@ public:
     bool has_parameter_map() const { return m_has_parameter_map; }
     void set_has_parameter_map() { m_has_parameter_map = true; }
 
+    // Whether [[GetOwnProperty]], [[Get]] and [[Set]] are the ordinary ones for every property stored in the shape.
+    // Only then may the bytecode's property lookup caches skip them.
+    bool has_ordinary_property_access() const { return m_has_ordinary_property_access; }
+
     virtual void visit_edges(Cell::Visitor&) override;
 
     Value get_direct(size_t index) const { return m_storage[index]; }
+    void put_direct(size_t index, Value value) { m_storage[index] = value; }
 
     IndexedProperties const& indexed_properties() const { return m_indexed_properties; }
     IndexedProperties& indexed_properties() { return m_indexed_properties; }
@@ -184,6 +202,11 @@ public:
 
     void ensure_shape_is_unique();
 
+    // For native code that checks property lookup caches by itself.
+    static constexpr size_t shape_offset() { return OFFSET_OF(Object, m_shape); }
+    static constexpr size_t storage_offset() { return OFFSET_OF(Object, m_storage); }
+    static constexpr size_t has_ordinary_property_access_offset() { return OFFSET_OF(Object, m_has_ordinary_property_access); }
+
     template<typename T>
     bool fast_is() const = delete;
 
@@ -199,12 +222,18 @@ protected:
 
     void set_prototype(Object*);
 
+    // Exotic objects whose [[GetOwnProperty]], [[Get]] or [[Set]] can differ from the ordinary ones for a
+    // property in the shape must call this in their constructor.
+    void set_has_exotic_property_access() { m_has_ordinary_property_access = false; }
+
     // [[Extensible]]
     bool m_is_extensible { true };
 
     // [[ParameterMap]]
     bool m_has_parameter_map { false };
 
+    bool m_has_ordinary_property_access { true };
+
 private:
     void set_shape(Shape& shape) { m_shape = &shape; }
 
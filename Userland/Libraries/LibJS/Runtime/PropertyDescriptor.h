@@ -39,6 +39,9 @@ public:
     Optional<bool> writable {};
     Optional<bool> enumerable {};
     Optional<bool> configurable {};
+
+    // Not part of the spec: where the property lives in the object's storage, if it does.
+    Optional<u32> property_offset {};
 };
 
 }
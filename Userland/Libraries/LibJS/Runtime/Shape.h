@@ -59,10 +59,16 @@ public:
     bool is_unique() const { return m_unique; }
     Shape* create_unique_clone() const;
 
+    // Unique shapes are changed in place instead of transitioning to a new shape, so anything
+    // that remembers what a shape looked like has to compare this number as well.
+    u32 unique_shape_serial_number() const { return m_unique_shape_serial_number; }
+    static constexpr size_t unique_shape_serial_number_offset() { return OFFSET_OF(Shape, m_unique_shape_serial_number); }
+
     Realm& realm() const { return m_realm; }
 
     Object* prototype() { return m_prototype; }
     Object const* prototype() const { return m_prototype; }
+    static constexpr size_t prototype_offset() { return OFFSET_OF(Shape, m_prototype); }
 
     Optional<PropertyMetadata> lookup(StringOrSymbol const&) const;
     HashMap<StringOrSymbol, PropertyMetadata> const& property_table() const;
@@ -75,7 +81,11 @@ public:
 
     Vector<Property> property_table_ordered() const;
 
-    void set_prototype_without_transition(Object* new_prototype) { m_prototype = new_prototype; }
+    void set_prototype_without_transition(Object* new_prototype)
+    {
+        m_prototype = new_prototype;
+        ++m_unique_shape_serial_number;
+    }
 
     void remove_property_from_unique_shape(StringOrSymbol const&, size_t offset);
     void add_property_to_unique_shape(StringOrSymbol const&, PropertyAttributes attributes);
@@ -103,6 +113,7 @@ private:
     StringOrSymbol m_property_key;
     Object* m_prototype { nullptr };
     u32 m_property_count { 0 };
+    u32 m_unique_shape_serial_number { 0 };
 
     PropertyAttributes m_attributes { 0 };
     TransitionType m_transition_type : 6 { TransitionType::Invalid };
@@ -24,6 +24,7 @@ StringObject::StringObject(PrimitiveString& string, Object& prototype)
     : Object(prototype)
     , m_string(string)
 {
+    set_has_exotic_property_access();
 }
 
 void StringObject::initialize(Realm& realm)
@@ -0,0 +1,142 @@
+describe("transitions between element kinds", () => {
+    test("int32 elements become doubles", () => {
+        const array = [1, 2, 3];
+        array.push(4.5);
+        array[0] = -0;
+        expect(array).toEqual([-0, 2, 3, 4.5]);
+        expect(Object.is(array[0], -0)).toBeTrue();
+        expect(array[3]).toBe(4.5);
+    });
+
+    test("number elements become values", () => {
+        const array = [1, 2.5, 3];
+        array.push("foo");
+        array[1] = undefined;
+        expect(array).toEqual([1, undefined, 3, "foo"]);
+    });
+
+    test("holes", () => {
+        const array = [1, 2, 3];
+        array[5] = 6;
+        expect(array).toHaveLength(6);
+        expect(3 in array).toBeFalse();
+        expect(5 in array).toBeTrue();
+
+        const other = [1, 2, 3];
+        delete other[1];
+        expect(1 in other).toBeFalse();
+        expect(other.indexOf(undefined)).toBe(-1);
+
+        const grown = [1, 2, 3];
+        grown.length = 5;
+        expect(3 in grown).toBeFalse();
+        expect(grown.indexOf(undefined)).toBe(-1);
+    });
+
+    test("shrinking keeps the remaining elements", () => {
+        const array = [1, 2, 3, 4];
+        array.length = 2;
+        expect(array).toEqual([1, 2]);
+        expect(array.shift()).toBe(1);
+        expect(array).toEqual([2]);
+    });
+});
+
+describe("fast paths", () => {
+    test("push with indexed properties on the prototype chain", () => {
+        const setter_values = [];
+        Object.defineProperty(Array.prototype, 3, {
+            set(value) {
+                setter_values.push(value);
+            },
+            configurable: true,
+        });
+        try {
+            const array = [1, 2, 3];
+            expect(array.push(4, 5)).toBe(5);
+            expect(setter_values).toEqual([4]);
+            expect(array.hasOwnProperty(3)).toBeFalse();
+            expect(array[4]).toBe(5);
+        } finally {
+            delete Array.prototype[3];
+        }
+    });
+
+    test("push onto a non-extensible array", () => {
+        const array = [1, 2, 3];
+        Object.preventExtensions(array);
+        expect(() => array.push(4)).toThrow(TypeError);
+        expect(array).toEqual([1, 2, 3]);
+    });
+
+    test("indexOf compares numbers strictly", () => {
+        const array = [1, 2, 3, 2.5, -0, NaN];
+        expect(array.indexOf(2)).toBe(1);
+        expect(array.indexOf(2.5)).toBe(3);
+        expect(array.indexOf(0)).toBe(4);
+        expect(array.indexOf(NaN)).toBe(-1);
+        expect(array.indexOf("2")).toBe(-1);
+        expect([1, 2, 3].indexOf(2.0)).toBe(1);
+        expect([1, 2, 3].indexOf(3, -1)).toBe(2);
+    });
+
+    test("indexOf after the array shrank while converting fromIndex", () => {
+        Array.prototype[2] = "foo";
+        try {
+            const array = [1, 2, 3];
+            const from_index = {
+                valueOf() {
+                    array.length = 1;
+                    return 0;
+                },
+            };
+            expect(array.indexOf("foo", from_index)).toBe(2);
+        } finally {
+            delete Array.prototype[2];
+        }
+    });
+
+    test("fill changes the element kind as needed", () => {
+        expect([1, 2, 3].fill(1.5, 1)).toEqual([1, 1.5, 1.5]);
+        expect([1, 2, 3].fill("foo", 0, 2)).toEqual(["foo", "foo", 3]);
+        expect([1.5, 2.5].fill(0)).toEqual([0, 0]);
+        expect([1, 2, 3].fill(0, 2, 1)).toEqual([1, 2, 3]);
+        expect([1, 2, 3].fill(0.5, 1, 1)).toEqual([1, 2, 3]);
+    });
+
+    test("map reads the array again after every callback", () => {
+        const array = [1, 2, 3, 4];
+        const result = array.map((value, index) => {
+            if (index === 1) array.length = 3;
+            if (index === 0) array[2] = "foo";
+            return value * 2;
+        });
+        expect(result).toHaveLength(4);
+        expect(result[0]).toBe(2);
+        expect(result[1]).toBe(4);
+        expect(result[2]).toBeNaN();
+        expect(3 in result).toBeFalse();
+    });
+
+    test("map into a species array", () => {
+        class MyArray extends Array {}
+        const result = MyArray.from([1, 2, 3]).map(value => value + 0.5);
+        expect(result).toBeInstanceOf(MyArray);
+        expect(result).toEqual([1.5, 2.5, 3.5]);
+    });
+
+    test("sort without a comparator compares strings", () => {
+        expect([10, 9, 1, 100, -1, 2].sort()).toEqual([-1, 1, 10, 100, 2, 9]);
+        expect([0.5, 1e21, 3, -0.25].sort()).toEqual([-0.25, 0.5, 1e21, 3]);
+    });
+
+    test("sort without a comparator is stable", () => {
+        const array = [0, -0, 0, -0].sort();
+        expect(array.map(value => Object.is(value, -0))).toEqual([false, true, false, true]);
+    });
+
+    test("sort with a comparator", () => {
+        expect([3, 1.5, 2, -7].sort((a, b) => a - b)).toEqual([-7, 1.5, 2, 3]);
+        expect([3, 1, 2].toSorted((a, b) => b - a)).toEqual([3, 2, 1]);
+    });
+});
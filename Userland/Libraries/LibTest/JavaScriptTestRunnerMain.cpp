@@ -7,6 +7,7 @@
  */
 
 #include <LibCore/ArgsParser.h>
+#include <LibJS/JIT/Compiler.h>
 #include <LibTest/JavaScriptTestRunner.h>
 #include <signal.h>
 #include <stdio.h>
@@ -114,6 +115,8 @@ int main(int argc, char** argv)
     args_parser.add_option(g_collect_on_every_allocation, "Collect garbage after every allocation", "collect-often", 'g');
     args_parser.add_option(g_run_bytecode, "Use the bytecode interpreter", "run-bytecode", 'b');
     args_parser.add_option(JS::Bytecode::g_dump_bytecode, "Dump the bytecode", "dump-bytecode", 'd');
+    args_parser.add_option(JS::JIT::g_jit_enabled, "Compile frequently run bytecode to native code (implies -b)", "jit", 0);
+    args_parser.add_option(JS::JIT::g_jit_threshold, "Number of runs before bytecode gets compiled", "jit-threshold", 0, "count");
     args_parser.add_option(test_glob, "Only run tests matching the given glob", "filter", 'f', "glob");
     for (auto& entry : g_extra_args)
         args_parser.add_option(*entry.key, entry.value.get<0>().characters(), entry.value.get<1>().characters(), entry.value.get<2>());
@@ -124,6 +127,9 @@ int main(int argc, char** argv)
     if (per_file)
         print_json = true;
 
+    if (JS::JIT::g_jit_enabled)
+        g_run_bytecode = true;
+
     test_glob = String::formatted("*{}*", test_glob);
 
     if (getenv("DISABLE_DBG_OUTPUT")) {
@@ -13,6 +13,7 @@ namespace Web::Bindings {
 LegacyPlatformObject::LegacyPlatformObject(JS::Object& prototype)
     : PlatformObject(prototype)
 {
+    set_has_exotic_property_access();
 }
 
 LegacyPlatformObject::~LegacyPlatformObject() = default;
@@ -163,7 +164,13 @@ JS::ThrowCompletionOr<Optional<JS::PropertyDescriptor>> LegacyPlatformObject::in
     return TRY(legacy_platform_object_get_own_property_for_get_own_property_slot(property_name));
 }
 
-JS::ThrowCompletionOr<bool> LegacyPlatformObject::internal_set(JS::PropertyKey const& property_name, JS::Value value, JS::Value receiver)
+JS::ThrowCompletionOr<JS::Value> LegacyPlatformObject::internal_get(JS::PropertyKey const& property_name, JS::Value receiver, JS::CacheablePropertyMetadata*) const
+{
+    // NOTE: Named properties come and go without the shape changing, so lookups on this object must never be cached.
+    return Object::internal_get(property_name, receiver);
+}
+
+JS::ThrowCompletionOr<bool> LegacyPlatformObject::internal_set(JS::PropertyKey const& property_name, JS::Value value, JS::Value receiver, JS::CacheablePropertyMetadata*)
 {
     [[maybe_unused]] auto& global_object = this->global_object();
 
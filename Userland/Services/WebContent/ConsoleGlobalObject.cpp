@@ -74,7 +74,7 @@ JS::ThrowCompletionOr<bool> ConsoleGlobalObject::internal_has_property(JS::Prope
     return TRY(Object::internal_has_property(property_name)) || TRY(m_window_object->internal_has_property(property_name));
 }
 
-JS::ThrowCompletionOr<JS::Value> ConsoleGlobalObject::internal_get(JS::PropertyKey const& property_name, JS::Value receiver) const
+JS::ThrowCompletionOr<JS::Value> ConsoleGlobalObject::internal_get(JS::PropertyKey const& property_name, JS::Value receiver, JS::CacheablePropertyMetadata*) const
 {
     if (TRY(m_window_object->has_own_property(property_name)))
         return m_window_object->internal_get(property_name, (receiver == this) ? m_window_object : receiver);
@@ -82,7 +82,7 @@ JS::ThrowCompletionOr<JS::Value> ConsoleGlobalObject::internal_get(JS::PropertyK
     return Base::internal_get(property_name, receiver);
 }
 
-JS::ThrowCompletionOr<bool> ConsoleGlobalObject::internal_set(JS::PropertyKey const& property_name, JS::Value value, JS::Value receiver)
+JS::ThrowCompletionOr<bool> ConsoleGlobalObject::internal_set(JS::PropertyKey const& property_name, JS::Value value, JS::Value receiver, JS::CacheablePropertyMetadata*)
 {
     return m_window_object->internal_set(property_name, value, (receiver == this) ? m_window_object : receiver);
 }
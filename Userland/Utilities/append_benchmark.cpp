@@ -0,0 +1,152 @@
+/*
+ * Copyright (c) 2022, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <AK/Atomic.h>
+#include <AK/String.h>
+#include <AK/Types.h>
+#include <AK/Vector.h>
+#include <LibCore/ArgsParser.h>
+#include <LibCore/ElapsedTimer.h>
+#include <LibCore/System.h>
+#include <LibMain/Main.h>
+#include <fcntl.h>
+#include <pthread.h>
+#include <string.h>
+#include <sys/ioctl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+struct Worker {
+    String path;
+    size_t file_size { 0 };
+    size_t write_size { 0 };
+    pthread_t thread {};
+    bool failed { false };
+};
+
+static Atomic<bool> s_start { false };
+
+static void* run_worker(void* argument)
+{
+    auto& worker = *static_cast<Worker*>(argument);
+    Vector<u8> buffer;
+    buffer.resize(worker.write_size);
+    memset(buffer.data(), 'A', buffer.size());
+
+    int fd = open(worker.path.characters(), O_CREAT | O_TRUNC | O_WRONLY, 0644);
+    if (fd < 0) {
+        worker.failed = true;
+        return nullptr;
+    }
+
+    while (!s_start.load())
+        sched_yield();
+
+    for (size_t written = 0; written < worker.file_size; written += worker.write_size) {
+        if (write(fd, buffer.data(), buffer.size()) != static_cast<ssize_t>(buffer.size())) {
+            worker.failed = true;
+            break;
+        }
+    }
+    if (fsync(fd) < 0)
+        worker.failed = true;
+    close(fd);
+    return nullptr;
+}
+
+// Counts the runs of blocks that are contiguous on disk, or returns 0 if they can't be queried.
+static size_t count_extents(String const& path)
+{
+    int fd = open(path.characters(), O_RDONLY);
+    if (fd < 0)
+        return 0;
+
+    struct stat st;
+    if (fstat(fd, &st) < 0 || st.st_blksize <= 0) {
+        close(fd);
+        return 0;
+    }
+
+    size_t extent_count = 0;
+    int previous_block = 0;
+    for (off_t index = 0; index * st.st_blksize < st.st_size; ++index) {
+        int block = static_cast<int>(index);
+        if (ioctl(fd, FIBMAP, &block) < 0) {
+            extent_count = 0;
+            break;
+        }
+        if (block == 0 || block != previous_block + 1)
+            ++extent_count;
+        previous_block = block;
+    }
+    close(fd);
+    return extent_count;
+}
+
+ErrorOr<int> serenity_main(Main::Arguments arguments)
+{
+    TRY(Core::System::pledge("stdio rpath wpath cpath thread"));
+
+    StringView directory = "."sv;
+    size_t thread_count = 4;
+    size_t file_size = 16 * MiB;
+    size_t write_size = 4096;
+    bool keep_files = false;
+
+    Core::ArgsParser args_parser;
+    args_parser.set_general_help("Measure how fast several threads append to their own files at the same time, and how fragmented the files end up.");
+    args_parser.add_option(thread_count, "Number of threads appending to files (default: 4)", "threads", 'j', "count");
+    args_parser.add_option(file_size, "Size of each file in bytes (default: 16 MiB)", "file-size", 'f', "bytes");
+    args_parser.add_option(write_size, "Size of each write in bytes (default: 4096)", "write-size", 'b', "bytes");
+    args_parser.add_option(keep_files, "Don't remove the files afterwards", "keep", 'k');
+    args_parser.add_positional_argument(directory, "Directory to create the files in (default: .)", "directory", Core::ArgsParser::Required::No);
+    args_parser.parse(arguments);
+
+    if (thread_count == 0 || write_size == 0 || file_size < write_size) {
+        warnln("Need at least one thread, and files that are at least one write long");
+        return 1;
+    }
+
+    Vector<Worker> workers;
+    workers.resize(thread_count);
+    for (size_t i = 0; i < thread_count; ++i) {
+        auto& worker = workers[i];
+        worker.path = String::formatted("{}/append_benchmark.{}.{}", directory, getpid(), i);
+        worker.file_size = file_size;
+        worker.write_size = write_size;
+        if (auto rc = pthread_create(&worker.thread, nullptr, run_worker, &worker); rc != 0)
+            return Error::from_errno(rc);
+    }
+
+    outln("Appending {}-byte writes to {} file(s) of {} bytes in {}...", write_size, thread_count, file_size, directory);
+    auto timer = Core::ElapsedTimer::start_new();
+    s_start.store(true);
+
+    bool failed = false;
+    for (auto& worker : workers) {
+        if (auto rc = pthread_join(worker.thread, nullptr); rc != 0)
+            return Error::from_errno(rc);
+        failed |= worker.failed;
+    }
+    auto elapsed_ms = max<i64>(timer.elapsed(), 1);
+
+    size_t total_extents = 0;
+    for (auto& worker : workers)
+        total_extents += count_extents(worker.path);
+
+    u64 total_bytes = static_cast<u64>(file_size) * thread_count;
+    outln("Finished: time={}ms bps={}{}", elapsed_ms, total_bytes * 1000 / elapsed_ms, failed ? " (some writes failed)" : "");
+    if (total_extents > 0)
+        outln("Fragmentation: {} extent(s) in total, {} per file on average", total_extents, total_extents / thread_count);
+    else
+        outln("Fragmentation: unknown (reading block addresses requires root)");
+
+    if (!keep_files) {
+        for (auto& worker : workers)
+            (void)Core::System::unlink(worker.path);
+    }
+    return failed ? 1 : 0;
+}
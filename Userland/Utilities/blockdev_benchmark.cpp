@@ -0,0 +1,126 @@
+/*
+ * Copyright (c) 2022, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <AK/Atomic.h>
+#include <AK/Random.h>
+#include <AK/String.h>
+#include <AK/Types.h>
+#include <AK/Vector.h>
+#include <LibCore/ArgsParser.h>
+#include <LibCore/ElapsedTimer.h>
+#include <LibCore/System.h>
+#include <LibMain/Main.h>
+#include <fcntl.h>
+#include <pthread.h>
+#include <string.h>
+#include <sys/ioctl.h>
+#include <unistd.h>
+
+struct Worker {
+    int fd { -1 };
+    u64 block_count { 0 };
+    size_t request_size { 0 };
+    bool sequential { false };
+    int seconds { 0 };
+    pthread_t thread {};
+    u64 completed_requests { 0 };
+    u64 failed_requests { 0 };
+};
+
+static Atomic<bool> s_start { false };
+
+static void* run_worker(void* argument)
+{
+    auto& worker = *static_cast<Worker*>(argument);
+    Vector<u8> buffer;
+    buffer.resize(worker.request_size);
+
+    while (!s_start.load())
+        sched_yield();
+
+    auto blocks_per_request = worker.request_size / 512;
+    auto request_count_on_device = worker.block_count / blocks_per_request;
+    u64 next_request = get_random_uniform(request_count_on_device);
+
+    auto timer = Core::ElapsedTimer::start_new();
+    while (timer.elapsed() < worker.seconds * 1000) {
+        u64 request_index = worker.sequential ? (next_request++ % request_count_on_device) : get_random_uniform(request_count_on_device);
+        auto nread = pread(worker.fd, buffer.data(), worker.request_size, request_index * worker.request_size);
+        if (nread != static_cast<ssize_t>(worker.request_size))
+            ++worker.failed_requests;
+        else
+            ++worker.completed_requests;
+    }
+    return nullptr;
+}
+
+ErrorOr<int> serenity_main(Main::Arguments arguments)
+{
+    TRY(Core::System::pledge("stdio rpath thread"));
+
+    StringView device_path;
+    size_t thread_count = 0;
+    size_t request_size = 4096;
+    int seconds = 10;
+    bool sequential = false;
+
+    Core::ArgsParser args_parser;
+    args_parser.set_general_help("Measure how many read requests per second a block device completes.");
+    args_parser.add_option(thread_count, "Number of threads issuing requests (default: one per processor)", "threads", 'j', "count");
+    args_parser.add_option(request_size, "Size of each read request in bytes (default: 4096)", "request-size", 'b', "bytes");
+    args_parser.add_option(seconds, "Duration of the benchmark in seconds (default: 10)", "time", 't', "seconds");
+    args_parser.add_option(sequential, "Read consecutive requests instead of random ones", "sequential", 's');
+    args_parser.add_positional_argument(device_path, "Block device to read from, e.g. /dev/hda", "device");
+    args_parser.parse(arguments);
+
+    if (request_size == 0 || request_size % 512 != 0) {
+        warnln("Request size must be a non-zero multiple of 512 bytes");
+        return 1;
+    }
+
+    if (thread_count == 0) {
+        auto processor_count = sysconf(_SC_NPROCESSORS_ONLN);
+        thread_count = processor_count > 0 ? static_cast<size_t>(processor_count) : 1;
+    }
+
+    auto fd = TRY(Core::System::open(device_path, O_RDONLY));
+    u64 device_size = 0;
+    TRY(Core::System::ioctl(fd, STORAGE_DEVICE_GET_SIZE, &device_size));
+    if (device_size < request_size) {
+        warnln("{} is smaller than a single request", device_path);
+        return 1;
+    }
+
+    Vector<Worker> workers;
+    workers.resize(thread_count);
+    for (auto& worker : workers) {
+        worker.fd = fd;
+        worker.block_count = device_size / 512;
+        worker.request_size = request_size;
+        worker.sequential = sequential;
+        worker.seconds = seconds;
+        if (auto rc = pthread_create(&worker.thread, nullptr, run_worker, &worker); rc != 0)
+            return Error::from_errno(rc);
+    }
+
+    outln("Reading {}-byte {} requests from {} with {} thread(s) for {}s...", request_size, sequential ? "sequential" : "random", device_path, thread_count, seconds);
+    auto timer = Core::ElapsedTimer::start_new();
+    s_start.store(true);
+
+    u64 completed_requests = 0;
+    u64 failed_requests = 0;
+    for (auto& worker : workers) {
+        if (auto rc = pthread_join(worker.thread, nullptr); rc != 0)
+            return Error::from_errno(rc);
+        completed_requests += worker.completed_requests;
+        failed_requests += worker.failed_requests;
+    }
+    auto elapsed_ms = max<i64>(timer.elapsed(), 1);
+
+    auto iops = completed_requests * 1000 / elapsed_ms;
+    outln("Finished: requests={} failed={} time={}ms iops={} bps={}", completed_requests, failed_requests, elapsed_ms, iops, iops * request_size);
+    return 0;
+}
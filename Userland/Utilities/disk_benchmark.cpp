@@ -14,8 +14,11 @@
 #include <LibCore/ElapsedTimer.h>
 #include <LibCore/System.h>
 #include <LibMain/Main.h>
+#include <errno.h>
 #include <fcntl.h>
+#include <serenity.h>
 #include <stdio.h>
+#include <string.h>
 #include <sys/stat.h>
 #include <unistd.h>
 
@@ -40,6 +43,8 @@ static Result average_result(Vector<Result> const& results)
 }
 
 static ErrorOr<Result> benchmark(String const& filename, int file_size, ByteBuffer& buffer, bool allow_cache);
+static ErrorOr<u64> read_benchmark(String const& filename, ByteBuffer& buffer);
+static ErrorOr<int> run_read_benchmarks(String const& filename, Vector<size_t> const& block_sizes, int time_per_benchmark);
 
 ErrorOr<int> serenity_main(Main::Arguments arguments)
 {
@@ -48,6 +53,7 @@ ErrorOr<int> serenity_main(Main::Arguments arguments)
     Vector<size_t> file_sizes;
     Vector<size_t> block_sizes;
     bool allow_cache = false;
+    String read_file;
 
     Core::ArgsParser args_parser;
     args_parser.add_option(allow_cache, "Allow using disk cache", "cache", 'c');
@@ -55,6 +61,7 @@ ErrorOr<int> serenity_main(Main::Arguments arguments)
     args_parser.add_option(time_per_benchmark, "Time elapsed per benchmark", "time-per-benchmark", 't', "time-per-benchmark");
     args_parser.add_option(file_sizes, "A comma-separated list of file sizes", "file-size", 'f', "file-size");
     args_parser.add_option(block_sizes, "A comma-separated list of block sizes", "block-size", 'b', "block-size");
+    args_parser.add_option(read_file, "Only measure sequential buffered reads of an existing (large) file, starting with a cold cache (ignores -c)", "read-file", 'r', "path");
     args_parser.parse(arguments);
 
     if (file_sizes.size() == 0) {
@@ -64,6 +71,9 @@ ErrorOr<int> serenity_main(Main::Arguments arguments)
         block_sizes = { 8192, 32768, 65536 };
     }
 
+    if (!read_file.is_empty())
+        return run_read_benchmarks(read_file, block_sizes, time_per_benchmark);
+
     umask(0644);
 
     auto filename = String::formatted("{}/disk_benchmark.tmp", directory);
@@ -141,3 +151,64 @@ ErrorOr<Result> benchmark(String const& filename, int file_size, ByteBuffer& buf
     result.read_bps = (u64)(timer.elapsed() ? (file_size / timer.elapsed()) : file_size) * 1000;
     return result;
 }
+
+ErrorOr<int> run_read_benchmarks(String const& filename, Vector<size_t> const& block_sizes, int time_per_benchmark)
+{
+    for (auto block_size : block_sizes) {
+        auto buffer_result = ByteBuffer::create_uninitialized(block_size);
+        if (buffer_result.is_error()) {
+            warnln("Not enough memory to allocate space for block size = {}", block_size);
+            continue;
+        }
+        Vector<u64> results;
+
+        outln("Running: file={} block_size={}", filename, block_size);
+        auto timer = Core::ElapsedTimer::start_new();
+        while (timer.elapsed() < time_per_benchmark * 1000) {
+            out(".");
+            fflush(stdout);
+            results.append(TRY(read_benchmark(filename, buffer_result.value())));
+            usleep(100);
+        }
+        u64 average_read_bps = 0;
+        for (auto read_bps : results)
+            average_read_bps += read_bps;
+        average_read_bps /= results.size();
+        outln("Finished: runs={} time={}ms read_bps={}", results.size(), timer.elapsed(), average_read_bps);
+
+        sleep(1);
+    }
+
+    return 0;
+}
+
+ErrorOr<u64> read_benchmark(String const& filename, ByteBuffer& buffer)
+{
+    // Start every run with a cold cache, so it's the disk (and readahead) that is being measured.
+    // The file is read through the page cache, as O_DIRECT would bypass readahead entirely.
+    if (purge(PURGE_ALL_CLEAN_INODE) < 0) {
+        static bool did_warn = false;
+        if (!did_warn)
+            warnln("Unable to drop clean cached pages, results include reads served from memory: {}", strerror(errno));
+        did_warn = true;
+    }
+
+    int fd = TRY(Core::System::open(filename, O_RDONLY));
+    auto fd_cleanup = ScopeGuard([fd] {
+        auto void_or_error = Core::System::close(fd);
+        if (void_or_error.is_error())
+            warnln("{}", void_or_error.release_error());
+    });
+
+    auto timer = Core::ElapsedTimer::start_new();
+    u64 total_read = 0;
+    for (;;) {
+        auto nread = TRY(Core::System::read(fd, buffer));
+        if (nread == 0)
+            break;
+        total_read += nread;
+    }
+
+    auto elapsed = timer.elapsed();
+    return (elapsed ? (total_read / elapsed) : total_read) * 1000;
+}
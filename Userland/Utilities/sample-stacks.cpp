@@ -0,0 +1,309 @@
+/*
+ * Copyright (c) 2022, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <AK/Atomic.h>
+#include <AK/Checked.h>
+#include <AK/HashMap.h>
+#include <AK/JsonArray.h>
+#include <AK/JsonObject.h>
+#include <AK/JsonValue.h>
+#include <AK/QuickSort.h>
+#include <AK/StringBuilder.h>
+#include <Kernel/API/SampleRing.h>
+#include <LibCore/ArgsParser.h>
+#include <LibCore/ElapsedTimer.h>
+#include <LibCore/File.h>
+#include <LibCore/ProcessStatisticsReader.h>
+#include <LibCore/Stream.h>
+#include <LibCore/System.h>
+#include <LibMain/Main.h>
+#include <LibSymbolication/Symbolication.h>
+#include <fcntl.h>
+#include <signal.h>
+#include <sys/ioctl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+
+using Kernel::SampleRecord;
+using Kernel::SampleRecordType;
+using Kernel::SampleRingHeader;
+
+struct Ring {
+    SampleRingHeader* header { nullptr };
+    u8 const* data { nullptr };
+};
+
+struct Region {
+    FlatPtr base { 0 };
+    size_t size { 0 };
+    String path;
+};
+
+struct ProcessInfo {
+    String name;
+    Vector<Region> regions;
+    HashMap<FlatPtr, String> symbols;
+};
+
+static Atomic<bool> s_should_stop { false };
+
+class StackFolder {
+public:
+    explicit StackFolder(bool symbolicate)
+        : m_symbolicate(symbolicate)
+    {
+    }
+
+    void add_sample(SampleRecord const& record)
+    {
+        auto& process = process_info(record.pid);
+        StringBuilder builder;
+        builder.append(process.name);
+
+        // The frames are innermost first, but folded stacks start at the root.
+        size_t frame_count = record.kernel_frame_count + record.user_frame_count;
+        for (size_t i = frame_count; i > 0; --i) {
+            auto address = record.frames()[i - 1];
+            bool is_kernel_frame = i <= record.kernel_frame_count;
+            builder.append(';');
+            // Everything but the first frame is a return address, which points past the call.
+            builder.append(symbolicate(process, address, is_kernel_frame, i != 1));
+        }
+
+        m_stacks.ensure(builder.to_string(), [] { return 0; })++;
+        ++m_sample_count;
+    }
+
+    String folded_stacks() const
+    {
+        Vector<String> stacks;
+        stacks.ensure_capacity(m_stacks.size());
+        for (auto& it : m_stacks)
+            stacks.append(it.key);
+        quick_sort(stacks);
+
+        StringBuilder builder;
+        for (auto& stack : stacks)
+            builder.appendff("{} {}\n", stack, m_stacks.get(stack).value());
+        return builder.to_string();
+    }
+
+    size_t sample_count() const { return m_sample_count; }
+
+private:
+    ProcessInfo& process_info(pid_t pid)
+    {
+        if (auto it = m_processes.find(pid); it != m_processes.end())
+            return it->value;
+
+        ProcessInfo info;
+        info.name = String::formatted("[{}]", pid);
+        if (auto all_processes = Core::ProcessStatisticsReader::get_all(false); all_processes.has_value()) {
+            for (auto& process : all_processes->processes) {
+                if (process.pid == pid) {
+                    info.name = process.name;
+                    break;
+                }
+            }
+        }
+        if (m_symbolicate)
+            info.regions = read_regions(pid);
+        m_processes.set(pid, move(info));
+        return m_processes.get(pid).value();
+    }
+
+    static Vector<Region> read_regions(pid_t pid)
+    {
+        Vector<Region> regions;
+        auto file_or_error = Core::File::open(String::formatted("/proc/{}/vm", pid), Core::OpenMode::ReadOnly);
+        if (file_or_error.is_error())
+            return regions;
+        auto json = JsonValue::from_string(file_or_error.value()->read_all());
+        if (json.is_error() || !json.value().is_array())
+            return regions;
+
+        for (auto& region_value : json.value().as_array().values()) {
+            auto& region = region_value.as_object();
+            auto name = region.get("name"sv).to_string();
+            String path;
+            if (name == "/usr/lib/Loader.so")
+                path = name;
+            else if (name.ends_with(": .text"sv) || name.ends_with(": .rodata"sv))
+                path = name.split_view(':')[0];
+            else
+                continue;
+            regions.append({ region.get("address"sv).to_addr(), region.get("size"sv).to_addr(), move(path) });
+        }
+        return regions;
+    }
+
+    String symbolicate(ProcessInfo& process, FlatPtr address, bool is_kernel_frame, bool is_return_address)
+    {
+        if (!m_symbolicate)
+            return String::formatted("{:p}", address);
+
+        auto& cache = is_kernel_frame ? m_kernel_symbols : process.symbols;
+        if (auto it = cache.find(address); it != cache.end())
+            return it->value;
+
+        auto symbol = symbolicate_uncached(process, address, is_kernel_frame, is_return_address);
+        if (is_kernel_frame)
+            symbol = String::formatted("{}_[k]", symbol);
+        cache.set(address, symbol);
+        return symbol;
+    }
+
+    static String symbolicate_uncached(ProcessInfo const& process, FlatPtr address, bool is_kernel_frame, bool is_return_address)
+    {
+        String path;
+        FlatPtr base = 0;
+        if (is_kernel_frame) {
+            auto kernel_base = Symbolication::kernel_base();
+            if (!kernel_base.has_value() || address < kernel_base.value())
+                return String::formatted("{:p}", address);
+            path = "/boot/Kernel.debug";
+            base = kernel_base.value();
+        } else {
+            Region const* found_region = nullptr;
+            for (auto& region : process.regions) {
+                if (address >= region.base && address - region.base < region.size) {
+                    found_region = &region;
+                    break;
+                }
+            }
+            if (!found_region)
+                return String::formatted("{:p}", address);
+
+            // The lowest mapping of an image is where it was loaded, see Symbolication::symbolicate_thread().
+            base = found_region->base;
+            for (auto& region : process.regions) {
+                if (region.path == found_region->path)
+                    base = min(base, region.base);
+            }
+            path = found_region->path;
+        }
+
+        auto symbol = Symbolication::symbolicate(path, address - base - (is_return_address ? 1 : 0), Symbolication::IncludeSourcePosition::No);
+        if (!symbol.has_value() || symbol->name.is_empty())
+            return String::formatted("{:p}", address);
+        return symbol->name;
+    }
+
+    bool m_symbolicate { true };
+    size_t m_sample_count { 0 };
+    HashMap<String, u64> m_stacks;
+    HashMap<pid_t, ProcessInfo> m_processes;
+    HashMap<FlatPtr, String> m_kernel_symbols;
+};
+
+static void drain(Ring& ring, StackFolder& folder)
+{
+    auto& header = *ring.header;
+    auto write_position = AK::atomic_load(&header.write_position, AK::MemoryOrder::memory_order_acquire);
+    auto read_position = header.read_position;
+    auto data_size = header.data_size;
+
+    while (read_position < write_position) {
+        auto offset = read_position & (data_size - 1);
+        auto const& record = *reinterpret_cast<SampleRecord const*>(ring.data + offset);
+        if (record.size < sizeof(u64) || record.size % 8 != 0 || record.size > data_size - offset) {
+            warnln("Corrupted sample ring of CPU #{}, skipping ahead", header.cpu);
+            read_position = write_position;
+            break;
+        }
+        size_t frame_count = record.kernel_frame_count + record.user_frame_count;
+        if (record.type == SampleRecordType::Sample && sizeof(SampleRecord) + frame_count * sizeof(FlatPtr) <= record.size)
+            folder.add_sample(record);
+        read_position += record.size;
+    }
+
+    AK::atomic_store(&header.read_position, read_position, AK::MemoryOrder::memory_order_release);
+}
+
+static void handle_sigint(int)
+{
+    s_should_stop = true;
+}
+
+static ErrorOr<void> write_folded_stacks(StackFolder const& folder, StringView output_path)
+{
+    auto folded_stacks = folder.folded_stacks();
+    if (output_path.is_empty()) {
+        out("{}", folded_stacks);
+        return {};
+    }
+    auto file = TRY(Core::Stream::File::open(output_path, Core::Stream::OpenMode::Write | Core::Stream::OpenMode::Truncate));
+    if (!file->write_or_error(folded_stacks.bytes()))
+        return Error::from_string_literal("Failed to write the folded stacks");
+    return {};
+}
+
+ErrorOr<int> serenity_main(Main::Arguments arguments)
+{
+    size_t ring_size_in_kib = 0;
+    int duration_in_seconds = 0;
+    int write_interval_in_seconds = 0;
+    StringView output_path;
+    bool raw_addresses = false;
+
+    Core::ArgsParser args_parser;
+    args_parser.set_general_help("Continuously sample the stacks running on all CPUs and fold them into flame graph input.");
+    args_parser.add_option(duration_in_seconds, "Stop after this many seconds instead of on SIGINT", "duration", 'd', "seconds");
+    args_parser.add_option(write_interval_in_seconds, "Rewrite the output file this often while sampling", "interval", 'i', "seconds");
+    args_parser.add_option(output_path, "Write the folded stacks to this file instead of stdout", "output", 'o', "path");
+    args_parser.add_option(ring_size_in_kib, "Size of the ring of each CPU", "ring-size", 's', "KiB");
+    args_parser.add_option(raw_addresses, "Don't symbolicate the stacks", "raw", 'r');
+    args_parser.parse(arguments);
+
+    if (write_interval_in_seconds && output_path.is_empty()) {
+        warnln("An interval only makes sense together with an output file");
+        return 1;
+    }
+
+    auto fd = TRY(Core::System::open("/dev/samples"sv, O_RDWR | O_CLOEXEC));
+    TRY(Core::System::ioctl(fd, SAMPLING_IOCTL_ENABLE, ring_size_in_kib * KiB));
+
+    // The kernel rounds the size up, so ask the first ring how big they really are.
+    auto* first_header = static_cast<SampleRingHeader*>(TRY(Core::System::mmap(nullptr, Kernel::sample_ring_header_size, PROT_READ, MAP_SHARED, fd, 0)));
+    auto ring_size = Kernel::sample_ring_size(first_header->data_size);
+    TRY(Core::System::munmap(first_header, Kernel::sample_ring_header_size));
+
+    Vector<Ring> rings;
+    auto cpu_count = sysconf(_SC_NPROCESSORS_ONLN);
+    for (long cpu = 0; cpu < cpu_count; ++cpu) {
+        auto* ring = static_cast<u8*>(TRY(Core::System::mmap(nullptr, ring_size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, cpu * ring_size, 0, "Sample ring"sv)));
+        rings.append({ reinterpret_cast<SampleRingHeader*>(ring), ring + Kernel::sample_ring_header_size });
+    }
+
+    TRY(Core::System::pledge("stdio rpath wpath cpath"));
+    TRY(Core::System::signal(SIGINT, handle_sigint));
+
+    StackFolder folder(!raw_addresses);
+    auto elapsed = Core::ElapsedTimer::start_new();
+    auto last_write = Core::ElapsedTimer::start_new();
+    while (!s_should_stop) {
+        usleep(100'000);
+        for (auto& ring : rings)
+            drain(ring, folder);
+
+        if (duration_in_seconds && elapsed.elapsed() >= duration_in_seconds * 1000)
+            break;
+        if (write_interval_in_seconds && last_write.elapsed() >= write_interval_in_seconds * 1000) {
+            TRY(write_folded_stacks(folder, output_path));
+            last_write.start();
+        }
+    }
+
+    for (auto& ring : rings)
+        drain(ring, folder);
+    TRY(write_folded_stacks(folder, output_path));
+
+    u64 lost_samples = 0;
+    for (auto& ring : rings)
+        lost_samples += AK::atomic_load(&ring.header->lost_samples, AK::MemoryOrder::memory_order_relaxed);
+    warnln("{} samples, {} lost", folder.sample_count(), lost_samples);
+    return 0;
+}
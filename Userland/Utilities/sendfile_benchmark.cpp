@@ -0,0 +1,129 @@
+/*
+ * Copyright (c) 2022, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <AK/ScopeGuard.h>
+#include <AK/String.h>
+#include <AK/Types.h>
+#include <AK/Vector.h>
+#include <LibCore/ArgsParser.h>
+#include <LibCore/ElapsedTimer.h>
+#include <LibCore/System.h>
+#include <LibMain/Main.h>
+#include <arpa/inet.h>
+#include <fcntl.h>
+#include <netinet/in.h>
+#include <pthread.h>
+#include <string.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+static void* run_receiver(void* argument)
+{
+    int fd = *static_cast<int*>(argument);
+    u8 buffer[64 * KiB];
+    while (read(fd, buffer, sizeof(buffer)) > 0)
+        ;
+    return nullptr;
+}
+
+// Sends the whole file over a fresh loopback TCP connection as often as possible for
+// `seconds`, and returns the number of bytes per second that made it into the socket.
+static ErrorOr<u64> run_benchmark(int file_fd, size_t file_size, int seconds, bool use_sendfile)
+{
+    auto server_fd = TRY(Core::System::socket(AF_INET, SOCK_STREAM, 0));
+    sockaddr_in address {};
+    address.sin_family = AF_INET;
+    address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    address.sin_port = 0;
+    TRY(Core::System::bind(server_fd, reinterpret_cast<sockaddr const*>(&address), sizeof(address)));
+    TRY(Core::System::listen(server_fd, 1));
+    socklen_t address_size = sizeof(address);
+    TRY(Core::System::getsockname(server_fd, reinterpret_cast<sockaddr*>(&address), &address_size));
+
+    auto client_fd = TRY(Core::System::socket(AF_INET, SOCK_STREAM, 0));
+    TRY(Core::System::connect(client_fd, reinterpret_cast<sockaddr const*>(&address), sizeof(address)));
+    auto sender_fd = TRY(Core::System::accept(server_fd, nullptr, nullptr));
+    TRY(Core::System::close(server_fd));
+
+    pthread_t receiver;
+    if (auto rc = pthread_create(&receiver, nullptr, run_receiver, &client_fd); rc != 0)
+        return Error::from_errno(rc);
+
+    Vector<u8> buffer;
+    if (!use_sendfile)
+        buffer.resize(64 * KiB);
+
+    u64 total_sent = 0;
+    auto timer = Core::ElapsedTimer::start_new();
+    while (timer.elapsed() < seconds * 1000) {
+        off_t offset = 0;
+        while (static_cast<size_t>(offset) < file_size) {
+            if (use_sendfile) {
+                // NOTE: sendfile() advances the offset by itself.
+                TRY(Core::System::sendfile(sender_fd, file_fd, &offset, file_size - offset));
+                continue;
+            }
+            auto nread = TRY(Core::System::read(file_fd, buffer.span().trim(file_size - offset)));
+            ReadonlyBytes data { buffer.data(), static_cast<size_t>(nread) };
+            while (!data.is_empty())
+                data = data.slice(TRY(Core::System::write(sender_fd, data)));
+            offset += nread;
+        }
+        if (!use_sendfile)
+            TRY(Core::System::lseek(file_fd, 0, SEEK_SET));
+        total_sent += file_size;
+    }
+    auto elapsed_ms = max<i64>(timer.elapsed(), 1);
+
+    TRY(Core::System::close(sender_fd));
+    if (auto rc = pthread_join(receiver, nullptr); rc != 0)
+        return Error::from_errno(rc);
+    TRY(Core::System::close(client_fd));
+    return total_sent * 1000 / elapsed_ms;
+}
+
+ErrorOr<int> serenity_main(Main::Arguments arguments)
+{
+    TRY(Core::System::pledge("stdio rpath wpath cpath inet accept thread"));
+
+    StringView directory = "/tmp"sv;
+    size_t file_size = 16 * MiB;
+    int seconds = 5;
+
+    Core::ArgsParser args_parser;
+    args_parser.set_general_help("Compare sending a file over a loopback TCP connection with read()/write() and with sendfile().");
+    args_parser.add_option(file_size, "Size of the file to send in bytes (default: 16 MiB)", "file-size", 'f', "bytes");
+    args_parser.add_option(seconds, "Duration of each benchmark in seconds (default: 5)", "time", 't', "seconds");
+    args_parser.add_positional_argument(directory, "Directory to create the file in (default: /tmp)", "directory", Core::ArgsParser::Required::No);
+    args_parser.parse(arguments);
+
+    if (file_size == 0) {
+        warnln("The file must not be empty");
+        return 1;
+    }
+
+    auto path = String::formatted("{}/sendfile_benchmark.{}", directory, getpid());
+    auto file_fd = TRY(Core::System::open(path, O_CREAT | O_TRUNC | O_RDWR, 0644));
+    ScopeGuard remove_file = [&] { (void)Core::System::unlink(path); };
+
+    Vector<u8> chunk;
+    chunk.resize(64 * KiB);
+    memset(chunk.data(), 'A', chunk.size());
+    for (size_t written = 0; written < file_size;) {
+        auto nwritten = TRY(Core::System::write(file_fd, chunk.span().trim(file_size - written)));
+        written += nwritten;
+    }
+    TRY(Core::System::lseek(file_fd, 0, SEEK_SET));
+
+    outln("Sending a {}-byte file over loopback TCP for {}s each...", file_size, seconds);
+    auto read_write_bps = TRY(run_benchmark(file_fd, file_size, seconds, false));
+    outln("read()/write(): bps={}", read_write_bps);
+    auto sendfile_bps = TRY(run_benchmark(file_fd, file_size, seconds, true));
+    outln("sendfile():     bps={}", sendfile_bps);
+
+    TRY(Core::System::close(file_fd));
+    return 0;
+}